@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace lithium::bench {
+
+// Runs `fn` once and returns the elapsed wall time in milliseconds
+template<typename Fn>
+double time_ms(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// One result row: name, problem size, time, and throughput per second
+inline void report(const char* name, std::size_t n, double ms, std::size_t ops) {
+    double per_sec = ms > 0.0 ? static_cast<double>(ops) / (ms / 1000.0) : 0.0;
+    std::printf("%-28s n=%-9zu %10.2f ms %14.0f ops/s\n", name, n, ms, per_sec);
+}
+
+// One result row for byte-oriented work: name, input size, time, and MB/s
+inline void report_bytes(const char* name, std::size_t bytes, double ms) {
+    double mb_per_sec = ms > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0;
+    std::printf("%-28s %10zu B %10.2f ms %11.1f MB/s\n", name, bytes, ms, mb_per_sec);
+}
+
+} // namespace lithium::bench
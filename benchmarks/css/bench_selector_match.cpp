@@ -0,0 +1,101 @@
+/**
+ * Selector matching microbenchmark: SelectorMatcher::query_selector_all over
+ * a large DOM for class, compound, attribute, child and descendant
+ * selectors, and SelectorMatcher::matches of a selector-heavy list against
+ * every element.
+ */
+
+#include "bench_util.hpp"
+#include "lithium/css/selector.hpp"
+#include "lithium/html/parser.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+using namespace lithium;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+std::string make_document(usize sections, usize items_per_section) {
+    std::string html = "<!DOCTYPE html><html><head><title>Match</title></head><body>\n";
+    for (usize s = 0; s < sections; ++s) {
+        html += "<section id=\"s" + std::to_string(s) + "\" class=\"list theme-" + std::to_string(s % 7) + "\">\n";
+        for (usize i = 0; i < items_per_section; ++i) {
+            html += "<div class=\"item card u-" + std::to_string(i % 50) + (i % 3 ? "" : " is-active") +
+                    "\" data-index=\"" + std::to_string(i) + "\"><span class=\"label\">Item</span> "
+                    "<a href=\"#\" class=\"link\">link</a></div>\n";
+        }
+        html += "</section>\n";
+    }
+    html += "</body></html>";
+    return html;
+}
+
+void collect_elements(dom::Element& element, std::vector<dom::Element*>& out) {
+    out.push_back(&element);
+    for (auto* child = element.first_child(); child; child = child->next_sibling()) {
+        if (child->is_element()) {
+            collect_elements(*child->as_element(), out);
+        }
+    }
+}
+
+void bench_query(const dom::Document& document, const char* selector_text) {
+    auto selectors = css::SelectorList::parse(String(selector_text));
+    usize found = 0;
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        double ms = bench::time_ms([&] {
+            found = css::SelectorMatcher::query_selector_all(selectors, *document.document_element()).size();
+        });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = std::string("query ") + selector_text;
+    bench::report(name.c_str(), found, best, 1);
+}
+
+// Every element against a list of selectors, most of which fail late
+void bench_match_list(const std::vector<dom::Element*>& elements) {
+    std::string text;
+    for (int i = 0; i < 50; ++i) {
+        auto n = std::to_string(i);
+        text += ".theme-" + n + " > .item.u-" + n + " .label, section .card.is-active > a.link-" + n +
+                ", [data-index=\"" + n + "\"].card, div.u-" + n + " + div.u-" + n + ",";
+    }
+    text += "#s0";
+    auto selectors = css::SelectorList::parse(String(text));
+
+    usize matched = 0;
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        matched = 0;
+        double ms = bench::time_ms([&] {
+            for (auto* element : elements) {
+                matched += css::SelectorMatcher::matches(selectors, *element) ? usize{1} : usize{0};
+            }
+        });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = "match " + std::to_string(selectors.selectors.size()) + " selectors";
+    bench::report(name.c_str(), elements.size(), best, elements.size() * selectors.selectors.size());
+    std::printf("  %zu elements matched\n", matched);
+}
+
+} // namespace
+
+int main() {
+    html::Parser parser;
+    auto document = parser.parse(String(make_document(200, 50)));
+    std::vector<dom::Element*> elements;
+    collect_elements(*document->document_element(), elements);
+
+    bench_query(*document, ".is-active");
+    bench_query(*document, "div.card.u-7");
+    bench_query(*document, "[data-index=\"42\"]");
+    bench_query(*document, ".theme-3 > .item > .label");
+    bench_query(*document, "section a.link");
+    bench_match_list(elements);
+    return 0;
+}
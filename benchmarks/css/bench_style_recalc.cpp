@@ -0,0 +1,310 @@
+/**
+ * Style recalc microbenchmark: StyleResolver::resolve_document over a large
+ * DOM against a framework-sized author stylesheet (thousands of class, id,
+ * tag, attribute and child-combinator rules), and a deeply nested DOM
+ * against many combinator rules to exercise the ancestor Bloom filter, and
+ * a large table of identical rows to exercise style sharing. Each case also
+ * prints the memory held by the computed styles' property groups. The last
+ * cases scale the large recalc over 1/2/4/8 threads, and restyle the large
+ * DOM after single class and child mutations through the invalidation sets.
+ */
+
+#include "bench_util.hpp"
+#include "lithium/css/style_resolver.hpp"
+#include "lithium/html/parser.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+
+using namespace lithium;
+
+namespace {
+
+constexpr int ROUNDS = 3;
+
+// Roughly the shape of a utility/component framework: mostly single-class
+// rules, some compound and child selectors, a few ids, attributes and tags
+std::string make_stylesheet(usize rules) {
+    std::string css;
+    for (usize i = 0; i < rules; ++i) {
+        auto n = std::to_string(i);
+        switch (i % 8) {
+            case 0: case 1: case 2:
+                css += ".u-" + n + " { margin-top: " + std::to_string(i % 40) + "px }\n";
+                break;
+            case 3:
+                css += ".card-" + n + ".is-active { color: red; padding: 4px }\n";
+                break;
+            case 4:
+                css += ".list-" + n + " > .item-" + n + " { display: block }\n";
+                break;
+            case 5:
+                css += "#section-" + n + " { width: 100px }\n";
+                break;
+            case 6:
+                css += "[data-role-" + n + "] { height: 10px }\n";
+                break;
+            default:
+                css += (i % 16 == 7 ? "div.c-" : "span.c-") + n + " { font-size: 14px }\n";
+                break;
+        }
+    }
+    css += "* { box-sizing: border-box }\n";
+    return css;
+}
+
+std::string make_document(usize sections, usize items_per_section, usize rules) {
+    std::string html = "<!DOCTYPE html><html><head><title>Recalc</title></head><body>\n";
+    usize k = 0;
+    for (usize s = 0; s < sections; ++s) {
+        html += "<section id=\"section-" + std::to_string((s * 8 + 5) % rules) + "\" class=\"list-" +
+                std::to_string((s * 8 + 4) % rules) + "\">\n";
+        for (usize i = 0; i < items_per_section; ++i, ++k) {
+            auto cls = std::to_string((k * 8) % rules);
+            html += "<div class=\"u-" + cls + " item-" + std::to_string((s * 8 + 4) % rules) +
+                    " card-" + std::to_string((k * 8 + 3) % rules) + " is-active\" data-role-" +
+                    std::to_string((k * 8 + 6) % rules) + "><span class=\"c-" + std::to_string((k * 8 + 15) % rules) +
+                    "\">Item</span> <a href=\"#\">link</a></div>\n";
+        }
+        html += "</section>\n";
+    }
+    html += "</body></html>";
+    return html;
+}
+
+// Child-combinator chains whose ancestors mostly do not exist in the page
+std::string make_combinator_stylesheet(usize rules) {
+    std::string css;
+    for (usize i = 0; i < rules; ++i) {
+        auto n = std::to_string(i);
+        css += ".theme-" + n + " > .panel > .row > div { color: red }\n";
+        css += "#view-" + n + " > section > .item { margin-top: 1px }\n";
+        css += ".level-" + std::to_string(i % 40) + " > .box-" + n + " > .item { padding: 2px }\n";
+    }
+    return css;
+}
+
+std::string make_deep_document(usize trees, usize depth) {
+    std::string html = "<!DOCTYPE html><html><head><title>Deep</title></head><body class=\"theme-0\">\n";
+    for (usize t = 0; t < trees; ++t) {
+        for (usize d = 0; d < depth; ++d) {
+            html += "<div class=\"level-" + std::to_string(d) + " panel row\">";
+        }
+        html += "<section><div class=\"item\">Leaf</div><div class=\"item\">Leaf</div></section>";
+        for (usize d = 0; d < depth; ++d) {
+            html += "</div>";
+        }
+        html += "\n";
+    }
+    html += "</body></html>";
+    return html;
+}
+
+std::string make_table_document(usize rows, usize columns) {
+    std::string html = "<!DOCTYPE html><html><head><title>Table</title></head><body><table class=\"grid\">\n";
+    for (usize r = 0; r < rows; ++r) {
+        html += r % 2 ? "<tr class=\"row odd\">" : "<tr class=\"row\">";
+        for (usize c = 0; c < columns; ++c) {
+            html += "<td class=\"cell\"><span class=\"value\">" + std::to_string(r * columns + c) + "</span></td>";
+        }
+        html += "</tr>\n";
+    }
+    html += "</table></body></html>";
+    return html;
+}
+
+usize count_elements(const dom::Element& element) {
+    usize count = 1;
+    for (auto* child = element.first_child(); child; child = child->next_sibling()) {
+        if (child->is_element()) {
+            count += count_elements(*child->as_element());
+        }
+    }
+    return count;
+}
+
+// Bytes held by the distinct property groups of every element's style, next
+// to what one flat copy of every group per element would take
+void report_style_memory(const css::StyleResolver& resolver, const dom::Element& root) {
+    std::unordered_set<const void*> groups;
+    usize elements = 0;
+    usize shared_bytes = 0;
+    auto add = [&](const auto& group) {
+        if (groups.insert(&group).second) {
+            shared_bytes += sizeof(group);
+        }
+    };
+    auto visit = [&](auto& self, const dom::Element& element) -> void {
+        if (const auto* style = resolver.get_computed_style(element)) {
+            ++elements;
+            add(style->box());
+            add(style->border());
+            add(style->background());
+            add(style->font());
+            add(style->inherited_text());
+            add(style->text());
+        }
+        for (auto* child = element.first_child(); child; child = child->next_sibling()) {
+            if (child->is_element()) {
+                self(self, *child->as_element());
+            }
+        }
+    };
+    visit(visit, root);
+
+    usize flat_bytes = elements * (sizeof(css::BoxProperties) + sizeof(css::BorderProperties) +
+                                   sizeof(css::BackgroundProperties) + sizeof(css::FontProperties) +
+                                   sizeof(css::InheritedTextProperties) + sizeof(css::TextProperties));
+    std::printf("  style memory: %zu groups, %zu KB (%zu KB unshared)\n", groups.size(), shared_bytes / 1024,
+                flat_bytes / 1024);
+}
+
+void bench_recalc(usize rules, usize sections, usize items_per_section, usize threads = 1) {
+    css::Parser css_parser;
+    auto stylesheet = css_parser.parse_stylesheet(String(make_stylesheet(rules)));
+    html::Parser html_parser;
+    auto document = html_parser.parse(String(make_document(sections, items_per_section, rules)));
+    usize elements = count_elements(*document->document_element());
+
+    css::StyleResolver resolver;
+    resolver.add_stylesheet(stylesheet);
+    resolver.set_thread_count(threads);
+
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        resolver.invalidate_all();
+        double ms = bench::time_ms([&] { resolver.resolve_document(*document); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = "recalc " + std::to_string(rules) + " rules";
+    if (threads > 1) {
+        name += ", " + std::to_string(threads) + " threads";
+    }
+    bench::report(name.c_str(), elements, best, elements);
+    if (threads == 1) {
+        report_style_memory(resolver, *document->document_element());
+    }
+}
+
+void bench_table_recalc(usize rules, usize rows, usize columns) {
+    css::Parser css_parser;
+    auto stylesheet = css_parser.parse_stylesheet(
+        String(make_stylesheet(rules) + ".grid > tr > .cell { padding: 2px } .odd > .cell { color: gray } "
+                                        ".value { font-weight: bold }\n"));
+    html::Parser html_parser;
+    auto document = html_parser.parse(String(make_table_document(rows, columns)));
+    usize elements = count_elements(*document->document_element());
+
+    css::StyleResolver resolver;
+    resolver.add_stylesheet(stylesheet);
+
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        resolver.invalidate_all();
+        resolver.reset_style_sharing_stats();
+        double ms = bench::time_ms([&] { resolver.resolve_document(*document); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = "table recalc " + std::to_string(rows) + "x" + std::to_string(columns);
+    bench::report(name.c_str(), elements, best, elements);
+
+    const auto& stats = resolver.style_sharing_stats();
+    std::printf("  style sharing: %llu shared, %llu resolved, %.1f%% hit rate\n",
+                static_cast<unsigned long long>(stats.shared), static_cast<unsigned long long>(stats.resolved),
+                stats.hit_rate() * 100.0);
+    report_style_memory(resolver, *document->document_element());
+}
+
+void bench_deep_recalc(usize rules, usize trees, usize depth) {
+    css::Parser css_parser;
+    auto stylesheet = css_parser.parse_stylesheet(String(make_combinator_stylesheet(rules)));
+    html::Parser html_parser;
+    auto document = html_parser.parse(String(make_deep_document(trees, depth)));
+    usize elements = count_elements(*document->document_element());
+
+    css::StyleResolver resolver;
+    resolver.add_stylesheet(stylesheet);
+
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        resolver.invalidate_all();
+        resolver.reset_ancestor_filter_stats();
+        double ms = bench::time_ms([&] { resolver.resolve_document(*document); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = "deep recalc " + std::to_string(rules * 3) + " rules, depth " + std::to_string(depth);
+    bench::report(name.c_str(), elements, best, elements);
+
+    const auto& stats = resolver.ancestor_filter_stats();
+    std::printf("  ancestor filter: %llu rejected, %llu passed, %llu false positives\n",
+                static_cast<unsigned long long>(stats.rejected), static_cast<unsigned long long>(stats.passed),
+                static_cast<unsigned long long>(stats.false_positives));
+}
+
+// Forwards the document's mutations to the resolver, as the browser engine does
+class InvalidatingObserver : public dom::DocumentObserver {
+public:
+    explicit InvalidatingObserver(css::StyleResolver& resolver) : m_resolver(resolver) {}
+
+    void attribute_changed(dom::Element& element, const String& name,
+                           const std::optional<String>& old_value) override {
+        m_resolver.invalidate_attribute_change(element, name, old_value);
+    }
+    void child_inserted(dom::Node& parent, dom::Node& child) override {
+        m_resolver.invalidate_child_inserted(parent, child);
+    }
+    void child_removed(dom::Node& parent, dom::Node& child) override {
+        m_resolver.invalidate_child_removed(parent, child);
+    }
+
+private:
+    css::StyleResolver& m_resolver;
+};
+
+// Toggles a class that a child-combinator rule keys on, on one section at a
+// time, and appends an item to it; each step restyles just that section
+void bench_incremental_restyle(usize rules, usize sections, usize items_per_section) {
+    css::Parser css_parser;
+    auto stylesheet = css_parser.parse_stylesheet(
+        String(make_stylesheet(rules) + ".open > div { padding: 3px }\n"));
+    html::Parser html_parser;
+    auto document = html_parser.parse(String(make_document(sections, items_per_section, rules)));
+    usize elements = count_elements(*document->document_element());
+
+    css::StyleResolver resolver;
+    resolver.add_stylesheet(stylesheet);
+    resolver.resolve_document(*document);
+    InvalidatingObserver observer(resolver);
+    document->set_observer(&observer);
+
+    auto section_elements = document->get_elements_by_tag_name("section"_s);
+    constexpr usize STEPS = 200;
+    double ms = bench::time_ms([&] {
+        for (usize step = 0; step < STEPS; ++step) {
+            auto* section = section_elements[step % section_elements.size()];
+            section->set_attribute("class"_s, step % 2 ? "list"_s : "list open"_s);
+            resolver.resolve_document(*document);
+            section->append_child(document->create_element("div"_s));
+            resolver.resolve_document(*document);
+        }
+    });
+    document->set_observer(nullptr);
+
+    bench::report("incremental restyle", elements, ms, STEPS * 2);
+}
+
+} // namespace
+
+int main() {
+    bench_recalc(1000, 100, 20);
+    bench_recalc(8000, 100, 20);
+    bench_recalc(8000, 400, 20);
+    bench_deep_recalc(1000, 50, 40);
+    bench_table_recalc(1000, 2000, 10);
+    for (usize threads : {2u, 4u, 8u}) {
+        bench_recalc(8000, 400, 20, threads);
+    }
+    bench_incremental_restyle(8000, 400, 20);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * Stylesheet cache microbenchmark: a framework-sized stylesheet parsed and
+ * prepared on a miss, served from memory on a hit, and loaded from the
+ * cache directory by a fresh cache (as a new process would), plus adding
+ * the prepared stylesheet to a StyleResolver. Prints the cache counters.
+ */
+
+#include "bench_util.hpp"
+#include "lithium/css/style_resolver.hpp"
+#include "lithium/css/stylesheet_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+using namespace lithium;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+std::string make_stylesheet(usize rules) {
+    std::string css;
+    for (usize i = 0; i < rules; ++i) {
+        auto n = std::to_string(i);
+        switch (i % 6) {
+            case 0: case 1:
+                css += ".u-" + n + " { margin: " + std::to_string(i % 40) + "px auto; color: #3a3a3a }\n";
+                break;
+            case 2:
+                css += ".card-" + n + ".is-active > .title, .card-" + n +
+                       ":hover { padding: 4px 8px; background-color: rgba(0, 0, 0, 0.5) }\n";
+                break;
+            case 3:
+                css += "#section-" + n + " [data-role=\"tab\"] { width: calc(100% - 2px); font-weight: 700 }\n";
+                break;
+            case 4:
+                css += "@media (min-width: " + std::to_string(400 + i % 800) + "px) { .col-" + n +
+                       " { width: 50% } }\n";
+                break;
+            default:
+                css += "nav ul li a.link-" + n + " { font-size: 14px; line-height: 1.5; text-align: center }\n";
+                break;
+        }
+    }
+    return css;
+}
+
+template<typename Fn>
+double best_of(Fn&& fn) {
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        double ms = bench::time_ms(fn);
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+void print_stats(const char* label, const css::StylesheetCache& cache) {
+    const auto& stats = cache.stats();
+    std::printf("  %s: %llu hits, %llu disk hits, %llu misses, %llu evictions, %zu KB held\n", label,
+                static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.disk_hits),
+                static_cast<unsigned long long>(stats.misses), static_cast<unsigned long long>(stats.evictions),
+                cache.memory_size() / 1024);
+}
+
+} // namespace
+
+int main() {
+    String css(make_stylesheet(20000));
+    auto directory = std::filesystem::temp_directory_path() / "lithium-bench-stylesheet-cache";
+    std::filesystem::remove_all(directory);
+
+    css::StylesheetCache disabled;
+    disabled.enable_cache(false);
+    RefPtr<const css::PreparedStylesheet> prepared;
+    double ms = best_of([&] { prepared = disabled.get(css); });
+    bench::report_bytes("miss (parse + prepare)", css.size(), ms);
+
+    css::StylesheetCache cache;
+    cache.set_directory(String(directory.string()));
+    (void)cache.get(css);  // Parses and writes the file
+    ms = best_of([&] { prepared = cache.get(css); });
+    bench::report_bytes("memory hit", css.size(), ms);
+    print_stats("warm cache", cache);
+
+    ms = best_of([&] {
+        css::StylesheetCache fresh;
+        fresh.set_directory(String(directory.string()));
+        prepared = fresh.get(css);
+    });
+    bench::report_bytes("disk hit (fresh cache)", css.size(), ms);
+
+    ms = best_of([&] {
+        css::StyleResolver resolver;
+        resolver.add_stylesheet(prepared);
+    });
+    bench::report("add prepared to resolver", prepared->selectors().size(), ms, prepared->selectors().size());
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * DOM child list microbenchmark: a wide container built by appending and by
+ * inserting at the front, its children removed front to back, and the
+ * children walked by iteration and by index, as scripts walk childNodes.
+ */
+
+#include "bench_util.hpp"
+#include "lithium/dom/document.hpp"
+#include "lithium/dom/element.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace lithium;
+
+int main() {
+    auto document = make_ref<dom::Document>();
+    auto body = document->create_element("body"_s);
+    document->append_child(body);
+
+    constexpr usize CHILDREN = 50000;
+    std::vector<RefPtr<dom::Element>> items;
+    items.reserve(CHILDREN);
+    for (usize i = 0; i < CHILDREN; ++i) {
+        items.push_back(document->create_element("li"_s));
+    }
+
+    auto list = document->create_element("ul"_s);
+    body->append_child(list);
+
+    double ms = bench::time_ms([&] {
+        for (const auto& item : items) {
+            list->append_child(item);
+        }
+    });
+    bench::report("append_child", CHILDREN, ms, CHILDREN);
+
+    usize visited = 0;
+    ms = bench::time_ms([&] {
+        for (int round = 0; round < 100; ++round) {
+            for (const auto& child : list->child_nodes()) {
+                visited += child->is_element() ? 1u : 0u;
+            }
+        }
+    });
+    bench::report("iterate child_nodes x100", CHILDREN, ms, CHILDREN * 100);
+
+    ms = bench::time_ms([&] {
+        auto children = list->child_nodes();
+        for (usize i = 0; i < children.size(); ++i) {
+            visited += children[i]->is_element() ? 1u : 0u;
+        }
+    });
+    bench::report("child_nodes()[i] walk", CHILDREN, ms, CHILDREN);
+
+    ms = bench::time_ms([&] {
+        for (const auto& item : items) {
+            list->remove_child(item);
+        }
+    });
+    bench::report("remove_child (front)", CHILDREN, ms, CHILDREN);
+
+    ms = bench::time_ms([&] {
+        for (const auto& item : items) {
+            list->insert_before(item, list->first_child());
+        }
+    });
+    bench::report("insert_before (front)", CHILDREN, ms, CHILDREN);
+
+    ms = bench::time_ms([&] {
+        for (usize i = 0; i < CHILDREN; i += 2) {
+            list->remove_child(items[i]);
+        }
+    });
+    bench::report("remove_child (every other)", CHILDREN, ms, CHILDREN / 2);
+
+    std::printf("  %zu visited, %zu left\n", visited, list->child_nodes().size());
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * DOM lookup microbenchmark: Document::get_element_by_id,
+ * get_elements_by_class_name and get_elements_by_tag_name called in a loop
+ * on a large document, as scripts do, and the same lookups interleaved with
+ * a class change that invalidates the class collections.
+ */
+
+#include "bench_util.hpp"
+#include "lithium/dom/document.hpp"
+#include "lithium/html/parser.hpp"
+#include <cstdio>
+#include <string>
+
+using namespace lithium;
+
+namespace {
+
+std::string make_document(usize sections, usize items_per_section) {
+    std::string html = "<!DOCTYPE html><html><head><title>Lookup</title></head><body>\n";
+    usize k = 0;
+    for (usize s = 0; s < sections; ++s) {
+        html += "<section id=\"section-" + std::to_string(s) + "\" class=\"list\">\n";
+        for (usize i = 0; i < items_per_section; ++i, ++k) {
+            html += "<div id=\"item-" + std::to_string(k) + "\" class=\"item u-" + std::to_string(k % 50) +
+                    (k % 3 ? "" : " is-active") + "\"><span class=\"label\">Item</span></div>\n";
+        }
+        html += "</section>\n";
+    }
+    html += "</body></html>";
+    return html;
+}
+
+} // namespace
+
+int main() {
+    html::Parser parser;
+    auto document = parser.parse(String(make_document(200, 50)));
+    constexpr usize ITEMS = 200 * 50;
+
+    std::vector<String> ids;
+    for (usize i = 0; i < ITEMS; i += 7) {
+        ids.push_back(String("item-" + std::to_string(i)));
+    }
+
+    constexpr usize ID_LOOKUPS = 20000;
+    usize found = 0;
+    double ms = bench::time_ms([&] {
+        for (usize i = 0; i < ID_LOOKUPS; ++i) {
+            found += document->get_element_by_id(ids[i % ids.size()]) ? 1u : 0u;
+        }
+    });
+    bench::report("get_element_by_id", ITEMS, ms, ID_LOOKUPS);
+
+    constexpr usize COLLECTION_LOOKUPS = 200;
+    ms = bench::time_ms([&] {
+        for (usize i = 0; i < COLLECTION_LOOKUPS; ++i) {
+            found += document->get_elements_by_class_name("is-active"_s).size();
+        }
+    });
+    bench::report("get_elements_by_class_name", ITEMS, ms, COLLECTION_LOOKUPS);
+
+    ms = bench::time_ms([&] {
+        for (usize i = 0; i < COLLECTION_LOOKUPS; ++i) {
+            found += document->get_elements_by_tag_name("span"_s).size();
+        }
+    });
+    bench::report("get_elements_by_tag_name", ITEMS, ms, COLLECTION_LOOKUPS);
+
+    // Each class change drops the class collections, so each lookup walks
+    auto* toggled = document->get_element_by_id("item-1"_s);
+    ms = bench::time_ms([&] {
+        for (usize i = 0; i < COLLECTION_LOOKUPS; ++i) {
+            toggled->set_attribute("class"_s, i % 2 ? "item"_s : "item is-active"_s);
+            found += document->get_elements_by_class_name("is-active"_s).size();
+        }
+    });
+    bench::report("class change + lookup", ITEMS, ms, COLLECTION_LOOKUPS);
+
+    std::printf("  %zu found\n", found);
+    return 0;
+}
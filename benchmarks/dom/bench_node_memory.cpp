@@ -0,0 +1,108 @@
+/**
+ * DOM node memory microbenchmark: parses a ~1 MB attribute-heavy page and
+ * reports parse time, heap allocations and heap bytes per node (counted by
+ * this executable's global operator new), then the document's node arena
+ * report: slab slots per node size and the bytes they hold.
+ */
+
+#include "bench_util.hpp"
+#include "lithium/dom/document.hpp"
+#include "lithium/html/parser.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace lithium;
+
+namespace {
+
+std::atomic<usize> g_allocations{0};
+std::atomic<usize> g_live_bytes{0};
+
+// Every allocation carries its size in front, so frees can be counted
+constexpr usize PREFIX = alignof(std::max_align_t);
+
+void* counted_alloc(usize size) {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + PREFIX));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<usize*>(block) = size;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+    return block + PREFIX;
+}
+
+void counted_free(void* ptr) {
+    if (!ptr) return;
+    auto* block = static_cast<unsigned char*>(ptr) - PREFIX;
+    g_live_bytes.fetch_sub(*reinterpret_cast<usize*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+std::string make_page(usize cards) {
+    std::string html = "<!DOCTYPE html><html><head><title>Cards</title></head><body>\n";
+    for (usize i = 0; i < cards; ++i) {
+        auto n = std::to_string(i);
+        html += "<div class=\"card card-" + std::to_string(i % 20) + "\" id=\"card-" + n +
+                "\" data-index=\"" + n + "\" role=\"listitem\">"
+                "<a href=\"/items/" + n + "\" class=\"link\" title=\"Item " + n + "\">"
+                "<img src=\"/img/" + n + ".png\" alt=\"\" width=\"64\" height=\"64\"></a>"
+                "<span class=\"label\">Item " + n + "</span><!-- card " + n + " -->"
+                "<p>Short description of the item.</p></div>\n";
+    }
+    html += "</body></html>";
+    return html;
+}
+
+usize count_nodes(const dom::Node& root) {
+    usize count = 0;
+    for (const dom::Node* node = &root; node; node = node->next_in_subtree(root)) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { counted_free(ptr); }
+
+int main() {
+    String page(make_page(3000));
+    constexpr int ROUNDS = 5;
+
+    html::Parser parser;
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        double ms = bench::time_ms([&] { (void)parser.parse(page); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    bench::report_bytes("parse", page.size(), best);
+
+    usize allocations_before = g_allocations.load();
+    usize bytes_before = g_live_bytes.load();
+    auto document = parser.parse(page);
+    usize allocations = g_allocations.load() - allocations_before;
+    usize bytes = g_live_bytes.load() - bytes_before;
+
+    usize nodes = count_nodes(*document);
+    std::printf("  %zu nodes: %.1f allocations/node during parse, %.0f heap bytes/node held\n", nodes,
+                static_cast<double>(allocations) / static_cast<double>(nodes),
+                static_cast<double>(bytes) / static_cast<double>(nodes));
+
+    const auto& arena = document->node_arena();
+    for (const auto& slab : arena.stats().slabs) {
+        std::printf("  arena slab %4zu B: %7zu live %7zu slots %8zu KB\n", slab.slot_size, slab.live,
+                    slab.capacity, slab.slot_size * slab.capacity / 1024);
+    }
+    std::printf("  arena: %zu nodes live, %zu KB reserved\n", arena.stats().live(), arena.stats().reserved() / 1024);
+    return 0;
+}
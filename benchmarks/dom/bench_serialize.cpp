@@ -0,0 +1,86 @@
+/**
+ * DOM serialization microbenchmark: inner_html of the body of a ~10 MB page
+ * (article sections with attributes, inline markup and text that needs
+ * escaping), outer_html of one small element in a loop, as scripts read
+ * it, and inner_html of a deeply nested subtree
+ */
+
+#include "bench_util.hpp"
+#include "lithium/dom/document.hpp"
+#include "lithium/html/parser.hpp"
+#include <algorithm>
+#include <string>
+
+using namespace lithium;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+std::string make_document(usize target_bytes) {
+    std::string html = "<!DOCTYPE html><html><head><title>Serialize</title></head><body>\n";
+    for (usize i = 0; html.size() < target_bytes; ++i) {
+        auto n = std::to_string(i);
+        html += "<section id=\"s-" + n + "\" class=\"article card\" data-index=\"" + n + "\">"
+                "<h2 title=\"Part &quot;" + n + "&quot;\">Section " + n + "</h2>"
+                "<p>Prices rise &amp; fall: 3 &lt; 5 &gt; 2, caf\xC3\xA9&nbsp;au&nbsp;lait. "
+                "Lorem ipsum dolor sit amet, <em>consectetur</em> adipiscing elit, sed do eiusmod "
+                "tempor incididunt ut labore et <a href=\"/p?x=1&amp;y=" + n + "\">dolore</a> magna.</p>"
+                "<ul><li>One</li><li>Two</li><li>Three</li></ul><br><img src=\"i" + n + ".png\" alt=\"\">"
+                "<!-- section " + n + " --></section>\n";
+    }
+    html += "</body></html>";
+    return html;
+}
+
+template<typename Fn>
+double best_of(Fn&& fn) {
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        double ms = bench::time_ms(fn);
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    html::Parser parser;
+    auto document = parser.parse(String(make_document(10 * 1024 * 1024)));
+    auto* body = document->body();
+
+    String markup;
+    double ms = best_of([&] { markup = body->inner_html(); });
+    bench::report_bytes("body inner_html (10 MB)", markup.size(), ms);
+
+    auto* section = document->get_element_by_id("s-100"_s);
+    constexpr usize READS = 100000;
+    usize bytes = 0;
+    ms = best_of([&] {
+        for (usize i = 0; i < READS; ++i) {
+            bytes += section->outer_html().size();
+        }
+    });
+    bench::report("section outer_html", READS, ms, READS);
+
+    constexpr usize DEPTH = 20000;
+    auto nested = document->create_element("div"_s);
+    dom::Element* parent = nested.get();
+    for (usize i = 0; i < DEPTH; ++i) {
+        auto child = document->create_element("span"_s);
+        parent->append_child(child);
+        parent = child.get();
+    }
+    ms = best_of([&] { markup = nested->inner_html(); });
+    bench::report_bytes("nested inner_html", markup.size(), ms);
+
+    // Released from the innermost node out, so teardown does not recurse
+    while (parent != nested.get()) {
+        auto* up = parent->parent_node();
+        up->remove_child(RefPtr<dom::Node>(parent));
+        parent = up->as_element();
+    }
+    std::printf("  %zu bytes read\n", bytes);
+    return 0;
+}
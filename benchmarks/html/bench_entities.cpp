@@ -0,0 +1,70 @@
+/**
+ * HTML tokenizer microbenchmark on entity-dense input: an escaped code
+ * listing, prose with typographic entities, and attribute values with
+ * query strings (legacy names without ';')
+ */
+
+#include "bench_util.hpp"
+#include "lithium/html/tokenizer.hpp"
+#include <algorithm>
+#include <string>
+
+using namespace lithium;
+using namespace lithium::html;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+std::string make_code_listing(usize lines) {
+    std::string text = "<pre><code>";
+    for (usize i = 0; i < lines; ++i) {
+        text += "&lt;div class=&quot;row-" + std::to_string(i) +
+                "&quot;&gt;&amp;nbsp;&lt;/div&gt; &#x2192; &lt;span&gt;&apos;x&apos;&lt;/span&gt;\n";
+    }
+    text += "</code></pre>";
+    return text;
+}
+
+std::string make_prose(usize paragraphs) {
+    std::string text;
+    for (usize i = 0; i < paragraphs; ++i) {
+        text += "<p>&ldquo;Caf&eacute;&rdquo; &mdash; na&iuml;ve &hellip; &copy; 2024 &middot; "
+                "&alpha;&beta;&gamma; &le; &infin; &ne; &NotEqualTilde; &CounterClockwiseContourIntegral; "
+                "&nbsp;&nbsp;&times;&divide;&plusmn;&frac12;&rarr;&larr;&harr;</p>\n";
+    }
+    return text;
+}
+
+std::string make_attributes(usize links) {
+    std::string text;
+    for (usize i = 0; i < links; ++i) {
+        text += "<a href=\"/search?q=" + std::to_string(i) +
+                "&amp;lang=en&copy=1&not=2&para;&sect=3\" title=\"A &amp; B &lt; C\">link</a>\n";
+    }
+    return text;
+}
+
+void bench_tokenize(const char* label, const std::string& text) {
+    usize tokens = 0;
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        Tokenizer tokenizer;
+        tokenizer.set_input(std::string_view(text));
+        tokens = 0;
+        tokenizer.set_token_callback([&tokens](Token) { ++tokens; });
+        double ms = bench::time_ms([&] { tokenizer.run(); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = std::string("tokenize ") + label;
+    bench::report_bytes(name.c_str(), text.size(), best);
+}
+
+} // namespace
+
+int main() {
+    bench_tokenize("code listing", make_code_listing(20000));
+    bench_tokenize("prose", make_prose(10000));
+    bench_tokenize("attributes", make_attributes(20000));
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * HTML parser microbenchmark on markup-heavy documents, where the time goes
+ * to tag and attribute names rather than text: the tokenizer alone, and
+ * tokenizer plus tree builder (MB/s) for nested sections with attributes,
+ * inline formatting, forms, and custom elements
+ */
+
+#include "bench_util.hpp"
+#include "lithium/html/parser.hpp"
+#include "lithium/html/tokenizer.hpp"
+#include <algorithm>
+#include <string>
+
+using namespace lithium;
+using namespace lithium::html;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+std::string make_sections(usize sections) {
+    std::string text = "<!DOCTYPE html><html><head><title>Markup</title></head><body>\n";
+    for (usize i = 0; i < sections; ++i) {
+        auto n = std::to_string(i);
+        text += "<section id=\"s" + n + "\" class=\"card\" data-index=\"" + n + "\"><header><h2 class=\"title\">"
+                "T</h2></header><div class=\"body\"><ul><li><a href=\"#" + n + "\" title=\"t\">a</a></li>"
+                "<li><span class=\"tag\">b</span></li></ul><img src=\"i.png\" alt=\"\" width=\"16\" height=\"16\">"
+                "</div><footer><small>c</small></footer></section>\n";
+    }
+    text += "</body></html>";
+    return text;
+}
+
+std::string make_formatting(usize paragraphs) {
+    std::string text;
+    for (usize i = 0; i < paragraphs; ++i) {
+        // Misnested formatting exercises the adoption agency algorithm
+        text += "<p><b>bold <i>both</b> italic</i> <code>x</code> <em><strong>y</strong></em> "
+                "<a href=\"#\"><u>z</u></a></p>\n";
+    }
+    return text;
+}
+
+std::string make_forms(usize forms) {
+    std::string text;
+    for (usize i = 0; i < forms; ++i) {
+        auto n = std::to_string(i);
+        text += "<form action=\"/f" + n + "\" method=\"post\"><fieldset><label for=\"i" + n + "\">L</label>"
+                "<input id=\"i" + n + "\" name=\"q\" type=\"text\" required><select name=\"s\">"
+                "<option value=\"1\" selected>1</option><option value=\"2\">2</option></select>"
+                "<textarea rows=\"2\" cols=\"8\">t</textarea><button type=\"submit\">Go</button></fieldset></form>\n";
+    }
+    return text;
+}
+
+std::string make_custom_elements(usize items) {
+    std::string text;
+    for (usize i = 0; i < items; ++i) {
+        text += "<app-card variant=\"outlined\" aria-label=\"card\"><app-card-header slot=\"header\">h"
+                "</app-card-header><app-icon name=\"star\" size=\"small\"></app-icon></app-card>\n";
+    }
+    return text;
+}
+
+template<typename Fn>
+double best_of(Fn&& fn) {
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        double ms = bench::time_ms(fn);
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+void bench_tokenize(const char* label, const std::string& text) {
+    usize tags = 0;
+    double ms = best_of([&] {
+        Tokenizer tokenizer;
+        tokenizer.set_input(std::string_view(text));
+        tokenizer.set_token_callback([&tags](Token token) { tags += is_start_tag(token) ? 1u : 0u; });
+        tokenizer.run();
+    });
+    std::string name = std::string("tokenize ") + label;
+    bench::report_bytes(name.c_str(), text.size(), ms);
+}
+
+void bench_parse(const char* label, const std::string& text) {
+    double ms = best_of([&] {
+        Parser parser;
+        auto document = parser.parse(std::string_view(text));
+    });
+    std::string name = std::string("parse ") + label;
+    bench::report_bytes(name.c_str(), text.size(), ms);
+}
+
+} // namespace
+
+int main() {
+    auto sections = make_sections(20000);
+    auto formatting = make_formatting(20000);
+    auto forms = make_forms(10000);
+    auto custom = make_custom_elements(20000);
+
+    bench_tokenize("sections", sections);
+    bench_tokenize("custom elements", custom);
+    bench_parse("sections", sections);
+    bench_parse("formatting", formatting);
+    bench_parse("forms", forms);
+    bench_parse("custom elements", custom);
+    return 0;
+}
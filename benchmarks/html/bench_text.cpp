@@ -0,0 +1,80 @@
+/**
+ * HTML parser microbenchmark on text-heavy documents: tokenizer plus tree
+ * builder throughput (MB/s) for prose paragraphs, one large preformatted
+ * block, inline scripts and table cells
+ */
+
+#include "bench_util.hpp"
+#include "lithium/html/parser.hpp"
+#include <algorithm>
+#include <string>
+
+using namespace lithium;
+using namespace lithium::html;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+std::string make_prose(usize paragraphs) {
+    std::string text = "<!DOCTYPE html><html><head><title>Prose</title></head><body>\n";
+    for (usize i = 0; i < paragraphs; ++i) {
+        text += "<p>Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+                "incididunt ut labore et dolore magna aliqua. Ut enim ad <em>minim</em> veniam, quis "
+                "nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. "
+                "Caf\xC3\xA9 na\xC3\xAFve r\xC3\xA9sum\xC3\xA9 " + std::to_string(i) + ".</p>\n";
+    }
+    text += "</body></html>";
+    return text;
+}
+
+std::string make_preformatted(usize lines) {
+    std::string text = "<pre>";
+    for (usize i = 0; i < lines; ++i) {
+        text += "    for (int i = 0; i != count; ++i) { total += values[i] * " + std::to_string(i) + "; }\n";
+    }
+    text += "</pre>";
+    return text;
+}
+
+std::string make_scripts(usize scripts) {
+    std::string text;
+    for (usize i = 0; i < scripts; ++i) {
+        text += "<script>function handler" + std::to_string(i) +
+                "(event) { if (event.detail > 1) { console.log('clicked', event.target); } "
+                "return document.querySelectorAll('.item').length; }</script>\n";
+    }
+    return text;
+}
+
+std::string make_table(usize rows) {
+    std::string text = "<table>\n";
+    for (usize i = 0; i < rows; ++i) {
+        text += "  <tr>\n    <td>Row " + std::to_string(i) + " name</td>\n    <td>Some longer description text</td>\n"
+                "    <td>12,345.67</td>\n  </tr>\n";
+    }
+    text += "</table>";
+    return text;
+}
+
+void bench_parse(const char* label, const std::string& text) {
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        Parser parser;
+        RefPtr<dom::Document> document;
+        double ms = bench::time_ms([&] { document = parser.parse(std::string_view(text)); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = std::string("parse ") + label;
+    bench::report_bytes(name.c_str(), text.size(), best);
+}
+
+} // namespace
+
+int main() {
+    bench_parse("prose", make_prose(20000));
+    bench_parse("pre block", make_preformatted(50000));
+    bench_parse("scripts", make_scripts(20000));
+    bench_parse("table", make_table(20000));
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * Map / Set microbenchmarks: set, get, has, delete and ordered iteration
+ * for 1e3 to 1e6 keys (numbers and strings)
+ */
+
+#include "bench_util.hpp"
+#include "lithium/js/vm.hpp"
+#include "lithium/js/object.hpp"
+#include <string>
+#include <vector>
+
+using namespace lithium;
+using namespace lithium::js;
+
+namespace {
+
+volatile double g_sink = 0.0;
+
+void bench_map(VM& vm, const char* label, const std::vector<Value>& keys) {
+    auto& gc = vm.gc();
+    Value holder(gc.allocate<MapObject>());
+    GC_ROOT(gc, holder);
+    auto* map = static_cast<MapObject*>(holder.as_object());
+    usize n = keys.size();
+
+    std::string name = std::string("Map.set ") + label;
+    double ms = bench::time_ms([&] {
+        for (usize i = 0; i < n; ++i) {
+            map->set(keys[i], Value(static_cast<f64>(i)));
+        }
+    });
+    bench::report(name.c_str(), n, ms, n);
+
+    name = std::string("Map.get ") + label;
+    ms = bench::time_ms([&] {
+        double sum = 0.0;
+        for (usize i = 0; i < n; ++i) {
+            sum += map->get(keys[i]).to_number();
+        }
+        g_sink = sum;
+    });
+    bench::report(name.c_str(), n, ms, n);
+
+    name = std::string("Map.has(miss) ") + label;
+    ms = bench::time_ms([&] {
+        usize hits = 0;
+        for (usize i = 0; i < n; ++i) {
+            if (map->has(Value(-static_cast<f64>(i) - 1.0))) {
+                ++hits;
+            }
+        }
+        g_sink = static_cast<double>(hits);
+    });
+    bench::report(name.c_str(), n, ms, n);
+
+    name = std::string("Map.delete(half) ") + label;
+    ms = bench::time_ms([&] {
+        for (usize i = 0; i < n; i += 2) {
+            map->remove(keys[i]);
+        }
+    });
+    bench::report(name.c_str(), n, ms, n / 2);
+
+    name = std::string("Map iterate ") + label;
+    ms = bench::time_ms([&] {
+        double sum = 0.0;
+        for (const auto& entry : map->internal_entries()) {
+            sum += entry.value.to_number();
+        }
+        g_sink = sum;
+    });
+    bench::report(name.c_str(), n, ms, map->size());
+}
+
+void bench_set(VM& vm, const std::vector<Value>& keys) {
+    auto& gc = vm.gc();
+    Value holder(gc.allocate<SetObject>());
+    GC_ROOT(gc, holder);
+    auto* set = static_cast<SetObject*>(holder.as_object());
+    usize n = keys.size();
+
+    double ms = bench::time_ms([&] {
+        // Every key twice: half the adds are duplicates
+        for (usize i = 0; i < n; ++i) {
+            set->add(keys[i]);
+            set->add(keys[i / 2]);
+        }
+    });
+    bench::report("Set.add (dedup) number", n, ms, 2 * n);
+
+    ms = bench::time_ms([&] {
+        usize hits = 0;
+        for (usize i = 0; i < n; ++i) {
+            if (set->has(keys[i])) {
+                ++hits;
+            }
+        }
+        g_sink = static_cast<double>(hits);
+    });
+    bench::report("Set.has number", n, ms, n);
+}
+
+} // namespace
+
+int main() {
+    VM vm;
+    for (usize n : {usize{1000}, usize{10000}, usize{100000}, usize{1000000}}) {
+        std::vector<Value> numbers;
+        std::vector<Value> strings;
+        numbers.reserve(n);
+        strings.reserve(n);
+        for (usize i = 0; i < n; ++i) {
+            numbers.emplace_back(static_cast<f64>(i));
+            strings.emplace_back(String("key-" + std::to_string(i)));
+        }
+        bench_map(vm, "number", numbers);
+        bench_map(vm, "string", strings);
+        bench_set(vm, numbers);
+        std::printf("\n");
+    }
+    return 0;
+}
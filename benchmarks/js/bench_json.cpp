@@ -0,0 +1,98 @@
+/**
+ * JSON microbenchmarks: parse and stringify throughput in MB/s for
+ * repeated-record arrays, deeply nested documents and string-heavy payloads
+ */
+
+#include "bench_util.hpp"
+#include "lithium/js/json.hpp"
+#include "lithium/js/vm.hpp"
+#include <algorithm>
+#include <string>
+
+using namespace lithium;
+using namespace lithium::js;
+
+namespace {
+
+constexpr int ROUNDS = 5;
+
+// [{"id":0,"name":"user-0","score":0.5,"active":true,"tags":["a","b"]}, ...]
+std::string make_records(usize count) {
+    std::string text = "[";
+    for (usize i = 0; i < count; ++i) {
+        if (i > 0) {
+            text += ',';
+        }
+        text += R"({"id":)" + std::to_string(i) + R"(,"name":"user-)" + std::to_string(i) +
+                R"(","score":)" + std::to_string(static_cast<double>(i) * 0.25) +
+                R"(,"active":)" + (i % 2 == 0 ? "true" : "false") + R"(,"tags":["a","b"]})";
+    }
+    text += ']';
+    return text;
+}
+
+// {"child":{"child":...{"leaf":[1,2,3]}...}}
+std::string make_nested(usize depth) {
+    std::string text;
+    for (usize i = 0; i < depth; ++i) {
+        text += R"({"level":)" + std::to_string(i) + R"(,"child":)";
+    }
+    text += R"({"leaf":[1,2,3]})";
+    text.append(depth, '}');
+    return text;
+}
+
+// Long strings with escapes and non-ASCII text
+std::string make_strings(usize count) {
+    std::string text = "[";
+    for (usize i = 0; i < count; ++i) {
+        if (i > 0) {
+            text += ',';
+        }
+        text += R"("Lorem ipsum dolor sit amet, consectetur adipiscing elit \"quoted\"\n\tcafé )" +
+                std::to_string(i) + "\"";
+    }
+    text += ']';
+    return text;
+}
+
+void bench_document(VM& vm, const char* label, const std::string& text) {
+    auto& gc = vm.gc();
+    auto no_callbacks = [](const Value&, const Value&, const std::vector<Value>&) { return Value::undefined(); };
+
+    Value parsed;
+    GC_ROOT(gc, parsed);
+    double best = 0.0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        JsonParser parser(gc, nullptr, nullptr);
+        double ms = bench::time_ms([&] { parsed = parser.parse(text).value; });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    std::string name = std::string("parse ") + label;
+    bench::report_bytes(name.c_str(), text.size(), best);
+
+    usize out_size = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        JsonStringifier stringifier(gc, nullptr, no_callbacks);
+        double ms = bench::time_ms([&] { out_size = stringifier.stringify(parsed).value.as_string().size(); });
+        best = round == 0 ? ms : std::min(best, ms);
+    }
+    name = std::string("stringify ") + label;
+    bench::report_bytes(name.c_str(), out_size, best);
+
+    JsonStringifier pretty(gc, nullptr, no_callbacks);
+    pretty.set_space(Value(2));
+    double ms = bench::time_ms([&] { out_size = pretty.stringify(parsed).value.as_string().size(); });
+    name = std::string("stringify(indent) ") + label;
+    bench::report_bytes(name.c_str(), out_size, ms);
+}
+
+} // namespace
+
+int main() {
+    VM vm;
+    bench_document(vm, "records", make_records(100000));
+    bench_document(vm, "nested", make_nested(4000));
+    bench_document(vm, "strings", make_strings(50000));
+    return 0;
+}
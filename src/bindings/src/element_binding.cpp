@@ -16,7 +16,7 @@ js::Value create_element_wrapper(dom::Element* element, js::VM& vm) {
         return js::Value::null();
     }
 
-    auto wrapper = std::make_shared<js::Object>();
+    auto* wrapper = vm.gc().allocate<js::Object>();
 
     // Element properties
     wrapper->set_property("tagName"_s, js::Value(element->tag_name()));
@@ -21,10 +21,10 @@ namespace lithium::browser {
 // Browser Engine - Coordinates all components
 // ============================================================================
 
-class Engine {
+class Engine : private dom::DocumentObserver {
 public:
     Engine();
-    ~Engine();
+    ~Engine() override;
 
     // Initialize the engine
     bool init();
@@ -86,6 +86,12 @@ private:
     void apply_stylesheets();
     void execute_scripts();
 
+    // DOM mutations (from scripts): restyle what they can affect
+    void attribute_changed(dom::Element& element, const String& name,
+                           const std::optional<String>& old_value) override;
+    void child_inserted(dom::Node& parent, dom::Node& child) override;
+    void child_removed(dom::Node& parent, dom::Node& child) override;
+
     // Layout and rendering
     void update_layout();
     void invalidate_layout();
@@ -99,9 +105,9 @@ private:
 
     // Parsers
     html::Parser m_html_parser;
-    css::Parser m_css_parser;
 
-    // Styling
+    // Styling; stylesheets seen on earlier page loads come from the cache
+    css::StylesheetCache m_stylesheet_cache;
     css::StyleResolver m_style_resolver;
 
     // JavaScript
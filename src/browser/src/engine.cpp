@@ -15,7 +15,11 @@ namespace lithium::browser {
 
 Engine::Engine() = default;
 
-Engine::~Engine() = default;
+Engine::~Engine() {
+    if (m_document) {
+        m_document->set_observer(nullptr);
+    }
+}
 
 bool Engine::init() {
     // Note: Graphics engine (mica) is created and owned by main.cpp
@@ -224,6 +228,9 @@ void Engine::parse_html_response(const String& html) {
     LITHIUM_LOG_INFO("Engine::parse_html_response: parsing {} bytes of HTML", html.length());
 
     // Parse HTML
+    if (m_document) {
+        m_document->set_observer(nullptr);
+    }
     m_document = m_html_parser.parse(html);
 
     if (!m_document) {
@@ -236,8 +243,11 @@ void Engine::parse_html_response(const String& html) {
     // Set up DOM bindings
     m_dom_bindings->set_document(m_document);
 
-    // Extract and apply stylesheets
+    // Extract and apply stylesheets; the previous document's stylesheets and
+    // styles are dropped, later mutations invalidate only what they affect
+    m_style_resolver.clear_stylesheets();
     apply_stylesheets();
+    m_document->set_observer(this);
 
     // Execute scripts
     execute_scripts();
@@ -257,9 +267,7 @@ void Engine::apply_stylesheets() {
     // Find all <style> elements
     auto style_elements = m_document->get_elements_by_tag_name("style"_s);
     for (auto* style : style_elements) {
-        String css = style->text_content();
-        auto stylesheet = m_css_parser.parse_stylesheet(css);
-        m_style_resolver.add_stylesheet(stylesheet);
+        m_style_resolver.add_stylesheet(m_stylesheet_cache.get(style->text_content()));
     }
 
     // Find all <link rel="stylesheet"> elements
@@ -277,8 +285,7 @@ void Engine::apply_stylesheets() {
 
         auto result = m_resource_loader.load(*href, network::ResourceType::Stylesheet);
         if (result.is_ok()) {
-            auto stylesheet = m_css_parser.parse_stylesheet(result.value().data_as_string());
-            m_style_resolver.add_stylesheet(stylesheet);
+            m_style_resolver.add_stylesheet(m_stylesheet_cache.get(result.value().data_as_string()));
         }
     }
 
@@ -316,8 +323,9 @@ void Engine::update_layout() {
     LITHIUM_LOG_INFO("Engine::update_layout: building layout tree (viewport: {}x{})",
         m_viewport_width, m_viewport_height);
 
-    // IMPORTANT: Invalidate all cached styles to ensure UA stylesheet is applied
-    m_style_resolver.invalidate_all();
+    // Restyle only the subtrees invalidated by DOM mutations since the last
+    // layout (the whole document after a load)
+    m_style_resolver.resolve_document(*m_document);
 
     // Build layout tree
     layout::LayoutTreeBuilder builder;
@@ -347,6 +355,22 @@ void Engine::update_layout() {
     m_render_dirty = true;
 }
 
+void Engine::attribute_changed(dom::Element& element, const String& name,
+                               const std::optional<String>& old_value) {
+    m_style_resolver.invalidate_attribute_change(element, name, old_value);
+    invalidate_layout();
+}
+
+void Engine::child_inserted(dom::Node& parent, dom::Node& child) {
+    m_style_resolver.invalidate_child_inserted(parent, child);
+    invalidate_layout();
+}
+
+void Engine::child_removed(dom::Node& parent, dom::Node& child) {
+    m_style_resolver.invalidate_child_removed(parent, child);
+    invalidate_layout();
+}
+
 void Engine::invalidate_layout() {
     m_layout_dirty = true;
     m_render_dirty = true;
@@ -381,11 +405,11 @@ void Engine::render_layout_box(mica::Painter& painter, const layout::LayoutBox&
 
     // Get background color
     lithium::mica::Color bg_color;
-    if (style.background_color.a == 0) {
+    if (style.background().background_color.a == 0) {
         // Transparent - use light gray
         bg_color = {0.95f, 0.95f, 0.95f, 1.0f};
     } else {
-        bg_color = css_to_mica_color(style.background_color);
+        bg_color = css_to_mica_color(style.background().background_color);
     }
 
     // Create paint for background
@@ -402,7 +426,7 @@ void Engine::render_layout_box(mica::Painter& painter, const layout::LayoutBox&
 
     // Draw border if any
     if (d.border.left > 0 || d.border.top > 0 || d.border.right > 0 || d.border.bottom > 0) {
-        auto border_color = css_to_mica_color(style.border_top_color);
+        auto border_color = css_to_mica_color(style.border().border_top_color);
         auto border_paint = mica::Paint::solid(border_color);
         f32 border_width = d.border.left;
         painter.draw_rect(bg_rect, border_paint);
@@ -412,26 +436,26 @@ void Engine::render_layout_box(mica::Painter& painter, const layout::LayoutBox&
     if (box.is_text() && !box.text().empty()) {
         // Get font size
         f32 font_size = 16.0f;  // Default
-        if (style.font_size.unit == lithium::css::LengthUnit::Px) {
-            font_size = static_cast<f32>(style.font_size.value);
+        if (style.font().font_size.unit == lithium::css::LengthUnit::Px) {
+            font_size = static_cast<f32>(style.font().font_size.value);
         }
 
         // Get text color
         lithium::mica::Color text_color;
-        if (style.color.a == 0) {
+        if (style.inherited_text().color.a == 0) {
             text_color = {0.0f, 0.0f, 0.0f, 1.0f};  // Default black
         } else {
-            text_color = css_to_mica_color(style.color);
+            text_color = css_to_mica_color(style.inherited_text().color);
         }
 
         // Create font description
         beryl::FontDescription font_desc;
         font_desc.size = font_size;
-        font_desc.family = style.font_family.empty() ? String("Arial") : style.font_family[0];
-        font_desc.weight = (style.font_weight == css::FontWeight::Bold ||
-                           style.font_weight == css::FontWeight::W700)
+        font_desc.family = style.font().font_family.empty() ? String("Arial") : style.font().font_family[0];
+        font_desc.weight = (style.font().font_weight == css::FontWeight::Bold ||
+                           style.font().font_weight == css::FontWeight::W700)
             ? beryl::FontWeight::Bold : beryl::FontWeight::Normal;
-        font_desc.style = (style.font_style == css::FontStyle::Italic)
+        font_desc.style = (style.font().font_style == css::FontStyle::Italic)
             ? beryl::FontStyle::Italic : beryl::FontStyle::Normal;
 
         // Draw text at position
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "types.hpp"
+#include "string.hpp"
+#include "atom_names.hpp"
+#include <functional>
+#include <optional>
+#include <string_view>
+
+namespace lithium {
+
+// ============================================================================
+// Atom - Interned name
+// ============================================================================
+//
+// A name (tag, attribute, namespace) interned in a process-wide table, so
+// that comparing two atoms is comparing two pointers. The names listed in
+// atom_names.hpp are built in: each has a fixed AtomId and a constant in
+// lithium::atoms (atoms::div, atoms::class_), and interning them takes no
+// lock. Other names get the next free id on first use and live until the
+// process exits. Reading an atom's name never locks.
+
+enum class AtomId : u32 {
+    Empty,
+#define LITHIUM_ATOM_ID(identifier, name) identifier,
+    LITHIUM_ENUMERATE_ATOMS(LITHIUM_ATOM_ID)
+#undef LITHIUM_ATOM_ID
+    StaticCount
+};
+
+struct AtomEntry {
+    std::string_view name;
+    u32 id;
+};
+
+namespace detail {
+
+inline constexpr AtomEntry STATIC_ATOMS[] = {
+    {"", 0},
+#define LITHIUM_ATOM_ENTRY(identifier, name) {name, static_cast<u32>(AtomId::identifier)},
+    LITHIUM_ENUMERATE_ATOMS(LITHIUM_ATOM_ENTRY)
+#undef LITHIUM_ATOM_ENTRY
+};
+
+} // namespace detail
+
+class Atom {
+public:
+    // The empty name
+    constexpr Atom() = default;
+
+    // Interns `name` (case-sensitive)
+    explicit Atom(std::string_view name);
+    explicit Atom(const String& name) : Atom(name.view()) {}
+    explicit Atom(const char* name) : Atom(std::string_view(name)) {}
+
+    // A built-in atom, usable in constant expressions
+    [[nodiscard]] static constexpr Atom from_id(AtomId id) {
+        return Atom(&detail::STATIC_ATOMS[static_cast<u32>(id)]);
+    }
+
+    // The atom for `name` if it has been interned, without interning it
+    [[nodiscard]] static std::optional<Atom> find(std::string_view name);
+
+    [[nodiscard]] u32 id() const { return m_entry->id; }
+    [[nodiscard]] bool is_static() const { return m_entry->id < static_cast<u32>(AtomId::StaticCount); }
+    [[nodiscard]] bool empty() const { return m_entry->name.empty(); }
+
+    [[nodiscard]] std::string_view view() const { return m_entry->name; }
+    [[nodiscard]] String string() const { return String(m_entry->name); }
+
+    [[nodiscard]] constexpr bool operator==(const Atom& other) const { return m_entry == other.m_entry; }
+    [[nodiscard]] constexpr bool operator!=(const Atom& other) const { return m_entry != other.m_entry; }
+
+private:
+    constexpr explicit Atom(const AtomEntry* entry) : m_entry(entry) {}
+
+    const AtomEntry* m_entry{&detail::STATIC_ATOMS[0]};
+};
+
+namespace atoms {
+
+#define LITHIUM_ATOM_CONSTANT(identifier, name) inline constexpr Atom identifier = Atom::from_id(AtomId::identifier);
+LITHIUM_ENUMERATE_ATOMS(LITHIUM_ATOM_CONSTANT)
+#undef LITHIUM_ATOM_CONSTANT
+
+} // namespace atoms
+
+} // namespace lithium
+
+template<>
+struct std::hash<lithium::Atom> {
+    std::size_t operator()(const lithium::Atom& atom) const noexcept { return atom.id(); }
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+// ============================================================================
+// Static atoms
+// ============================================================================
+//
+// Every HTML, SVG and MathML element name and the common attribute names,
+// as X(identifier, "name"). Identifiers replace '-' and ':' with '_' and
+// append '_' to C++ keywords (class_, for_, template_). Names the tree
+// builder adjusts (foreignObject, viewBox) appear in both spellings, since
+// the tokenizer lowercases what it reads.
+
+#define LITHIUM_ENUMERATE_ATOMS(X) \
+    X(a, "a") X(abbr, "abbr") X(acronym, "acronym") X(address, "address") X(applet, "applet") \
+    X(area, "area") X(article, "article") X(aside, "aside") X(audio, "audio") X(b, "b") X(base, "base") \
+    X(basefont, "basefont") X(bdi, "bdi") X(bdo, "bdo") X(bgsound, "bgsound") X(big, "big") \
+    X(blink, "blink") X(blockquote, "blockquote") X(body, "body") X(br, "br") X(button, "button") \
+    X(canvas, "canvas") X(caption, "caption") X(center, "center") X(cite, "cite") X(code, "code") \
+    X(col, "col") X(colgroup, "colgroup") X(data, "data") X(datalist, "datalist") X(dd, "dd") X(del, "del") \
+    X(details, "details") X(dfn, "dfn") X(dialog, "dialog") X(dir, "dir") X(div, "div") X(dl, "dl") \
+    X(dt, "dt") X(em, "em") X(embed, "embed") X(fieldset, "fieldset") X(figcaption, "figcaption") \
+    X(figure, "figure") X(font, "font") X(footer, "footer") X(form, "form") X(frame, "frame") \
+    X(frameset, "frameset") X(h1, "h1") X(h2, "h2") X(h3, "h3") X(h4, "h4") X(h5, "h5") X(h6, "h6") \
+    X(head, "head") X(header, "header") X(hgroup, "hgroup") X(hr, "hr") X(html, "html") X(i, "i") \
+    X(iframe, "iframe") X(image, "image") X(img, "img") X(input, "input") X(ins, "ins") \
+    X(isindex, "isindex") X(kbd, "kbd") X(keygen, "keygen") X(label, "label") X(legend, "legend") \
+    X(li, "li") X(link, "link") X(listing, "listing") X(main, "main") X(map, "map") X(mark, "mark") \
+    X(marquee, "marquee") X(menu, "menu") X(menuitem, "menuitem") X(meta, "meta") X(meter, "meter") \
+    X(nav, "nav") X(nobr, "nobr") X(noembed, "noembed") X(noframes, "noframes") X(noscript, "noscript") \
+    X(object, "object") X(ol, "ol") X(optgroup, "optgroup") X(option, "option") X(output, "output") \
+    X(p, "p") X(param, "param") X(picture, "picture") X(plaintext, "plaintext") X(pre, "pre") \
+    X(progress, "progress") X(q, "q") X(rb, "rb") X(rp, "rp") X(rt, "rt") X(rtc, "rtc") X(ruby, "ruby") \
+    X(s, "s") X(samp, "samp") X(script, "script") X(search, "search") X(section, "section") \
+    X(select, "select") X(slot, "slot") X(small, "small") X(source, "source") X(span, "span") \
+    X(strike, "strike") X(strong, "strong") X(style, "style") X(sub, "sub") X(summary, "summary") \
+    X(sup, "sup") X(table, "table") X(tbody, "tbody") X(td, "td") X(template_, "template") \
+    X(textarea, "textarea") X(tfoot, "tfoot") X(th, "th") X(thead, "thead") X(time, "time") \
+    X(title, "title") X(tr, "tr") X(track, "track") X(tt, "tt") X(u, "u") X(ul, "ul") X(var, "var") \
+    X(video, "video") X(wbr, "wbr") X(xmp, "xmp") X(svg, "svg") X(altGlyph, "altGlyph") \
+    X(altglyph, "altglyph") X(altGlyphDef, "altGlyphDef") X(altglyphdef, "altglyphdef") \
+    X(altGlyphItem, "altGlyphItem") X(altglyphitem, "altglyphitem") X(animate, "animate") \
+    X(animateColor, "animateColor") X(animatecolor, "animatecolor") X(animateMotion, "animateMotion") \
+    X(animatemotion, "animatemotion") X(animateTransform, "animateTransform") \
+    X(animatetransform, "animatetransform") X(circle, "circle") X(clipPath, "clipPath") \
+    X(clippath, "clippath") X(defs, "defs") X(desc, "desc") X(ellipse, "ellipse") X(feBlend, "feBlend") \
+    X(feblend, "feblend") X(feColorMatrix, "feColorMatrix") X(fecolormatrix, "fecolormatrix") \
+    X(feComponentTransfer, "feComponentTransfer") X(fecomponenttransfer, "fecomponenttransfer") \
+    X(feComposite, "feComposite") X(fecomposite, "fecomposite") X(feConvolveMatrix, "feConvolveMatrix") \
+    X(feconvolvematrix, "feconvolvematrix") X(feDiffuseLighting, "feDiffuseLighting") \
+    X(fediffuselighting, "fediffuselighting") X(feDisplacementMap, "feDisplacementMap") \
+    X(fedisplacementmap, "fedisplacementmap") X(feDistantLight, "feDistantLight") \
+    X(fedistantlight, "fedistantlight") X(feDropShadow, "feDropShadow") X(fedropshadow, "fedropshadow") \
+    X(feFlood, "feFlood") X(feflood, "feflood") X(feFuncA, "feFuncA") X(fefunca, "fefunca") \
+    X(feFuncB, "feFuncB") X(fefuncb, "fefuncb") X(feFuncG, "feFuncG") X(fefuncg, "fefuncg") \
+    X(feFuncR, "feFuncR") X(fefuncr, "fefuncr") X(feGaussianBlur, "feGaussianBlur") \
+    X(fegaussianblur, "fegaussianblur") X(feImage, "feImage") X(feimage, "feimage") X(feMerge, "feMerge") \
+    X(femerge, "femerge") X(feMergeNode, "feMergeNode") X(femergenode, "femergenode") \
+    X(feMorphology, "feMorphology") X(femorphology, "femorphology") X(feOffset, "feOffset") \
+    X(feoffset, "feoffset") X(fePointLight, "fePointLight") X(fepointlight, "fepointlight") \
+    X(feSpecularLighting, "feSpecularLighting") X(fespecularlighting, "fespecularlighting") \
+    X(feSpotLight, "feSpotLight") X(fespotlight, "fespotlight") X(feTile, "feTile") X(fetile, "fetile") \
+    X(feTurbulence, "feTurbulence") X(feturbulence, "feturbulence") X(filter, "filter") \
+    X(foreignObject, "foreignObject") X(foreignobject, "foreignobject") X(g, "g") X(glyphRef, "glyphRef") \
+    X(glyphref, "glyphref") X(line, "line") X(linearGradient, "linearGradient") \
+    X(lineargradient, "lineargradient") X(marker, "marker") X(mask, "mask") X(metadata, "metadata") \
+    X(mpath, "mpath") X(path, "path") X(pattern, "pattern") X(polygon, "polygon") X(polyline, "polyline") \
+    X(radialGradient, "radialGradient") X(radialgradient, "radialgradient") X(rect, "rect") X(set, "set") \
+    X(stop, "stop") X(switch_, "switch") X(symbol, "symbol") X(text, "text") X(textPath, "textPath") \
+    X(textpath, "textpath") X(tspan, "tspan") X(use, "use") X(view, "view") X(math, "math") \
+    X(maction, "maction") X(annotation, "annotation") X(annotation_xml, "annotation-xml") \
+    X(menclose, "menclose") X(merror, "merror") X(mfenced, "mfenced") X(mfrac, "mfrac") X(mglyph, "mglyph") \
+    X(mi, "mi") X(malignmark, "malignmark") X(mmultiscripts, "mmultiscripts") X(mn, "mn") X(mo, "mo") \
+    X(mover, "mover") X(mpadded, "mpadded") X(mphantom, "mphantom") X(mprescripts, "mprescripts") \
+    X(mroot, "mroot") X(mrow, "mrow") X(ms, "ms") X(mspace, "mspace") X(msqrt, "msqrt") X(mstyle, "mstyle") \
+    X(msub, "msub") X(msubsup, "msubsup") X(msup, "msup") X(mtable, "mtable") X(mtd, "mtd") \
+    X(mtext, "mtext") X(mtr, "mtr") X(munder, "munder") X(munderover, "munderover") X(none, "none") \
+    X(semantics, "semantics") X(accept, "accept") X(accept_charset, "accept-charset") \
+    X(accesskey, "accesskey") X(action, "action") X(align, "align") X(alink, "alink") X(allow, "allow") \
+    X(allowfullscreen, "allowfullscreen") X(alt, "alt") X(archive, "archive") X(async, "async") \
+    X(autocapitalize, "autocapitalize") X(autocomplete, "autocomplete") X(autofocus, "autofocus") \
+    X(autoplay, "autoplay") X(axis, "axis") X(background, "background") X(bgcolor, "bgcolor") \
+    X(border, "border") X(cellpadding, "cellpadding") X(cellspacing, "cellspacing") X(char_, "char") \
+    X(charoff, "charoff") X(charset, "charset") X(checked, "checked") X(class_, "class") \
+    X(classid, "classid") X(clear, "clear") X(codebase, "codebase") X(codetype, "codetype") \
+    X(color, "color") X(cols, "cols") X(colspan, "colspan") X(compact, "compact") X(content, "content") \
+    X(contenteditable, "contenteditable") X(controls, "controls") X(coords, "coords") \
+    X(crossorigin, "crossorigin") X(datetime, "datetime") X(declare, "declare") X(decoding, "decoding") \
+    X(default_, "default") X(defer, "defer") X(dirname, "dirname") X(disabled, "disabled") \
+    X(download, "download") X(draggable, "draggable") X(enctype, "enctype") X(encoding, "encoding") \
+    X(enterkeyhint, "enterkeyhint") X(face, "face") X(for_, "for") X(formaction, "formaction") \
+    X(formenctype, "formenctype") X(formmethod, "formmethod") X(formnovalidate, "formnovalidate") \
+    X(formtarget, "formtarget") X(frameborder, "frameborder") X(headers, "headers") X(height, "height") \
+    X(hidden, "hidden") X(high, "high") X(href, "href") X(hreflang, "hreflang") X(hspace, "hspace") \
+    X(http_equiv, "http-equiv") X(id, "id") X(inert, "inert") X(inputmode, "inputmode") \
+    X(integrity, "integrity") X(is, "is") X(ismap, "ismap") X(itemid, "itemid") X(itemprop, "itemprop") \
+    X(itemref, "itemref") X(itemscope, "itemscope") X(itemtype, "itemtype") X(kind, "kind") X(lang, "lang") \
+    X(language, "language") X(loading, "loading") X(list, "list") X(loop, "loop") X(low, "low") \
+    X(manifest, "manifest") X(marginheight, "marginheight") X(marginwidth, "marginwidth") X(max, "max") \
+    X(maxlength, "maxlength") X(media, "media") X(method, "method") X(min, "min") X(minlength, "minlength") \
+    X(multiple, "multiple") X(muted, "muted") X(name, "name") X(nohref, "nohref") X(nonce, "nonce") \
+    X(noresize, "noresize") X(noshade, "noshade") X(novalidate, "novalidate") X(nowrap, "nowrap") \
+    X(onblur, "onblur") X(onchange, "onchange") X(onclick, "onclick") X(onerror, "onerror") \
+    X(onfocus, "onfocus") X(oninput, "oninput") X(onkeydown, "onkeydown") X(onkeyup, "onkeyup") \
+    X(onload, "onload") X(onmouseout, "onmouseout") X(onmouseover, "onmouseover") X(onsubmit, "onsubmit") \
+    X(open, "open") X(optimum, "optimum") X(ping, "ping") X(placeholder, "placeholder") \
+    X(playsinline, "playsinline") X(popover, "popover") X(poster, "poster") X(preload, "preload") \
+    X(profile, "profile") X(prompt, "prompt") X(readonly, "readonly") X(referrerpolicy, "referrerpolicy") \
+    X(rel, "rel") X(required, "required") X(rev, "rev") X(reversed, "reversed") X(role, "role") \
+    X(rows, "rows") X(rowspan, "rowspan") X(rules, "rules") X(sandbox, "sandbox") X(scope, "scope") \
+    X(scrolling, "scrolling") X(selected, "selected") X(shape, "shape") X(size, "size") X(sizes, "sizes") \
+    X(spellcheck, "spellcheck") X(src, "src") X(srcdoc, "srcdoc") X(srclang, "srclang") X(srcset, "srcset") \
+    X(start, "start") X(step, "step") X(tabindex, "tabindex") X(target, "target") X(translate, "translate") \
+    X(type, "type") X(usemap, "usemap") X(valign, "valign") X(value, "value") X(valuetype, "valuetype") \
+    X(version, "version") X(vlink, "vlink") X(vspace, "vspace") X(width, "width") X(wrap, "wrap") \
+    X(viewBox, "viewBox") X(viewbox, "viewbox") X(preserveAspectRatio, "preserveAspectRatio") \
+    X(preserveaspectratio, "preserveaspectratio") X(d, "d") X(fill, "fill") X(stroke, "stroke") \
+    X(stroke_width, "stroke-width") X(stroke_opacity, "stroke-opacity") X(stroke_linecap, "stroke-linecap") \
+    X(stroke_linejoin, "stroke-linejoin") X(stroke_dasharray, "stroke-dasharray") X(transform, "transform") \
+    X(x, "x") X(y, "y") X(x1, "x1") X(x2, "x2") X(y1, "y1") X(y2, "y2") X(cx, "cx") X(cy, "cy") X(r, "r") \
+    X(rx, "rx") X(ry, "ry") X(points, "points") X(xmlns, "xmlns") X(xlink_href, "xlink:href") \
+    X(xml_lang, "xml:lang") X(xml_space, "xml:space") X(xmlns_xlink, "xmlns:xlink") \
+    X(gradientUnits, "gradientUnits") X(gradientunits, "gradientunits") \
+    X(gradientTransform, "gradientTransform") X(gradienttransform, "gradienttransform") \
+    X(patternUnits, "patternUnits") X(patternunits, "patternunits") X(patternTransform, "patternTransform") \
+    X(patterntransform, "patterntransform") X(clipPathUnits, "clipPathUnits") \
+    X(clippathunits, "clippathunits") X(markerWidth, "markerWidth") X(markerwidth, "markerwidth") \
+    X(markerHeight, "markerHeight") X(markerheight, "markerheight") X(refX, "refX") X(refx, "refx") \
+    X(refY, "refY") X(refy, "refy") X(textLength, "textLength") X(textlength, "textlength") \
+    X(lengthAdjust, "lengthAdjust") X(lengthadjust, "lengthadjust") X(stdDeviation, "stdDeviation") \
+    X(stddeviation, "stddeviation") X(opacity, "opacity") X(fill_opacity, "fill-opacity") \
+    X(fill_rule, "fill-rule") X(clip_rule, "clip-rule") X(clip_path, "clip-path") \
+    X(font_family, "font-family") X(font_size, "font-size") X(offset, "offset") X(stop_color, "stop-color") \
+    X(stop_opacity, "stop-opacity") X(definitionURL, "definitionURL") X(definitionurl, "definitionurl") \
+    X(mathvariant, "mathvariant") X(display, "display")
@@ -0,0 +1,80 @@
+#include "lithium/core/atom.hpp"
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace lithium {
+
+namespace {
+
+using AtomIndex = std::unordered_map<std::string_view, const AtomEntry*>;
+
+// Built once, then only read: no lock
+const AtomIndex& static_index() {
+    static const AtomIndex index = [] {
+        AtomIndex built;
+        built.reserve(std::size(detail::STATIC_ATOMS));
+        for (const auto& entry : detail::STATIC_ATOMS) {
+            built.emplace(entry.name, &entry);
+        }
+        return built;
+    }();
+    return index;
+}
+
+// Names outside the static list. Entries and their characters are never
+// freed or moved, so atoms can read them without the lock.
+struct DynamicTable {
+    std::mutex mutex;
+    AtomIndex index;
+    std::deque<AtomEntry> entries;
+    std::deque<std::unique_ptr<char[]>> names;
+};
+
+DynamicTable& dynamic_table() {
+    static DynamicTable table;
+    return table;
+}
+
+const AtomEntry* find_entry(std::string_view name) {
+    const auto& statics = static_index();
+    if (auto it = statics.find(name); it != statics.end()) {
+        return it->second;
+    }
+    auto& table = dynamic_table();
+    std::lock_guard lock(table.mutex);
+    auto it = table.index.find(name);
+    return it != table.index.end() ? it->second : nullptr;
+}
+
+} // namespace
+
+Atom::Atom(std::string_view name) {
+    if (const auto* entry = find_entry(name)) {
+        m_entry = entry;
+        return;
+    }
+
+    auto& table = dynamic_table();
+    std::lock_guard lock(table.mutex);
+    if (auto it = table.index.find(name); it != table.index.end()) {
+        m_entry = it->second;  // Interned by another thread meanwhile
+        return;
+    }
+    auto& characters = table.names.emplace_back(std::make_unique<char[]>(name.size()));
+    std::copy(name.begin(), name.end(), characters.get());
+    u32 id = static_cast<u32>(AtomId::StaticCount) + static_cast<u32>(table.entries.size());
+    m_entry = &table.entries.emplace_back(AtomEntry{std::string_view(characters.get(), name.size()), id});
+    table.index.emplace(m_entry->name, m_entry);
+}
+
+std::optional<Atom> Atom::find(std::string_view name) {
+    if (const auto* entry = find_entry(name)) {
+        return Atom(entry);
+    }
+    return std::nullopt;
+}
+
+} // namespace lithium
@@ -109,19 +109,17 @@ private:
     Function consume_function();
 
     // Token handling
-    [[nodiscard]] const Token& current_token() const;
-    [[nodiscard]] const Token& peek_token() const;
-    void consume_token();
-    void reconsume_token();
-    [[nodiscard]] bool at_end() const;
+    void begin(const String& css);
+    [[nodiscard]] const TokenView& current_token() const { return m_current; }
+    void consume_token() { m_current = m_tokens.next(); }
+    [[nodiscard]] bool at_end() const { return m_current.kind == TokenKind::EndOfFile; }
 
     // Error handling
     void parse_error(const String& message);
 
-    // State
-    Tokenizer m_tokenizer;
-    std::vector<Token> m_tokens;
-    usize m_position{0};
+    // State: tokens are views into the css being parsed, read one at a time
+    TokenStream m_tokens;
+    TokenView m_current;
     std::vector<String> m_errors;
 };
 
@@ -2,10 +2,13 @@
 
 #include "lithium/core/types.hpp"
 #include "lithium/core/string.hpp"
+#include "lithium/core/atom.hpp"
+#include <array>
 #include <variant>
 #include <vector>
 #include <optional>
 #include <memory>
+#include <string_view>
 
 namespace lithium::dom {
 class Element;
@@ -18,7 +21,13 @@ namespace lithium::css {
 // ============================================================================
 
 // Simple selectors
-struct TypeSelector { String tag_name; };
+struct TypeSelector {
+    String tag_name;
+    Atom local_name;  // tag_name lowercased and interned, compared to Element::local_name_atom
+
+    TypeSelector() = default;
+    explicit TypeSelector(String name) : tag_name(std::move(name)), local_name(tag_name.to_lowercase()) {}
+};
 struct UniversalSelector {};
 struct IdSelector { String id; };
 struct ClassSelector { String class_name; };
@@ -71,6 +80,66 @@ struct CompoundSelector {
     [[nodiscard]] bool matches(const dom::Element& element) const;
 };
 
+// ============================================================================
+// Compiled Selector
+// ============================================================================
+//
+// A complex selector flattened into one instruction array and matched by a
+// single loop, without std::visit or allocation. Compounds are laid out
+// right to left, the subject first, each followed by the combinator that
+// leads to the compound on its left; a final Match ends the program. Tag
+// and attribute names (and the values of case-insensitive attribute
+// selectors) are lowercased once, when compiled.
+
+struct ComplexSelector;
+
+class CompiledSelector {
+public:
+    enum class Op : u8 {
+        Tag,                // operand: lowercase tag name (atom table)
+        Id,                 // operand: id
+        Class,              // operand: class name
+        Attribute,          // operands: lowercase name, value; `matcher`
+        FirstChild,
+        LastChild,
+        OnlyChild,
+        Empty,
+        Root,
+        Never,              // Unsupported pseudo-class, or a pseudo-element
+        Descendant,         // Combinators: continue on the compound to the left
+        Child,
+        NextSibling,
+        SubsequentSibling,
+        Match,
+    };
+
+    struct Instruction {
+        Op op;
+        AttributeSelector::Matcher matcher{AttributeSelector::Matcher::Exists};
+        bool case_insensitive{false};
+        u32 name{0};   // Index into the string table (the atom table for Tag)
+        u32 value{0};  // Index into the string table (attribute value)
+    };
+
+    [[nodiscard]] static CompiledSelector compile(const ComplexSelector& selector);
+
+    // False for an empty (never compiled) program
+    [[nodiscard]] bool matches(const dom::Element& element) const;
+
+    [[nodiscard]] bool empty() const { return m_code.empty(); }
+    [[nodiscard]] const std::vector<Instruction>& code() const { return m_code; }
+
+private:
+    [[nodiscard]] bool matches_from(usize pc, const dom::Element* element) const;
+    [[nodiscard]] bool matches_attribute(const Instruction& instruction, const dom::Element& element) const;
+    u32 add_string(String string);
+    u32 add_atom(Atom atom);
+
+    std::vector<Instruction> m_code;
+    std::vector<String> m_strings;
+    std::vector<Atom> m_atoms;
+};
+
 // ============================================================================
 // Complex Selector
 // ============================================================================
@@ -89,6 +158,7 @@ struct ComplexSelectorPart {
 
 struct ComplexSelector {
     std::vector<ComplexSelectorPart> parts;
+    CompiledSelector compiled;  // Filled in by SelectorParser
 
     [[nodiscard]] bool matches(const dom::Element& element) const;
 };
@@ -180,4 +250,50 @@ public:
         const SelectorList& selectors, const dom::Element& root);
 };
 
+// ============================================================================
+// Ancestor Bloom Filter
+// ============================================================================
+//
+// Counting Bloom filter over the tag names, ids and classes of the elements
+// on the path from the root to the element being styled. A selector whose
+// compounds left of a descendant or child combinator need a name that is
+// not in the filter cannot match, so it is rejected without walking the
+// tree. False positives only cost the full match; there are no false
+// negatives.
+
+class AncestorBloomFilter {
+public:
+    // Hashes of the keys a selector needs on its ancestors, 0-terminated
+    static constexpr usize MAX_SELECTOR_HASHES = 4;
+    using SelectorHashes = std::array<u32, MAX_SELECTOR_HASHES>;
+
+    static constexpr usize KEY_BITS = 12;
+
+    // Keys, hashed with their kind so that "#a", ".a" and "a" differ
+    [[nodiscard]] static u32 tag_hash(std::string_view lowercase_name);
+    [[nodiscard]] static u32 id_hash(std::string_view id);
+    [[nodiscard]] static u32 class_hash(std::string_view class_name);
+
+    // Ancestor keys of a complex selector: ids, classes and tags of every
+    // compound joined to the right by a descendant or child combinator
+    [[nodiscard]] static SelectorHashes selector_hashes(const ComplexSelector& selector);
+
+    // Descending into / returning from an element's children
+    void push_element(const dom::Element& element);
+    void pop_element();
+    void clear();
+
+    [[nodiscard]] usize depth() const { return m_frames.size(); }
+    [[nodiscard]] bool may_contain(u32 hash) const;
+    [[nodiscard]] bool may_contain_all(const SelectorHashes& hashes) const;
+
+private:
+    void add(u32 hash);
+    void remove(u32 hash);
+
+    std::array<u8, usize{1} << KEY_BITS> m_counters{};
+    std::vector<u32> m_hashes;   // Keys of the pushed elements, in push order
+    std::vector<usize> m_frames; // Start of each pushed element's keys
+};
+
 } // namespace lithium::css
@@ -2,8 +2,10 @@
 
 #include "parser.hpp"
 #include "selector.hpp"
+#include "stylesheet_cache.hpp"
 #include "value.hpp"
 #include "lithium/dom/document.hpp"
+#include <array>
 #include <unordered_map>
 
 namespace lithium::css {
@@ -24,21 +26,152 @@ enum class CascadeOrigin {
 
 struct MatchedRule {
     const StyleRule* rule;
+    const std::vector<TypedDeclaration>* declarations;  // The rule's, parsed
     Specificity specificity;
     CascadeOrigin origin;
     u32 source_order;
 };
 
+// ============================================================================
+// Rule Set - style rules indexed by their key selector
+// ============================================================================
+//
+// Each selector of each style rule is filed in one bucket, keyed by its
+// rightmost compound selector: the id if it has one, else a class, else an
+// attribute name, else the tag name, else the universal bucket. A selector
+// can only match an element that carries its key, so an element needs to
+// test just the buckets for its own id, classes, attribute names and tag,
+// plus the universal bucket. Declarations, buckets and keys come from the
+// PreparedStylesheet, so adding one only appends its entries.
+
+struct RuleSetEntry {
+    const StyleRule* rule;
+    const std::vector<TypedDeclaration>* declarations;
+    const ComplexSelector* selector;
+    Specificity specificity;
+    CascadeOrigin origin;
+    u32 rule_index;      // Position of the rule across all stylesheets
+    u32 selector_index;  // Position of the selector in the rule's list
+    AncestorBloomFilter::SelectorHashes ancestor_hashes;  // Keys required on ancestors
+};
+
+// Which elements may match differently once an element gains or loses an
+// id, class or attribute: the element's subtree (it appears in a subject
+// compound, or left of a descendant or child combinator) and/or its later
+// siblings' subtrees (it appears left of a sibling combinator)
+struct InvalidationSet {
+    bool subtree{false};
+    bool following_siblings{false};
+
+    [[nodiscard]] bool empty() const { return !subtree && !following_siblings; }
+    InvalidationSet& operator|=(InvalidationSet other) {
+        subtree = subtree || other.subtree;
+        following_siblings = following_siblings || other.following_siblings;
+        return *this;
+    }
+};
+
+class RuleSet {
+public:
+    void add_stylesheet(const Stylesheet& stylesheet, CascadeOrigin origin);
+    void add_stylesheet(RefPtr<const PreparedStylesheet> stylesheet, CascadeOrigin origin);
+    void clear();
+
+    // Appends every entry whose key the element carries (unordered; the
+    // selectors still have to be matched)
+    void collect_candidates(const dom::Element& element, std::vector<const RuleSetEntry*>& out) const;
+
+    [[nodiscard]] usize size() const { return m_size; }
+
+    // Whether any selector depends on an element's siblings or position
+    // (sibling combinators, structural pseudo-classes)
+    [[nodiscard]] bool has_sibling_rules() const { return m_has_sibling_rules; }
+
+    // What a change to one id, class or attribute (lowercase name) of an
+    // element can restyle, from every loaded selector that mentions it
+    [[nodiscard]] InvalidationSet id_invalidation(const String& id) const;
+    [[nodiscard]] InvalidationSet class_invalidation(const String& class_name) const;
+    [[nodiscard]] InvalidationSet attribute_invalidation(const String& name) const;
+
+private:
+    void add_selector(const RuleSetEntry& entry, const PreparedSelector& prepared);
+    void add_invalidation_features(const ComplexSelector& selector);
+
+    std::unordered_map<String, std::vector<RuleSetEntry>> m_id_rules;
+    std::unordered_map<String, std::vector<RuleSetEntry>> m_class_rules;
+    std::unordered_map<String, std::vector<RuleSetEntry>> m_attribute_rules;  // Lowercase names
+    std::unordered_map<Atom, std::vector<RuleSetEntry>> m_tag_rules;          // Lowercase names
+    std::vector<RuleSetEntry> m_universal_rules;
+    std::unordered_map<String, InvalidationSet> m_id_invalidation;
+    std::unordered_map<String, InvalidationSet> m_class_invalidation;
+    std::unordered_map<String, InvalidationSet> m_attribute_invalidation;  // Lowercase names
+    std::vector<RefPtr<const PreparedStylesheet>> m_stylesheets;  // Held, the entries point into them
+    u32 m_rule_count{0};
+    usize m_size{0};
+    bool m_has_sibling_rules{false};
+};
+
+// ============================================================================
+// Ancestor Filter Statistics
+// ============================================================================
+
+// Counts for selectors with ancestor keys, checked during resolve_document
+struct AncestorFilterStats {
+    u64 rejected{0};         // Ruled out by the Bloom filter, no tree walk
+    u64 passed{0};           // Let through to full matching
+    u64 false_positives{0};  // Let through, but the full match failed
+};
+
+// ============================================================================
+// Style Sharing
+// ============================================================================
+//
+// During resolve_document an element may take the style of a recently
+// resolved sibling or cousin instead of running the cascade. Both must have
+// the same parent style object, tag, namespace and attributes, no id and no
+// inline style, and no loaded selector may depend on sibling position. A
+// parent style object is itself only shared between elements with the same
+// signature, so every selector sees identical ancestors for the two.
+
+// Immutable computed style, shared by the elements that resolved to it
+class SharedComputedValue : public RefCounted {
+public:
+    explicit SharedComputedValue(ComputedValue value) : m_value(std::move(value)) {}
+
+    [[nodiscard]] const ComputedValue& value() const { return m_value; }
+
+private:
+    ComputedValue m_value;
+};
+
+struct StyleSharingStats {
+    u64 shared{0};    // Styles reused from a sibling or cousin
+    u64 resolved{0};  // Styles computed by the cascade
+
+    [[nodiscard]] f64 hit_rate() const {
+        u64 total = shared + resolved;
+        return total ? static_cast<f64>(shared) / static_cast<f64>(total) : 0.0;
+    }
+};
+
 // ============================================================================
 // Style Resolver - Computes styles for DOM elements
 // ============================================================================
+//
+// Styles are cached per element. DOM mutations invalidate only what the
+// loaded selectors say they can affect (see InvalidationSet): the cached
+// styles of those subtrees are dropped and their roots recorded, and the
+// next resolve_document restyles just those subtrees. Adding a stylesheet
+// or invalidate_all makes the next resolve_document walk the whole tree.
 
 class StyleResolver {
 public:
     StyleResolver();
 
-    // Add stylesheets
+    // Add stylesheets; a prepared one (e.g. from a StylesheetCache) is
+    // shared rather than copied
     void add_stylesheet(const Stylesheet& stylesheet, CascadeOrigin origin = CascadeOrigin::Author);
+    void add_stylesheet(RefPtr<const PreparedStylesheet> stylesheet, CascadeOrigin origin = CascadeOrigin::Author);
     void add_user_agent_stylesheet(const Stylesheet& stylesheet);
     void add_user_stylesheet(const Stylesheet& stylesheet);
 
@@ -51,16 +184,63 @@ public:
     // Resolve styles for entire document
     void resolve_document(dom::Document& document);
 
+    // Threads used by resolve_document: 1 walks the tree on the calling
+    // thread (the default), 0 means one per hardware thread. The result is
+    // the same for every count.
+    void set_thread_count(usize count);
+    [[nodiscard]] usize thread_count() const { return m_thread_count; }
+
     // Get computed style for an element (cached)
     [[nodiscard]] const ComputedValue* get_computed_style(const dom::Element& element) const;
 
-    // Invalidate cached styles
+    // Invalidate cached styles: an element's with its descendants' (which
+    // inherit from it), or every style
     void invalidate_element(const dom::Element& element);
     void invalidate_all();
 
+    // Invalidate what a DOM mutation can restyle (see dom::DocumentObserver)
+    void invalidate_attribute_change(const dom::Element& element, const String& name,
+                                     const std::optional<String>& old_value);
+    void invalidate_child_inserted(const dom::Node& parent, const dom::Node& child);
+    void invalidate_child_removed(const dom::Node& parent, const dom::Node& child);
+
+    // Elements whose subtrees the next resolve_document restyles (all of
+    // them when it walks the whole tree)
+    [[nodiscard]] usize pending_restyle_roots() const { return m_restyle_roots.size(); }
+
+    // Ancestor Bloom filter effectiveness, accumulated across resolve_document calls
+    [[nodiscard]] const AncestorFilterStats& ancestor_filter_stats() const { return m_ancestor_filter_stats; }
+    void reset_ancestor_filter_stats() { m_ancestor_filter_stats = {}; }
+
+    // Style sharing hit rate, accumulated across resolve_document calls
+    [[nodiscard]] const StyleSharingStats& style_sharing_stats() const { return m_style_sharing_stats; }
+    void reset_style_sharing_stats() { m_style_sharing_stats = {}; }
+
 private:
+    // Per-thread state of a resolve_document walk
+    struct WalkState;
+
+    [[nodiscard]] RefPtr<const SharedComputedValue> resolve_shared(const dom::Element& element) const;
+
+    // Style of an element whose parent resolved to `parent_style`; `walk` is
+    // null outside resolve_document (no ancestor filter, no sharing)
+    [[nodiscard]] RefPtr<const SharedComputedValue> compute_style(
+        const dom::Element& element, const SharedComputedValue* parent_style, WalkState* walk) const;
+
+    void resolve_subtree(const dom::Element& element, const SharedComputedValue* parent_style, WalkState& walk);
+    void resolve_restyle_roots(const dom::Element& document_element);
+    void invalidate_following_siblings(const dom::Node& node);
+    void erase_subtree(const dom::Element& element);
+    void resolve_document_parallel(const dom::Element& root);
+    void add_walk_stats(const WalkState& walk);
+
+    // A recently resolved element's style that this element can take, if any
+    [[nodiscard]] RefPtr<const SharedComputedValue> find_shared_style(
+        const dom::Element& element, const SharedComputedValue* parent_style, const WalkState& walk) const;
+    [[nodiscard]] bool can_share_style(const dom::Element& element) const;
+
     // Find all matching rules for an element
-    [[nodiscard]] std::vector<MatchedRule> collect_matching_rules(const dom::Element& element) const;
+    [[nodiscard]] std::vector<MatchedRule> collect_matching_rules(const dom::Element& element, WalkState* walk) const;
 
     // Sort rules by cascade order
     static void sort_by_cascade(std::vector<MatchedRule>& rules);
@@ -68,7 +248,8 @@ private:
     // Apply matched rules to compute style
     [[nodiscard]] ComputedValue apply_cascade(
         const std::vector<MatchedRule>& rules,
-        const dom::Element& element) const;
+        const dom::Element& element,
+        const ComputedValue* parent_style) const;
 
     // Apply inheritance
     void apply_inheritance(ComputedValue& style, const ComputedValue* parent_style) const;
@@ -82,15 +263,21 @@ private:
     // Default style (user-agent stylesheet)
     [[nodiscard]] static ComputedValue default_style_for_element(const dom::Element& element);
 
-    // Style storage
-    struct StylesheetEntry {
-        Stylesheet stylesheet;
-        CascadeOrigin origin;
-    };
-    std::vector<StylesheetEntry> m_stylesheets;
+    RuleSet m_rule_set;
+
+    usize m_thread_count{1};
+
+    AncestorFilterStats m_ancestor_filter_stats;
+    StyleSharingStats m_style_sharing_stats;
 
     // Style cache
-    mutable std::unordered_map<const dom::Element*, ComputedValue> m_style_cache;
+    mutable std::unordered_map<const dom::Element*, RefPtr<const SharedComputedValue>> m_style_cache;
+
+    // Roots of the subtrees invalidated since the last resolve_document
+    // (held, so a root removed from the tree meanwhile stays valid)
+    std::vector<RefPtr<const dom::Element>> m_restyle_roots;
+    const dom::Document* m_resolved_document{nullptr};  // Last walked in full, if still current
+    bool m_full_restyle{true};
 };
 
 // ============================================================================
@@ -99,4 +286,7 @@ private:
 
 [[nodiscard]] const Stylesheet& default_user_agent_stylesheet();
 
+// The same, prepared once and shared by every resolver
+[[nodiscard]] const RefPtr<const PreparedStylesheet>& default_prepared_user_agent_stylesheet();
+
 } // namespace lithium::css
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "parser.hpp"
+#include "selector.hpp"
+#include "value.hpp"
+#include <list>
+#include <unordered_map>
+
+namespace lithium::css {
+
+// ============================================================================
+// Prepared Stylesheet
+// ============================================================================
+//
+// A parsed stylesheet together with everything the rule set derives from it:
+// each top-level style rule's declarations parsed into typed longhands, and
+// each of its selectors' rule set bucket and key, specificity and ancestor
+// filter hashes. Adding one to a RuleSet only appends these entries.
+// Immutable once built, so one instance can be shared by any number of
+// resolvers (see StylesheetCache).
+
+// The rule set bucket a selector is filed in, by its rightmost compound
+enum class RuleBucket : u8 {
+    Id,
+    Class,
+    Attribute,  // Keyed by the lowercase attribute name
+    Tag,        // Keyed by the lowercase tag name
+    Universal
+};
+
+struct PreparedSelector {
+    u32 rule;            // Index into style_rules()
+    u32 selector_index;  // Position of the selector in the rule's list
+    RuleBucket bucket;
+    String key;          // Empty for the universal bucket
+    Specificity specificity;
+    AncestorBloomFilter::SelectorHashes ancestor_hashes;
+    bool depends_on_siblings;  // Sibling combinators, structural pseudo-classes
+};
+
+class PreparedStylesheet : public RefCounted {
+public:
+    explicit PreparedStylesheet(Stylesheet stylesheet);
+
+    PreparedStylesheet(const PreparedStylesheet&) = delete;
+    PreparedStylesheet& operator=(const PreparedStylesheet&) = delete;
+
+    [[nodiscard]] const Stylesheet& stylesheet() const { return m_stylesheet; }
+
+    // Top-level style rules in order, and the typed declarations of each
+    [[nodiscard]] const std::vector<const StyleRule*>& style_rules() const { return m_style_rules; }
+    [[nodiscard]] const std::vector<std::vector<TypedDeclaration>>& declarations() const { return m_declarations; }
+
+    // Every selector of every style rule; selectors that can match nothing
+    // (no compounds) are left out
+    [[nodiscard]] const std::vector<PreparedSelector>& selectors() const { return m_selectors; }
+
+    // Approximate heap footprint, for cache accounting
+    [[nodiscard]] usize memory_size() const { return m_memory_size; }
+
+    // Binary form for StylesheetCache's files: appends to `out`, and reads
+    // back what serialize wrote (null if the bytes are truncated or corrupt).
+    // Native byte order and layout; files are not portable between builds.
+    void serialize(std::string& out) const;
+    [[nodiscard]] static RefPtr<const PreparedStylesheet> deserialize(std::string_view bytes);
+
+private:
+    PreparedStylesheet(Stylesheet stylesheet, std::vector<std::vector<TypedDeclaration>> declarations,
+                       std::vector<PreparedSelector> selectors);
+
+    void collect_style_rules();
+    void estimate_memory_size();
+
+    Stylesheet m_stylesheet;
+    std::vector<const StyleRule*> m_style_rules;
+    std::vector<std::vector<TypedDeclaration>> m_declarations;
+    std::vector<PreparedSelector> m_selectors;
+    usize m_memory_size{0};
+};
+
+// ============================================================================
+// Stylesheet Cache
+// ============================================================================
+//
+// Prepared stylesheets keyed by the hash of their source text, so a page
+// load that sees the same CSS again (a shared <link>ed bundle, a reload)
+// skips the tokenizer, parser, declaration parsing and selector indexing.
+// A hit compares the stored source, so a hash collision is only a miss.
+//
+// Entries are evicted least recently used first once their sources and
+// prepared forms exceed the size bound. With a directory set, a miss also
+// looks for the entry's file there (memory-mapped where the platform
+// allows) before parsing, and a parse writes the file for the next process.
+// Not thread-safe.
+
+struct StylesheetCacheStats {
+    u64 hits{0};        // Served from memory
+    u64 disk_hits{0};   // Loaded from the cache directory
+    u64 misses{0};      // Parsed
+    u64 evictions{0};
+
+    [[nodiscard]] f64 hit_rate() const {
+        u64 total = hits + disk_hits + misses;
+        return total ? static_cast<f64>(hits + disk_hits) / static_cast<f64>(total) : 0.0;
+    }
+};
+
+class StylesheetCache {
+public:
+    // The prepared stylesheet for `css`, parsing it on a miss
+    [[nodiscard]] RefPtr<const PreparedStylesheet> get(const String& css);
+
+    void enable_cache(bool enabled) { m_enabled = enabled; }
+    void set_max_size(usize bytes);
+    void clear();
+
+    // Directory for the on-disk entries; empty (the default) disables them
+    void set_directory(const String& directory) { m_directory = directory; }
+    [[nodiscard]] const String& directory() const { return m_directory; }
+
+    [[nodiscard]] usize size() const { return m_entries.size(); }
+    [[nodiscard]] usize memory_size() const { return m_memory_size; }
+
+    [[nodiscard]] const StylesheetCacheStats& stats() const { return m_stats; }
+    void reset_stats() { m_stats = {}; }
+
+    // Stable 64-bit hash of a stylesheet's source, the cache key
+    [[nodiscard]] static u64 hash_source(std::string_view css);
+
+private:
+    struct Entry {
+        u64 hash;
+        String source;
+        RefPtr<const PreparedStylesheet> stylesheet;
+        usize bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    [[nodiscard]] String file_path(u64 hash) const;
+    [[nodiscard]] RefPtr<const PreparedStylesheet> load_file(u64 hash, std::string_view css) const;
+    void store_file(u64 hash, std::string_view css, const PreparedStylesheet& stylesheet) const;
+    void insert(u64 hash, const String& css, RefPtr<const PreparedStylesheet> stylesheet);
+    void evict_if_needed();
+
+    Parser m_parser;
+    EntryList m_entries;  // Most recently used first
+    std::unordered_map<u64, EntryList::iterator> m_index;
+    String m_directory;
+    bool m_enabled{true};
+    usize m_max_size{64 * 1024 * 1024};  // 64MB default
+    usize m_memory_size{0};
+    StylesheetCacheStats m_stats;
+};
+
+} // namespace lithium::css
@@ -2,6 +2,7 @@
 
 #include "lithium/core/types.hpp"
 #include "lithium/core/string.hpp"
+#include <string_view>
 #include <variant>
 #include <vector>
 #include <optional>
@@ -75,13 +76,119 @@ template<typename T>
 [[nodiscard]] bool is_ident(const Token& token);
 [[nodiscard]] bool is_ident_with_value(const Token& token, const String& value);
 
+// ============================================================================
+// Token views
+// ============================================================================
+
+// One kind per Token alternative. Whitespace is skipped before every token,
+// so there is no whitespace kind.
+enum class TokenKind : u8 {
+    Ident,
+    Function,
+    AtKeyword,
+    Hash,
+    String,
+    BadString,
+    Url,
+    BadUrl,
+    Delim,
+    Number,
+    Percentage,
+    Dimension,
+    CDO,
+    CDC,
+    Colon,
+    Semicolon,
+    Comma,
+    OpenSquare,
+    CloseSquare,
+    OpenParen,
+    CloseParen,
+    OpenCurly,
+    CloseCurly,
+    EndOfFile
+};
+
+// A token as a range of the source buffer. The range holds the name of an
+// ident, function, at-keyword or hash; the contents of a string or url; the
+// number (and then the unit) of a numeric token; the byte of a delim.
+struct TokenView {
+    static constexpr u8 ESCAPED = 1 << 0;  // the range holds escapes; TokenStream::value decodes them
+    static constexpr u8 ID = 1 << 1;       // a hash that would start an identifier
+    static constexpr u8 INTEGER = 1 << 2;  // a number without fraction or exponent
+
+    TokenKind kind{TokenKind::EndOfFile};
+    u8 flags{0};
+    u32 offset{0};
+    u32 length{0};
+    u32 number_length{0};  // numeric tokens: bytes of the range before the unit or %
+
+    [[nodiscard]] bool has(u8 flag) const { return (flags & flag) != 0; }
+};
+
+// Tokenizes a buffer the caller keeps alive, one TokenView at a time,
+// without copying or decoding anything until value() or number() asks
+class TokenStream {
+public:
+    TokenStream() = default;
+    explicit TokenStream(std::string_view source);
+
+    [[nodiscard]] TokenView next();
+    [[nodiscard]] bool at_end() const { return m_position >= m_source.size(); }
+    [[nodiscard]] std::string_view source() const { return m_source; }
+
+    // Raw bytes of the token's range
+    [[nodiscard]] std::string_view text(const TokenView& token) const {
+        return m_source.substr(token.offset, token.length);
+    }
+    [[nodiscard]] std::string_view number_text(const TokenView& token) const {
+        return m_source.substr(token.offset, token.number_length);
+    }
+    [[nodiscard]] std::string_view unit_text(const TokenView& token) const {
+        return m_source.substr(token.offset + token.number_length, token.length - token.number_length);
+    }
+
+    // Name, string or url contents, or dimension unit, with escapes decoded
+    [[nodiscard]] String value(const TokenView& token) const;
+    [[nodiscard]] f64 number(const TokenView& token) const;
+    [[nodiscard]] unicode::CodePoint delim(const TokenView& token) const {
+        return static_cast<unsigned char>(m_source[token.offset]);
+    }
+
+private:
+    [[nodiscard]] TokenView consume_ident_like(usize start);
+    [[nodiscard]] TokenView consume_string(char quote);
+    [[nodiscard]] TokenView consume_url();
+    [[nodiscard]] TokenView consume_numeric(usize start);
+    [[nodiscard]] TokenView consume_hash();
+
+    [[nodiscard]] bool is_valid_escape(usize position) const;
+    [[nodiscard]] bool would_start_identifier(usize position) const;
+    [[nodiscard]] bool would_start_number(usize position) const;
+
+    // Advance past a name or escape; return whether the name held escapes
+    bool skip_name();
+    void skip_escape();
+    void skip_remnants_of_bad_url();
+
+    [[nodiscard]] char peek(usize offset = 0) const {
+        return m_position + offset < m_source.size() ? m_source[m_position + offset] : '\0';
+    }
+
+    std::string_view m_source;
+    usize m_position{0};
+};
+
 // ============================================================================
 // CSS Tokenizer
 // ============================================================================
 
+// Owns a copy of its input and converts the TokenStream's views into Tokens
 class Tokenizer {
 public:
     Tokenizer();
+    Tokenizer(const Tokenizer&) = delete;
+    Tokenizer& operator=(const Tokenizer&) = delete;
 
     void set_input(const String& input);
     void set_input(std::string_view input);
@@ -99,33 +206,11 @@ public:
     [[nodiscard]] bool at_end() const;
 
 private:
-    // Character consumption
-    [[nodiscard]] unicode::CodePoint peek(usize offset = 0) const;
-    unicode::CodePoint consume();
-    void reconsume();
-
-    // Token production
-    Token consume_token();
-    Token consume_ident_like_token();
-    Token consume_string_token(unicode::CodePoint ending);
-    Token consume_url_token();
-    Token consume_numeric_token();
-    Token consume_hash_token();
-
-    // Helpers
-    [[nodiscard]] bool is_valid_escape(usize offset = 0) const;
-    [[nodiscard]] bool would_start_identifier(usize offset = 0) const;
-    [[nodiscard]] bool would_start_number(usize offset = 0) const;
-
-    unicode::CodePoint consume_escaped_code_point();
-    String consume_name();
-    std::pair<f64, bool> consume_number();
-    void consume_whitespace();
-    void consume_remnants_of_bad_url();
+    [[nodiscard]] Token to_token(const TokenView& view) const;
 
     // Input
     String m_input;
-    usize m_position{0};
+    TokenStream m_stream;
 
     // Peeked token cache
     std::optional<Token> m_peeked;
@@ -2,6 +2,7 @@
 
 #include "lithium/core/types.hpp"
 #include "lithium/core/string.hpp"
+#include <optional>
 #include <variant>
 #include <vector>
 #include <memory>
@@ -163,19 +164,23 @@ enum class BorderStyle {
 // ============================================================================
 // Computed Value
 // ============================================================================
-
-struct ComputedValue {
-    // Layout
+//
+// Properties live in immutable, reference-counted groups. Copying a
+// ComputedValue copies one pointer per group; a child shares its parent's
+// inherited groups (font, inherited text), and elements share every group
+// their rules leave alone. Writes go through mutable_*(), which clones a
+// group first if anyone else holds it (copy-on-write).
+
+// Box model, positioning and layout mode
+struct BoxProperties : public RefCounted {
     Display display{Display::Inline};
     Position position{Position::Static};
     Float float_value{Float::None};
     Clear clear{Clear::None};
     Overflow overflow_x{Overflow::Visible};
     Overflow overflow_y{Overflow::Visible};
-    Visibility visibility{Visibility::Visible};
     BoxSizing box_sizing{BoxSizing::ContentBox};
 
-    // Box model
     std::optional<Length> width;
     std::optional<Length> height;
     std::optional<Length> min_width;
@@ -193,6 +198,16 @@ struct ComputedValue {
     Length padding_bottom;
     Length padding_left;
 
+    std::optional<Length> top;
+    std::optional<Length> right;
+    std::optional<Length> bottom;
+    std::optional<Length> left;
+    i32 z_index{0};
+
+    f32 opacity{1.0f};
+};
+
+struct BorderProperties : public RefCounted {
     Length border_top_width;
     Length border_right_width;
     Length border_bottom_width;
@@ -207,34 +222,99 @@ struct ComputedValue {
     Color border_right_color{Color::black()};
     Color border_bottom_color{Color::black()};
     Color border_left_color{Color::black()};
+};
 
-    // Positioning
-    std::optional<Length> top;
-    std::optional<Length> right;
-    std::optional<Length> bottom;
-    std::optional<Length> left;
-    i32 z_index{0};
+struct BackgroundProperties : public RefCounted {
+    Color background_color{Color::transparent()};
+};
 
-    // Text
+// Inherited
+struct FontProperties : public RefCounted {
+    Length font_size{16, LengthUnit::Px};
+    FontWeight font_weight{FontWeight::Normal};
+    FontStyle font_style{FontStyle::Normal};
+    std::vector<String> font_family;
+    Length line_height{1.2f, LengthUnit::Em};
+};
+
+// Inherited
+struct InheritedTextProperties : public RefCounted {
     Color color{Color::black()};
     TextAlign text_align{TextAlign::Start};
-    VerticalAlign vertical_align{VerticalAlign::Baseline};
     WhiteSpace white_space{WhiteSpace::Normal};
+    Visibility visibility{Visibility::Visible};
+};
+
+struct TextProperties : public RefCounted {
+    VerticalAlign vertical_align{VerticalAlign::Baseline};
     TextDecorationLine text_decoration_line{TextDecorationLine::None};
     Color text_decoration_color{Color::black()};
+};
 
-    // Font
-    Length font_size{16, LengthUnit::Px};
-    FontWeight font_weight{FontWeight::Normal};
-    FontStyle font_style{FontStyle::Normal};
-    std::vector<String> font_family;
-    Length line_height{1.2f, LengthUnit::Em};
+class ComputedValue {
+public:
+    // Initial values; every group is a shared default
+    ComputedValue();
+
+    [[nodiscard]] const BoxProperties& box() const { return *m_box; }
+    [[nodiscard]] const BorderProperties& border() const { return *m_border; }
+    [[nodiscard]] const BackgroundProperties& background() const { return *m_background; }
+    [[nodiscard]] const FontProperties& font() const { return *m_font; }
+    [[nodiscard]] const InheritedTextProperties& inherited_text() const { return *m_inherited_text; }
+    [[nodiscard]] const TextProperties& text() const { return *m_text; }
+
+    [[nodiscard]] BoxProperties& mutable_box() { return unshare(m_box); }
+    [[nodiscard]] BorderProperties& mutable_border() { return unshare(m_border); }
+    [[nodiscard]] BackgroundProperties& mutable_background() { return unshare(m_background); }
+    [[nodiscard]] FontProperties& mutable_font() { return unshare(m_font); }
+    [[nodiscard]] InheritedTextProperties& mutable_inherited_text() { return unshare(m_inherited_text); }
+    [[nodiscard]] TextProperties& mutable_text() { return unshare(m_text); }
+
+    // Take the parent's inherited groups (shared, not copied)
+    void inherit_from(const ComputedValue& parent);
+
+private:
+    template<typename T>
+    static T& unshare(RefPtr<T>& group) {
+        if (group->ref_count() > 1) {
+            group = make_ref<T>(*group);
+        }
+        return *group;
+    }
+
+    RefPtr<BoxProperties> m_box;
+    RefPtr<BorderProperties> m_border;
+    RefPtr<BackgroundProperties> m_background;
+    RefPtr<FontProperties> m_font;
+    RefPtr<InheritedTextProperties> m_inherited_text;
+    RefPtr<TextProperties> m_text;
+};
 
-    // Background
-    Color background_color{Color::transparent()};
+// ============================================================================
+// Typed Declarations
+// ============================================================================
 
-    // Opacity
-    f32 opacity{1.0f};
+// Longhand properties the cascade applies; shorthands expand into these
+enum class PropertyId : u8 {
+    Display, Position,
+    Color, BackgroundColor,
+    FontSize, FontWeight, LineHeight, TextAlign,
+    Width, Height,
+    MarginTop, MarginRight, MarginBottom, MarginLeft,
+    PaddingTop, PaddingRight, PaddingBottom, PaddingLeft,
+    BorderTopWidth, BorderRightWidth, BorderBottomWidth, BorderLeftWidth,
+    Opacity
+};
+
+// The `auto` keyword (width, height)
+struct AutoValue {};
+
+using PropertyValue = std::variant<AutoValue, Length, Color, Display, Position, FontWeight, TextAlign, f32>;
+
+// A declaration parsed once, when its stylesheet is loaded
+struct TypedDeclaration {
+    PropertyId property;
+    PropertyValue value;
 };
 
 // ============================================================================
@@ -250,6 +330,14 @@ public:
     [[nodiscard]] static std::optional<Position> parse_position(const String& value);
     [[nodiscard]] static std::optional<FontWeight> parse_font_weight(const String& value);
 
+    // Parse a declaration into typed longhands appended to `out`; false if
+    // the property is unsupported or the value invalid (nothing appended)
+    [[nodiscard]] static bool parse_declaration(const String& property, const String& value,
+                                                std::vector<TypedDeclaration>& out);
+
+    // Copy a typed value into the style
+    static void apply_declaration(ComputedValue& style, const TypedDeclaration& declaration);
+
     // Parse a property value
     [[nodiscard]] static bool apply_property(ComputedValue& style, const String& property, const String& value);
 };
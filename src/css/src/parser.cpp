@@ -15,6 +15,17 @@ static String number_to_string(f64 value) {
     return sb.build();
 }
 
+// A plain integer of up to six digits already reads the way "%g" prints it
+static String number_to_string(const TokenStream& tokens, const TokenView& token) {
+    auto text = tokens.number_text(token);
+    auto digits = text.substr(text[0] == '-' ? 1 : 0);
+    if (token.has(TokenView::INTEGER) && text[0] != '+' && digits.size() <= 6 &&
+        (digits[0] != '0' || digits.size() == 1)) {
+        return String(text);
+    }
+    return number_to_string(tokens.number(token));
+}
+
 // ============================================================================
 // Stylesheet
 // ============================================================================
@@ -76,10 +87,7 @@ std::optional<const Declaration*> DeclarationBlock::get_property(const String& n
 Parser::Parser() = default;
 
 Stylesheet Parser::parse_stylesheet(const String& css) {
-    m_tokenizer.set_input(css);
-    m_tokens = m_tokenizer.tokenize();
-    m_position = 0;
-    m_errors.clear();
+    begin(css);
 
     Stylesheet stylesheet;
     stylesheet.rules = consume_rule_list(true);
@@ -87,10 +95,7 @@ Stylesheet Parser::parse_stylesheet(const String& css) {
 }
 
 DeclarationBlock Parser::parse_style_attribute(const String& css) {
-    m_tokenizer.set_input(css);
-    m_tokens = m_tokenizer.tokenize();
-    m_position = 0;
-    m_errors.clear();
+    begin(css);
 
     DeclarationBlock block;
     block.declarations = consume_declaration_list();
@@ -98,10 +103,7 @@ DeclarationBlock Parser::parse_style_attribute(const String& css) {
 }
 
 std::optional<Declaration> Parser::parse_declaration(const String& css) {
-    m_tokenizer.set_input(css);
-    m_tokens = m_tokenizer.tokenize();
-    m_position = 0;
-    m_errors.clear();
+    begin(css);
 
     return consume_declaration();
 }
@@ -111,37 +113,10 @@ std::optional<SelectorList> Parser::parse_selector(const String& css) {
     return parser.parse(css);
 }
 
-const Token& Parser::current_token() const {
-    if (m_position >= m_tokens.size()) {
-        static EOFToken eof;
-        return eof;
-    }
-    return m_tokens[m_position];
-}
-
-const Token& Parser::peek_token() const {
-    if (m_position + 1 >= m_tokens.size()) {
-        static EOFToken eof;
-        return eof;
-    }
-    return m_tokens[m_position + 1];
-}
-
-void Parser::consume_token() {
-    if (m_position < m_tokens.size()) {
-        ++m_position;
-    }
-}
-
-void Parser::reconsume_token() {
-    if (m_position > 0) {
-        --m_position;
-    }
-}
-
-bool Parser::at_end() const {
-    return m_position >= m_tokens.size() ||
-           std::holds_alternative<EOFToken>(current_token());
+void Parser::begin(const String& css) {
+    m_tokens = TokenStream(css.view());
+    m_errors.clear();
+    consume_token();
 }
 
 void Parser::parse_error(const String& message) {
@@ -155,34 +130,29 @@ std::vector<Rule> Parser::consume_rule_list(bool top_level, bool stop_on_close_c
         const auto& token = current_token();
 
         // When parsing inside a block, bail out once we see the closing brace.
-        if (stop_on_close_curly && std::holds_alternative<CloseCurlyToken>(token)) {
+        if (stop_on_close_curly && token.kind == TokenKind::CloseCurly) {
             consume_token();
             break;
         }
 
-        if (std::holds_alternative<WhitespaceToken>(token)) {
-            consume_token();
-            continue;
-        }
-
-        if (std::holds_alternative<EOFToken>(token)) {
+        if (token.kind == TokenKind::EndOfFile) {
             break;
         }
 
-        if (std::holds_alternative<CDOToken>(token) ||
-            std::holds_alternative<CDCToken>(token)) {
+        if (token.kind == TokenKind::CDO ||
+            token.kind == TokenKind::CDC) {
             if (top_level) {
                 consume_token();
                 continue;
             }
             if (auto rule = consume_qualified_rule()) {
-                rules.push_back(*rule);
+                rules.push_back(std::move(*rule));
             }
             continue;
         }
 
         if (auto rule = consume_rule(top_level, stop_on_close_curly)) {
-            rules.push_back(*rule);
+            rules.push_back(std::move(*rule));
         }
     }
 
@@ -190,18 +160,14 @@ std::vector<Rule> Parser::consume_rule_list(bool top_level, bool stop_on_close_c
 }
 
 std::optional<Rule> Parser::consume_rule(bool top_level, bool stop_on_close_curly) {
-    while (!at_end() && std::holds_alternative<WhitespaceToken>(current_token())) {
-        consume_token();
-    }
-
     if (at_end()) return std::nullopt;
 
-    if (stop_on_close_curly && std::holds_alternative<CloseCurlyToken>(current_token())) {
+    if (stop_on_close_curly && current_token().kind == TokenKind::CloseCurly) {
         consume_token();
         return std::nullopt;
     }
 
-    if (std::holds_alternative<AtKeywordToken>(current_token())) {
+    if (current_token().kind == TokenKind::AtKeyword) {
         return consume_at_rule();
     }
 
@@ -209,9 +175,8 @@ std::optional<Rule> Parser::consume_rule(bool top_level, bool stop_on_close_curl
 }
 
 std::optional<AtRule> Parser::consume_at_rule() {
-    auto& at_token = std::get<AtKeywordToken>(current_token());
     AtRule rule;
-    rule.name = at_token.value;
+    rule.name = m_tokens.value(current_token());
     consume_token();
 
     auto lower_name = rule.name.to_lowercase();
@@ -232,17 +197,17 @@ std::optional<AtRule> Parser::consume_at_rule() {
     while (!at_end()) {
         const auto& token = current_token();
 
-        if (std::holds_alternative<SemicolonToken>(token)) {
+        if (token.kind == TokenKind::Semicolon) {
             consume_token();
             return rule;
         }
 
-        if (std::holds_alternative<EOFToken>(token)) {
+        if (token.kind == TokenKind::EndOfFile) {
             parse_error("Unexpected EOF in at-rule"_s);
             return rule;
         }
 
-        if (std::holds_alternative<OpenCurlyToken>(token)) {
+        if (token.kind == TokenKind::OpenCurly) {
             consume_token(); // consume {
 
             if (at_rule_allows_rule_list(lower_name)) {
@@ -273,16 +238,16 @@ std::optional<StyleRule> Parser::consume_qualified_rule() {
     while (!at_end()) {
         const auto& token = current_token();
 
-        if (std::holds_alternative<EOFToken>(token)) {
+        if (token.kind == TokenKind::EndOfFile) {
             parse_error("Unexpected EOF in qualified rule"_s);
             return std::nullopt;
         }
 
-        if (std::holds_alternative<OpenCurlyToken>(token)) {
+        if (token.kind == TokenKind::OpenCurly) {
             // Parse selector
             SelectorParser parser;
             if (auto selectors = parser.parse(selector_text.build())) {
-                rule.selectors = *selectors;
+                rule.selectors = std::move(*selectors);
             } else {
                 parse_error("Invalid selector: "_s + parser.error());
             }
@@ -294,32 +259,34 @@ std::optional<StyleRule> Parser::consume_qualified_rule() {
         }
 
         // Accumulate selector text
-        if (auto* ident = std::get_if<IdentToken>(&token)) {
-            selector_text.append(ident->value);
-        } else if (auto* hash = std::get_if<HashToken>(&token)) {
-            selector_text.append('#');
-            selector_text.append(hash->value);
-        } else if (auto* delim = std::get_if<DelimToken>(&token)) {
-            selector_text.append(delim->value);
-        } else if (std::holds_alternative<WhitespaceToken>(token)) {
-            selector_text.append(' ');
-        } else if (std::holds_alternative<ColonToken>(token)) {
+        if (token.kind == TokenKind::Ident || token.kind == TokenKind::Hash) {
+            if (token.kind == TokenKind::Hash) {
+                selector_text.append('#');
+            }
+            if (token.has(TokenView::ESCAPED)) {
+                selector_text.append(m_tokens.value(token));
+            } else {
+                selector_text.append(m_tokens.text(token));
+            }
+        } else if (token.kind == TokenKind::Delim) {
+            selector_text.append(m_tokens.delim(token));
+        } else if (token.kind == TokenKind::Colon) {
             selector_text.append(':');
-        } else if (std::holds_alternative<OpenSquareToken>(token)) {
+        } else if (token.kind == TokenKind::OpenSquare) {
             selector_text.append('[');
-        } else if (std::holds_alternative<CloseSquareToken>(token)) {
+        } else if (token.kind == TokenKind::CloseSquare) {
             selector_text.append(']');
-        } else if (std::holds_alternative<OpenParenToken>(token)) {
+        } else if (token.kind == TokenKind::OpenParen) {
             selector_text.append('(');
-        } else if (std::holds_alternative<CloseParenToken>(token)) {
+        } else if (token.kind == TokenKind::CloseParen) {
             selector_text.append(')');
-        } else if (auto* string_tok = std::get_if<StringToken>(&token)) {
+        } else if (token.kind == TokenKind::String) {
             selector_text.append('"');
-            selector_text.append(string_tok->value);
+            selector_text.append(m_tokens.value(token));
             selector_text.append('"');
-        } else if (auto* num = std::get_if<NumberToken>(&token)) {
-            selector_text.append(num->value);  // StringBuilder::append(f64)
-        } else if (std::holds_alternative<CommaToken>(token)) {
+        } else if (token.kind == TokenKind::Number) {
+            selector_text.append(m_tokens.number(token));  // StringBuilder::append(f64)
+        } else if (token.kind == TokenKind::Comma) {
             selector_text.append(',');
         }
 
@@ -334,7 +301,7 @@ DeclarationBlock Parser::consume_declaration_block() {
     block.declarations = consume_declaration_list();
 
     // Consume closing brace if present
-    if (!at_end() && std::holds_alternative<CloseCurlyToken>(current_token())) {
+    if (!at_end() && current_token().kind == TokenKind::CloseCurly) {
         consume_token();
     }
 
@@ -347,32 +314,31 @@ std::vector<Declaration> Parser::consume_declaration_list() {
     while (!at_end()) {
         const auto& token = current_token();
 
-        if (std::holds_alternative<WhitespaceToken>(token) ||
-            std::holds_alternative<SemicolonToken>(token)) {
+        if (token.kind == TokenKind::Semicolon) {
             consume_token();
             continue;
         }
 
-        if (std::holds_alternative<EOFToken>(token) ||
-            std::holds_alternative<CloseCurlyToken>(token)) {
+        if (token.kind == TokenKind::EndOfFile ||
+            token.kind == TokenKind::CloseCurly) {
             break;
         }
 
-        if (std::holds_alternative<AtKeywordToken>(token)) {
+        if (token.kind == TokenKind::AtKeyword) {
             // At-rule in declaration block (not common, but valid)
             consume_at_rule();
             continue;
         }
 
-        if (std::holds_alternative<IdentToken>(token)) {
+        if (token.kind == TokenKind::Ident) {
             if (auto decl = consume_declaration()) {
-                declarations.push_back(*decl);
+                declarations.push_back(std::move(*decl));
             }
         } else {
             // Skip until ; or }
             while (!at_end() &&
-                   !std::holds_alternative<SemicolonToken>(current_token()) &&
-                   !std::holds_alternative<CloseCurlyToken>(current_token())) {
+                   current_token().kind != TokenKind::Semicolon &&
+                   current_token().kind != TokenKind::CloseCurly) {
                 consume_token();
             }
         }
@@ -385,44 +351,30 @@ std::optional<Declaration> Parser::consume_declaration() {
     Declaration decl;
 
     // Property name
-    if (auto* ident = std::get_if<IdentToken>(&current_token())) {
-        decl.property = ident->value;
+    if (current_token().kind == TokenKind::Ident) {
+        decl.property = m_tokens.value(current_token());
         consume_token();
     } else {
         return std::nullopt;
     }
 
-    // Skip whitespace
-    while (!at_end() && std::holds_alternative<WhitespaceToken>(current_token())) {
-        consume_token();
-    }
-
     // Colon
-    if (!std::holds_alternative<ColonToken>(current_token())) {
+    if (current_token().kind != TokenKind::Colon) {
         parse_error("Expected ':' in declaration"_s);
         return std::nullopt;
     }
     consume_token();
 
-    // Skip whitespace
-    while (!at_end() && std::holds_alternative<WhitespaceToken>(current_token())) {
-        consume_token();
-    }
-
     // Value
     while (!at_end() &&
-           !std::holds_alternative<SemicolonToken>(current_token()) &&
-           !std::holds_alternative<CloseCurlyToken>(current_token())) {
+           current_token().kind != TokenKind::Semicolon &&
+           current_token().kind != TokenKind::CloseCurly) {
         // Check for !important
-        if (auto* delim = std::get_if<DelimToken>(&current_token())) {
-            if (delim->value == '!') {
+        if (current_token().kind == TokenKind::Delim) {
+            if (m_tokens.delim(current_token()) == '!') {
                 consume_token();
-                // Skip whitespace
-                while (!at_end() && std::holds_alternative<WhitespaceToken>(current_token())) {
-                    consume_token();
-                }
-                if (auto* ident = std::get_if<IdentToken>(&current_token())) {
-                    if (ident->value.to_lowercase() == "important"_s) {
+                if (current_token().kind == TokenKind::Ident) {
+                    if (m_tokens.value(current_token()).to_lowercase() == "important"_s) {
                         decl.important = true;
                         consume_token();
                         continue;
@@ -451,40 +403,49 @@ std::optional<Declaration> Parser::consume_declaration() {
 ComponentValue Parser::consume_component_value() {
     const auto& token = current_token();
 
-    if (std::holds_alternative<OpenCurlyToken>(token) ||
-        std::holds_alternative<OpenSquareToken>(token) ||
-        std::holds_alternative<OpenParenToken>(token)) {
+    if (token.kind == TokenKind::OpenCurly ||
+        token.kind == TokenKind::OpenSquare ||
+        token.kind == TokenKind::OpenParen) {
         return std::make_shared<SimpleBlock>(consume_simple_block());
     }
 
-    if (std::holds_alternative<FunctionToken>(token)) {
+    if (token.kind == TokenKind::Function) {
         return std::make_shared<Function>(consume_function());
     }
 
     // Preserved token
     PreservedToken preserved;
-    if (auto* ident = std::get_if<IdentToken>(&token)) {
-        preserved.value = ident->value;
-    } else if (auto* string_tok = std::get_if<StringToken>(&token)) {
-        preserved.value = string_tok->value;
-    } else if (auto* num = std::get_if<NumberToken>(&token)) {
-        preserved.value = number_to_string(num->value);
-    } else if (auto* dim = std::get_if<DimensionToken>(&token)) {
-        preserved.value = number_to_string(dim->value) + dim->unit;
-    } else if (auto* pct = std::get_if<PercentageToken>(&token)) {
-        preserved.value = number_to_string(pct->value) + "%"_s;
-    } else if (auto* hash = std::get_if<HashToken>(&token)) {
-        preserved.value = "#"_s + hash->value;
-    } else if (auto* delim = std::get_if<DelimToken>(&token)) {
-        preserved.value = String(1, static_cast<char>(delim->value));
-    } else if (std::holds_alternative<WhitespaceToken>(token)) {
-        preserved.value = " "_s;
-    } else if (std::holds_alternative<CommaToken>(token)) {
-        preserved.value = ","_s;
-    } else if (std::holds_alternative<ColonToken>(token)) {
-        preserved.value = ":"_s;
-    } else if (auto* url = std::get_if<UrlToken>(&token)) {
-        preserved.value = "url("_s + url->value + ")"_s;
+    switch (token.kind) {
+        case TokenKind::Ident:
+        case TokenKind::String:
+            preserved.value = m_tokens.value(token);
+            break;
+        case TokenKind::Number:
+            preserved.value = number_to_string(m_tokens, token);
+            break;
+        case TokenKind::Dimension:
+            preserved.value = number_to_string(m_tokens, token) + m_tokens.value(token);
+            break;
+        case TokenKind::Percentage:
+            preserved.value = number_to_string(m_tokens, token) + "%"_s;
+            break;
+        case TokenKind::Hash:
+            preserved.value = "#"_s + m_tokens.value(token);
+            break;
+        case TokenKind::Delim:
+            preserved.value = String(1, static_cast<char>(m_tokens.delim(token)));
+            break;
+        case TokenKind::Comma:
+            preserved.value = ","_s;
+            break;
+        case TokenKind::Colon:
+            preserved.value = ":"_s;
+            break;
+        case TokenKind::Url:
+            preserved.value = "url("_s + m_tokens.value(token) + ")"_s;
+            break;
+        default:
+            break;
     }
 
     consume_token();
@@ -495,11 +456,11 @@ SimpleBlock Parser::consume_simple_block() {
     SimpleBlock block;
 
     const auto& start = current_token();
-    if (std::holds_alternative<OpenCurlyToken>(start)) {
+    if (start.kind == TokenKind::OpenCurly) {
         block.associated_token = '{';
-    } else if (std::holds_alternative<OpenSquareToken>(start)) {
+    } else if (start.kind == TokenKind::OpenSquare) {
         block.associated_token = '[';
-    } else if (std::holds_alternative<OpenParenToken>(start)) {
+    } else if (start.kind == TokenKind::OpenParen) {
         block.associated_token = '(';
     }
 
@@ -514,9 +475,9 @@ SimpleBlock Parser::consume_simple_block() {
         const auto& token = current_token();
 
         bool is_ending = false;
-        if (ending == '}' && std::holds_alternative<CloseCurlyToken>(token)) is_ending = true;
-        if (ending == ']' && std::holds_alternative<CloseSquareToken>(token)) is_ending = true;
-        if (ending == ')' && std::holds_alternative<CloseParenToken>(token)) is_ending = true;
+        if (ending == '}' && token.kind == TokenKind::CloseCurly) is_ending = true;
+        if (ending == ']' && token.kind == TokenKind::CloseSquare) is_ending = true;
+        if (ending == ')' && token.kind == TokenKind::CloseParen) is_ending = true;
 
         if (is_ending) {
             consume_token();
@@ -532,14 +493,14 @@ SimpleBlock Parser::consume_simple_block() {
 Function Parser::consume_function() {
     Function func;
 
-    if (auto* func_token = std::get_if<FunctionToken>(&current_token())) {
-        func.name = func_token->value;
+    if (current_token().kind == TokenKind::Function) {
+        func.name = m_tokens.value(current_token());
     }
 
     consume_token(); // function token
 
     while (!at_end()) {
-        if (std::holds_alternative<CloseParenToken>(current_token())) {
+        if (current_token().kind == TokenKind::CloseParen) {
             consume_token();
             return func;
         }
@@ -0,0 +1,215 @@
+#pragma once
+
+/**
+ * Byte-run scanners for the CSS tokenizer
+ *
+ * Each scanner returns how many bytes at the start of [begin, end) belong to
+ * one run (a name, whitespace, digits, plain string or url contents), so the
+ * tokenizer only steps byte by byte at the run's boundaries. With SSE2 the
+ * runs are classified 16 bytes at a time; the tail and other targets use the
+ * byte class table. Neither path reads past end.
+ */
+
+#include "lithium/core/types.hpp"
+#include <array>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lithium::css::detail {
+
+// ============================================================================
+// Byte classes
+// ============================================================================
+
+enum ByteClass : u8 {
+    NAME_START = 1 << 0,  // a-z, A-Z, _, and every non-ASCII byte
+    NAME = 1 << 1,        // NAME_START, digits and -
+    DIGIT = 1 << 2,
+    HEX_DIGIT = 1 << 3,
+    WHITESPACE = 1 << 4,  // space, \t, \n, \r, \f
+    URL_STOP = 1 << 5,    // bytes that end the plain part of an unquoted url
+};
+
+inline constexpr std::array<u8, 256> BYTE_CLASSES = [] {
+    std::array<u8, 256> classes{};
+    for (usize c = 0; c < 256; ++c) {
+        u8 bits = 0;
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool digit = c >= '0' && c <= '9';
+        if (alpha || c == '_' || c >= 0x80) {
+            bits |= NAME_START | NAME;
+        }
+        if (digit || c == '-') {
+            bits |= NAME;
+        }
+        if (digit) {
+            bits |= DIGIT | HEX_DIGIT;
+        }
+        if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
+            bits |= HEX_DIGIT;
+        }
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f') {
+            bits |= WHITESPACE;
+        }
+        if (c <= ' ' || c == 0x7F || c == '"' || c == '\'' || c == '(' || c == ')' || c == '\\') {
+            bits |= URL_STOP;
+        }
+        classes[c] = bits;
+    }
+    return classes;
+}();
+
+[[nodiscard]] inline bool has_class(char c, u8 byte_class) {
+    return (BYTE_CLASSES[static_cast<unsigned char>(c)] & byte_class) != 0;
+}
+
+// ============================================================================
+// Run scanners
+// ============================================================================
+
+#if defined(__SSE2__)
+
+namespace simd {
+
+[[nodiscard]] inline __m128i in_range(__m128i bytes, char low, char high) {
+    // Signed compares: only meaningful for ASCII ranges, non-ASCII bytes are negative
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(static_cast<char>(low - 1))),
+                         _mm_cmplt_epi8(bytes, _mm_set1_epi8(static_cast<char>(high + 1))));
+}
+
+[[nodiscard]] inline __m128i equals(__m128i bytes, char c) {
+    return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(c));
+}
+
+[[nodiscard]] inline __m128i name_mask(__m128i bytes) {
+    __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+    __m128i mask = _mm_or_si128(in_range(folded, 'a', 'z'), in_range(bytes, '0', '9'));
+    mask = _mm_or_si128(mask, _mm_or_si128(equals(bytes, '_'), equals(bytes, '-')));
+    // Non-ASCII bytes have the sign bit set
+    return _mm_or_si128(mask, _mm_cmplt_epi8(bytes, _mm_setzero_si128()));
+}
+
+[[nodiscard]] inline __m128i whitespace_mask(__m128i bytes) {
+    __m128i mask = _mm_or_si128(equals(bytes, ' '), equals(bytes, '\n'));
+    mask = _mm_or_si128(mask, _mm_or_si128(equals(bytes, '\t'), equals(bytes, '\r')));
+    return _mm_or_si128(mask, equals(bytes, '\f'));
+}
+
+[[nodiscard]] inline __m128i url_stop_mask(__m128i bytes) {
+    // Control characters and space (but not the negative non-ASCII bytes), DEL,
+    // quotes, parentheses and backslash
+    __m128i mask = in_range(bytes, 0, ' ');
+    mask = _mm_or_si128(mask, _mm_or_si128(equals(bytes, 0x7F), equals(bytes, '\\')));
+    mask = _mm_or_si128(mask, _mm_or_si128(equals(bytes, '"'), equals(bytes, '\'')));
+    return _mm_or_si128(mask, _mm_or_si128(equals(bytes, '('), equals(bytes, ')')));
+}
+
+// Scans whole 16-byte blocks until one holds a byte whose mask bit is set
+// (stop_on_match) or clear, and returns that byte's offset; when no block
+// breaks the run, returns where the fewer than 16 remaining bytes start
+template<typename Mask>
+[[nodiscard]] inline usize run_length(const char* begin, const char* end, Mask mask_of, bool stop_on_match) {
+    const char* p = begin;
+    while (end - p >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto bits = static_cast<u32>(_mm_movemask_epi8(mask_of(bytes)));
+        if (!stop_on_match) {
+            bits = ~bits & 0xFFFF;
+        }
+        if (bits != 0) {
+            return static_cast<usize>(p - begin) + static_cast<usize>(__builtin_ctz(bits));
+        }
+        p += 16;
+    }
+    return static_cast<usize>(p - begin);
+}
+
+} // namespace simd
+
+#endif
+
+// Scalar loop over the byte class table, for the tail and non-SSE2 targets
+[[nodiscard]] inline usize class_run(const char* begin, const char* end, u8 byte_class, bool stop_on_match) {
+    const char* p = begin;
+    while (p < end && has_class(*p, byte_class) != stop_on_match) {
+        ++p;
+    }
+    return static_cast<usize>(p - begin);
+}
+
+// Name code points (escapes end the run; the tokenizer decodes them)
+[[nodiscard]] inline usize name_run(const char* begin, const char* end) {
+    usize length = 0;
+#if defined(__SSE2__)
+    length = simd::run_length(begin, end, simd::name_mask, false);
+#endif
+    return length + class_run(begin + length, end, NAME, false);
+}
+
+[[nodiscard]] inline usize whitespace_run(const char* begin, const char* end) {
+    // Most gaps between tokens are zero or one byte
+    if (begin == end || !has_class(*begin, WHITESPACE)) {
+        return 0;
+    }
+    usize length = 0;
+#if defined(__SSE2__)
+    length = simd::run_length(begin, end, simd::whitespace_mask, false);
+#endif
+    return length + class_run(begin + length, end, WHITESPACE, false);
+}
+
+[[nodiscard]] inline usize digit_run(const char* begin, const char* end) {
+    return class_run(begin, end, DIGIT, false);
+}
+
+// Bytes of a quoted string up to its closing quote, a backslash or a newline
+[[nodiscard]] inline usize string_run(const char* begin, const char* end, char quote) {
+    usize length = 0;
+#if defined(__SSE2__)
+    auto mask_of = [quote](__m128i bytes) {
+        return _mm_or_si128(simd::equals(bytes, quote),
+                            _mm_or_si128(simd::equals(bytes, '\\'), simd::equals(bytes, '\n')));
+    };
+    length = simd::run_length(begin, end, mask_of, true);
+#endif
+    // Picks up after the wide scan, which stops on a match or at the tail
+    const char* p = begin + length;
+    while (p < end && *p != quote && *p != '\\' && *p != '\n') {
+        ++p;
+    }
+    return static_cast<usize>(p - begin);
+}
+
+// Bytes of an unquoted url up to the first byte that ends or escapes it
+[[nodiscard]] inline usize url_run(const char* begin, const char* end) {
+    usize length = 0;
+#if defined(__SSE2__)
+    length = simd::run_length(begin, end, simd::url_stop_mask, true);
+#endif
+    return length + class_run(begin + length, end, URL_STOP, true);
+}
+
+// Offset of the "*/" that closes a comment whose body starts at begin, or
+// the length of the input when the comment is unterminated
+[[nodiscard]] inline usize comment_body_length(const char* begin, const char* end) {
+    const char* p = begin;
+    while (p < end) {
+#if defined(__SSE2__)
+        p += simd::run_length(p, end, [](__m128i bytes) { return simd::equals(bytes, '*'); }, true);
+#endif
+        while (p < end && *p != '*') {
+            ++p;
+        }
+        if (p + 1 < end && p[1] == '/') {
+            return static_cast<usize>(p - begin);
+        }
+        if (p < end) {
+            ++p;
+        }
+    }
+    return static_cast<usize>(end - begin);
+}
+
+} // namespace lithium::css::detail
@@ -141,7 +141,7 @@ std::optional<SelectorList> SelectorParser::parse_selector_list() {
         if (!selector) {
             return std::nullopt;
         }
-        list.selectors.push_back(*selector);
+        list.selectors.push_back(std::move(*selector));
 
         skip_whitespace();
         if (!at_end() && peek() == ',') {
@@ -169,12 +169,12 @@ std::optional<ComplexSelector> SelectorParser::parse_complex_selector() {
     }
 
     ComplexSelectorPart part;
-    part.compound = *compound;
+    part.compound = std::move(*compound);
 
     while (true) {
         skip_whitespace();
         if (at_end() || peek() == ',') {
-            selector.parts.push_back(part);
+            selector.parts.push_back(std::move(part));
             break;
         }
 
@@ -198,12 +198,12 @@ std::optional<ComplexSelector> SelectorParser::parse_complex_selector() {
             // Descendant combinator (whitespace)
             combinator = Combinator::Descendant;
         } else {
-            selector.parts.push_back(part);
+            selector.parts.push_back(std::move(part));
             break;
         }
 
         part.combinator = combinator;
-        selector.parts.push_back(part);
+        selector.parts.push_back(std::move(part));
 
         // Parse next compound
         compound = parse_compound_selector();
@@ -216,7 +216,7 @@ std::optional<ComplexSelector> SelectorParser::parse_complex_selector() {
         }
 
         part = ComplexSelectorPart();
-        part.compound = *compound;
+        part.compound = std::move(*compound);
     }
 
     if (selector.parts.empty()) {
@@ -224,6 +224,7 @@ std::optional<ComplexSelector> SelectorParser::parse_complex_selector() {
         return std::nullopt;
     }
 
+    selector.compiled = CompiledSelector::compile(selector);
     return selector;
 }
 
@@ -235,7 +236,7 @@ std::optional<CompoundSelector> SelectorParser::parse_compound_selector() {
         if (!simple) {
             break;
         }
-        selector.selectors.push_back(*simple);
+        selector.selectors.push_back(std::move(*simple));
     }
 
     if (selector.selectors.empty()) {
@@ -502,80 +503,11 @@ bool SelectorMatcher::matches(const SelectorList& selectors, const dom::Element&
 }
 
 bool SelectorMatcher::matches(const ComplexSelector& selector, const dom::Element& element) {
-    if (selector.parts.empty()) return false;
-
-    // Start from the last part (subject)
-    const dom::Element* current = &element;
-
-    for (auto it = selector.parts.rbegin(); it != selector.parts.rend(); ++it) {
-        if (!current) return false;
-
-        if (!matches(it->compound, *current)) {
-            return false;
-        }
-
-        // Move to next part based on combinator
-        if (std::next(it) != selector.parts.rend()) {
-            auto combinator = it->combinator;
-            if (!combinator) {
-                // This is the first part (rightmost), continue
-                ++it;
-                if (it == selector.parts.rend()) break;
-                combinator = std::prev(it)->combinator;
-            }
-
-            switch (*combinator) {
-                case Combinator::Descendant: {
-                    // Any ancestor must match
-                    const dom::Element* ancestor = current->parent_node() ?
-                        current->parent_node()->as_element() : nullptr;
-                    bool found = false;
-                    while (ancestor) {
-                        if (matches(std::next(it)->compound, *ancestor)) {
-                            current = ancestor;
-                            found = true;
-                            break;
-                        }
-                        ancestor = ancestor->parent_node() ?
-                            ancestor->parent_node()->as_element() : nullptr;
-                    }
-                    if (!found) return false;
-                    break;
-                }
-                case Combinator::Child: {
-                    // Direct parent must match
-                    if (!current->parent_node() || !current->parent_node()->is_element()) {
-                        return false;
-                    }
-                    current = current->parent_node()->as_element();
-                    break;
-                }
-                case Combinator::NextSibling: {
-                    // Previous sibling must match
-                    current = current->previous_element_sibling();
-                    if (!current) return false;
-                    break;
-                }
-                case Combinator::SubsequentSibling: {
-                    // Any previous sibling must match
-                    const dom::Element* sibling = current->previous_element_sibling();
-                    bool found = false;
-                    while (sibling) {
-                        if (matches(std::next(it)->compound, *sibling)) {
-                            current = sibling;
-                            found = true;
-                            break;
-                        }
-                        sibling = sibling->previous_element_sibling();
-                    }
-                    if (!found) return false;
-                    break;
-                }
-            }
-        }
+    if (!selector.compiled.empty()) {
+        return selector.compiled.matches(element);
     }
-
-    return true;
+    // Built by hand rather than parsed
+    return CompiledSelector::compile(selector).matches(element);
 }
 
 bool SelectorMatcher::matches(const CompoundSelector& selector, const dom::Element& element) {
@@ -594,12 +526,11 @@ bool SelectorMatcher::matches(const SimpleSelector& selector, const dom::Element
         if constexpr (std::is_same_v<T, UniversalSelector>) {
             return true;
         } else if constexpr (std::is_same_v<T, TypeSelector>) {
-            return element.local_name() == sel.tag_name.to_lowercase();
+            return element.local_name_atom() == sel.local_name;
         } else if constexpr (std::is_same_v<T, IdSelector>) {
             return element.id() == sel.id;
         } else if constexpr (std::is_same_v<T, ClassSelector>) {
-            auto classes = element.class_list();
-            return std::find(classes.begin(), classes.end(), sel.class_name) != classes.end();
+            return element.has_class(sel.class_name.view());
         } else if constexpr (std::is_same_v<T, AttributeSelector>) {
             auto attr = element.get_attribute(sel.attribute);
             if (!attr) {
@@ -678,46 +609,436 @@ bool SelectorMatcher::matches(const SimpleSelector& selector, const dom::Element
     }, selector);
 }
 
+namespace {
+
+// Programs for every selector of a list, compiling any the parser did not
+std::vector<CompiledSelector> compile_all(const SelectorList& selectors) {
+    std::vector<CompiledSelector> programs;
+    programs.reserve(selectors.selectors.size());
+    for (const auto& selector : selectors.selectors) {
+        programs.push_back(selector.compiled.empty() ? CompiledSelector::compile(selector) : selector.compiled);
+    }
+    return programs;
+}
+
+bool matches_any(const std::vector<CompiledSelector>& programs, const dom::Element& element) {
+    return std::any_of(programs.begin(), programs.end(),
+                       [&element](const CompiledSelector& program) { return program.matches(element); });
+}
+
+// Descendant elements of `root` in tree order, until `visit` returns false
+template<typename Visit>
+void for_each_descendant_element(const dom::Element& root, Visit&& visit) {
+    const dom::Node* node = root.first_child();
+    while (node) {
+        if (node->is_element()) {
+            if (!visit(*node->as_element())) {
+                return;
+            }
+            if (node->first_child()) {
+                node = node->first_child();
+                continue;
+            }
+        }
+        while (node != &root && !node->next_sibling()) {
+            node = node->parent_node();
+        }
+        if (node == &root) {
+            return;
+        }
+        node = node->next_sibling();
+    }
+}
+
+} // namespace
+
 dom::Element* SelectorMatcher::query_selector(
     const SelectorList& selectors, const dom::Element& root)
 {
-    std::function<dom::Element*(const dom::Element&)> find = [&](const dom::Element& elem) -> dom::Element* {
-        for (const auto& child : elem.child_nodes()) {
-            if (child->is_element()) {
-                auto* el = child->as_element();
-                if (matches(selectors, *el)) {
-                    return el;
-                }
-                if (auto* found = find(*el)) {
-                    return found;
-                }
-            }
+    auto programs = compile_all(selectors);
+    dom::Element* found = nullptr;
+    for_each_descendant_element(root, [&](const dom::Element& element) {
+        if (matches_any(programs, element)) {
+            found = const_cast<dom::Element*>(&element);
+            return false;
         }
-        return nullptr;
-    };
-
-    return find(root);
+        return true;
+    });
+    return found;
 }
 
 std::vector<dom::Element*> SelectorMatcher::query_selector_all(
     const SelectorList& selectors, const dom::Element& root)
 {
+    auto programs = compile_all(selectors);
     std::vector<dom::Element*> results;
+    for_each_descendant_element(root, [&](const dom::Element& element) {
+        if (matches_any(programs, element)) {
+            results.push_back(const_cast<dom::Element*>(&element));
+        }
+        return true;
+    });
+    return results;
+}
+
+// ============================================================================
+// CompiledSelector implementation
+// ============================================================================
+
+namespace {
+
+char fold_ascii(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// With `fold`, `a` is compared ASCII case-insensitively to a lowercase `b`
+bool equals_folded(std::string_view a, std::string_view b, bool fold) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    if (!fold) {
+        return a == b;
+    }
+    for (usize i = 0; i < a.size(); ++i) {
+        if (fold_ascii(a[i]) != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool contains_folded(std::string_view haystack, std::string_view needle, bool fold) {
+    if (needle.size() > haystack.size()) {
+        return false;
+    }
+    for (usize i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (equals_folded(haystack.substr(i, needle.size()), needle, fold)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CompiledSelector::Op combinator_op(Combinator combinator) {
+    switch (combinator) {
+        case Combinator::Descendant: return CompiledSelector::Op::Descendant;
+        case Combinator::Child: return CompiledSelector::Op::Child;
+        case Combinator::NextSibling: return CompiledSelector::Op::NextSibling;
+        case Combinator::SubsequentSibling: return CompiledSelector::Op::SubsequentSibling;
+    }
+    return CompiledSelector::Op::Descendant;
+}
+
+CompiledSelector::Op pseudo_class_op(const String& name) {
+    auto lower = name.to_lowercase();
+    if (lower == "first-child"_s) return CompiledSelector::Op::FirstChild;
+    if (lower == "last-child"_s) return CompiledSelector::Op::LastChild;
+    if (lower == "only-child"_s) return CompiledSelector::Op::OnlyChild;
+    if (lower == "empty"_s) return CompiledSelector::Op::Empty;
+    if (lower == "root"_s) return CompiledSelector::Op::Root;
+    return CompiledSelector::Op::Never;
+}
+
+} // namespace
+
+u32 CompiledSelector::add_string(String string) {
+    m_strings.push_back(std::move(string));
+    return static_cast<u32>(m_strings.size() - 1);
+}
+
+u32 CompiledSelector::add_atom(Atom atom) {
+    m_atoms.push_back(atom);
+    return static_cast<u32>(m_atoms.size() - 1);
+}
 
-    std::function<void(const dom::Element&)> collect = [&](const dom::Element& elem) {
-        for (const auto& child : elem.child_nodes()) {
-            if (child->is_element()) {
-                auto* el = child->as_element();
-                if (matches(selectors, *el)) {
-                    results.push_back(el);
+CompiledSelector CompiledSelector::compile(const ComplexSelector& selector) {
+    CompiledSelector program;
+    if (selector.parts.empty()) {
+        return program;  // Matches nothing
+    }
+
+    // parts[i - 1].combinator joins parts[i - 1] to parts[i]
+    for (usize i = selector.parts.size(); i-- > 0;) {
+        for (const auto& simple : selector.parts[i].compound.selectors) {
+            Instruction instruction{Op::Never};
+            if (const auto* type = std::get_if<TypeSelector>(&simple)) {
+                instruction = {Op::Tag, {}, false, program.add_atom(type->local_name)};
+            } else if (std::holds_alternative<UniversalSelector>(simple)) {
+                continue;
+            } else if (const auto* id = std::get_if<IdSelector>(&simple)) {
+                instruction = {Op::Id, {}, false, program.add_string(id->id)};
+            } else if (const auto* cls = std::get_if<ClassSelector>(&simple)) {
+                instruction = {Op::Class, {}, false, program.add_string(cls->class_name)};
+            } else if (const auto* attribute = std::get_if<AttributeSelector>(&simple)) {
+                instruction.op = Op::Attribute;
+                instruction.matcher = attribute->matcher;
+                instruction.case_insensitive = attribute->case_insensitive;
+                instruction.name = program.add_string(attribute->attribute.to_lowercase());
+                instruction.value = program.add_string(
+                    attribute->case_insensitive ? attribute->value.to_lowercase() : attribute->value);
+            } else if (const auto* pseudo = std::get_if<PseudoClassSelector>(&simple)) {
+                instruction.op = pseudo_class_op(pseudo->name);
+            }
+            // Pseudo-elements don't match elements directly: Never
+            program.m_code.push_back(instruction);
+        }
+        if (i > 0) {
+            auto combinator = selector.parts[i - 1].combinator.value_or(Combinator::Descendant);
+            program.m_code.push_back({combinator_op(combinator)});
+        }
+    }
+    program.m_code.push_back({Op::Match});
+    return program;
+}
+
+bool CompiledSelector::matches(const dom::Element& element) const {
+    return !m_code.empty() && matches_from(0, &element);
+}
+
+namespace {
+
+const dom::Element* parent_element(const dom::Element& element) {
+    auto* parent = element.parent_node();
+    return parent ? parent->as_element() : nullptr;
+}
+
+} // namespace
+
+// Runs the program from `pc` against `element`. Child and next-sibling
+// combinators move to the one candidate and carry on; descendant and
+// subsequent-sibling combinators try every candidate, so a nearer ancestor
+// that fails further left does not hide a farther one.
+bool CompiledSelector::matches_from(usize pc, const dom::Element* element) const {
+    for (;; ++pc) {
+        const auto& instruction = m_code[pc];
+        switch (instruction.op) {
+            case Op::Tag:
+                if (element->local_name_atom() != m_atoms[instruction.name]) return false;
+                break;
+            case Op::Id:
+                if (element->id() != m_strings[instruction.name]) return false;
+                break;
+            case Op::Class:
+                if (!element->has_class(m_strings[instruction.name].view())) return false;
+                break;
+            case Op::Attribute:
+                if (!matches_attribute(instruction, *element)) return false;
+                break;
+            case Op::FirstChild:
+                if (element->previous_element_sibling()) return false;
+                break;
+            case Op::LastChild:
+                if (element->next_element_sibling()) return false;
+                break;
+            case Op::OnlyChild:
+                if (element->previous_element_sibling() || element->next_element_sibling()) return false;
+                break;
+            case Op::Empty:
+                if (element->has_children()) return false;
+                break;
+            case Op::Root:
+                if (!element->parent_node() || !element->parent_node()->is_document()) return false;
+                break;
+            case Op::Never:
+                return false;
+            case Op::Child:
+                element = parent_element(*element);
+                if (!element) return false;
+                break;
+            case Op::NextSibling:
+                element = element->previous_element_sibling();
+                if (!element) return false;
+                break;
+            case Op::Descendant:
+                for (auto* ancestor = parent_element(*element); ancestor; ancestor = parent_element(*ancestor)) {
+                    if (matches_from(pc + 1, ancestor)) return true;
+                }
+                return false;
+            case Op::SubsequentSibling:
+                for (auto* sibling = element->previous_element_sibling(); sibling;
+                     sibling = sibling->previous_element_sibling()) {
+                    if (matches_from(pc + 1, sibling)) return true;
+                }
+                return false;
+            case Op::Match:
+                return true;
+        }
+    }
+}
+
+bool CompiledSelector::matches_attribute(const Instruction& instruction, const dom::Element& element) const {
+    std::string_view name = m_strings[instruction.name].view();
+    const dom::Attribute* found = nullptr;
+    for (const auto& attribute : element.attributes()) {
+        if (equals_folded(attribute.name().view(), name, true)) {
+            found = &attribute;
+            break;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    std::string_view value = found->value.view();
+    std::string_view expected = m_strings[instruction.value].view();
+    bool fold = instruction.case_insensitive;
+    switch (instruction.matcher) {
+        case AttributeSelector::Matcher::Exists:
+            return true;
+        case AttributeSelector::Matcher::Equals:
+            return equals_folded(value, expected, fold);
+        case AttributeSelector::Matcher::Includes: {
+            // Space-separated list contains value
+            usize start = 0;
+            for (usize i = 0; i <= value.size(); ++i) {
+                if (i == value.size() || value[i] == ' ') {
+                    if (i > start && equals_folded(value.substr(start, i - start), expected, fold)) {
+                        return true;
+                    }
+                    start = i + 1;
                 }
-                collect(*el);
             }
+            return false;
         }
+        case AttributeSelector::Matcher::DashMatch:
+            return equals_folded(value, expected, fold) ||
+                   (value.size() > expected.size() && value[expected.size()] == '-' &&
+                    equals_folded(value.substr(0, expected.size()), expected, fold));
+        case AttributeSelector::Matcher::Prefix:
+            return value.size() >= expected.size() &&
+                   equals_folded(value.substr(0, expected.size()), expected, fold);
+        case AttributeSelector::Matcher::Suffix:
+            return value.size() >= expected.size() &&
+                   equals_folded(value.substr(value.size() - expected.size()), expected, fold);
+        case AttributeSelector::Matcher::Substring:
+            return contains_folded(value, expected, fold);
+    }
+    return false;
+}
+
+// ============================================================================
+// AncestorBloomFilter implementation
+// ============================================================================
+
+namespace {
+
+// FNV-1a over a kind byte and the name; never 0, which ends SelectorHashes
+u32 key_hash(char kind, std::string_view name) {
+    u32 hash = 2166136261u;
+    auto mix = [&hash](unsigned char byte) {
+        hash ^= byte;
+        hash *= 16777619u;
     };
+    mix(static_cast<unsigned char>(kind));
+    for (char c : name) {
+        mix(static_cast<unsigned char>(c));
+    }
+    return hash != 0 ? hash : 1;
+}
 
-    collect(root);
-    return results;
+// Two probe positions from one hash, as in the filters of other engines
+constexpr u32 KEY_MASK = (u32{1} << AncestorBloomFilter::KEY_BITS) - 1;
+
+usize first_slot(u32 hash) { return hash & KEY_MASK; }
+usize second_slot(u32 hash) { return (hash >> AncestorBloomFilter::KEY_BITS) & KEY_MASK; }
+
+} // namespace
+
+u32 AncestorBloomFilter::tag_hash(std::string_view lowercase_name) {
+    return key_hash('t', lowercase_name);
+}
+
+u32 AncestorBloomFilter::id_hash(std::string_view id) {
+    return key_hash('#', id);
+}
+
+u32 AncestorBloomFilter::class_hash(std::string_view class_name) {
+    return key_hash('.', class_name);
+}
+
+AncestorBloomFilter::SelectorHashes AncestorBloomFilter::selector_hashes(const ComplexSelector& selector) {
+    SelectorHashes hashes{};
+    usize count = 0;
+    auto add_hash = [&](u32 hash) {
+        if (count < MAX_SELECTOR_HASHES) {
+            hashes[count++] = hash;
+        }
+    };
+
+    // parts[i] is an ancestor of the subject exactly when the combinator on
+    // its right is descendant or child (a parent of a sibling of an ancestor
+    // is still an ancestor). Nearest compounds first: they reject most.
+    for (usize i = selector.parts.size(); i-- > 1;) {
+        const auto& part = selector.parts[i - 1];
+        auto combinator = part.combinator.value_or(Combinator::Descendant);
+        if (combinator != Combinator::Descendant && combinator != Combinator::Child) {
+            continue;
+        }
+        for (const auto& simple : part.compound.selectors) {
+            if (const auto* id = std::get_if<IdSelector>(&simple)) {
+                add_hash(id_hash(id->id.view()));
+            } else if (const auto* cls = std::get_if<ClassSelector>(&simple)) {
+                add_hash(class_hash(cls->class_name.view()));
+            } else if (const auto* type = std::get_if<TypeSelector>(&simple)) {
+                add_hash(tag_hash(type->local_name.view()));
+            }
+        }
+    }
+    return hashes;
+}
+
+void AncestorBloomFilter::push_element(const dom::Element& element) {
+    m_frames.push_back(m_hashes.size());
+    m_hashes.push_back(tag_hash(element.local_name().view()));
+    if (const auto& id = element.id(); !id.empty()) {
+        m_hashes.push_back(id_hash(id.view()));
+    }
+    for (const auto& class_name : element.class_list()) {
+        m_hashes.push_back(class_hash(class_name.view()));
+    }
+    for (usize i = m_frames.back(); i < m_hashes.size(); ++i) {
+        add(m_hashes[i]);
+    }
+}
+
+void AncestorBloomFilter::pop_element() {
+    if (m_frames.empty()) return;
+    for (usize i = m_frames.back(); i < m_hashes.size(); ++i) {
+        remove(m_hashes[i]);
+    }
+    m_hashes.resize(m_frames.back());
+    m_frames.pop_back();
+}
+
+void AncestorBloomFilter::clear() {
+    m_counters.fill(0);
+    m_hashes.clear();
+    m_frames.clear();
+}
+
+bool AncestorBloomFilter::may_contain(u32 hash) const {
+    return m_counters[first_slot(hash)] != 0 && m_counters[second_slot(hash)] != 0;
+}
+
+bool AncestorBloomFilter::may_contain_all(const SelectorHashes& hashes) const {
+    for (u32 hash : hashes) {
+        if (hash == 0) break;
+        if (!may_contain(hash)) return false;
+    }
+    return true;
+}
+
+// Counters saturate and then stay put: a stuck slot only adds false positives
+void AncestorBloomFilter::add(u32 hash) {
+    for (usize slot : {first_slot(hash), second_slot(hash)}) {
+        if (m_counters[slot] != 0xFF) ++m_counters[slot];
+    }
+}
+
+void AncestorBloomFilter::remove(u32 hash) {
+    for (usize slot : {first_slot(hash), second_slot(hash)}) {
+        if (m_counters[slot] != 0xFF) --m_counters[slot];
+    }
 }
 
 } // namespace lithium::css
@@ -5,22 +5,172 @@
 #include "lithium/css/style_resolver.hpp"
 #include "lithium/dom/element.hpp"
 #include <algorithm>
-#include <unordered_set>
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 namespace lithium::css {
 
+// ============================================================================
+// RuleSet implementation
+// ============================================================================
+
+void RuleSet::add_stylesheet(const Stylesheet& stylesheet, CascadeOrigin origin) {
+    add_stylesheet(make_ref<const PreparedStylesheet>(stylesheet), origin);
+}
+
+void RuleSet::add_stylesheet(RefPtr<const PreparedStylesheet> stylesheet, CascadeOrigin origin) {
+    const auto& style_rules = stylesheet->style_rules();
+    const auto& declarations = stylesheet->declarations();
+    u32 first_rule = m_rule_count;
+    for (const auto& prepared : stylesheet->selectors()) {
+        const auto* rule = style_rules[prepared.rule];
+        add_selector({rule, &declarations[prepared.rule], &rule->selectors.selectors[prepared.selector_index],
+                      prepared.specificity, origin, first_rule + prepared.rule, prepared.selector_index,
+                      prepared.ancestor_hashes},
+                     prepared);
+    }
+    m_rule_count += static_cast<u32>(style_rules.size());
+    m_stylesheets.push_back(std::move(stylesheet));
+}
+
+void RuleSet::add_selector(const RuleSetEntry& entry, const PreparedSelector& prepared) {
+    m_has_sibling_rules = m_has_sibling_rules || prepared.depends_on_siblings;
+    add_invalidation_features(*entry.selector);
+
+    switch (prepared.bucket) {
+        case RuleBucket::Id:
+            m_id_rules[prepared.key].push_back(entry);
+            break;
+        case RuleBucket::Class:
+            m_class_rules[prepared.key].push_back(entry);
+            break;
+        case RuleBucket::Attribute:
+            m_attribute_rules[prepared.key].push_back(entry);
+            break;
+        case RuleBucket::Tag:
+            m_tag_rules[Atom(prepared.key)].push_back(entry);
+            break;
+        case RuleBucket::Universal:
+            m_universal_rules.push_back(entry);
+            break;
+    }
+    ++m_size;
+}
+
+// A compound in the subject position, or left of a descendant or child
+// combinator, can change how the element carrying it and its descendants
+// match; left of a sibling combinator, how its later siblings and their
+// descendants match
+void RuleSet::add_invalidation_features(const ComplexSelector& selector) {
+    for (const auto& part : selector.parts) {
+        InvalidationSet scope;
+        if (part.combinator == Combinator::NextSibling || part.combinator == Combinator::SubsequentSibling) {
+            scope.following_siblings = true;
+        } else {
+            scope.subtree = true;
+        }
+        for (const auto& simple : part.compound.selectors) {
+            if (auto* sel = std::get_if<IdSelector>(&simple)) {
+                m_id_invalidation[sel->id] |= scope;
+            } else if (auto* sel = std::get_if<ClassSelector>(&simple)) {
+                m_class_invalidation[sel->class_name] |= scope;
+            } else if (auto* sel = std::get_if<AttributeSelector>(&simple)) {
+                m_attribute_invalidation[sel->attribute.to_lowercase()] |= scope;
+            }
+        }
+    }
+}
+
+namespace {
+
+InvalidationSet find_invalidation(const std::unordered_map<String, InvalidationSet>& sets, const String& key) {
+    auto it = sets.find(key);
+    return it != sets.end() ? it->second : InvalidationSet{};
+}
+
+} // namespace
+
+InvalidationSet RuleSet::id_invalidation(const String& id) const {
+    return find_invalidation(m_id_invalidation, id);
+}
+
+InvalidationSet RuleSet::class_invalidation(const String& class_name) const {
+    return find_invalidation(m_class_invalidation, class_name);
+}
+
+InvalidationSet RuleSet::attribute_invalidation(const String& name) const {
+    return find_invalidation(m_attribute_invalidation, name);
+}
+
+void RuleSet::clear() {
+    m_id_rules.clear();
+    m_class_rules.clear();
+    m_attribute_rules.clear();
+    m_tag_rules.clear();
+    m_universal_rules.clear();
+    m_id_invalidation.clear();
+    m_class_invalidation.clear();
+    m_attribute_invalidation.clear();
+    m_stylesheets.clear();
+    m_rule_count = 0;
+    m_size = 0;
+    m_has_sibling_rules = false;
+}
+
+void RuleSet::collect_candidates(const dom::Element& element, std::vector<const RuleSetEntry*>& out) const {
+    auto append = [&out](const std::vector<RuleSetEntry>& entries) {
+        for (const auto& entry : entries) {
+            out.push_back(&entry);
+        }
+    };
+    auto append_bucket = [&append](const auto& buckets, const auto& key) {
+        auto it = buckets.find(key);
+        if (it != buckets.end()) {
+            append(it->second);
+        }
+    };
+
+    if (!m_id_rules.empty()) {
+        append_bucket(m_id_rules, element.id());
+    }
+    if (!m_class_rules.empty()) {
+        for (const auto& class_name : element.class_list()) {
+            append_bucket(m_class_rules, class_name);
+        }
+    }
+    if (!m_attribute_rules.empty()) {
+        for (const auto& attr : element.attributes()) {
+            // Names set without a namespace are interned with their lowercase form
+            if (attr.namespace_uri().empty()) {
+                append_bucket(m_attribute_rules, attr.local_name());
+            } else {
+                append_bucket(m_attribute_rules, attr.name().to_lowercase());
+            }
+        }
+    }
+    append_bucket(m_tag_rules, element.local_name_atom());
+    append(m_universal_rules);
+}
+
 // ============================================================================
 // StyleResolver implementation
 // ============================================================================
 
 StyleResolver::StyleResolver() {
     // Add default user-agent stylesheet
-    add_user_agent_stylesheet(default_user_agent_stylesheet());
+    add_stylesheet(default_prepared_user_agent_stylesheet(), CascadeOrigin::UserAgent);
 }
 
 void StyleResolver::add_stylesheet(const Stylesheet& stylesheet, CascadeOrigin origin) {
-    m_stylesheets.push_back({stylesheet, origin});
+    add_stylesheet(make_ref<const PreparedStylesheet>(stylesheet), origin);
+}
+
+void StyleResolver::add_stylesheet(RefPtr<const PreparedStylesheet> stylesheet, CascadeOrigin origin) {
+    m_rule_set.add_stylesheet(std::move(stylesheet), origin);
     invalidate_all();
 }
 
@@ -33,92 +183,563 @@ void StyleResolver::add_user_stylesheet(const Stylesheet& stylesheet) {
 }
 
 void StyleResolver::clear_stylesheets() {
-    m_stylesheets.clear();
+    m_rule_set.clear();
     invalidate_all();
     // Re-add user-agent stylesheet
-    add_user_agent_stylesheet(default_user_agent_stylesheet());
+    add_stylesheet(default_prepared_user_agent_stylesheet(), CascadeOrigin::UserAgent);
 }
 
+// ============================================================================
+// Document walks
+// ============================================================================
+
+// One thread's state while resolving a document: the ancestor filter, the
+// style sharing candidates, counters and scratch space. Each worker of a
+// parallel walk has its own, so nothing here is shared between threads.
+struct StyleResolver::WalkState {
+    AncestorBloomFilter ancestor_filter;
+    std::vector<const dom::Element*> filter_path;  // Elements in the filter, root first
+
+    // Recently resolved elements, most recent at next_sharing_candidate - 1
+    struct SharingCandidate {
+        const dom::Element* element{nullptr};
+        const SharedComputedValue* parent_style{nullptr};
+        RefPtr<const SharedComputedValue> style;
+    };
+    static constexpr usize SHARING_CANDIDATES = 8;
+    std::array<SharingCandidate, SHARING_CANDIDATES> sharing_candidates;
+    usize next_sharing_candidate{0};
+
+    AncestorFilterStats filter_stats;
+    StyleSharingStats sharing_stats;
+
+    std::vector<const RuleSetEntry*> candidates;  // Scratch for collect_matching_rules
+
+    // Styles resolved by a parallel worker, moved into the cache afterwards
+    std::vector<std::pair<const dom::Element*, RefPtr<const SharedComputedValue>>> results;
+};
+
 ComputedValue StyleResolver::resolve(const dom::Element& element) const {
+    return resolve_shared(element)->value();
+}
+
+RefPtr<const SharedComputedValue> StyleResolver::resolve_shared(const dom::Element& element) const {
     // Check cache first
-    auto cached = get_computed_style(element);
-    if (cached) {
-        std::cout << "  resolve: returning CACHED style for '" << element.tag_name().c_str() << "'" << std::endl;
-        return *cached;
+    auto it = m_style_cache.find(&element);
+    if (it != m_style_cache.end()) {
+        return it->second;
     }
 
-    std::cout << "  resolve: COMPUTING style for '" << element.tag_name().c_str() << "'" << std::endl;
+    const SharedComputedValue* parent_style = nullptr;
+    if (auto* parent = element.parent_node(); parent && parent->is_element()) {
+        auto parent_it = m_style_cache.find(parent->as_element());
+        if (parent_it != m_style_cache.end()) {
+            parent_style = parent_it->second.get();
+        }
+    }
+
+    auto style = compute_style(element, parent_style, nullptr);
+
+    // Cache result
+    m_style_cache[&element] = style;
+
+    return style;
+}
+
+RefPtr<const SharedComputedValue> StyleResolver::compute_style(
+    const dom::Element& element, const SharedComputedValue* parent_style, WalkState* walk) const
+{
+    bool shareable = walk && parent_style && can_share_style(element);
+    if (shareable) {
+        if (auto shared = find_shared_style(element, parent_style, *walk)) {
+            ++walk->sharing_stats.shared;
+            return shared;
+        }
+    }
 
     // Collect matching rules
-    auto rules = collect_matching_rules(element);
+    auto rules = collect_matching_rules(element, walk);
 
     // Sort by cascade order
     sort_by_cascade(rules);
 
     // Apply cascade
-    auto style = apply_cascade(rules, element);
+    auto style = make_ref<const SharedComputedValue>(
+        apply_cascade(rules, element, parent_style ? &parent_style->value() : nullptr));
 
-    // Cache result
-    m_style_cache[&element] = style;
+    if (walk) {
+        ++walk->sharing_stats.resolved;
+    }
+    if (shareable) {
+        walk->sharing_candidates[walk->next_sharing_candidate] = {&element, parent_style, style};
+        walk->next_sharing_candidate = (walk->next_sharing_candidate + 1) % WalkState::SHARING_CANDIDATES;
+    }
 
     return style;
 }
 
+namespace {
+
+// ASCII case-insensitive, without the allocations of Element::has_attribute
+bool has_attribute_named(const dom::Element& element, std::string_view lowercase_name) {
+    for (const auto& attr : element.attributes()) {
+        auto name = attr.name().view();
+        if (name.size() == lowercase_name.size() &&
+            std::equal(name.begin(), name.end(), lowercase_name.begin(), [](char a, char b) {
+                return (a >= 'A' && a <= 'Z' ? static_cast<char>(a - 'A' + 'a') : a) == b;
+            })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const dom::Element* parent_element(const dom::Element& element) {
+    auto* parent = element.parent_node();
+    return parent && parent->is_element() ? parent->as_element() : nullptr;
+}
+
+// Elements displayed as blocks before any stylesheet applies
+bool is_default_block(Atom tag) {
+    switch (static_cast<AtomId>(tag.id())) {
+        case AtomId::div: case AtomId::p: case AtomId::h1: case AtomId::h2: case AtomId::h3:
+        case AtomId::h4: case AtomId::h5: case AtomId::h6: case AtomId::ul: case AtomId::ol:
+        case AtomId::li: case AtomId::table: case AtomId::form: case AtomId::header:
+        case AtomId::footer: case AtomId::main: case AtomId::section: case AtomId::article:
+        case AtomId::nav: case AtomId::aside: case AtomId::pre:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+bool StyleResolver::can_share_style(const dom::Element& element) const {
+    return !m_rule_set.has_sibling_rules() && !has_attribute_named(element, "id") &&
+           !has_attribute_named(element, "style");
+}
+
+RefPtr<const SharedComputedValue> StyleResolver::find_shared_style(
+    const dom::Element& element, const SharedComputedValue* parent_style, const WalkState& walk) const
+{
+    const auto& attributes = element.attributes();
+    for (const auto& candidate : walk.sharing_candidates) {
+        if (!candidate.element || candidate.parent_style != parent_style) {
+            continue;
+        }
+        const auto& other = *candidate.element;
+        if (other.local_name_atom() != element.local_name_atom() || other.namespace_uri() != element.namespace_uri()) {
+            continue;
+        }
+        const auto& other_attributes = other.attributes();
+        bool same_attributes = other_attributes.size() == attributes.size() &&
+            std::equal(attributes.begin(), attributes.end(), other_attributes.begin(),
+                       [](const dom::Attribute& a, const dom::Attribute& b) {
+                           return (a.qualified_name == b.qualified_name || a.name() == b.name()) &&
+                                  a.value == b.value;
+                       });
+        if (same_attributes) {
+            return candidate.style;
+        }
+    }
+    return {};
+}
+
+void StyleResolver::set_thread_count(usize count) {
+    m_thread_count = count != 0 ? count : std::max(1u, std::thread::hardware_concurrency());
+}
+
 void StyleResolver::resolve_document(dom::Document& document) {
     auto* root = document.document_element();
     if (!root) return;
 
-    // Simple recursive resolution
-    std::function<void(dom::Element&)> resolve_recursive = [&](dom::Element& elem) {
-        (void)resolve(elem);
-        for (auto* child = elem.first_child(); child; child = child->next_sibling()) {
+    if (!m_full_restyle && m_resolved_document == &document) {
+        resolve_restyle_roots(*root);
+        return;
+    }
+    m_full_restyle = false;
+    m_resolved_document = &document;
+    m_restyle_roots.clear();
+
+    if (m_thread_count > 1) {
+        resolve_document_parallel(*root);
+        return;
+    }
+
+    WalkState walk;
+    resolve_subtree(*root, nullptr, walk);
+    add_walk_stats(walk);
+}
+
+// Pre-order walk; the filter holds exactly the ancestors of the element
+// being resolved
+void StyleResolver::resolve_subtree(const dom::Element& element, const SharedComputedValue* parent_style,
+                                    WalkState& walk) {
+    RefPtr<const SharedComputedValue> style;
+    if (auto it = m_style_cache.find(&element); it != m_style_cache.end()) {
+        style = it->second;
+    } else {
+        style = compute_style(element, parent_style, &walk);
+        m_style_cache[&element] = style;
+    }
+
+    walk.ancestor_filter.push_element(element);
+    for (auto* child = element.first_child(); child; child = child->next_sibling()) {
+        if (child->is_element()) {
+            resolve_subtree(*child->as_element(), style.get(), walk);
+        }
+    }
+    walk.ancestor_filter.pop_element();
+}
+
+// Restyles the subtrees invalidated since the last walk, on the calling
+// thread (they are usually small). Each starts at the outermost element on
+// the root's ancestor path without a cached style, so its parent's style is
+// current, with the ancestors above it pushed into the filter.
+void StyleResolver::resolve_restyle_roots(const dom::Element& document_element) {
+    auto roots = std::move(m_restyle_roots);
+    m_restyle_roots.clear();
+
+    WalkState walk;
+    std::vector<const dom::Element*> path;  // Root first
+    for (const auto& root : roots) {
+        path.clear();
+        for (const dom::Node* node = root.get(); node && node->is_element(); node = node->parent_node()) {
+            path.push_back(node->as_element());
+        }
+        if (path.back() != &document_element) {
+            continue;  // Removed from the document since
+        }
+
+        usize start = path.size();
+        while (start > 1 && m_style_cache.count(path[start - 1])) {
+            --start;
+        }
+        --start;
+        const auto& element = *path[start];
+
+        const SharedComputedValue* parent_style = nullptr;
+        if (start + 1 < path.size()) {
+            parent_style = m_style_cache.at(path[start + 1]).get();
+        }
+        walk.ancestor_filter.clear();
+        for (usize i = path.size(); i > start + 1; --i) {
+            walk.ancestor_filter.push_element(*path[i - 1]);
+        }
+        resolve_subtree(element, parent_style, walk);
+    }
+    add_walk_stats(walk);
+}
+
+namespace {
+
+// An element whose parent's style is ready
+struct StyleTask {
+    const dom::Element* element;
+    const SharedComputedValue* parent_style;
+};
+
+// A worker's tasks. The owner pushes and pops at the back, so it walks its
+// subtree depth-first and its ancestor filter stays warm; thieves take the
+// oldest task from the front, which is the highest (largest) subtree.
+class StyleTaskQueue {
+public:
+    void push(const StyleTask& task) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(task);
+    }
+
+    std::optional<StyleTask> pop() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tasks.empty()) return std::nullopt;
+        auto task = m_tasks.back();
+        m_tasks.pop_back();
+        return task;
+    }
+
+    std::optional<StyleTask> steal() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tasks.empty()) return std::nullopt;
+        auto task = m_tasks.front();
+        m_tasks.pop_front();
+        return task;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<StyleTask> m_tasks;
+};
+
+// Make the filter hold exactly the ancestors of `element`: pop back to its
+// parent when that is on the current path (the usual depth-first case),
+// otherwise rebuild from the root (after a steal)
+void sync_ancestor_filter(AncestorBloomFilter& filter, std::vector<const dom::Element*>& path,
+                          const dom::Element& element) {
+    const auto* parent = parent_element(element);
+    auto on_path = std::find(path.rbegin(), path.rend(), parent);
+    if (parent && on_path != path.rend()) {
+        while (path.back() != parent) {
+            filter.pop_element();
+            path.pop_back();
+        }
+        return;
+    }
+
+    filter.clear();
+    path.clear();
+    for (const auto* ancestor = parent; ancestor; ancestor = parent_element(*ancestor)) {
+        path.push_back(ancestor);
+    }
+    std::reverse(path.begin(), path.end());
+    for (const auto* ancestor : path) {
+        filter.push_element(*ancestor);
+    }
+}
+
+} // namespace
+
+// Styles are computed in parallel but only read from the cache; each worker
+// keeps its results and they are merged once every worker has finished. A
+// style depends only on the element, its ancestors and its parent's style,
+// so the result is the same as the serial walk whatever the schedule.
+void StyleResolver::resolve_document_parallel(const dom::Element& root) {
+    usize workers = m_thread_count;
+    std::vector<WalkState> walks(workers);
+    std::vector<StyleTaskQueue> queues(workers);
+    std::atomic<usize> pending{1};
+    queues[0].push({&root, nullptr});
+
+    auto process = [&](const StyleTask& task, WalkState& walk, StyleTaskQueue& queue) {
+        const auto& element = *task.element;
+        sync_ancestor_filter(walk.ancestor_filter, walk.filter_path, element);
+
+        RefPtr<const SharedComputedValue> style;
+        if (auto it = m_style_cache.find(&element); it != m_style_cache.end()) {
+            style = it->second;
+        } else {
+            style = compute_style(element, task.parent_style, &walk);
+        }
+        const auto* parent_style = style.get();
+        walk.results.emplace_back(&element, std::move(style));
+
+        walk.ancestor_filter.push_element(element);
+        walk.filter_path.push_back(&element);
+
+        // Last child first, so the owner pops the first child next
+        for (auto* child = element.last_child(); child; child = child->previous_sibling()) {
             if (child->is_element()) {
-                resolve_recursive(*child->as_element());
+                pending.fetch_add(1, std::memory_order_relaxed);
+                queue.push({child->as_element(), parent_style});
             }
         }
     };
 
-    resolve_recursive(*root);
+    auto run = [&](usize index) {
+        auto& walk = walks[index];
+        while (true) {
+            auto task = queues[index].pop();
+            for (usize offset = 1; !task && offset < workers; ++offset) {
+                task = queues[(index + offset) % workers].steal();
+            }
+            if (!task) {
+                if (pending.load(std::memory_order_acquire) == 0) {
+                    return;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            process(*task, walk, queues[index]);
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (usize i = 1; i < workers; ++i) {
+        threads.emplace_back(run, i);
+    }
+    run(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& walk : walks) {
+        for (auto& [element, style] : walk.results) {
+            m_style_cache[element] = std::move(style);
+        }
+        add_walk_stats(walk);
+    }
+}
+
+void StyleResolver::add_walk_stats(const WalkState& walk) {
+    m_ancestor_filter_stats.rejected += walk.filter_stats.rejected;
+    m_ancestor_filter_stats.passed += walk.filter_stats.passed;
+    m_ancestor_filter_stats.false_positives += walk.filter_stats.false_positives;
+    m_style_sharing_stats.shared += walk.sharing_stats.shared;
+    m_style_sharing_stats.resolved += walk.sharing_stats.resolved;
 }
 
 const ComputedValue* StyleResolver::get_computed_style(const dom::Element& element) const {
     auto it = m_style_cache.find(&element);
     if (it != m_style_cache.end()) {
-        return &it->second;
+        return &it->second->value();
     }
     return nullptr;
 }
 
 void StyleResolver::invalidate_element(const dom::Element& element) {
-    m_style_cache.erase(&element);
+    erase_subtree(element);
+    if (!m_full_restyle) {
+        m_restyle_roots.emplace_back(&element);
+    }
 }
 
 void StyleResolver::invalidate_all() {
     m_style_cache.clear();
+    m_restyle_roots.clear();
+    m_full_restyle = true;
 }
 
-std::vector<MatchedRule> StyleResolver::collect_matching_rules(const dom::Element& element) const {
-    std::vector<MatchedRule> matches;
-    u32 source_order = 0;
+void StyleResolver::erase_subtree(const dom::Element& element) {
+    m_style_cache.erase(&element);
+    for (auto* child = element.first_child(); child; child = child->next_sibling()) {
+        if (child->is_element()) {
+            erase_subtree(*child->as_element());
+        }
+    }
+}
 
-    for (const auto& entry : m_stylesheets) {
-        for (const auto& rule : entry.stylesheet.rules) {
-            if (rule.is<StyleRule>()) {
-                const auto& style_rule = rule.get<StyleRule>();
-
-                // Check if any selector matches
-                for (const auto& selector : style_rule.selectors.selectors) {
-                    if (selector.matches(element)) {
-                        MatchedRule matched;
-                        matched.rule = &style_rule;
-                        matched.origin = entry.origin;
-                        matched.specificity = calculate_specificity(selector);
-                        matched.source_order = source_order++;
-                        matches.push_back(matched);
-                        break; // Only add once per rule
-                    }
+void StyleResolver::invalidate_following_siblings(const dom::Node& node) {
+    for (auto* sibling = node.next_sibling(); sibling; sibling = sibling->next_sibling()) {
+        if (sibling->is_element()) {
+            invalidate_element(*sibling->as_element());
+        }
+    }
+}
+
+namespace {
+
+std::vector<String> split_class_names(const std::optional<String>& value) {
+    std::vector<String> classes;
+    if (!value) {
+        return classes;
+    }
+    usize start = 0;
+    for (usize i = 0; i <= value->length(); ++i) {
+        if (i == value->length() || (*value)[i] == ' ' || (*value)[i] == '\t') {
+            if (i > start) {
+                classes.push_back(value->substring(start, i - start));
+            }
+            start = i + 1;
+        }
+    }
+    return classes;
+}
+
+} // namespace
+
+void StyleResolver::invalidate_attribute_change(const dom::Element& element, const String& name,
+                                                const std::optional<String>& old_value) {
+    auto lower_name = name.to_lowercase();
+    auto scope = m_rule_set.attribute_invalidation(lower_name);
+
+    if (lower_name == "class"_s) {
+        // Only the classes added or removed can change what matches
+        auto old_classes = split_class_names(old_value);
+        const auto& new_classes = element.class_list();
+        auto add_missing = [&](const std::vector<String>& from, const std::vector<String>& in) {
+            for (const auto& class_name : from) {
+                if (std::find(in.begin(), in.end(), class_name) == in.end()) {
+                    scope |= m_rule_set.class_invalidation(class_name);
                 }
             }
+        };
+        add_missing(old_classes, new_classes);
+        add_missing(new_classes, old_classes);
+    } else if (lower_name == "id"_s) {
+        auto new_id = element.get_attribute("id"_s);
+        if (old_value != new_id) {
+            if (old_value) {
+                scope |= m_rule_set.id_invalidation(*old_value);
+            }
+            if (new_id) {
+                scope |= m_rule_set.id_invalidation(*new_id);
+            }
+        }
+    }
+
+    // Without a style the element is already due for a restyle, or not in
+    // the document
+    if (scope.subtree && m_style_cache.count(&element)) {
+        invalidate_element(element);
+    }
+    if (scope.following_siblings) {
+        invalidate_following_siblings(element);
+    }
+}
+
+// The inserted subtree has no style yet (or one from where it was before).
+// Sibling-dependent selectors can change for every child of the parent,
+// and :empty for the parent itself.
+void StyleResolver::invalidate_child_inserted(const dom::Node& parent, const dom::Node& child) {
+    if (m_rule_set.has_sibling_rules() && parent.is_element()) {
+        invalidate_element(*parent.as_element());
+    } else if (child.is_element()) {
+        invalidate_element(*child.as_element());
+    }
+}
+
+void StyleResolver::invalidate_child_removed(const dom::Node& parent, const dom::Node& child) {
+    if (child.is_element()) {
+        erase_subtree(*child.as_element());
+    }
+    if (m_rule_set.has_sibling_rules() && parent.is_element()) {
+        invalidate_element(*parent.as_element());
+    }
+}
+
+std::vector<MatchedRule> StyleResolver::collect_matching_rules(const dom::Element& element, WalkState* walk) const {
+    std::vector<const RuleSetEntry*> local_candidates;
+    auto& candidates = walk ? walk->candidates : local_candidates;
+    candidates.clear();
+    m_rule_set.collect_candidates(element, candidates);
+
+    // Visit rules in source order, and each rule's selectors in list order,
+    // as a walk over every stylesheet would
+    std::sort(candidates.begin(), candidates.end(), [](const RuleSetEntry* a, const RuleSetEntry* b) {
+        if (a->rule_index != b->rule_index) {
+            return a->rule_index < b->rule_index;
+        }
+        return a->selector_index < b->selector_index;
+    });
+
+    std::vector<MatchedRule> matches;
+    u32 source_order = 0;
+    const RuleSetEntry* last_matched = nullptr;
+    for (const auto* entry : candidates) {
+        if (last_matched && last_matched->rule_index == entry->rule_index) {
+            continue; // Only add once per rule
+        }
+        bool filtered = walk && entry->ancestor_hashes[0] != 0;
+        if (filtered && !walk->ancestor_filter.may_contain_all(entry->ancestor_hashes)) {
+            ++walk->filter_stats.rejected;
+            continue;
+        }
+        if (filtered) {
+            ++walk->filter_stats.passed;
+        }
+        if (entry->selector->matches(element)) {
+            MatchedRule matched;
+            matched.rule = entry->rule;
+            matched.declarations = entry->declarations;
+            matched.origin = entry->origin;
+            matched.specificity = entry->specificity;
+            matched.source_order = source_order++;
+            matches.push_back(matched);
+            last_matched = entry;
+        } else if (filtered) {
+            ++walk->filter_stats.false_positives;
         }
     }
 
@@ -144,54 +765,26 @@ void StyleResolver::sort_by_cascade(std::vector<MatchedRule>& rules) {
 
 ComputedValue StyleResolver::apply_cascade(
     const std::vector<MatchedRule>& rules,
-    const dom::Element& element) const
+    const dom::Element& element,
+    const ComputedValue* parent_style) const
 {
-    std::cout << "  apply_cascade for '" << element.tag_name().c_str()
-              << "' with " << rules.size() << " matched rules" << std::endl;
-
-    // Step 1: Apply inheritance from parent FIRST (before any rules)
+    // Step 1: Apply inheritance from parent FIRST (before any rules); a
+    // default ComputedValue already holds the initial values
     ComputedValue style;
-    apply_initial_values(style);
-
-    auto* parent = element.parent_node();
-    if (parent && parent->is_element()) {
-        auto parent_style = get_computed_style(*parent->as_element());
-        apply_inheritance(style, parent_style);
-        std::cout << "    Applied inheritance from parent" << std::endl;
-    }
+    apply_inheritance(style, parent_style);
 
     // Step 2: Apply element-specific defaults (like display for headings)
     // This allows UA rules to override these
-    String tag = element.local_name().to_lowercase();
-
     // Default display (can be overridden by UA stylesheet)
-    static const std::unordered_set<std::string> block_elements = {
-        "div", "p", "h1", "h2", "h3", "h4", "h5", "h6",
-        "ul", "ol", "li", "table", "form", "header", "footer",
-        "main", "section", "article", "nav", "aside", "pre"
-    };
-
-    if (block_elements.count(std::string(tag.c_str())) > 0) {
-        style.display = Display::Block;
+    if (is_default_block(element.local_name_atom())) {
+        style.mutable_box().display = Display::Block;
     }
 
     // Step 3: Apply matched rules (UA, user, author) in cascade order
     for (const auto& matched : rules) {
-        std::cout << "    Applying rule with specificity: "
-                  << matched.specificity.a << "." << matched.specificity.b << "." << matched.specificity.c
-                  << " origin=" << static_cast<int>(matched.origin) << std::endl;
-        for (const auto& decl : matched.rule->declarations.declarations) {
-            // Build value string
-            StringBuilder sb;
-            for (const auto& cv : decl.value) {
-                if (auto* preserved = std::get_if<PreservedToken>(&cv)) {
-                    sb.append(preserved->value);
-                }
-            }
-            String value_str = sb.build();
-            std::cout << "      Declaration: " << decl.property.c_str() << "=" << value_str.c_str() << std::endl;
+        for (const auto& decl : *matched.declarations) {
             // Apply declaration to style (this overrides inherited values)
-            (void)ValueParser::apply_property(style, decl.property, value_str);
+            ValueParser::apply_declaration(style, decl);
         }
     }
 
@@ -205,29 +798,15 @@ void StyleResolver::apply_inheritance(ComputedValue& style, const ComputedValue*
     // For now, we'll always inherit these properties before applying rules
     // The rules will override if explicitly set
 
-    // Font properties are inherited
-    style.font_family = parent_style->font_family;
-    style.font_size = parent_style->font_size;
-    style.font_weight = parent_style->font_weight;
-    style.font_style = parent_style->font_style;
-    style.line_height = parent_style->line_height;
-
-    // Color is inherited
-    style.color = parent_style->color;
-
-    // Text alignment is inherited
-    style.text_align = parent_style->text_align;
+    // Font and text properties (color, alignment, ...) are inherited; the
+    // groups are shared with the parent until a rule writes to them
+    style.inherit_from(*parent_style);
 }
 
 void StyleResolver::apply_initial_values(ComputedValue& style) {
-    // Set initial values for properties
-    style.display = Display::Inline;
-    style.position = Position::Static;
-    style.color = Color{0, 0, 0, 255};
-    style.background_color = Color{0, 0, 0, 0}; // transparent
-    style.font_size = Length{16, LengthUnit::Px};
-    style.font_weight = FontWeight::Normal;
-    style.font_style = FontStyle::Normal;
+    // Initial values are the defaults of the shared property groups (inline,
+    // static, black text on transparent, 16px normal font)
+    style = ComputedValue{};
 }
 
 bool StyleResolver::is_inherited_property(const String& property) {
@@ -243,42 +822,36 @@ ComputedValue StyleResolver::default_style_for_element(const dom::Element& eleme
     ComputedValue style;
     apply_initial_values(style);
 
-    String tag = element.local_name().to_lowercase();
+    Atom tag = element.local_name_atom();
 
     // Default display
-    static const std::unordered_set<std::string> block_elements = {
-        "div", "p", "h1", "h2", "h3", "h4", "h5", "h6",
-        "ul", "ol", "li", "table", "form", "header", "footer",
-        "main", "section", "article", "nav", "aside", "pre"
-    };
-
-    if (block_elements.count(std::string(tag.c_str())) > 0) {
-        style.display = Display::Block;
+    if (is_default_block(tag)) {
+        style.mutable_box().display = Display::Block;
     }
 
     // Default font size for headings
-    if (tag == "h1"_s) {
-        style.font_size = Length{32, LengthUnit::Px};
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "h2"_s) {
-        style.font_size = Length{24, LengthUnit::Px};
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "h3"_s) {
-        style.font_size = Length{18.72f, LengthUnit::Px};
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "h4"_s) {
-        style.font_size = Length{16, LengthUnit::Px};
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "h5"_s) {
-        style.font_size = Length{13.28f, LengthUnit::Px};
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "h6"_s) {
-        style.font_size = Length{10.72f, LengthUnit::Px};
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "b"_s || tag == "strong"_s) {
-        style.font_weight = FontWeight::Bold;
-    } else if (tag == "i"_s || tag == "em"_s) {
-        style.font_style = FontStyle::Italic;
+    if (tag == atoms::h1) {
+        style.mutable_font().font_size = Length{32, LengthUnit::Px};
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::h2) {
+        style.mutable_font().font_size = Length{24, LengthUnit::Px};
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::h3) {
+        style.mutable_font().font_size = Length{18.72f, LengthUnit::Px};
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::h4) {
+        style.mutable_font().font_size = Length{16, LengthUnit::Px};
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::h5) {
+        style.mutable_font().font_size = Length{13.28f, LengthUnit::Px};
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::h6) {
+        style.mutable_font().font_size = Length{10.72f, LengthUnit::Px};
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::b || tag == atoms::strong) {
+        style.mutable_font().font_weight = FontWeight::Bold;
+    } else if (tag == atoms::i || tag == atoms::em) {
+        style.mutable_font().font_style = FontStyle::Italic;
     }
 
     return style;
@@ -464,4 +1037,10 @@ input, textarea, select, button {
     return ua_stylesheet;
 }
 
+const RefPtr<const PreparedStylesheet>& default_prepared_user_agent_stylesheet() {
+    static const RefPtr<const PreparedStylesheet> prepared =
+        make_ref<const PreparedStylesheet>(default_user_agent_stylesheet());
+    return prepared;
+}
+
 } // namespace lithium::css
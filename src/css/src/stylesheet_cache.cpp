@@ -0,0 +1,917 @@
+/**
+ * Prepared stylesheets and the stylesheet cache
+ */
+
+#include "lithium/css/stylesheet_cache.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <unordered_set>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LITHIUM_CSS_HAS_MMAP 1
+#endif
+
+namespace lithium::css {
+
+// ============================================================================
+// PreparedStylesheet implementation
+// ============================================================================
+
+namespace {
+
+std::vector<TypedDeclaration> parse_declarations(const DeclarationBlock& block) {
+    std::vector<TypedDeclaration> parsed;
+    for (const auto& decl : block.declarations) {
+        StringBuilder sb;
+        for (const auto& cv : decl.value) {
+            if (auto* preserved = std::get_if<PreservedToken>(&cv)) {
+                sb.append(preserved->value);
+            }
+        }
+        // Unsupported properties and invalid values are dropped here, once
+        (void)ValueParser::parse_declaration(decl.property, sb.build(), parsed);
+    }
+    return parsed;
+}
+
+bool is_structural_pseudo_class(const String& name) {
+    static const std::unordered_set<std::string> structural = {
+        "first-child", "last-child", "only-child", "nth-child", "nth-last-child",
+        "first-of-type", "last-of-type", "only-of-type", "nth-of-type", "nth-last-of-type",
+        "empty"
+    };
+    return structural.count(std::string(name.to_lowercase().c_str())) > 0;
+}
+
+bool depends_on_siblings(const ComplexSelector& selector) {
+    for (const auto& part : selector.parts) {
+        if (part.combinator == Combinator::NextSibling || part.combinator == Combinator::SubsequentSibling) {
+            return true;
+        }
+        for (const auto& simple : part.compound.selectors) {
+            auto* pseudo = std::get_if<PseudoClassSelector>(&simple);
+            if (pseudo && is_structural_pseudo_class(pseudo->name)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// The rightmost compound's id if it has one, else a class, else an
+// attribute name, else the tag name, else the universal bucket
+std::pair<RuleBucket, String> bucket_for(const ComplexSelector& selector) {
+    const IdSelector* id = nullptr;
+    const ClassSelector* class_selector = nullptr;
+    const AttributeSelector* attribute = nullptr;
+    const TypeSelector* type = nullptr;
+    for (const auto& simple : selector.parts.back().compound.selectors) {
+        if (auto* sel = std::get_if<IdSelector>(&simple); sel && !id) {
+            id = sel;
+        } else if (auto* sel = std::get_if<ClassSelector>(&simple); sel && !class_selector) {
+            class_selector = sel;
+        } else if (auto* sel = std::get_if<AttributeSelector>(&simple); sel && !attribute) {
+            attribute = sel;
+        } else if (auto* sel = std::get_if<TypeSelector>(&simple); sel && !type) {
+            type = sel;
+        }
+    }
+
+    if (id) {
+        return {RuleBucket::Id, id->id};
+    }
+    if (class_selector) {
+        return {RuleBucket::Class, class_selector->class_name};
+    }
+    if (attribute) {
+        return {RuleBucket::Attribute, attribute->attribute.to_lowercase()};
+    }
+    if (type) {
+        return {RuleBucket::Tag, type->local_name.string()};
+    }
+    return {RuleBucket::Universal, String()};
+}
+
+// Rough heap footprint of the parsed rules; only used to bound the cache
+usize values_size(const std::vector<ComponentValue>& values) {
+    usize size = values.capacity() * sizeof(ComponentValue);
+    for (const auto& value : values) {
+        if (auto* preserved = std::get_if<PreservedToken>(&value)) {
+            size += preserved->value.size();
+        } else if (auto* block = std::get_if<std::shared_ptr<SimpleBlock>>(&value)) {
+            size += sizeof(SimpleBlock) + values_size((*block)->value);
+        } else if (auto* function = std::get_if<std::shared_ptr<Function>>(&value)) {
+            size += sizeof(Function) + (*function)->name.size() + values_size((*function)->value);
+        }
+    }
+    return size;
+}
+
+usize declarations_size(const DeclarationBlock& block) {
+    usize size = block.declarations.capacity() * sizeof(Declaration);
+    for (const auto& declaration : block.declarations) {
+        size += declaration.property.size() + values_size(declaration.value);
+    }
+    return size;
+}
+
+usize selector_size(const ComplexSelector& selector) {
+    usize size = sizeof(ComplexSelector) + selector.parts.capacity() * sizeof(ComplexSelectorPart) +
+                 selector.compiled.code().capacity() * sizeof(CompiledSelector::Instruction);
+    for (const auto& part : selector.parts) {
+        size += part.compound.selectors.capacity() * sizeof(SimpleSelector);
+    }
+    return size;
+}
+
+usize rule_size(const Rule& rule) {
+    usize size = sizeof(Rule);
+    if (rule.is<StyleRule>()) {
+        const auto& style_rule = rule.get<StyleRule>();
+        for (const auto& selector : style_rule.selectors.selectors) {
+            size += selector_size(selector);
+        }
+        return size + declarations_size(style_rule.declarations);
+    }
+    const auto& at_rule = rule.get<AtRule>();
+    size += at_rule.name.size() + values_size(at_rule.prelude);
+    if (at_rule.declarations) {
+        size += declarations_size(*at_rule.declarations);
+    }
+    if (at_rule.nested_rules) {
+        for (const auto& nested : *at_rule.nested_rules) {
+            size += rule_size(*nested);
+        }
+    }
+    return size;
+}
+
+} // namespace
+
+PreparedStylesheet::PreparedStylesheet(Stylesheet stylesheet)
+    : m_stylesheet(std::move(stylesheet))
+{
+    collect_style_rules();
+    m_declarations.reserve(m_style_rules.size());
+    for (u32 rule = 0; rule < m_style_rules.size(); ++rule) {
+        const auto& style_rule = *m_style_rules[rule];
+        m_declarations.push_back(parse_declarations(style_rule.declarations));
+        const auto& selectors = style_rule.selectors.selectors;
+        for (u32 i = 0; i < selectors.size(); ++i) {
+            if (selectors[i].parts.empty()) {
+                continue;  // Matches nothing
+            }
+            auto [bucket, key] = bucket_for(selectors[i]);
+            m_selectors.push_back({rule, i, bucket, std::move(key), calculate_specificity(selectors[i]),
+                                   AncestorBloomFilter::selector_hashes(selectors[i]),
+                                   depends_on_siblings(selectors[i])});
+        }
+    }
+    estimate_memory_size();
+}
+
+PreparedStylesheet::PreparedStylesheet(Stylesheet stylesheet,
+                                       std::vector<std::vector<TypedDeclaration>> declarations,
+                                       std::vector<PreparedSelector> selectors)
+    : m_stylesheet(std::move(stylesheet))
+    , m_declarations(std::move(declarations))
+    , m_selectors(std::move(selectors))
+{
+    collect_style_rules();
+    estimate_memory_size();
+}
+
+void PreparedStylesheet::collect_style_rules() {
+    for (const auto& rule : m_stylesheet.rules) {
+        if (rule.is<StyleRule>()) {
+            m_style_rules.push_back(&rule.get<StyleRule>());
+        }
+    }
+}
+
+void PreparedStylesheet::estimate_memory_size() {
+    m_memory_size = sizeof(PreparedStylesheet) + m_style_rules.capacity() * sizeof(const StyleRule*);
+    for (const auto& rule : m_stylesheet.rules) {
+        m_memory_size += rule_size(rule);
+    }
+    for (const auto& declarations : m_declarations) {
+        m_memory_size += sizeof(declarations) + declarations.capacity() * sizeof(TypedDeclaration);
+    }
+    for (const auto& selector : m_selectors) {
+        m_memory_size += sizeof(PreparedSelector) + selector.key.size();
+    }
+}
+
+// ============================================================================
+// Binary form
+// ============================================================================
+//
+// Counts are u32; strings a count and their bytes; enums and variant
+// alternatives one byte. Typed declarations are copied as raw arrays.
+// Selectors are recompiled on load rather than stored compiled.
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<TypedDeclaration>,
+              "typed declarations are stored as raw bytes");
+
+constexpr u8 NO_COMBINATOR = 0xFF;
+constexpr u32 MAX_NESTING = 256;  // Blocks, functions and nested rules
+
+class Writer {
+public:
+    explicit Writer(std::string& out) : m_out(out) {}
+
+    template<typename T>
+    void pod(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&value, sizeof(T));
+    }
+    void byte(u8 value) { pod(value); }
+    void count(usize value) { pod(static_cast<u32>(value)); }
+    void string(const String& value) {
+        count(value.size());
+        bytes(value.data(), value.size());
+    }
+    void bytes(const void* data, usize size) { m_out.append(static_cast<const char*>(data), size); }
+
+private:
+    std::string& m_out;
+};
+
+// Reads what Writer wrote; any overrun or out-of-range value latches a
+// failure, after which every read returns zero
+class Reader {
+public:
+    explicit Reader(std::string_view bytes) : m_position(bytes.data()), m_end(bytes.data() + bytes.size()) {}
+
+    [[nodiscard]] bool ok() const { return m_ok; }
+    [[nodiscard]] bool at_end() const { return m_position == m_end; }
+    void fail() { m_ok = false; }
+
+    template<typename T>
+    T pod() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        bytes(&value, sizeof(T));
+        return value;
+    }
+    u8 byte() { return pod<u8>(); }
+
+    // An element count; each element takes at least `element_size` bytes,
+    // so a count larger than the rest of the input is corrupt
+    u32 count(usize element_size = 1) {
+        auto value = pod<u32>();
+        if (value > remaining() / element_size) {
+            fail();
+            return 0;
+        }
+        return value;
+    }
+
+    String string() {
+        u32 size = count();
+        if (!m_ok) {
+            return {};
+        }
+        String value(m_position, size);
+        m_position += size;
+        return value;
+    }
+
+    void bytes(void* out, usize size) {
+        if (!m_ok || remaining() < size) {
+            fail();
+            return;
+        }
+        std::memcpy(out, m_position, size);
+        m_position += size;
+    }
+
+private:
+    [[nodiscard]] usize remaining() const { return static_cast<usize>(m_end - m_position); }
+
+    const char* m_position;
+    const char* m_end;
+    bool m_ok{true};
+};
+
+void write_values(Writer& out, const std::vector<ComponentValue>& values) {
+    out.count(values.size());
+    for (const auto& value : values) {
+        out.byte(static_cast<u8>(value.index()));
+        if (auto* preserved = std::get_if<PreservedToken>(&value)) {
+            out.string(preserved->value);
+        } else if (auto* block = std::get_if<std::shared_ptr<SimpleBlock>>(&value)) {
+            out.pod((*block)->associated_token);
+            write_values(out, (*block)->value);
+        } else if (auto* function = std::get_if<std::shared_ptr<Function>>(&value)) {
+            out.string((*function)->name);
+            write_values(out, (*function)->value);
+        }
+    }
+}
+
+std::vector<ComponentValue> read_values(Reader& in, u32 depth) {
+    std::vector<ComponentValue> values;
+    if (depth > MAX_NESTING) {
+        in.fail();
+        return values;
+    }
+    u32 count = in.count();
+    values.reserve(count);
+    for (u32 i = 0; i < count && in.ok(); ++i) {
+        switch (in.byte()) {
+            case 0:
+                values.emplace_back(PreservedToken{in.string()});
+                break;
+            case 1: {
+                auto block = std::make_shared<SimpleBlock>();
+                block->associated_token = in.pod<unicode::CodePoint>();
+                block->value = read_values(in, depth + 1);
+                values.emplace_back(std::move(block));
+                break;
+            }
+            case 2: {
+                auto function = std::make_shared<Function>();
+                function->name = in.string();
+                function->value = read_values(in, depth + 1);
+                values.emplace_back(std::move(function));
+                break;
+            }
+            default:
+                in.fail();
+                break;
+        }
+    }
+    return values;
+}
+
+void write_declarations(Writer& out, const DeclarationBlock& block) {
+    out.count(block.declarations.size());
+    for (const auto& declaration : block.declarations) {
+        out.string(declaration.property);
+        write_values(out, declaration.value);
+        out.byte(declaration.important ? 1 : 0);
+    }
+}
+
+DeclarationBlock read_declarations(Reader& in) {
+    DeclarationBlock block;
+    u32 count = in.count();
+    block.declarations.reserve(count);
+    for (u32 i = 0; i < count && in.ok(); ++i) {
+        auto& declaration = block.declarations.emplace_back();
+        declaration.property = in.string();
+        declaration.value = read_values(in, 0);
+        declaration.important = in.byte() != 0;
+    }
+    return block;
+}
+
+void write_simple_selector(Writer& out, const SimpleSelector& simple) {
+    out.byte(static_cast<u8>(simple.index()));
+    if (auto* sel = std::get_if<TypeSelector>(&simple)) {
+        out.string(sel->tag_name);
+    } else if (auto* sel = std::get_if<IdSelector>(&simple)) {
+        out.string(sel->id);
+    } else if (auto* sel = std::get_if<ClassSelector>(&simple)) {
+        out.string(sel->class_name);
+    } else if (auto* sel = std::get_if<AttributeSelector>(&simple)) {
+        out.string(sel->attribute);
+        out.byte(static_cast<u8>(sel->matcher));
+        out.string(sel->value);
+        out.byte(sel->case_insensitive ? 1 : 0);
+    } else if (auto* sel = std::get_if<PseudoClassSelector>(&simple)) {
+        out.string(sel->name);
+        out.byte(sel->argument ? 1 : 0);
+        if (sel->argument) {
+            out.string(*sel->argument);
+        }
+    } else if (auto* sel = std::get_if<PseudoElementSelector>(&simple)) {
+        out.string(sel->name);
+    }
+}
+
+SimpleSelector read_simple_selector(Reader& in) {
+    switch (in.byte()) {
+        case 0:
+            return TypeSelector(in.string());
+        case 1:
+            return UniversalSelector{};
+        case 2:
+            return IdSelector{in.string()};
+        case 3:
+            return ClassSelector{in.string()};
+        case 4: {
+            AttributeSelector sel;
+            sel.attribute = in.string();
+            u8 matcher = in.byte();
+            if (matcher > static_cast<u8>(AttributeSelector::Matcher::Substring)) {
+                in.fail();
+            }
+            sel.matcher = static_cast<AttributeSelector::Matcher>(matcher);
+            sel.value = in.string();
+            sel.case_insensitive = in.byte() != 0;
+            return sel;
+        }
+        case 5: {
+            PseudoClassSelector sel;
+            sel.name = in.string();
+            if (in.byte() != 0) {
+                sel.argument = in.string();
+            }
+            return sel;
+        }
+        case 6:
+            return PseudoElementSelector{in.string()};
+        default:
+            in.fail();
+            return UniversalSelector{};
+    }
+}
+
+void write_selector(Writer& out, const ComplexSelector& selector) {
+    out.count(selector.parts.size());
+    for (const auto& part : selector.parts) {
+        out.count(part.compound.selectors.size());
+        for (const auto& simple : part.compound.selectors) {
+            write_simple_selector(out, simple);
+        }
+        out.byte(part.combinator ? static_cast<u8>(*part.combinator) : NO_COMBINATOR);
+    }
+}
+
+ComplexSelector read_selector(Reader& in) {
+    ComplexSelector selector;
+    u32 parts = in.count();
+    selector.parts.reserve(parts);
+    for (u32 i = 0; i < parts && in.ok(); ++i) {
+        auto& part = selector.parts.emplace_back();
+        u32 simples = in.count();
+        part.compound.selectors.reserve(simples);
+        for (u32 j = 0; j < simples && in.ok(); ++j) {
+            part.compound.selectors.push_back(read_simple_selector(in));
+        }
+        u8 combinator = in.byte();
+        if (combinator != NO_COMBINATOR) {
+            if (combinator > static_cast<u8>(Combinator::SubsequentSibling)) {
+                in.fail();
+            }
+            part.combinator = static_cast<Combinator>(combinator);
+        }
+    }
+    if (in.ok()) {
+        selector.compiled = CompiledSelector::compile(selector);
+    }
+    return selector;
+}
+
+void write_rule(Writer& out, const Rule& rule) {
+    out.byte(static_cast<u8>(rule.value.index()));
+    if (rule.is<StyleRule>()) {
+        const auto& style_rule = rule.get<StyleRule>();
+        out.count(style_rule.selectors.selectors.size());
+        for (const auto& selector : style_rule.selectors.selectors) {
+            write_selector(out, selector);
+        }
+        write_declarations(out, style_rule.declarations);
+        return;
+    }
+    const auto& at_rule = rule.get<AtRule>();
+    out.string(at_rule.name);
+    write_values(out, at_rule.prelude);
+    out.byte(at_rule.declarations ? 1 : 0);
+    if (at_rule.declarations) {
+        write_declarations(out, *at_rule.declarations);
+    }
+    out.byte(at_rule.nested_rules ? 1 : 0);
+    if (at_rule.nested_rules) {
+        out.count(at_rule.nested_rules->size());
+        for (const auto& nested : *at_rule.nested_rules) {
+            write_rule(out, *nested);
+        }
+    }
+}
+
+std::optional<Rule> read_rule(Reader& in, u32 depth) {
+    if (depth > MAX_NESTING) {
+        in.fail();
+        return std::nullopt;
+    }
+    switch (in.byte()) {
+        case 0: {
+            StyleRule style_rule;
+            u32 selectors = in.count();
+            style_rule.selectors.selectors.reserve(selectors);
+            for (u32 i = 0; i < selectors && in.ok(); ++i) {
+                style_rule.selectors.selectors.push_back(read_selector(in));
+            }
+            style_rule.declarations = read_declarations(in);
+            return Rule(std::move(style_rule));
+        }
+        case 1: {
+            AtRule at_rule;
+            at_rule.name = in.string();
+            at_rule.prelude = read_values(in, 0);
+            if (in.byte() != 0) {
+                at_rule.declarations = read_declarations(in);
+            }
+            if (in.byte() != 0) {
+                auto& nested_rules = at_rule.nested_rules.emplace();
+                u32 count = in.count();
+                for (u32 i = 0; i < count && in.ok(); ++i) {
+                    if (auto nested = read_rule(in, depth + 1)) {
+                        nested_rules.push_back(std::make_shared<RuleVariant>(std::move(*nested)));
+                    }
+                }
+            }
+            return Rule(std::move(at_rule));
+        }
+        default:
+            in.fail();
+            return std::nullopt;
+    }
+}
+
+// Whether a declaration read back from a file is one parse_declaration
+// could have produced: apply_declaration takes the property's alternative
+// for granted, and its enums are used as given
+template<typename Enum>
+bool holds_enum(const PropertyValue& value, Enum last) {
+    auto* e = std::get_if<Enum>(&value);
+    return e && static_cast<u32>(*e) <= static_cast<u32>(last);
+}
+
+bool holds_length(const PropertyValue& value) {
+    auto* length = std::get_if<Length>(&value);
+    return length && static_cast<u32>(length->unit) <= static_cast<u32>(LengthUnit::Percent);
+}
+
+bool is_valid_declaration(const TypedDeclaration& declaration) {
+    const auto& value = declaration.value;
+    switch (declaration.property) {
+        case PropertyId::Display: return holds_enum(value, Display::Contents);
+        case PropertyId::Position: return holds_enum(value, Position::Sticky);
+        case PropertyId::FontWeight: return holds_enum(value, FontWeight::W900);
+        case PropertyId::TextAlign: return holds_enum(value, TextAlign::End);
+        case PropertyId::Color:
+        case PropertyId::BackgroundColor: return std::holds_alternative<Color>(value);
+        case PropertyId::Opacity: return std::holds_alternative<f32>(value);
+        case PropertyId::Width:
+        case PropertyId::Height: return std::holds_alternative<AutoValue>(value) || holds_length(value);
+        case PropertyId::FontSize:
+        case PropertyId::LineHeight:
+        case PropertyId::MarginTop:
+        case PropertyId::MarginRight:
+        case PropertyId::MarginBottom:
+        case PropertyId::MarginLeft:
+        case PropertyId::PaddingTop:
+        case PropertyId::PaddingRight:
+        case PropertyId::PaddingBottom:
+        case PropertyId::PaddingLeft:
+        case PropertyId::BorderTopWidth:
+        case PropertyId::BorderRightWidth:
+        case PropertyId::BorderBottomWidth:
+        case PropertyId::BorderLeftWidth: return holds_length(value);
+    }
+    return false;
+}
+
+} // namespace
+
+void PreparedStylesheet::serialize(std::string& out) const {
+    Writer writer(out);
+    writer.count(m_stylesheet.rules.size());
+    for (const auto& rule : m_stylesheet.rules) {
+        write_rule(writer, rule);
+    }
+
+    writer.count(m_declarations.size());
+    for (const auto& declarations : m_declarations) {
+        writer.count(declarations.size());
+        writer.bytes(declarations.data(), declarations.size() * sizeof(TypedDeclaration));
+    }
+
+    writer.count(m_selectors.size());
+    for (const auto& selector : m_selectors) {
+        writer.pod(selector.rule);
+        writer.pod(selector.selector_index);
+        writer.byte(static_cast<u8>(selector.bucket));
+        writer.string(selector.key);
+        writer.pod(selector.specificity);
+        writer.pod(selector.ancestor_hashes);
+        writer.byte(selector.depends_on_siblings ? 1 : 0);
+    }
+}
+
+RefPtr<const PreparedStylesheet> PreparedStylesheet::deserialize(std::string_view bytes) {
+    Reader in(bytes);
+
+    Stylesheet stylesheet;
+    u32 rules = in.count();
+    stylesheet.rules.reserve(rules);
+    for (u32 i = 0; i < rules && in.ok(); ++i) {
+        if (auto rule = read_rule(in, 0)) {
+            stylesheet.rules.push_back(std::move(*rule));
+        }
+    }
+
+    std::vector<std::vector<TypedDeclaration>> declarations(in.count());
+    for (auto& rule_declarations : declarations) {
+        rule_declarations.resize(in.count(sizeof(TypedDeclaration)));
+        in.bytes(rule_declarations.data(), rule_declarations.size() * sizeof(TypedDeclaration));
+        for (const auto& declaration : rule_declarations) {
+            if (declaration.value.index() >= std::variant_size_v<PropertyValue> ||
+                !is_valid_declaration(declaration)) {
+                in.fail();
+            }
+        }
+        if (!in.ok()) {
+            return {};
+        }
+    }
+
+    std::vector<PreparedSelector> selectors(in.count());
+    for (auto& selector : selectors) {
+        selector.rule = in.pod<u32>();
+        selector.selector_index = in.pod<u32>();
+        u8 bucket = in.byte();
+        if (bucket > static_cast<u8>(RuleBucket::Universal)) {
+            in.fail();
+        }
+        selector.bucket = static_cast<RuleBucket>(bucket);
+        selector.key = in.string();
+        selector.specificity = in.pod<Specificity>();
+        selector.ancestor_hashes = in.pod<AncestorBloomFilter::SelectorHashes>();
+        selector.depends_on_siblings = in.byte() != 0;
+    }
+    if (!in.ok() || !in.at_end()) {
+        return {};
+    }
+
+    RefPtr<const PreparedStylesheet> prepared(
+        new PreparedStylesheet(std::move(stylesheet), std::move(declarations), std::move(selectors)));
+
+    // The indexes must point at rules and selectors that exist
+    if (prepared->m_declarations.size() != prepared->m_style_rules.size()) {
+        return {};
+    }
+    for (const auto& selector : prepared->m_selectors) {
+        if (selector.rule >= prepared->m_style_rules.size() ||
+            selector.selector_index >= prepared->m_style_rules[selector.rule]->selectors.selectors.size()) {
+            return {};
+        }
+    }
+    return prepared;
+}
+
+// ============================================================================
+// Cache files
+// ============================================================================
+//
+// <directory>/<hash as 16 hex digits>.lcss: a FileHeader, the source text
+// (compared on load, like the in-memory entries) and the prepared
+// stylesheet's binary form.
+
+namespace {
+
+constexpr char FILE_MAGIC[4] = {'L', 'C', 'S', 'S'};
+constexpr u32 FILE_VERSION = 1;
+
+struct FileHeader {
+    char magic[4];
+    u32 version;
+    u32 declaration_size;  // sizeof(TypedDeclaration) of the build that wrote it
+    u32 reserved;
+    u64 hash;
+    u64 source_length;
+    u64 payload_length;
+};
+
+// A whole file's bytes: mapped read-only where the platform has mmap, read
+// into memory elsewhere. Empty if the file cannot be opened.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+#if defined(LITHIUM_CSS_HAS_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = ::mmap(nullptr, static_cast<usize>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_data = static_cast<const char*>(data);
+                m_size = static_cast<usize>(info.st_size);
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (file) {
+            m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(LITHIUM_CSS_HAS_MMAP)
+        if (m_data) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] std::string_view bytes() const {
+#if defined(LITHIUM_CSS_HAS_MMAP)
+        return {m_data, m_size};
+#else
+        return m_buffer;
+#endif
+    }
+
+private:
+#if defined(LITHIUM_CSS_HAS_MMAP)
+    const char* m_data{nullptr};
+    usize m_size{0};
+#else
+    std::string m_buffer;
+#endif
+};
+
+} // namespace
+
+String StylesheetCache::file_path(u64 hash) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.lcss", static_cast<unsigned long long>(hash));
+    return String((std::filesystem::path(m_directory.std_string()) / name).string());
+}
+
+RefPtr<const PreparedStylesheet> StylesheetCache::load_file(u64 hash, std::string_view css) const {
+    MappedFile file(file_path(hash).std_string());
+    auto bytes = file.bytes();
+    if (bytes.size() < sizeof(FileHeader) + css.size()) {
+        return {};
+    }
+
+    FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION ||
+        header.declaration_size != sizeof(TypedDeclaration) || header.hash != hash ||
+        header.source_length != css.size() ||
+        header.payload_length != bytes.size() - sizeof(FileHeader) - css.size()) {
+        return {};
+    }
+    if (bytes.substr(sizeof(FileHeader), css.size()) != css) {
+        return {};  // Another stylesheet with the same hash
+    }
+    return PreparedStylesheet::deserialize(bytes.substr(sizeof(FileHeader) + css.size()));
+}
+
+void StylesheetCache::store_file(u64 hash, std::string_view css, const PreparedStylesheet& stylesheet) const {
+    std::string contents(sizeof(FileHeader), '\0');
+    contents.append(css);
+    stylesheet.serialize(contents);
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.declaration_size = sizeof(TypedDeclaration);
+    header.hash = hash;
+    header.source_length = css.size();
+    header.payload_length = contents.size() - sizeof(FileHeader) - css.size();
+    std::memcpy(contents.data(), &header, sizeof(header));
+
+    // Written aside and renamed into place, so a reader never maps a
+    // partial file
+    std::error_code error;
+    std::filesystem::create_directories(m_directory.std_string(), error);
+    std::filesystem::path path(file_path(hash).std_string());
+    auto temporary = path;
+    temporary += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+// ============================================================================
+// StylesheetCache implementation
+// ============================================================================
+
+u64 StylesheetCache::hash_source(std::string_view css) {
+    // Eight bytes per multiply; native byte order, like the cache files
+    constexpr u64 MULTIPLIER = 0x9E3779B97F4A7C15ull;
+    u64 hash = static_cast<u64>(css.size()) * MULTIPLIER;
+    auto mix = [&hash](u64 word) {
+        hash = (hash ^ word) * MULTIPLIER;
+        hash ^= hash >> 29;
+    };
+    const char* p = css.data();
+    usize remaining = css.size();
+    for (; remaining >= 8; p += 8, remaining -= 8) {
+        u64 word;
+        std::memcpy(&word, p, 8);
+        mix(word);
+    }
+    if (remaining > 0) {
+        u64 word = 0;
+        std::memcpy(&word, p, remaining);
+        mix(word);
+    }
+    hash ^= hash >> 32;
+    hash *= 0xD6E8FEB86659FD93ull;
+    return hash ^ (hash >> 32);
+}
+
+RefPtr<const PreparedStylesheet> StylesheetCache::get(const String& css) {
+    if (!m_enabled) {
+        ++m_stats.misses;
+        return make_ref<const PreparedStylesheet>(m_parser.parse_stylesheet(css));
+    }
+
+    u64 hash = hash_source(css.view());
+    if (auto it = m_index.find(hash); it != m_index.end()) {
+        auto entry = it->second;
+        if (entry->source == css) {
+            ++m_stats.hits;
+            m_entries.splice(m_entries.begin(), m_entries, entry);
+            return entry->stylesheet;
+        }
+        // A different stylesheet with the same hash: the new one replaces it
+        m_memory_size -= entry->bytes;
+        m_entries.erase(entry);
+        m_index.erase(it);
+    }
+
+    RefPtr<const PreparedStylesheet> stylesheet;
+    if (!m_directory.empty()) {
+        stylesheet = load_file(hash, css.view());
+    }
+    if (stylesheet) {
+        ++m_stats.disk_hits;
+    } else {
+        ++m_stats.misses;
+        stylesheet = make_ref<const PreparedStylesheet>(m_parser.parse_stylesheet(css));
+        if (!m_directory.empty()) {
+            store_file(hash, css.view(), *stylesheet);
+        }
+    }
+    insert(hash, css, stylesheet);
+    return stylesheet;
+}
+
+void StylesheetCache::insert(u64 hash, const String& css, RefPtr<const PreparedStylesheet> stylesheet) {
+    usize bytes = sizeof(Entry) + css.size() + stylesheet->memory_size();
+    if (bytes > m_max_size) {
+        return;  // Would evict everything and still not fit
+    }
+    m_entries.push_front({hash, css, std::move(stylesheet), bytes});
+    m_index[hash] = m_entries.begin();
+    m_memory_size += bytes;
+    evict_if_needed();
+}
+
+void StylesheetCache::set_max_size(usize bytes) {
+    m_max_size = bytes;
+    evict_if_needed();
+}
+
+void StylesheetCache::evict_if_needed() {
+    while (m_memory_size > m_max_size && !m_entries.empty()) {
+        const auto& oldest = m_entries.back();
+        m_memory_size -= oldest.bytes;
+        m_index.erase(oldest.hash);
+        m_entries.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+void StylesheetCache::clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_memory_size = 0;
+}
+
+} // namespace lithium::css
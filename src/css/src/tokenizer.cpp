@@ -1,11 +1,17 @@
 /**
  * CSS Tokenizer implementation
  * Following CSS Syntax Module Level 3
+ *
+ * TokenStream scans the source in place (see scan.hpp) and hands out ranges
+ * of it; escapes are only decoded when a token's value is asked for.
  */
 
 #include "lithium/css/tokenizer.hpp"
-#include <cctype>
-#include <cmath>
+#include "scan.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <string>
 
 namespace lithium::css {
 
@@ -28,537 +34,520 @@ bool is_ident_with_value(const Token& token, const String& value) {
 // Helper functions
 // ============================================================================
 
-static bool is_name_start_code_point(unicode::CodePoint cp) {
-    return std::isalpha(cp) || cp > 0x7F || cp == '_';
-}
-
-static bool is_name_code_point(unicode::CodePoint cp) {
-    return is_name_start_code_point(cp) || std::isdigit(cp) || cp == '-';
-}
+namespace {
 
-static bool is_non_printable(unicode::CodePoint cp) {
-    return (cp >= 0x00 && cp <= 0x08) ||
-           cp == 0x0B ||
-           (cp >= 0x0E && cp <= 0x1F) ||
-           cp == 0x7F;
-}
+using detail::has_class;
 
-static bool is_whitespace(unicode::CodePoint cp) {
-    return cp == ' ' || cp == '\t' || cp == '\n' || cp == '\r' || cp == '\f';
-}
-
-// ============================================================================
-// Tokenizer implementation
-// ============================================================================
-
-Tokenizer::Tokenizer() = default;
-
-void Tokenizer::set_input(const String& input) {
-    m_input = input;
-    m_position = 0;
-    m_peeked.reset();
-}
-
-void Tokenizer::set_input(std::string_view input) {
-    m_input = String(input);
-    m_position = 0;
-    m_peeked.reset();
-}
-
-std::vector<Token> Tokenizer::tokenize() {
-    std::vector<Token> tokens;
-    while (!at_end()) {
-        tokens.push_back(next_token());
-        if (std::holds_alternative<EOFToken>(tokens.back())) {
-            break;
+[[nodiscard]] bool equals_ascii_ignore_case(std::string_view text, std::string_view lower) {
+    if (text.size() != lower.size()) {
+        return false;
+    }
+    for (usize i = 0; i < text.size(); ++i) {
+        if (unicode::to_ascii_lower(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(lower[i])) {
+            return false;
         }
     }
-    return tokens;
+    return true;
 }
 
-Token Tokenizer::next_token() {
-    if (m_peeked) {
-        Token token = std::move(*m_peeked);
-        m_peeked.reset();
-        return token;
+// Decodes the escape whose body (after the backslash) starts text[i], and
+// leaves i past it: up to six hex digits and one whitespace byte, or one byte
+void decode_escape(std::string_view text, usize& i, StringBuilder& out) {
+    if (!has_class(text[i], detail::HEX_DIGIT)) {
+        out.append(text[i++]);
+        return;
     }
-    return consume_token();
-}
-
-Token Tokenizer::peek_token() {
-    if (!m_peeked) {
-        m_peeked = consume_token();
+    u32 value = 0;
+    for (usize digits = 0; i < text.size() && digits < 6 && has_class(text[i], detail::HEX_DIGIT); ++digits, ++i) {
+        auto c = static_cast<unicode::CodePoint>(unicode::to_ascii_lower(static_cast<unsigned char>(text[i])));
+        value = value * 16 + (c >= 'a' ? c - 'a' + 10 : c - '0');
     }
-    return *m_peeked;
-}
-
-bool Tokenizer::at_end() const {
-    return m_position >= m_input.length();
-}
-
-unicode::CodePoint Tokenizer::peek(usize offset) const {
-    if (m_position + offset >= m_input.length()) {
-        return 0;
+    if (i < text.size() && has_class(text[i], detail::WHITESPACE)) {
+        ++i;
+    }
+    if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+        value = unicode::REPLACEMENT_CHARACTER;
     }
-    return m_input[m_position + offset];
+    out.append(static_cast<unicode::CodePoint>(value));
 }
 
-unicode::CodePoint Tokenizer::consume() {
-    if (m_position >= m_input.length()) {
-        return 0;
+// A backslash at the end is dropped, as is an escaped newline (a string's
+// line continuation)
+String decode_escapes(std::string_view text) {
+    StringBuilder out(text.size());
+    usize i = 0;
+    while (i < text.size()) {
+        auto backslash = text.find('\\', i);
+        if (backslash == std::string_view::npos) {
+            out.append(text.substr(i));
+            break;
+        }
+        out.append(text.substr(i, backslash - i));
+        i = backslash + 1;
+        if (i == text.size()) {
+            break;
+        }
+        if (text[i] == '\n') {
+            ++i;
+            continue;
+        }
+        decode_escape(text, i, out);
     }
-    return m_input[m_position++];
+    return out.build();
 }
 
-void Tokenizer::reconsume() {
-    if (m_position > 0) {
-        --m_position;
-    }
+[[nodiscard]] TokenView make_token(TokenKind kind, usize offset, usize length, u8 flags = 0) {
+    TokenView token;
+    token.kind = kind;
+    token.flags = flags;
+    token.offset = static_cast<u32>(offset);
+    token.length = static_cast<u32>(length);
+    return token;
 }
 
-Token Tokenizer::consume_token() {
-    consume_whitespace();
+} // namespace
 
-    if (at_end()) {
-        return EOFToken{};
-    }
+// ============================================================================
+// TokenStream
+// ============================================================================
 
-    unicode::CodePoint cp = consume();
+TokenStream::TokenStream(std::string_view source) : m_source(source) {}
 
-    // Comments
-    if (cp == '/' && peek() == '*') {
-        consume(); // consume *
-        // Consume until */
-        while (!at_end()) {
-            if (consume() == '*' && peek() == '/') {
-                consume();
-                break;
-            }
-        }
-        return consume_token(); // Consume next token after comment
-    }
+TokenView TokenStream::next() {
+    const char* data = m_source.data();
+    const char* end = data + m_source.size();
 
-    // Whitespace
-    if (is_whitespace(cp)) {
-        while (!at_end() && is_whitespace(peek())) {
-            consume();
+    for (;;) {
+        m_position += detail::whitespace_run(data + m_position, end);
+        if (at_end()) {
+            return make_token(TokenKind::EndOfFile, m_source.size(), 0);
         }
-        return WhitespaceToken{};
-    }
 
-    // String
-    if (cp == '"' || cp == '\'') {
-        return consume_string_token(cp);
-    }
+        usize start = m_position;
+        char c = m_source[m_position++];
 
-    // Hash
-    if (cp == '#') {
-        if (is_name_code_point(peek()) || is_valid_escape()) {
-            return consume_hash_token();
+        // Comments
+        if (c == '/' && peek() == '*') {
+            ++m_position;
+            m_position += detail::comment_body_length(data + m_position, end);
+            m_position = std::min(m_position + 2, m_source.size());
+            continue;
         }
-        return DelimToken{cp};
-    }
 
-    // Plus
-    if (cp == '+') {
-        if (would_start_number(-1)) {
-            reconsume();
-            return consume_numeric_token();
+        switch (c) {
+            case '"':
+            case '\'':
+                return consume_string(c);
+            case '#':
+                if (has_class(peek(), detail::NAME) || is_valid_escape(m_position)) {
+                    return consume_hash();
+                }
+                return make_token(TokenKind::Delim, start, 1);
+            case '+':
+            case '.':
+                if (would_start_number(start)) {
+                    return consume_numeric(start);
+                }
+                return make_token(TokenKind::Delim, start, 1);
+            case '-':
+                if (would_start_number(start)) {
+                    return consume_numeric(start);
+                }
+                if (would_start_identifier(start)) {
+                    return consume_ident_like(start);
+                }
+                if (peek() == '-' && peek(1) == '>') {
+                    m_position += 2;
+                    return make_token(TokenKind::CDC, start, 3);
+                }
+                return make_token(TokenKind::Delim, start, 1);
+            case '<':
+                if (peek() == '!' && peek(1) == '-' && peek(2) == '-') {
+                    m_position += 3;
+                    return make_token(TokenKind::CDO, start, 4);
+                }
+                return make_token(TokenKind::Delim, start, 1);
+            case '@':
+                if (would_start_identifier(m_position)) {
+                    usize name_start = m_position;
+                    bool escaped = skip_name();
+                    return make_token(TokenKind::AtKeyword, name_start, m_position - name_start,
+                                      escaped ? TokenView::ESCAPED : 0);
+                }
+                return make_token(TokenKind::Delim, start, 1);
+            case '\\':
+                if (is_valid_escape(start)) {
+                    return consume_ident_like(start);
+                }
+                // Parse error
+                return make_token(TokenKind::Delim, start, 1);
+            case ':': return make_token(TokenKind::Colon, start, 1);
+            case ';': return make_token(TokenKind::Semicolon, start, 1);
+            case ',': return make_token(TokenKind::Comma, start, 1);
+            case '(': return make_token(TokenKind::OpenParen, start, 1);
+            case ')': return make_token(TokenKind::CloseParen, start, 1);
+            case '[': return make_token(TokenKind::OpenSquare, start, 1);
+            case ']': return make_token(TokenKind::CloseSquare, start, 1);
+            case '{': return make_token(TokenKind::OpenCurly, start, 1);
+            case '}': return make_token(TokenKind::CloseCurly, start, 1);
+            default:
+                break;
         }
-        return DelimToken{cp};
-    }
 
-    // Minus
-    if (cp == '-') {
-        if (would_start_number(-1)) {
-            reconsume();
-            return consume_numeric_token();
+        if (has_class(c, detail::DIGIT)) {
+            return consume_numeric(start);
         }
-        if (would_start_identifier(-1)) {
-            reconsume();
-            return consume_ident_like_token();
-        }
-        if (peek() == '-' && peek(1) == '>') {
-            consume();
-            consume();
-            return CDCToken{};
-        }
-        return DelimToken{cp};
-    }
-
-    // Period
-    if (cp == '.') {
-        if (would_start_number(-1)) {
-            reconsume();
-            return consume_numeric_token();
+        if (has_class(c, detail::NAME_START)) {
+            return consume_ident_like(start);
         }
-        return DelimToken{cp};
+        return make_token(TokenKind::Delim, start, 1);
     }
+}
 
-    // Less-than
-    if (cp == '<') {
-        if (peek() == '!' && peek(1) == '-' && peek(2) == '-') {
-            consume();
-            consume();
-            consume();
-            return CDOToken{};
-        }
-        return DelimToken{cp};
-    }
+TokenView TokenStream::consume_ident_like(usize start) {
+    m_position = start;
+    bool escaped = skip_name();
+    usize length = m_position - start;
+    u8 flags = escaped ? TokenView::ESCAPED : 0;
 
-    // At
-    if (cp == '@') {
-        if (would_start_identifier()) {
-            String name = consume_name();
-            return AtKeywordToken{name};
-        }
-        return DelimToken{cp};
+    if (peek() != '(') {
+        return make_token(TokenKind::Ident, start, length, flags);
     }
 
-    // Backslash
-    if (cp == '\\') {
-        if (is_valid_escape(-1)) {
-            reconsume();
-            return consume_ident_like_token();
+    auto name = m_source.substr(start, length);
+    bool is_url = escaped ? decode_escapes(name).to_lowercase() == "url"_s : equals_ascii_ignore_case(name, "url");
+    ++m_position;
+    if (is_url) {
+        m_position += detail::whitespace_run(m_source.data() + m_position, m_source.data() + m_source.size());
+        if (peek() != '"' && peek() != '\'') {
+            return consume_url();
         }
-        // Parse error
-        return DelimToken{cp};
-    }
-
-    // Colon
-    if (cp == ':') {
-        return ColonToken{};
-    }
-
-    // Semicolon
-    if (cp == ';') {
-        return SemicolonToken{};
     }
-
-    // Comma
-    if (cp == ',') {
-        return CommaToken{};
-    }
-
-    // Brackets
-    if (cp == '(') return OpenParenToken{};
-    if (cp == ')') return CloseParenToken{};
-    if (cp == '[') return OpenSquareToken{};
-    if (cp == ']') return CloseSquareToken{};
-    if (cp == '{') return OpenCurlyToken{};
-    if (cp == '}') return CloseCurlyToken{};
-
-    // Digit
-    if (std::isdigit(cp)) {
-        reconsume();
-        return consume_numeric_token();
-    }
-
-    // Name start
-    if (is_name_start_code_point(cp)) {
-        reconsume();
-        return consume_ident_like_token();
-    }
-
-    // Default: delimiter
-    return DelimToken{cp};
+    return make_token(TokenKind::Function, start, length, flags);
 }
 
-Token Tokenizer::consume_ident_like_token() {
-    String name = consume_name();
+TokenView TokenStream::consume_string(char quote) {
+    const char* end = m_source.data() + m_source.size();
+    usize start = m_position;
+    u8 flags = 0;
 
-    // url(
-    if (name.to_lowercase() == "url"_s && peek() == '(') {
-        consume();
-        // Skip whitespace
-        while (is_whitespace(peek())) {
-            consume();
+    while (!at_end()) {
+        m_position += detail::string_run(m_source.data() + m_position, end, quote);
+        if (at_end()) {
+            break;
         }
-        if (peek() == '"' || peek() == '\'') {
-            return FunctionToken{name};
+        char c = m_source[m_position];
+        if (c == quote) {
+            ++m_position;
+            return make_token(TokenKind::String, start, m_position - 1 - start, flags);
         }
-        return consume_url_token();
-    }
-
-    // function
-    if (peek() == '(') {
-        consume();
-        return FunctionToken{name};
-    }
-
-    return IdentToken{name};
-}
-
-Token Tokenizer::consume_string_token(unicode::CodePoint ending) {
-    StringBuilder result;
-
-    while (!at_end()) {
-        unicode::CodePoint cp = consume();
-
-        if (cp == ending) {
-            return StringToken{result.build()};
+        if (c == '\n') {
+            return make_token(TokenKind::BadString, start, m_position - start);
         }
-
-        if (cp == '\n') {
-            reconsume();
-            return BadStringToken{};
+        // Backslash: a line continuation, or an escape decoded by value()
+        flags |= TokenView::ESCAPED;
+        ++m_position;
+        if (at_end()) {
+            break;
         }
-
-        if (cp == '\\') {
-            if (at_end()) {
-                continue;
-            }
-            unicode::CodePoint next = peek();
-            if (next == '\n') {
-                consume();
-            } else {
-                result.append(consume_escaped_code_point());
-            }
+        if (peek() == '\n') {
+            ++m_position;
         } else {
-            result.append(cp);
+            skip_escape();
         }
     }
 
-    return StringToken{result.build()};
+    return make_token(TokenKind::String, start, m_position - start, flags);
 }
 
-Token Tokenizer::consume_url_token() {
-    StringBuilder result;
-
-    // Skip whitespace
-    while (is_whitespace(peek())) {
-        consume();
-    }
+TokenView TokenStream::consume_url() {
+    const char* end = m_source.data() + m_source.size();
+    usize start = m_position;
+    u8 flags = 0;
 
     while (!at_end()) {
-        unicode::CodePoint cp = consume();
+        m_position += detail::url_run(m_source.data() + m_position, end);
+        if (at_end()) {
+            break;
+        }
+
+        usize content_end = m_position;
+        char c = m_source[m_position++];
 
-        if (cp == ')') {
-            return UrlToken{result.build()};
+        if (c == ')') {
+            return make_token(TokenKind::Url, start, content_end - start, flags);
         }
 
-        if (is_whitespace(cp)) {
-            while (is_whitespace(peek())) {
-                consume();
-            }
+        if (has_class(c, detail::WHITESPACE)) {
+            m_position += detail::whitespace_run(m_source.data() + m_position, end);
             if (peek() == ')' || at_end()) {
-                if (!at_end()) consume();
-                return UrlToken{result.build()};
+                if (!at_end()) {
+                    ++m_position;
+                }
+                return make_token(TokenKind::Url, start, content_end - start, flags);
             }
-            consume_remnants_of_bad_url();
-            return BadUrlToken{};
+            skip_remnants_of_bad_url();
+            return make_token(TokenKind::BadUrl, start, m_position - start);
         }
 
-        if (cp == '"' || cp == '\'' || cp == '(' || is_non_printable(cp)) {
-            consume_remnants_of_bad_url();
-            return BadUrlToken{};
+        if (c == '\\' && is_valid_escape(content_end)) {
+            flags |= TokenView::ESCAPED;
+            skip_escape();
+            continue;
         }
 
-        if (cp == '\\') {
-            if (is_valid_escape(-1)) {
-                result.append(consume_escaped_code_point());
-            } else {
-                consume_remnants_of_bad_url();
-                return BadUrlToken{};
-            }
-        } else {
-            result.append(cp);
-        }
+        // Quotes, '(', non-printables and invalid escapes
+        skip_remnants_of_bad_url();
+        return make_token(TokenKind::BadUrl, start, m_position - start);
     }
 
-    return UrlToken{result.build()};
+    return make_token(TokenKind::Url, start, m_position - start, flags);
 }
 
-Token Tokenizer::consume_numeric_token() {
-    auto [number, is_integer] = consume_number();
+TokenView TokenStream::consume_numeric(usize start) {
+    const char* data = m_source.data();
+    const char* end = data + m_source.size();
+    u8 flags = TokenView::INTEGER;
 
-    if (would_start_identifier()) {
-        String unit = consume_name();
-        return DimensionToken{number, unit, is_integer};
+    m_position = start;
+    if (peek() == '+' || peek() == '-') {
+        ++m_position;
     }
+    m_position += detail::digit_run(data + m_position, end);
 
-    if (peek() == '%') {
-        consume();
-        return PercentageToken{number};
+    if (peek() == '.' && has_class(peek(1), detail::DIGIT)) {
+        flags = 0;
+        ++m_position;
+        m_position += detail::digit_run(data + m_position, end);
     }
 
-    return NumberToken{number, is_integer};
-}
+    if (peek() == 'e' || peek() == 'E') {
+        usize digits = has_class(peek(1), detail::DIGIT) ? 1
+                     : (peek(1) == '+' || peek(1) == '-') && has_class(peek(2), detail::DIGIT) ? 2
+                     : 0;
+        if (digits != 0) {
+            flags = 0;
+            m_position += digits;
+            m_position += detail::digit_run(data + m_position, end);
+        }
+    }
 
-Token Tokenizer::consume_hash_token() {
-    bool is_id = would_start_identifier();
-    String name = consume_name();
-    return HashToken{name, is_id};
+    usize number_length = m_position - start;
+    TokenView token;
+    if (would_start_identifier(m_position)) {
+        if (skip_name()) {
+            flags |= TokenView::ESCAPED;
+        }
+        token = make_token(TokenKind::Dimension, start, m_position - start, flags);
+    } else if (peek() == '%') {
+        ++m_position;
+        token = make_token(TokenKind::Percentage, start, number_length, flags);
+    } else {
+        token = make_token(TokenKind::Number, start, number_length, flags);
+    }
+    token.number_length = static_cast<u32>(number_length);
+    return token;
 }
 
-bool Tokenizer::is_valid_escape(usize offset) const {
-    usize pos = m_position + offset;
-    if (pos >= m_input.length()) return false;
-    if (m_input[pos] != '\\') return false;
-    if (pos + 1 >= m_input.length()) return false;
-    return m_input[pos + 1] != '\n';
+TokenView TokenStream::consume_hash() {
+    usize start = m_position;
+    u8 flags = would_start_identifier(start) ? TokenView::ID : 0;
+    if (skip_name()) {
+        flags |= TokenView::ESCAPED;
+    }
+    return make_token(TokenKind::Hash, start, m_position - start, flags);
 }
 
-bool Tokenizer::would_start_identifier(usize offset) const {
-    usize pos = m_position + offset;
-    if (pos >= m_input.length()) return false;
-
-    unicode::CodePoint first = m_input[pos];
-
-    if (is_name_start_code_point(first)) return true;
+bool TokenStream::is_valid_escape(usize position) const {
+    return position + 1 < m_source.size() && m_source[position] == '\\' && m_source[position + 1] != '\n';
+}
 
-    if (first == '-') {
-        if (pos + 1 >= m_input.length()) return false;
-        unicode::CodePoint second = m_input[pos + 1];
-        return is_name_start_code_point(second) || second == '-' || is_valid_escape(offset + 1);
+bool TokenStream::would_start_identifier(usize position) const {
+    if (position >= m_source.size()) {
+        return false;
     }
-
-    if (first == '\\') {
-        return is_valid_escape(offset);
+    char first = m_source[position];
+    if (has_class(first, detail::NAME_START)) {
+        return true;
     }
-
-    return false;
+    if (first == '-') {
+        if (position + 1 >= m_source.size()) {
+            return false;
+        }
+        char second = m_source[position + 1];
+        return has_class(second, detail::NAME_START) || second == '-' || is_valid_escape(position + 1);
+    }
+    return first == '\\' && is_valid_escape(position);
 }
 
-bool Tokenizer::would_start_number(usize offset) const {
-    usize pos = m_position + offset;
-    if (pos >= m_input.length()) return false;
-
-    unicode::CodePoint first = m_input[pos];
-
-    if (first == '+' || first == '-') {
-        if (pos + 1 >= m_input.length()) return false;
-        unicode::CodePoint second = m_input[pos + 1];
-        if (std::isdigit(second)) return true;
-        if (second == '.' && pos + 2 < m_input.length() && std::isdigit(m_input[pos + 2])) {
-            return true;
-        }
+bool TokenStream::would_start_number(usize position) const {
+    auto digit_at = [&](usize i) { return i < m_source.size() && has_class(m_source[i], detail::DIGIT); };
+    if (position >= m_source.size()) {
         return false;
     }
-
+    char first = m_source[position];
+    if (first == '+' || first == '-') {
+        return digit_at(position + 1) ||
+               (position + 1 < m_source.size() && m_source[position + 1] == '.' && digit_at(position + 2));
+    }
     if (first == '.') {
-        if (pos + 1 >= m_input.length()) return false;
-        return std::isdigit(m_input[pos + 1]);
+        return digit_at(position + 1);
     }
+    return digit_at(position);
+}
 
-    return std::isdigit(first);
+bool TokenStream::skip_name() {
+    const char* end = m_source.data() + m_source.size();
+    bool escaped = false;
+    for (;;) {
+        m_position += detail::name_run(m_source.data() + m_position, end);
+        if (!is_valid_escape(m_position)) {
+            return escaped;
+        }
+        escaped = true;
+        ++m_position;
+        skip_escape();
+    }
 }
 
-unicode::CodePoint Tokenizer::consume_escaped_code_point() {
+void TokenStream::skip_escape() {
     if (at_end()) {
-        return 0xFFFD;
+        return;
     }
-
-    unicode::CodePoint cp = consume();
-
-    if (std::isxdigit(cp)) {
-        StringBuilder hex;
-        hex.append(cp);
-        int count = 1;
-        while (!at_end() && count < 6 && std::isxdigit(peek())) {
-            hex.append(consume());
-            count++;
-        }
-        // Skip optional whitespace
-        if (!at_end() && is_whitespace(peek())) {
-            consume();
-        }
-
-        // Convert hex to code point
-        unsigned long value = std::strtoul(hex.build().c_str(), nullptr, 16);
-        if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
-            return 0xFFFD;
-        }
-        return static_cast<unicode::CodePoint>(value);
+    if (!has_class(peek(), detail::HEX_DIGIT)) {
+        ++m_position;
+        return;
+    }
+    for (usize digits = 0; digits < 6 && has_class(peek(), detail::HEX_DIGIT); ++digits) {
+        ++m_position;
+    }
+    if (has_class(peek(), detail::WHITESPACE)) {
+        ++m_position;
     }
-
-    return cp;
 }
 
-String Tokenizer::consume_name() {
-    StringBuilder result;
-
+void TokenStream::skip_remnants_of_bad_url() {
     while (!at_end()) {
-        unicode::CodePoint cp = peek();
-
-        if (is_name_code_point(cp)) {
-            result.append(consume());
-        } else if (is_valid_escape()) {
-            consume(); // consume backslash
-            result.append(consume_escaped_code_point());
-        } else {
-            break;
+        char c = m_source[m_position++];
+        if (c == ')') {
+            return;
+        }
+        if (is_valid_escape(m_position - 1)) {
+            skip_escape();
         }
     }
-
-    return result.build();
 }
 
-std::pair<f64, bool> Tokenizer::consume_number() {
-    StringBuilder repr;
-    bool is_integer = true;
-
-    // sign
-    if (peek() == '+' || peek() == '-') {
-        repr.append(consume());
-    }
-
-    // digits before decimal
-    while (!at_end() && std::isdigit(peek())) {
-        repr.append(consume());
+String TokenStream::value(const TokenView& token) const {
+    auto raw = token.kind == TokenKind::Dimension ? unit_text(token) : text(token);
+    if (!token.has(TokenView::ESCAPED)) {
+        return String(raw);
     }
+    return decode_escapes(raw);
+}
 
-    // fractional part
-    if (!at_end() && peek() == '.' && std::isdigit(peek(1))) {
-        is_integer = false;
-        repr.append(consume()); // .
-        while (!at_end() && std::isdigit(peek())) {
-            repr.append(consume());
+f64 TokenStream::number(const TokenView& token) const {
+    auto digits = number_text(token);
+    bool negative = digits[0] == '-';
+    if (digits[0] == '-' || digits[0] == '+') {
+        digits.remove_prefix(1);
+    }
+    f64 value = 0.0;
+    if (token.has(TokenView::INTEGER) && digits.size() <= 18) {
+        // Fits in an i64, whose conversion rounds the same way from_chars does
+        i64 integer = 0;
+        for (char c : digits) {
+            integer = integer * 10 + (c - '0');
+        }
+        value = static_cast<f64>(integer);
+    } else {
+        auto result = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (result.ec == std::errc::result_out_of_range) {
+            // from_chars leaves value alone; strtod saturates to inf or 0 like before
+            value = std::strtod(std::string(digits).c_str(), nullptr);
         }
     }
+    return negative ? -value : value;
+}
 
-    // exponent part
-    if (!at_end() && (peek() == 'e' || peek() == 'E')) {
-        bool valid_exponent = false;
-        unicode::CodePoint next = peek(1);
-        unicode::CodePoint next2 = peek(2);
+// ============================================================================
+// Tokenizer implementation
+// ============================================================================
 
-        if (std::isdigit(next)) {
-            valid_exponent = true;
-        } else if ((next == '+' || next == '-') && std::isdigit(next2)) {
-            valid_exponent = true;
-        }
+Tokenizer::Tokenizer() = default;
 
-        if (valid_exponent) {
-            is_integer = false;
-            repr.append(consume()); // e/E
-            if (peek() == '+' || peek() == '-') {
-                repr.append(consume());
-            }
-            while (!at_end() && std::isdigit(peek())) {
-                repr.append(consume());
-            }
+void Tokenizer::set_input(const String& input) {
+    m_input = input;
+    m_stream = TokenStream(m_input.view());
+    m_peeked.reset();
+}
+
+void Tokenizer::set_input(std::string_view input) {
+    m_input = String(input);
+    m_stream = TokenStream(m_input.view());
+    m_peeked.reset();
+}
+
+std::vector<Token> Tokenizer::tokenize() {
+    std::vector<Token> tokens;
+    while (!at_end()) {
+        tokens.push_back(next_token());
+        if (std::holds_alternative<EOFToken>(tokens.back())) {
+            break;
         }
     }
-
-    f64 value = std::strtod(repr.build().c_str(), nullptr);
-    return {value, is_integer};
+    return tokens;
 }
 
-void Tokenizer::consume_whitespace() {
-    while (!at_end() && is_whitespace(peek())) {
-        consume();
+Token Tokenizer::next_token() {
+    if (m_peeked) {
+        Token token = std::move(*m_peeked);
+        m_peeked.reset();
+        return token;
     }
+    return to_token(m_stream.next());
 }
 
-void Tokenizer::consume_remnants_of_bad_url() {
-    while (!at_end()) {
-        unicode::CodePoint cp = consume();
-        if (cp == ')') return;
-        if (is_valid_escape(-1)) {
-            consume_escaped_code_point();
-        }
+Token Tokenizer::peek_token() {
+    if (!m_peeked) {
+        m_peeked = to_token(m_stream.next());
     }
+    return *m_peeked;
+}
+
+bool Tokenizer::at_end() const {
+    return m_stream.at_end();
+}
+
+Token Tokenizer::to_token(const TokenView& view) const {
+    switch (view.kind) {
+        case TokenKind::Ident: return IdentToken{m_stream.value(view)};
+        case TokenKind::Function: return FunctionToken{m_stream.value(view)};
+        case TokenKind::AtKeyword: return AtKeywordToken{m_stream.value(view)};
+        case TokenKind::Hash: return HashToken{m_stream.value(view), view.has(TokenView::ID)};
+        case TokenKind::String: return StringToken{m_stream.value(view)};
+        case TokenKind::BadString: return BadStringToken{};
+        case TokenKind::Url: return UrlToken{m_stream.value(view)};
+        case TokenKind::BadUrl: return BadUrlToken{};
+        case TokenKind::Delim: return DelimToken{m_stream.delim(view)};
+        case TokenKind::Number: return NumberToken{m_stream.number(view), view.has(TokenView::INTEGER)};
+        case TokenKind::Percentage: return PercentageToken{m_stream.number(view)};
+        case TokenKind::Dimension:
+            return DimensionToken{m_stream.number(view), m_stream.value(view), view.has(TokenView::INTEGER)};
+        case TokenKind::CDO: return CDOToken{};
+        case TokenKind::CDC: return CDCToken{};
+        case TokenKind::Colon: return ColonToken{};
+        case TokenKind::Semicolon: return SemicolonToken{};
+        case TokenKind::Comma: return CommaToken{};
+        case TokenKind::OpenSquare: return OpenSquareToken{};
+        case TokenKind::CloseSquare: return CloseSquareToken{};
+        case TokenKind::OpenParen: return OpenParenToken{};
+        case TokenKind::CloseParen: return CloseParenToken{};
+        case TokenKind::OpenCurly: return OpenCurlyToken{};
+        case TokenKind::CloseCurly: return CloseCurlyToken{};
+        case TokenKind::EndOfFile: break;
+    }
+    return EOFToken{};
 }
 
 } // namespace lithium::css
@@ -7,7 +7,6 @@
 #include <cctype>
 #include <algorithm>
 #include <unordered_map>
-#include <iostream>
 
 namespace lithium::css {
 
@@ -101,6 +100,34 @@ f64 Time::to_milliseconds() const {
     return to_seconds() * 1000.0;
 }
 
+// ============================================================================
+// ComputedValue
+// ============================================================================
+
+namespace {
+
+// One shared instance of each group at its initial values
+template<typename T>
+const RefPtr<T>& initial_group() {
+    static const RefPtr<T> group = make_ref<T>();
+    return group;
+}
+
+} // namespace
+
+ComputedValue::ComputedValue()
+    : m_box(initial_group<BoxProperties>())
+    , m_border(initial_group<BorderProperties>())
+    , m_background(initial_group<BackgroundProperties>())
+    , m_font(initial_group<FontProperties>())
+    , m_inherited_text(initial_group<InheritedTextProperties>())
+    , m_text(initial_group<TextProperties>()) {}
+
+void ComputedValue::inherit_from(const ComputedValue& parent) {
+    m_font = parent.m_font;
+    m_inherited_text = parent.m_inherited_text;
+}
+
 // ============================================================================
 // ValueParser
 // ============================================================================
@@ -351,14 +378,47 @@ std::optional<FontWeight> ValueParser::parse_font_weight(const String& value) {
     return std::nullopt;
 }
 
-bool ValueParser::apply_property(ComputedValue& style, const String& property, const String& value) {
+namespace {
+
+void push_box(std::vector<TypedDeclaration>& out, PropertyId top, PropertyId right, PropertyId bottom,
+              PropertyId left, const Length& length) {
+    out.push_back({top, length});
+    out.push_back({right, length});
+    out.push_back({bottom, length});
+    out.push_back({left, length});
+}
+
+} // namespace
+
+bool ValueParser::parse_declaration(const String& property, const String& value,
+                                    std::vector<TypedDeclaration>& out) {
     String prop = property.to_lowercase();
     String val = value.trim();
 
+    // Properties whose value is a single length
+    static const std::unordered_map<std::string, PropertyId> length_properties = {
+        {"font-size", PropertyId::FontSize},
+        {"margin-top", PropertyId::MarginTop},
+        {"margin-right", PropertyId::MarginRight},
+        {"margin-bottom", PropertyId::MarginBottom},
+        {"margin-left", PropertyId::MarginLeft},
+        {"padding-top", PropertyId::PaddingTop},
+        {"padding-right", PropertyId::PaddingRight},
+        {"padding-bottom", PropertyId::PaddingBottom},
+        {"padding-left", PropertyId::PaddingLeft},
+    };
+    if (auto it = length_properties.find(std::string(prop.c_str())); it != length_properties.end()) {
+        if (auto length = parse_length(val)) {
+            out.push_back({it->second, *length});
+            return true;
+        }
+        return false;
+    }
+
     // Display
     if (prop == "display"_s) {
         if (auto display = parse_display(val)) {
-            style.display = *display;
+            out.push_back({PropertyId::Display, *display});
             return true;
         }
         return false;
@@ -367,33 +427,16 @@ bool ValueParser::apply_property(ComputedValue& style, const String& property, c
     // Position
     if (prop == "position"_s) {
         if (auto position = parse_position(val)) {
-            style.position = *position;
+            out.push_back({PropertyId::Position, *position});
             return true;
         }
         return false;
     }
 
     // Color
-    if (prop == "color"_s) {
-        if (auto color = parse_color(val)) {
-            style.color = *color;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "background-color"_s || prop == "background"_s) {
+    if (prop == "color"_s || prop == "background-color"_s || prop == "background"_s) {
         if (auto color = parse_color(val)) {
-            style.background_color = *color;
-            return true;
-        }
-        return false;
-    }
-
-    // Font size
-    if (prop == "font-size"_s) {
-        if (auto length = parse_length(val)) {
-            style.font_size = *length;
+            out.push_back({prop == "color"_s ? PropertyId::Color : PropertyId::BackgroundColor, *color});
             return true;
         }
         return false;
@@ -402,134 +445,49 @@ bool ValueParser::apply_property(ComputedValue& style, const String& property, c
     // Font weight
     if (prop == "font-weight"_s) {
         if (auto weight = parse_font_weight(val)) {
-            style.font_weight = *weight;
+            out.push_back({PropertyId::FontWeight, *weight});
             return true;
         }
         return false;
     }
 
     // Width/Height
-    if (prop == "width"_s) {
-        if (val == "auto"_s) {
-            style.width = std::nullopt;
-            return true;
-        }
-        if (auto length = parse_length(val)) {
-            style.width = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "height"_s) {
+    if (prop == "width"_s || prop == "height"_s) {
+        auto id = prop == "width"_s ? PropertyId::Width : PropertyId::Height;
         if (val == "auto"_s) {
-            style.height = std::nullopt;
+            out.push_back({id, AutoValue{}});
             return true;
         }
         if (auto length = parse_length(val)) {
-            style.height = *length;
+            out.push_back({id, *length});
             return true;
         }
         return false;
     }
 
-    // Margin
+    // Box shorthands (a single length for all four sides)
     if (prop == "margin"_s) {
         if (auto length = parse_length(val)) {
-            style.margin_top = *length;
-            style.margin_right = *length;
-            style.margin_bottom = *length;
-            style.margin_left = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "margin-top"_s) {
-        if (auto length = parse_length(val)) {
-            style.margin_top = *length;
-            std::cout << "    Applied margin-top: " << length->value << " em" << std::endl;
-            return true;
-        }
-        std::cout << "    Failed to parse margin-top: '" << val.c_str() << "'" << std::endl;
-        return false;
-    }
-
-    if (prop == "margin-right"_s) {
-        if (auto length = parse_length(val)) {
-            style.margin_right = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "margin-bottom"_s) {
-        if (auto length = parse_length(val)) {
-            style.margin_bottom = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "margin-left"_s) {
-        if (auto length = parse_length(val)) {
-            style.margin_left = *length;
+            push_box(out, PropertyId::MarginTop, PropertyId::MarginRight, PropertyId::MarginBottom,
+                     PropertyId::MarginLeft, *length);
             return true;
         }
         return false;
     }
 
-    // Padding
     if (prop == "padding"_s) {
         if (auto length = parse_length(val)) {
-            style.padding_top = *length;
-            style.padding_right = *length;
-            style.padding_bottom = *length;
-            style.padding_left = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "padding-top"_s) {
-        if (auto length = parse_length(val)) {
-            style.padding_top = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "padding-right"_s) {
-        if (auto length = parse_length(val)) {
-            style.padding_right = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "padding-bottom"_s) {
-        if (auto length = parse_length(val)) {
-            style.padding_bottom = *length;
-            return true;
-        }
-        return false;
-    }
-
-    if (prop == "padding-left"_s) {
-        if (auto length = parse_length(val)) {
-            style.padding_left = *length;
+            push_box(out, PropertyId::PaddingTop, PropertyId::PaddingRight, PropertyId::PaddingBottom,
+                     PropertyId::PaddingLeft, *length);
             return true;
         }
         return false;
     }
 
-    // Border width
     if (prop == "border-width"_s) {
         if (auto length = parse_length(val)) {
-            style.border_top_width = *length;
-            style.border_right_width = *length;
-            style.border_bottom_width = *length;
-            style.border_left_width = *length;
+            push_box(out, PropertyId::BorderTopWidth, PropertyId::BorderRightWidth, PropertyId::BorderBottomWidth,
+                     PropertyId::BorderLeftWidth, *length);
             return true;
         }
         return false;
@@ -538,36 +496,39 @@ bool ValueParser::apply_property(ComputedValue& style, const String& property, c
     // Opacity
     if (prop == "opacity"_s) {
         f64 opacity = std::strtod(val.c_str(), nullptr);
-        style.opacity = static_cast<f32>(std::clamp(opacity, 0.0, 1.0));
+        out.push_back({PropertyId::Opacity, static_cast<f32>(std::clamp(opacity, 0.0, 1.0))});
         return true;
     }
 
     // Text align
     if (prop == "text-align"_s) {
         String lower = val.to_lowercase();
-        if (lower == "left"_s) { style.text_align = TextAlign::Left; return true; }
-        if (lower == "right"_s) { style.text_align = TextAlign::Right; return true; }
-        if (lower == "center"_s) { style.text_align = TextAlign::Center; return true; }
-        if (lower == "justify"_s) { style.text_align = TextAlign::Justify; return true; }
-        if (lower == "start"_s) { style.text_align = TextAlign::Start; return true; }
-        if (lower == "end"_s) { style.text_align = TextAlign::End; return true; }
-        return false;
+        std::optional<TextAlign> align;
+        if (lower == "left"_s) align = TextAlign::Left;
+        else if (lower == "right"_s) align = TextAlign::Right;
+        else if (lower == "center"_s) align = TextAlign::Center;
+        else if (lower == "justify"_s) align = TextAlign::Justify;
+        else if (lower == "start"_s) align = TextAlign::Start;
+        else if (lower == "end"_s) align = TextAlign::End;
+        if (!align) return false;
+        out.push_back({PropertyId::TextAlign, *align});
+        return true;
     }
 
     // Line height
     if (prop == "line-height"_s) {
         if (val == "normal"_s) {
-            style.line_height = Length{1.2f, LengthUnit::Em};
+            out.push_back({PropertyId::LineHeight, Length{1.2f, LengthUnit::Em}});
             return true;
         }
         if (auto length = parse_length(val)) {
-            style.line_height = *length;
+            out.push_back({PropertyId::LineHeight, *length});
             return true;
         }
         // Unitless number
         f64 multiplier = std::strtod(val.c_str(), nullptr);
         if (multiplier > 0) {
-            style.line_height = Length{multiplier, LengthUnit::Em};
+            out.push_back({PropertyId::LineHeight, Length{multiplier, LengthUnit::Em}});
             return true;
         }
         return false;
@@ -576,4 +537,50 @@ bool ValueParser::apply_property(ComputedValue& style, const String& property, c
     return false;
 }
 
+void ValueParser::apply_declaration(ComputedValue& style, const TypedDeclaration& declaration) {
+    const auto& value = declaration.value;
+    auto length = [&value]() -> const Length& { return std::get<Length>(value); };
+    auto optional_length = [&value]() -> std::optional<Length> {
+        if (std::holds_alternative<AutoValue>(value)) return std::nullopt;
+        return std::get<Length>(value);
+    };
+
+    switch (declaration.property) {
+        case PropertyId::Display: style.mutable_box().display = std::get<Display>(value); break;
+        case PropertyId::Position: style.mutable_box().position = std::get<Position>(value); break;
+        case PropertyId::Color: style.mutable_inherited_text().color = std::get<Color>(value); break;
+        case PropertyId::BackgroundColor: style.mutable_background().background_color = std::get<Color>(value); break;
+        case PropertyId::FontSize: style.mutable_font().font_size = length(); break;
+        case PropertyId::FontWeight: style.mutable_font().font_weight = std::get<FontWeight>(value); break;
+        case PropertyId::LineHeight: style.mutable_font().line_height = length(); break;
+        case PropertyId::TextAlign: style.mutable_inherited_text().text_align = std::get<TextAlign>(value); break;
+        case PropertyId::Width: style.mutable_box().width = optional_length(); break;
+        case PropertyId::Height: style.mutable_box().height = optional_length(); break;
+        case PropertyId::MarginTop: style.mutable_box().margin_top = length(); break;
+        case PropertyId::MarginRight: style.mutable_box().margin_right = length(); break;
+        case PropertyId::MarginBottom: style.mutable_box().margin_bottom = length(); break;
+        case PropertyId::MarginLeft: style.mutable_box().margin_left = length(); break;
+        case PropertyId::PaddingTop: style.mutable_box().padding_top = length(); break;
+        case PropertyId::PaddingRight: style.mutable_box().padding_right = length(); break;
+        case PropertyId::PaddingBottom: style.mutable_box().padding_bottom = length(); break;
+        case PropertyId::PaddingLeft: style.mutable_box().padding_left = length(); break;
+        case PropertyId::BorderTopWidth: style.mutable_border().border_top_width = length(); break;
+        case PropertyId::BorderRightWidth: style.mutable_border().border_right_width = length(); break;
+        case PropertyId::BorderBottomWidth: style.mutable_border().border_bottom_width = length(); break;
+        case PropertyId::BorderLeftWidth: style.mutable_border().border_left_width = length(); break;
+        case PropertyId::Opacity: style.mutable_box().opacity = std::get<f32>(value); break;
+    }
+}
+
+bool ValueParser::apply_property(ComputedValue& style, const String& property, const String& value) {
+    std::vector<TypedDeclaration> declarations;
+    if (!parse_declaration(property, value, declarations)) {
+        return false;
+    }
+    for (const auto& declaration : declarations) {
+        apply_declaration(style, declaration);
+    }
+    return true;
+}
+
 } // namespace lithium::css
@@ -2,6 +2,7 @@
 
 #include "node.hpp"
 #include "element.hpp"
+#include <unordered_map>
 
 namespace lithium::dom {
 
@@ -43,6 +44,26 @@ private:
     String m_system_id;
 };
 
+// ============================================================================
+// DocumentObserver - Notified of tree and attribute mutations
+// ============================================================================
+//
+// Lets a consumer such as the style system react to changes made after the
+// document was built (by script, for instance) without rescanning the tree.
+// Callbacks run synchronously, after the mutation has been applied.
+
+class DocumentObserver {
+public:
+    virtual ~DocumentObserver() = default;
+
+    // An attribute was set or removed; `old_value` is empty if it was absent
+    virtual void attribute_changed(Element& element, const String& name, const std::optional<String>& old_value) = 0;
+
+    // `child` was inserted under, or removed from, `parent`
+    virtual void child_inserted(Node& parent, Node& child) = 0;
+    virtual void child_removed(Node& parent, Node& child) = 0;
+};
+
 // ============================================================================
 // Document - Represents the entire HTML document
 // ============================================================================
@@ -50,6 +71,7 @@ private:
 class Document : public Node {
 public:
     Document();
+    ~Document() override;
 
     // Node interface
     [[nodiscard]] NodeType node_type() const override { return NodeType::Document; }
@@ -75,16 +97,20 @@ public:
     [[nodiscard]] const String& content_type() const { return m_content_type; }
     void set_content_type(const String& type) { m_content_type = type; }
 
-    // Element creation
+    // Node creation; nodes are allocated in the document's arena
     [[nodiscard]] RefPtr<Element> create_element(const String& tag_name);
+    [[nodiscard]] RefPtr<Element> create_element(Atom local_name);
     [[nodiscard]] RefPtr<Element> create_element_ns(const String& namespace_uri, const String& qualified_name);
-    [[nodiscard]] RefPtr<Text> create_text_node(const String& data);
+    [[nodiscard]] RefPtr<Text> create_text_node(String data);
     [[nodiscard]] RefPtr<Node> create_comment(const String& data);
     [[nodiscard]] RefPtr<DocumentFragment> create_document_fragment();
     [[nodiscard]] RefPtr<DocumentType> create_document_type(
         const String& name, const String& public_id, const String& system_id);
 
-    // Element lookup
+    // Element lookup, over the elements connected to the document. Ids are
+    // indexed as the tree and id attributes change; tag and class results
+    // are collected on first use and reused until a tree or class change.
+    // Not safe to call from several threads at once.
     [[nodiscard]] Element* get_element_by_id(const String& id) const;
     [[nodiscard]] std::vector<Element*> get_elements_by_tag_name(const String& tag_name) const;
     [[nodiscard]] std::vector<Element*> get_elements_by_class_name(const String& class_names) const;
@@ -106,7 +132,24 @@ public:
     [[nodiscard]] QuirksMode quirks_mode() const { return m_quirks_mode; }
     void set_quirks_mode(QuirksMode mode) { m_quirks_mode = mode; }
 
+    // Slabs holding the nodes this document created
+    [[nodiscard]] NodeArena& node_arena() const { return *m_node_arena; }
+
+    // Mutation observer (not owned; null when nothing observes the document)
+    [[nodiscard]] DocumentObserver* observer() const { return m_observer; }
+    void set_observer(DocumentObserver* observer) { m_observer = observer; }
+
 private:
+    // Index maintenance, called by Node and Element after the mutation
+    friend class Node;
+    friend class Element;
+    void connect_subtree(Node& root);
+    void disconnect_subtree(Node& root);
+    void id_changed(Element& element, const String& old_id);
+    void classes_changed();
+    void invalidate_collections();
+
+    RefPtr<NodeArena> m_node_arena{make_ref<NodeArena>()};
     RefPtr<DocumentType> m_doctype;
     String m_title;
     String m_url;
@@ -114,6 +157,14 @@ private:
     String m_content_type{"text/html"};
     ReadyState m_ready_state{ReadyState::Loading};
     QuirksMode m_quirks_mode{QuirksMode::NoQuirks};
+    DocumentObserver* m_observer{nullptr};
+
+    // Connected elements by non-empty id, in no particular order
+    std::unordered_map<String, std::vector<Element*>> m_elements_by_id;
+    // Cached results in tree order: by lowercase tag name (or "*"), and by
+    // the class names string as queried
+    mutable std::unordered_map<String, std::vector<Element*>> m_tag_collections;
+    mutable std::unordered_map<String, std::vector<Element*>> m_class_collections;
 };
 
 } // namespace lithium::dom
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "node.hpp"
+#include "qualified_name.hpp"
 #include <unordered_map>
 #include <optional>
 
@@ -13,11 +14,13 @@ class DocumentFragment;
 // ============================================================================
 
 struct Attribute {
-    String name;
+    const QualifiedName* qualified_name;  // Interned; never null
     String value;
-    String namespace_uri;
-    String prefix;
-    String local_name;
+
+    [[nodiscard]] const String& name() const { return qualified_name->qualified_name(); }
+    [[nodiscard]] const String& local_name() const { return qualified_name->local_name(); }
+    [[nodiscard]] const String& namespace_uri() const { return qualified_name->namespace_uri(); }
+    [[nodiscard]] const String& prefix() const { return qualified_name->prefix(); }
 };
 
 // ============================================================================
@@ -28,28 +31,33 @@ class Element : public Node {
 public:
     explicit Element(const String& tag_name);
     Element(const String& namespace_uri, const String& qualified_name);
+    explicit Element(const QualifiedName& name);
 
     // Node interface
     [[nodiscard]] NodeType node_type() const override { return NodeType::Element; }
-    [[nodiscard]] String node_name() const override { return m_tag_name.to_uppercase(); }
+    [[nodiscard]] String node_name() const override { return m_name->uppercase_name(); }
     [[nodiscard]] RefPtr<Node> clone_node(bool deep) const override;
 
     // Element-specific
-    [[nodiscard]] const String& tag_name() const { return m_tag_name; }
-    [[nodiscard]] const String& local_name() const { return m_local_name; }
-    [[nodiscard]] const String& namespace_uri() const { return m_namespace_uri; }
-    [[nodiscard]] const String& prefix() const { return m_prefix; }
+    [[nodiscard]] const String& tag_name() const { return m_name->qualified_name(); }
+    [[nodiscard]] const String& local_name() const { return m_name->local_name(); }
+    [[nodiscard]] Atom local_name_atom() const { return m_name->local_name_atom(); }
+    [[nodiscard]] const String& namespace_uri() const { return m_name->namespace_uri(); }
+    [[nodiscard]] const String& prefix() const { return m_name->prefix(); }
+    [[nodiscard]] const QualifiedName& qualified_name() const { return *m_name; }
     [[nodiscard]] Element* form_owner() const { return m_form_owner; }
     void set_form_owner(Element* form) { m_form_owner = form; }
 
-    // ID and class
-    [[nodiscard]] String id() const { return get_attribute("id"_s).value_or(String()); }
+    // ID and class (kept parsed as the attributes change, so reading them
+    // does not allocate)
+    [[nodiscard]] const String& id() const { return m_id; }
     void set_id(const String& id) { set_attribute("id"_s, id); }
 
     [[nodiscard]] String class_name() const { return get_attribute("class"_s).value_or(String()); }
     void set_class_name(const String& class_name) { set_attribute("class"_s, class_name); }
 
-    [[nodiscard]] std::vector<String> class_list() const;
+    [[nodiscard]] const std::vector<String>& class_list() const { return m_classes; }
+    [[nodiscard]] bool has_class(std::string_view class_name) const;
 
     // Attributes
     [[nodiscard]] bool has_attribute(const String& name) const;
@@ -59,6 +67,7 @@ public:
     [[nodiscard]] std::optional<String> get_attribute_ns(const String& namespace_uri, const String& local_name) const;
 
     void set_attribute(const String& name, const String& value);
+    void set_attribute(Atom name, const String& value);
     void set_attribute_ns(const String& namespace_uri, const String& qualified_name, const String& value);
 
     void remove_attribute(const String& name);
@@ -80,7 +89,7 @@ public:
     [[nodiscard]] std::vector<Element*> get_elements_by_tag_name(const String& tag_name) const;
     [[nodiscard]] std::vector<Element*> get_elements_by_class_name(const String& class_names) const;
 
-    // Inner/Outer HTML
+    // Inner/Outer HTML (see serializer.hpp)
     [[nodiscard]] String inner_html() const;
     void set_inner_html(const String& html);
 
@@ -90,11 +99,13 @@ public:
     [[nodiscard]] bool matches(const String& selectors) const;
 
 private:
-    String m_tag_name;
-    String m_local_name;
-    String m_namespace_uri;
-    String m_prefix;
+    // Refreshes m_id / m_classes after the attribute `name` changed
+    void update_cached_attribute(std::string_view name);
+
+    const QualifiedName* m_name;
     std::vector<Attribute> m_attributes;
+    String m_id;
+    std::vector<String> m_classes;
     Element* m_form_owner{nullptr};
 };
 
@@ -105,6 +116,7 @@ private:
 class HTMLElement : public Element {
 public:
     explicit HTMLElement(const String& tag_name);
+    explicit HTMLElement(const QualifiedName& name);
 
     // Global attributes
     [[nodiscard]] String title() const { return get_attribute("title"_s).value_or(String()); }
@@ -2,6 +2,9 @@
 
 #include "lithium/core/types.hpp"
 #include "lithium/core/string.hpp"
+#include "node_arena.hpp"
+#include <cstddef>
+#include <iterator>
 #include <vector>
 #include <memory>
 
@@ -11,6 +14,61 @@ namespace lithium::dom {
 class Document;
 class Element;
 class Text;
+class Node;
+
+// ============================================================================
+// ChildNodes - Live view of a node's children
+// ============================================================================
+//
+// Walks the parent's intrusive sibling list, so it always reflects the
+// current children and is free to copy. size() is O(1); item() walks from
+// the nearest of the first child, the last child and a cursor cached on the
+// parent, so indexing through the children in order costs O(1) per step.
+// Any change to the child list drops the cursor.
+
+class ChildNodes {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Node* const*;
+        using reference = Node*;
+
+        Iterator() = default;
+        explicit Iterator(Node* node) : m_node(node) {}
+
+        [[nodiscard]] Node* operator*() const { return m_node; }
+        Iterator& operator++();
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        [[nodiscard]] bool operator==(const Iterator& other) const { return m_node == other.m_node; }
+        [[nodiscard]] bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+
+    private:
+        Node* m_node{nullptr};
+    };
+
+    explicit ChildNodes(const Node& parent) : m_parent(&parent) {}
+
+    [[nodiscard]] Iterator begin() const;
+    [[nodiscard]] Iterator end() const { return Iterator(); }
+
+    [[nodiscard]] usize size() const;
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    // The child at `index`, or null past the end
+    [[nodiscard]] Node* item(usize index) const;
+    [[nodiscard]] Node* operator[](usize index) const { return item(index); }
+
+private:
+    const Node* m_parent;
+};
 
 // ============================================================================
 // Node types (as per DOM spec)
@@ -34,7 +92,16 @@ enum class NodeType : u16 {
 
 class Node : public RefCounted {
 public:
-    virtual ~Node() = default;
+    virtual ~Node();
+
+    // Every node is allocated behind a one-pointer header naming the arena
+    // slab it came from (null for the global heap), so the last release()
+    // returns the memory there. Documents create their nodes in their
+    // NodeArena; make_ref<SomeNode> still allocates from the heap.
+    static void* operator new(usize size);
+    static void* operator new(usize size, NodeArena& arena);
+    static void operator delete(void* ptr);
+    static void operator delete(void* ptr, NodeArena& arena);
 
     // Type information
     [[nodiscard]] virtual NodeType node_type() const = 0;
@@ -49,11 +116,15 @@ public:
     [[nodiscard]] Node* next_sibling() const { return m_next_sibling.get(); }
 
     [[nodiscard]] bool has_children() const { return m_first_child != nullptr; }
-    [[nodiscard]] const std::vector<RefPtr<Node>>& child_nodes() const { return m_children; }
+    [[nodiscard]] ChildNodes child_nodes() const { return ChildNodes(*this); }
+    [[nodiscard]] usize child_count() const { return m_child_count; }
 
     // Document access
     [[nodiscard]] Document* owner_document() const { return m_owner_document; }
 
+    // Whether the node is in its owner document's tree (a document always is)
+    [[nodiscard]] bool is_connected() const { return m_connected; }
+
     // Tree manipulation
     RefPtr<Node> append_child(RefPtr<Node> child);
     RefPtr<Node> insert_before(RefPtr<Node> node, Node* reference);
@@ -71,6 +142,10 @@ public:
     [[nodiscard]] bool is_same_node(const Node* other) const { return this == other; }
     [[nodiscard]] bool contains(const Node* other) const;
 
+    // The node after this one in tree order, staying within `root`'s
+    // subtree; null after its last node
+    [[nodiscard]] Node* next_in_subtree(const Node& root) const;
+
     // Type checking helpers
     [[nodiscard]] bool is_element() const { return node_type() == NodeType::Element; }
     [[nodiscard]] bool is_text() const { return node_type() == NodeType::Text; }
@@ -90,19 +165,55 @@ protected:
     void set_owner_document(Document* doc) { m_owner_document = doc; }
     void set_parent(Node* parent) { m_parent = parent; }
 
+    // A new node in the arena this node came from (the heap for heap
+    // nodes), for clones and splits
+    template<typename T, typename... Args>
+    [[nodiscard]] RefPtr<T> create_node(Args&&... args) const {
+        if (auto* arena = allocating_arena()) {
+            return arena->create<T>(std::forward<Args>(args)...);
+        }
+        return make_ref<T>(std::forward<Args>(args)...);
+    }
+
 private:
-    void update_child_list();
+    [[nodiscard]] NodeArena* allocating_arena() const;
+
+    // Links `child` in before `next` (after the last child when null) and
+    // unlinks it again; tree bookkeeping is left to the callers
+    void link_child(RefPtr<Node> child, Node* next);
+    void unlink_child(Node& child);
 
+    // A node owns its first child and each child owns its next sibling
     Document* m_owner_document{nullptr};
     Node* m_parent{nullptr};
     RefPtr<Node> m_first_child;
     Node* m_last_child{nullptr};
     Node* m_previous_sibling{nullptr};
     RefPtr<Node> m_next_sibling;
-    std::vector<RefPtr<Node>> m_children;
 
+    // ChildNodes::item's cursor: m_child_cursor is the child at
+    // m_child_cursor_index, or null when there is none
+    mutable Node* m_child_cursor{nullptr};
+    mutable u32 m_child_cursor_index{0};
+    u32 m_child_count{0};
+    bool m_connected{false};
+
+    friend class ChildNodes;
     friend class Document;
     friend class Element;
 };
 
+inline ChildNodes::Iterator& ChildNodes::Iterator::operator++() {
+    m_node = m_node->next_sibling();
+    return *this;
+}
+
+inline ChildNodes::Iterator ChildNodes::begin() const {
+    return Iterator(m_parent->first_child());
+}
+
+inline usize ChildNodes::size() const {
+    return m_parent->m_child_count;
+}
+
 } // namespace lithium::dom
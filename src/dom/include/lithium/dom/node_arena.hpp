@@ -0,0 +1,76 @@
+#pragma once
+
+#include "lithium/core/types.hpp"
+#include <utility>
+#include <vector>
+
+namespace lithium::dom {
+
+class Node;
+
+// ============================================================================
+// NodeArena - Slab allocator for one document's nodes
+// ============================================================================
+//
+// A document creates its nodes here instead of on the global heap: each node
+// size (in practice, each node type) gets its own slab of fixed-size slots,
+// carved from large blocks and recycled through a free list, as in
+// memory::Pool. Nodes stay reference counted as before. A node returns its
+// slot when its last reference goes, wherever that happens, and holds a
+// reference on the arena, so the blocks are released once the document and
+// every node allocated from it are gone. Not thread-safe: nodes are created
+// and released on the document's thread.
+
+struct NodeArenaStats {
+    struct Slab {
+        usize slot_size;  // Bytes per slot, node header included
+        usize live;       // Slots holding a node
+        usize capacity;   // Slots carved from blocks so far
+    };
+    std::vector<Slab> slabs;
+
+    [[nodiscard]] usize live() const;
+    [[nodiscard]] usize reserved() const;  // Bytes held in blocks
+};
+
+class NodeArena : public RefCounted {
+public:
+    NodeArena() = default;
+    ~NodeArena() override;
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    // Constructs a T (a Node type) in one of this arena's slots
+    template<typename T, typename... Args>
+    [[nodiscard]] RefPtr<T> create(Args&&... args) {
+        return RefPtr<T>(new (*this) T(std::forward<Args>(args)...));
+    }
+
+    [[nodiscard]] NodeArenaStats stats() const;
+
+private:
+    friend class Node;
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct Slab {
+        NodeArena* arena;
+        usize slot_size;
+        FreeSlot* free_list{nullptr};
+        std::vector<u8*> blocks;
+        usize capacity{0};
+        usize live{0};
+    };
+
+    // A slot of at least `size` bytes, and the slab to give it back to
+    [[nodiscard]] std::pair<void*, Slab*> allocate(usize size);
+    static void deallocate(void* slot, Slab& slab);
+
+    // Slabs are few (one per node size) and never move once created
+    std::vector<Slab*> m_slabs;
+};
+
+} // namespace lithium::dom
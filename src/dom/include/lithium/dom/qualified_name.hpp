@@ -0,0 +1,63 @@
+#pragma once
+
+#include "lithium/core/types.hpp"
+#include "lithium/core/atom.hpp"
+#include "lithium/core/string.hpp"
+#include <string_view>
+
+namespace lithium::dom {
+
+// ============================================================================
+// QualifiedName - Interned element and attribute name
+// ============================================================================
+//
+// One immutable record per distinct name, shared by every element and
+// attribute that carries it, so nodes hold a pointer instead of their own
+// tag, local name, namespace and prefix strings. Two names are the same
+// exactly when their records are. Records live until the process exits;
+// interning takes a lock, reading a record does not.
+
+class QualifiedName {
+public:
+    // A name in no namespace, as HTML creates them: the local name is the
+    // ASCII-lowercased name and there is no prefix
+    [[nodiscard]] static const QualifiedName& html(std::string_view name);
+
+    // The same for an already interned (lowercase) name; names in the
+    // static atom table are found without taking the lock
+    [[nodiscard]] static const QualifiedName& html(Atom name);
+
+    // A name in `namespace_uri`, split at its first ':' into prefix and
+    // local name
+    [[nodiscard]] static const QualifiedName& with_namespace(std::string_view namespace_uri,
+                                                             std::string_view qualified_name);
+
+    QualifiedName(const QualifiedName&) = delete;
+    QualifiedName& operator=(const QualifiedName&) = delete;
+
+    // The name as written (an element's tag name, an attribute's name)
+    [[nodiscard]] const String& qualified_name() const { return m_qualified_name; }
+    [[nodiscard]] const String& local_name() const { return m_local_name; }
+    [[nodiscard]] const String& namespace_uri() const { return m_namespace_uri; }
+    [[nodiscard]] const String& prefix() const { return m_prefix; }
+
+    // The local name as an atom, for comparisons that should not touch
+    // the characters
+    [[nodiscard]] Atom local_name_atom() const { return m_local_name_atom; }
+
+    // The qualified name ASCII-uppercased, for Element::node_name
+    [[nodiscard]] const String& uppercase_name() const { return m_uppercase_name; }
+
+private:
+    friend class QualifiedNameTable;
+    QualifiedName(String qualified_name, String local_name, String namespace_uri, String prefix);
+
+    String m_qualified_name;
+    String m_local_name;
+    String m_namespace_uri;
+    String m_prefix;
+    String m_uppercase_name;
+    Atom m_local_name_atom;
+};
+
+} // namespace lithium::dom
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "lithium/core/string.hpp"
+#include <string>
+#include <string_view>
+
+namespace lithium::dom {
+
+class Node;
+
+// ============================================================================
+// HTML Serializer
+// ============================================================================
+//
+// The HTML fragment serialization algorithm, behind Element::inner_html and
+// outer_html. The subtree is walked once to size the output and once to
+// write it, iteratively (no recursion per level) into a single buffer.
+// Serialization is as with scripting disabled: <noscript> text is escaped.
+
+// The markup for `node`'s children
+[[nodiscard]] String serialize_children(const Node& node);
+
+// The markup for `node` itself, its children included
+[[nodiscard]] String serialize_node(const Node& node);
+
+// Appends `text` to `out` escaped as the serializer escapes text content
+// (`&`, `<`, `>` and U+00A0) or, with `attribute_mode`, attribute values
+// (`"` as well)
+void append_escaped(std::string& out, std::string_view text, bool attribute_mode);
+
+} // namespace lithium::dom
@@ -21,6 +21,7 @@ public:
     [[nodiscard]] usize length() const { return m_data.length(); }
 
     void append_data(const String& data);
+    void append_data(std::string_view data);
     void insert_data(usize offset, const String& data);
     void delete_data(usize offset, usize count);
     void replace_data(usize offset, usize count, const String& data);
@@ -29,7 +30,7 @@ public:
 
 protected:
     CharacterData() = default;
-    explicit CharacterData(const String& data) : m_data(data) {}
+    explicit CharacterData(String data) : m_data(std::move(data)) {}
 
 private:
     String m_data;
@@ -42,7 +43,7 @@ private:
 class Text : public CharacterData {
 public:
     Text() = default;
-    explicit Text(const String& data);
+    explicit Text(String data);
 
     // Node interface
     [[nodiscard]] NodeType node_type() const override { return NodeType::Text; }
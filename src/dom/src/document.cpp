@@ -20,7 +20,7 @@ DocumentType::DocumentType(const String& name, const String& public_id, const St
 }
 
 RefPtr<Node> DocumentType::clone_node(bool /*deep*/) const {
-    return make_ref<DocumentType>(m_name, m_public_id, m_system_id);
+    return create_node<DocumentType>(m_name, m_public_id, m_system_id);
 }
 
 // ============================================================================
@@ -30,7 +30,7 @@ RefPtr<Node> DocumentType::clone_node(bool /*deep*/) const {
 DocumentFragment::DocumentFragment() = default;
 
 RefPtr<Node> DocumentFragment::clone_node(bool deep) const {
-    auto clone = make_ref<DocumentFragment>();
+    auto clone = create_node<DocumentFragment>();
     if (deep) {
         for (const auto& child : child_nodes()) {
             auto child_clone = child->clone_node(true);
@@ -46,6 +46,19 @@ RefPtr<Node> DocumentFragment::clone_node(bool deep) const {
 
 Document::Document() {
     set_owner_document(this);
+    m_connected = true;
+}
+
+Document::~Document() {
+    // Nodes still referenced elsewhere outlive the document: detach them
+    // from it before the children are released
+    for (Node* node = first_child(); node; node = node->next_in_subtree(*this)) {
+        node->m_connected = false;
+        node->set_owner_document(nullptr);
+    }
+    if (m_doctype) {
+        m_doctype->set_owner_document(nullptr);
+    }
 }
 
 RefPtr<Node> Document::clone_node(bool deep) const {
@@ -87,7 +100,7 @@ Element* Document::head() const {
     for (const auto& child : html->child_nodes()) {
         if (child->is_element()) {
             auto* elem = child->as_element();
-            if (elem->local_name() == "head"_s) {
+            if (elem->local_name_atom() == atoms::head) {
                 return elem;
             }
         }
@@ -102,7 +115,7 @@ Element* Document::body() const {
     for (const auto& child : html->child_nodes()) {
         if (child->is_element()) {
             auto* elem = child->as_element();
-            if (elem->local_name() == "body"_s) {
+            if (elem->local_name_atom() == atoms::body) {
                 return elem;
             }
         }
@@ -119,7 +132,7 @@ void Document::set_title(const String& title) {
         for (const auto& child : head_elem->child_nodes()) {
             if (child->is_element()) {
                 auto* elem = child->as_element();
-                if (elem->local_name() == "title"_s) {
+                if (elem->local_name_atom() == atoms::title) {
                     elem->set_text_content(title);
                     return;
                 }
@@ -134,31 +147,37 @@ void Document::set_title(const String& title) {
 }
 
 RefPtr<Element> Document::create_element(const String& tag_name) {
-    auto elem = make_ref<HTMLElement>(tag_name);
+    auto elem = m_node_arena->create<HTMLElement>(tag_name);
+    elem->set_owner_document(this);
+    return elem;
+}
+
+RefPtr<Element> Document::create_element(Atom local_name) {
+    auto elem = m_node_arena->create<HTMLElement>(QualifiedName::html(local_name));
     elem->set_owner_document(this);
     return elem;
 }
 
 RefPtr<Element> Document::create_element_ns(const String& namespace_uri, const String& qualified_name) {
-    auto elem = make_ref<Element>(namespace_uri, qualified_name);
+    auto elem = m_node_arena->create<Element>(namespace_uri, qualified_name);
     elem->set_owner_document(this);
     return elem;
 }
 
-RefPtr<Text> Document::create_text_node(const String& data) {
-    auto text = make_ref<Text>(data);
+RefPtr<Text> Document::create_text_node(String data) {
+    auto text = m_node_arena->create<Text>(std::move(data));
     text->set_owner_document(this);
     return text;
 }
 
 RefPtr<Node> Document::create_comment(const String& data) {
-    auto comment = make_ref<Comment>(data);
+    auto comment = m_node_arena->create<Comment>(data);
     comment->set_owner_document(this);
     return comment;
 }
 
 RefPtr<DocumentFragment> Document::create_document_fragment() {
-    auto fragment = make_ref<DocumentFragment>();
+    auto fragment = m_node_arena->create<DocumentFragment>();
     fragment->set_owner_document(this);
     return fragment;
 }
@@ -166,56 +185,160 @@ RefPtr<DocumentFragment> Document::create_document_fragment() {
 RefPtr<DocumentType> Document::create_document_type(
     const String& name, const String& public_id, const String& system_id)
 {
-    auto doctype = make_ref<DocumentType>(name, public_id, system_id);
+    auto doctype = m_node_arena->create<DocumentType>(name, public_id, system_id);
     doctype->set_owner_document(this);
     m_doctype = doctype;
     return doctype;
 }
 
-Element* Document::get_element_by_id(const String& id) const {
-    std::function<Element*(const Node*)> find = [&](const Node* node) -> Element* {
-        for (const auto& child : node->child_nodes()) {
-            if (child->is_element()) {
-                auto* elem = child->as_element();
-                if (elem->id() == id) {
-                    return elem;
-                }
-                if (auto* found = find(elem)) {
-                    return found;
-                }
-            }
+namespace {
+
+// Whether `a` comes before `b` in tree order; both are in the same tree
+bool precedes(const Node& a, const Node& b) {
+    std::vector<const Node*> a_path;
+    std::vector<const Node*> b_path;
+    for (const Node* node = &a; node; node = node->parent_node()) {
+        a_path.push_back(node);
+    }
+    for (const Node* node = &b; node; node = node->parent_node()) {
+        b_path.push_back(node);
+    }
+    // Walk down from the root to where the paths part
+    auto a_it = a_path.rbegin();
+    auto b_it = b_path.rbegin();
+    while (a_it != a_path.rend() && b_it != b_path.rend() && *a_it == *b_it) {
+        ++a_it;
+        ++b_it;
+    }
+    if (a_it == a_path.rend() || b_it == b_path.rend()) {
+        return a_it == a_path.rend();  // An ancestor comes first
+    }
+    for (const Node* sibling = *a_it; sibling; sibling = sibling->next_sibling()) {
+        if (sibling == *b_it) {
+            return true;
         }
-        return nullptr;
-    };
+    }
+    return false;
+}
 
-    return find(this);
+template<typename Fn>
+void for_each_element(const Node& root, Fn&& fn) {
+    for (Node* node = root.first_child(); node; node = node->next_in_subtree(root)) {
+        if (node->is_element()) {
+            fn(*node->as_element());
+        }
+    }
+}
+
+} // namespace
+
+Element* Document::get_element_by_id(const String& id) const {
+    auto it = m_elements_by_id.find(id);
+    if (it == m_elements_by_id.end()) {
+        return nullptr;
+    }
+    // Several elements with the same id: the first in tree order wins
+    const auto& elements = it->second;
+    return *std::min_element(elements.begin(), elements.end(),
+        [](const Element* a, const Element* b) { return precedes(*a, *b); });
 }
 
 std::vector<Element*> Document::get_elements_by_tag_name(const String& tag_name) const {
-    std::vector<Element*> result;
-    auto lower_tag = tag_name.to_lowercase();
     bool match_all = (tag_name == "*"_s);
+    auto [it, inserted] = m_tag_collections.try_emplace(match_all ? tag_name : tag_name.to_lowercase());
+    if (inserted) {
+        const auto& lower_tag = it->first;
+        auto& result = it->second;
+        for_each_element(*this, [&](Element& element) {
+            if (match_all || element.local_name() == lower_tag) {
+                result.push_back(&element);
+            }
+        });
+    }
+    return it->second;
+}
 
-    std::function<void(const Node*)> collect = [&](const Node* node) {
-        for (const auto& child : node->child_nodes()) {
-            if (child->is_element()) {
-                auto* elem = child->as_element();
-                if (match_all || elem->local_name() == lower_tag) {
-                    result.push_back(elem);
+std::vector<Element*> Document::get_elements_by_class_name(const String& class_names) const {
+    auto [it, inserted] = m_class_collections.try_emplace(class_names);
+    if (inserted) {
+        auto search_classes = class_names.split(' ');
+        search_classes.erase(std::remove_if(search_classes.begin(), search_classes.end(),
+                                            [](const String& name) { return name.empty(); }),
+                             search_classes.end());
+        auto& result = it->second;
+        if (!search_classes.empty()) {
+            for_each_element(*this, [&](Element& element) {
+                bool has_all = std::all_of(search_classes.begin(), search_classes.end(),
+                    [&element](const String& name) { return element.has_class(name.view()); });
+                if (has_all) {
+                    result.push_back(&element);
                 }
-                collect(elem);
+            });
+        }
+    }
+    return it->second;
+}
+
+void Document::connect_subtree(Node& root) {
+    bool has_elements = false;
+    for (Node* node = &root; node; node = node->next_in_subtree(root)) {
+        node->m_connected = true;
+        node->set_owner_document(this);
+        if (node->is_element()) {
+            has_elements = true;
+            auto* element = node->as_element();
+            if (!element->id().empty()) {
+                m_elements_by_id[element->id()].push_back(element);
             }
         }
-    };
+    }
+    if (has_elements) {
+        invalidate_collections();
+    }
+}
 
-    collect(this);
-    return result;
+void Document::disconnect_subtree(Node& root) {
+    bool has_elements = false;
+    for (Node* node = &root; node; node = node->next_in_subtree(root)) {
+        node->m_connected = false;
+        if (node->is_element()) {
+            has_elements = true;
+            auto* element = node->as_element();
+            if (!element->id().empty()) {
+                id_changed(*element, element->id());
+            }
+        }
+    }
+    if (has_elements) {
+        invalidate_collections();
+    }
 }
 
-std::vector<Element*> Document::get_elements_by_class_name(const String& class_names) const {
-    auto* root = document_element();
-    if (!root) return {};
-    return root->get_elements_by_class_name(class_names);
+// Moves a connected element from its old id's entry to its current one's
+// (none once disconnected)
+void Document::id_changed(Element& element, const String& old_id) {
+    if (!old_id.empty()) {
+        auto it = m_elements_by_id.find(old_id);
+        if (it != m_elements_by_id.end()) {
+            auto& elements = it->second;
+            elements.erase(std::remove(elements.begin(), elements.end(), &element), elements.end());
+            if (elements.empty()) {
+                m_elements_by_id.erase(it);
+            }
+        }
+    }
+    if (element.is_connected() && !element.id().empty()) {
+        m_elements_by_id[element.id()].push_back(&element);
+    }
+}
+
+void Document::classes_changed() {
+    m_class_collections.clear();
+}
+
+void Document::invalidate_collections() {
+    m_tag_collections.clear();
+    m_class_collections.clear();
 }
 
 Element* Document::query_selector(const String& selectors) const {
@@ -242,7 +365,7 @@ RefPtr<Node> Document::adopt_node(RefPtr<Node> node) {
     std::function<void(Node*)> set_owner = [this, &set_owner](Node* n) {
         n->set_owner_document(this);
         for (const auto& child : n->child_nodes()) {
-            set_owner(child.get());
+            set_owner(child);
         }
     };
 
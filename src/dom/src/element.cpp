@@ -4,6 +4,7 @@
 
 #include "lithium/dom/element.hpp"
 #include "lithium/dom/document.hpp"
+#include "lithium/dom/serializer.hpp"
 #include "lithium/dom/text.hpp"
 #include <algorithm>
 
@@ -13,6 +14,34 @@ namespace {
 
 HTMLFragmentParser g_fragment_parser{nullptr};
 
+void notify_attribute_changed(Element& element, const String& name, const std::optional<String>& old_value) {
+    // Detached elements may outlive their owner document
+    if (!element.is_connected()) {
+        return;
+    }
+    if (auto* observer = element.owner_document()->observer()) {
+        observer->attribute_changed(element, name, old_value);
+    }
+}
+
+// ASCII case-insensitive name comparison, without the allocations of
+// String::to_lowercase
+bool name_equals_ignore_case(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (usize i = 0; i < a.size(); ++i) {
+        char x = a[i];
+        char y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace
 
 void register_html_fragment_parser(HTMLFragmentParser parser) {
@@ -24,30 +53,25 @@ void register_html_fragment_parser(HTMLFragmentParser parser) {
 // ============================================================================
 
 Element::Element(const String& tag_name)
-    : m_tag_name(tag_name)
-    , m_local_name(tag_name.to_lowercase())
+    : m_name(&QualifiedName::html(tag_name.view()))
 {
 }
 
 Element::Element(const String& namespace_uri, const String& qualified_name)
-    : m_namespace_uri(namespace_uri)
+    : m_name(&QualifiedName::with_namespace(namespace_uri.view(), qualified_name.view()))
+{
+}
+
+Element::Element(const QualifiedName& name)
+    : m_name(&name)
 {
-    auto colon_pos = qualified_name.find(':');
-    if (colon_pos.has_value()) {
-        m_prefix = qualified_name.substring(0, colon_pos.value());
-        m_local_name = qualified_name.substring(colon_pos.value() + 1);
-    } else {
-        m_local_name = qualified_name;
-    }
-    m_tag_name = qualified_name;
 }
 
 RefPtr<Node> Element::clone_node(bool deep) const {
-    auto clone = make_ref<Element>(m_tag_name);
-    clone->m_local_name = m_local_name;
-    clone->m_namespace_uri = m_namespace_uri;
-    clone->m_prefix = m_prefix;
+    auto clone = create_node<Element>(*m_name);
     clone->m_attributes = m_attributes;
+    clone->m_id = m_id;
+    clone->m_classes = m_classes;
     clone->m_form_owner = m_form_owner;
 
     if (deep) {
@@ -60,47 +84,59 @@ RefPtr<Node> Element::clone_node(bool deep) const {
     return clone;
 }
 
-std::vector<String> Element::class_list() const {
-    auto class_attr = get_attribute("class"_s);
-    if (!class_attr) {
-        return {};
-    }
+bool Element::has_class(std::string_view class_name) const {
+    return std::any_of(m_classes.begin(), m_classes.end(),
+        [class_name](const String& name) { return name.view() == class_name; });
+}
 
-    std::vector<String> classes;
-    auto class_str = class_attr.value();
+void Element::update_cached_attribute(std::string_view name) {
+    if (name_equals_ignore_case(name, "id")) {
+        String old_id = std::move(m_id);
+        m_id = get_attribute("id"_s).value_or(String());
+        if (is_connected() && m_id != old_id) {
+            owner_document()->id_changed(*this, old_id);
+        }
+        return;
+    }
+    if (!name_equals_ignore_case(name, "class")) {
+        return;
+    }
 
-    usize start = 0;
-    for (usize i = 0; i <= class_str.length(); ++i) {
-        if (i == class_str.length() || class_str[i] == ' ' || class_str[i] == '\t') {
-            if (i > start) {
-                classes.push_back(class_str.substring(start, i - start));
+    m_classes.clear();
+    if (auto class_attr = get_attribute("class"_s)) {
+        const auto& class_str = *class_attr;
+        usize start = 0;
+        for (usize i = 0; i <= class_str.length(); ++i) {
+            if (i == class_str.length() || class_str[i] == ' ' || class_str[i] == '\t') {
+                if (i > start) {
+                    m_classes.push_back(class_str.substring(start, i - start));
+                }
+                start = i + 1;
             }
-            start = i + 1;
         }
     }
-
-    return classes;
+    if (is_connected()) {
+        owner_document()->classes_changed();
+    }
 }
 
 bool Element::has_attribute(const String& name) const {
-    auto lower_name = name.to_lowercase();
     return std::any_of(m_attributes.begin(), m_attributes.end(),
-        [&lower_name](const Attribute& attr) {
-            return attr.name.to_lowercase() == lower_name;
+        [&name](const Attribute& attr) {
+            return name_equals_ignore_case(attr.name().view(), name.view());
         });
 }
 
 bool Element::has_attribute_ns(const String& namespace_uri, const String& local_name) const {
     return std::any_of(m_attributes.begin(), m_attributes.end(),
         [&namespace_uri, &local_name](const Attribute& attr) {
-            return attr.namespace_uri == namespace_uri && attr.local_name == local_name;
+            return attr.namespace_uri() == namespace_uri && attr.local_name() == local_name;
         });
 }
 
 std::optional<String> Element::get_attribute(const String& name) const {
-    auto lower_name = name.to_lowercase();
     for (const auto& attr : m_attributes) {
-        if (attr.name.to_lowercase() == lower_name) {
+        if (name_equals_ignore_case(attr.name().view(), name.view())) {
             return attr.value;
         }
     }
@@ -109,7 +145,7 @@ std::optional<String> Element::get_attribute(const String& name) const {
 
 std::optional<String> Element::get_attribute_ns(const String& namespace_uri, const String& local_name) const {
     for (const auto& attr : m_attributes) {
-        if (attr.namespace_uri == namespace_uri && attr.local_name == local_name) {
+        if (attr.namespace_uri() == namespace_uri && attr.local_name() == local_name) {
             return attr.value;
         }
     }
@@ -117,68 +153,84 @@ std::optional<String> Element::get_attribute_ns(const String& namespace_uri, con
 }
 
 void Element::set_attribute(const String& name, const String& value) {
-    auto lower_name = name.to_lowercase();
+    for (auto& attr : m_attributes) {
+        if (name_equals_ignore_case(attr.name().view(), name.view())) {
+            std::optional<String> old_value = std::move(attr.value);
+            attr.value = value;
+            update_cached_attribute(name.view());
+            notify_attribute_changed(*this, name, old_value);
+            return;
+        }
+    }
 
+    m_attributes.push_back({&QualifiedName::html(name.view()), value});
+    update_cached_attribute(name.view());
+    notify_attribute_changed(*this, name, std::nullopt);
+}
+
+void Element::set_attribute(Atom name, const String& value) {
+    const auto& qualified = QualifiedName::html(name);
     for (auto& attr : m_attributes) {
-        if (attr.name.to_lowercase() == lower_name) {
+        if (attr.qualified_name == &qualified || name_equals_ignore_case(attr.name().view(), name.view())) {
+            std::optional<String> old_value = std::move(attr.value);
             attr.value = value;
+            update_cached_attribute(name.view());
+            notify_attribute_changed(*this, attr.name(), old_value);
             return;
         }
     }
 
-    Attribute attr;
-    attr.name = name;
-    attr.value = value;
-    attr.local_name = lower_name;
-    m_attributes.push_back(attr);
+    m_attributes.push_back({&qualified, value});
+    update_cached_attribute(name.view());
+    notify_attribute_changed(*this, qualified.qualified_name(), std::nullopt);
 }
 
 void Element::set_attribute_ns(const String& namespace_uri, const String& qualified_name, const String& value) {
-    String prefix;
-    String local_name;
-
-    auto colon_pos = qualified_name.find(':');
-    if (colon_pos.has_value()) {
-        prefix = qualified_name.substring(0, colon_pos.value());
-        local_name = qualified_name.substring(colon_pos.value() + 1);
-    } else {
-        local_name = qualified_name;
-    }
+    const auto& name = QualifiedName::with_namespace(namespace_uri.view(), qualified_name.view());
 
     for (auto& attr : m_attributes) {
-        if (attr.namespace_uri == namespace_uri && attr.local_name == local_name) {
+        if (attr.namespace_uri() == namespace_uri && attr.local_name() == name.local_name()) {
+            std::optional<String> old_value = std::move(attr.value);
             attr.value = value;
-            attr.prefix = prefix;
+            attr.qualified_name = &name;  // Takes the new prefix
+            update_cached_attribute(attr.name().view());
+            notify_attribute_changed(*this, attr.name(), old_value);
             return;
         }
     }
 
-    Attribute attr;
-    attr.name = qualified_name;
-    attr.value = value;
-    attr.namespace_uri = namespace_uri;
-    attr.prefix = prefix;
-    attr.local_name = local_name;
-    m_attributes.push_back(attr);
+    m_attributes.push_back({&name, value});
+    update_cached_attribute(qualified_name.view());
+    notify_attribute_changed(*this, qualified_name, std::nullopt);
 }
 
 void Element::remove_attribute(const String& name) {
-    auto lower_name = name.to_lowercase();
-    m_attributes.erase(
-        std::remove_if(m_attributes.begin(), m_attributes.end(),
-            [&lower_name](const Attribute& attr) {
-                return attr.name.to_lowercase() == lower_name;
-            }),
-        m_attributes.end());
+    auto it = std::find_if(m_attributes.begin(), m_attributes.end(),
+        [&name](const Attribute& attr) {
+            return name_equals_ignore_case(attr.name().view(), name.view());
+        });
+    if (it == m_attributes.end()) {
+        return;
+    }
+    std::optional<String> old_value = std::move(it->value);
+    m_attributes.erase(it);
+    update_cached_attribute(name.view());
+    notify_attribute_changed(*this, name, old_value);
 }
 
 void Element::remove_attribute_ns(const String& namespace_uri, const String& local_name) {
-    m_attributes.erase(
-        std::remove_if(m_attributes.begin(), m_attributes.end(),
-            [&namespace_uri, &local_name](const Attribute& attr) {
-                return attr.namespace_uri == namespace_uri && attr.local_name == local_name;
-            }),
-        m_attributes.end());
+    auto it = std::find_if(m_attributes.begin(), m_attributes.end(),
+        [&namespace_uri, &local_name](const Attribute& attr) {
+            return attr.namespace_uri() == namespace_uri && attr.local_name() == local_name;
+        });
+    if (it == m_attributes.end()) {
+        return;
+    }
+    String name = it->name();
+    std::optional<String> old_value = std::move(it->value);
+    m_attributes.erase(it);
+    update_cached_attribute(name.view());
+    notify_attribute_changed(*this, name, old_value);
 }
 
 Element* Element::first_element_child() const {
@@ -191,10 +243,9 @@ Element* Element::first_element_child() const {
 }
 
 Element* Element::last_element_child() const {
-    const auto& children = child_nodes();
-    for (auto it = children.rbegin(); it != children.rend(); ++it) {
-        if ((*it)->is_element()) {
-            return (*it)->as_element();
+    for (Node* child = last_child(); child; child = child->previous_sibling()) {
+        if (child->is_element()) {
+            return child->as_element();
         }
     }
     return nullptr;
@@ -247,19 +298,11 @@ std::vector<Element*> Element::get_elements_by_tag_name(const String& tag_name)
     auto lower_tag = tag_name.to_lowercase();
     bool match_all = (tag_name == "*"_s);
 
-    std::function<void(const Node*)> collect = [&](const Node* node) {
-        for (const auto& child : node->child_nodes()) {
-            if (child->is_element()) {
-                auto* elem = child->as_element();
-                if (match_all || elem->local_name() == lower_tag) {
-                    result.push_back(elem);
-                }
-                collect(elem);
-            }
+    for (Node* node = first_child(); node; node = node->next_in_subtree(*this)) {
+        if (node->is_element() && (match_all || node->as_element()->local_name() == lower_tag)) {
+            result.push_back(node->as_element());
         }
-    };
-
-    collect(this);
+    }
     return result;
 }
 
@@ -282,43 +325,22 @@ std::vector<Element*> Element::get_elements_by_class_name(const String& class_na
         return result;
     }
 
-    std::function<void(const Node*)> collect = [&](const Node* node) {
-        for (const auto& child : node->child_nodes()) {
-            if (child->is_element()) {
-                auto* elem = child->as_element();
-                auto elem_classes = elem->class_list();
-
-                bool has_all = std::all_of(search_classes.begin(), search_classes.end(),
-                    [&elem_classes](const String& cls) {
-                        return std::find(elem_classes.begin(), elem_classes.end(), cls) != elem_classes.end();
-                    });
-
-                if (has_all) {
-                    result.push_back(elem);
-                }
-                collect(elem);
-            }
+    for (Node* node = first_child(); node; node = node->next_in_subtree(*this)) {
+        if (!node->is_element()) {
+            continue;
         }
-    };
-
-    collect(this);
+        auto* elem = node->as_element();
+        bool has_all = std::all_of(search_classes.begin(), search_classes.end(),
+            [elem](const String& cls) { return elem->has_class(cls.view()); });
+        if (has_all) {
+            result.push_back(elem);
+        }
+    }
     return result;
 }
 
 String Element::inner_html() const {
-    String result;
-
-    for (const auto& child : child_nodes()) {
-        if (child->is_text()) {
-            result = result + child->text_content();
-        } else if (child->is_element()) {
-            result = result + child->as_element()->outer_html();
-        } else if (child->node_type() == NodeType::Comment) {
-            result = result + "<!--"_s + child->text_content() + "-->"_s;
-        }
-    }
-
-    return result;
+    return serialize_children(*this);
 }
 
 void Element::set_inner_html(const String& html) {
@@ -352,27 +374,7 @@ void Element::set_inner_html(const String& html) {
 }
 
 String Element::outer_html() const {
-    String result = "<"_s + m_tag_name;
-
-    for (const auto& attr : m_attributes) {
-        result = result + " "_s + attr.name + "=\""_s + attr.value + "\""_s;
-    }
-
-    // Check for void elements
-    static const char* void_elements[] = {
-        "area", "base", "br", "col", "embed", "hr", "img", "input",
-        "link", "meta", "param", "source", "track", "wbr"
-    };
-
-    auto lower_tag = m_tag_name.to_lowercase();
-    for (const char* ve : void_elements) {
-        if (lower_tag == String(ve)) {
-            return result + ">"_s;
-        }
-    }
-
-    result = result + ">"_s + inner_html() + "</"_s + m_tag_name + ">"_s;
-    return result;
+    return serialize_node(*this);
 }
 
 bool Element::matches(const String& /*selectors*/) const {
@@ -389,6 +391,11 @@ HTMLElement::HTMLElement(const String& tag_name)
 {
 }
 
+HTMLElement::HTMLElement(const QualifiedName& name)
+    : Element(name)
+{
+}
+
 void HTMLElement::set_hidden(bool hidden) {
     if (hidden) {
         set_attribute("hidden"_s, ""_s);
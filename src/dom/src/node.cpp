@@ -6,7 +6,7 @@
 #include "lithium/dom/element.hpp"
 #include "lithium/dom/document.hpp"
 #include "lithium/dom/text.hpp"
-#include <algorithm>
+#include "lithium/dom/node_arena.hpp"
 #include <array>
 
 namespace lithium::dom {
@@ -33,12 +33,12 @@ Element* resolve_form_owner(Element* element) {
         return nullptr;
     }
 
-    if (element->local_name() == "option"_s || element->local_name() == "optgroup"_s) {
+    if (element->local_name_atom() == atoms::option || element->local_name_atom() == atoms::optgroup) {
         Node* ancestor = element->parent_node();
         while (ancestor) {
             if (ancestor->is_element()) {
                 auto* ancestor_el = ancestor->as_element();
-                if (ancestor_el->local_name() == "select"_s) {
+                if (ancestor_el->local_name_atom() == atoms::select) {
                     if (ancestor_el->form_owner()) {
                         return ancestor_el->form_owner();
                     }
@@ -52,7 +52,7 @@ Element* resolve_form_owner(Element* element) {
     if (auto attr = element->get_attribute("form"_s)) {
         auto* doc = element->owner_document();
         auto* target = doc ? doc->get_element_by_id(*attr) : nullptr;
-        if (target && target->local_name() == "form"_s) {
+        if (target && target->local_name_atom() == atoms::form) {
             return target;
         }
         return nullptr;
@@ -60,7 +60,7 @@ Element* resolve_form_owner(Element* element) {
 
     Node* ancestor = element->parent_node();
     while (ancestor) {
-        if (ancestor->is_element() && ancestor->as_element()->local_name() == "form"_s) {
+        if (ancestor->is_element() && ancestor->as_element()->local_name_atom() == atoms::form) {
             return ancestor->as_element();
         }
         ancestor = ancestor->parent_node();
@@ -77,79 +77,205 @@ void refresh_form_owners(Node* node) {
             element->set_form_owner(resolve_form_owner(element));
         }
     }
-    for (const auto& child : node->child_nodes()) {
-        refresh_form_owners(child.get());
+    for (Node* child = node->first_child(); child; child = child->next_sibling()) {
+        refresh_form_owners(child);
     }
 }
 
+// Only mutations inside the document's tree are reported: a node outside
+// it may outlive its owner document
+DocumentObserver* observer_of(const Node& node) {
+    if (!node.is_connected()) {
+        return nullptr;
+    }
+    return node.owner_document()->observer();
+}
+
 } // namespace
 
-RefPtr<Node> Node::append_child(RefPtr<Node> child) {
-    if (!child) return nullptr;
+// ============================================================================
+// ChildNodes
+// ============================================================================
 
-    // Remove from previous parent
-    if (child->m_parent) {
-        child->m_parent->remove_child(child);
+Node* ChildNodes::item(usize index) const {
+    const Node& parent = *m_parent;
+    if (index >= parent.m_child_count) {
+        return nullptr;
     }
 
-    // Set relationships
-    child->m_parent = this;
-    child->set_owner_document(m_owner_document);
+    auto distance = [index](usize position) { return position > index ? position - index : index - position; };
+
+    // Start from whichever of the ends and the cursor is nearest
+    usize last = parent.m_child_count - 1;
+    Node* node = parent.m_first_child.get();
+    usize position = 0;
+    if (distance(last) < distance(position)) {
+        node = parent.m_last_child;
+        position = last;
+    }
+    if (parent.m_child_cursor && distance(parent.m_child_cursor_index) < distance(position)) {
+        node = parent.m_child_cursor;
+        position = parent.m_child_cursor_index;
+    }
+
+    for (; position < index; ++position) {
+        node = node->m_next_sibling.get();
+    }
+    for (; position > index; --position) {
+        node = node->m_previous_sibling;
+    }
+
+    parent.m_child_cursor = node;
+    parent.m_child_cursor_index = static_cast<u32>(index);
+    return node;
+}
+
+// ============================================================================
+// Node
+// ============================================================================
+
+namespace {
 
-    if (m_last_child) {
-        m_last_child->m_next_sibling = child;
-        child->m_previous_sibling = m_last_child;
+// Precedes every node; `slab` is null for nodes on the global heap
+struct NodeHeader {
+    void* slab;
+};
+
+static_assert(alignof(Document) <= alignof(NodeHeader) && alignof(Element) <= alignof(NodeHeader),
+              "nodes are placed right after an unpadded NodeHeader");
+
+void* after_header(void* header) {
+    return static_cast<NodeHeader*>(header) + 1;
+}
+
+NodeHeader* header_of(void* node) {
+    return static_cast<NodeHeader*>(node) - 1;
+}
+
+const NodeHeader* header_of(const void* node) {
+    return static_cast<const NodeHeader*>(node) - 1;
+}
+
+} // namespace
+
+void* Node::operator new(usize size) {
+    void* header = ::operator new(sizeof(NodeHeader) + size);
+    static_cast<NodeHeader*>(header)->slab = nullptr;
+    return after_header(header);
+}
+
+void* Node::operator new(usize size, NodeArena& arena) {
+    auto [header, slab] = arena.allocate(sizeof(NodeHeader) + size);
+    static_cast<NodeHeader*>(header)->slab = slab;
+    return after_header(header);
+}
+
+void Node::operator delete(void* ptr) {
+    if (!ptr) return;
+    NodeHeader* header = header_of(ptr);
+    if (auto* slab = static_cast<NodeArena::Slab*>(header->slab)) {
+        NodeArena::deallocate(header, *slab);
     } else {
-        m_first_child = child;
+        ::operator delete(header);
     }
+}
 
-    m_last_child = child.get();
-    m_children.push_back(child);
+void Node::operator delete(void* ptr, NodeArena& /*arena*/) {
+    Node::operator delete(ptr);
+}
 
-    refresh_form_owners(child.get());
+Node::~Node() {
+    // Release the children front to back, so a long sibling chain is not
+    // destroyed one nested destructor per child
+    RefPtr<Node> child = std::move(m_first_child);
+    while (child) {
+        RefPtr<Node> next = std::move(child->m_next_sibling);
+        child->m_parent = nullptr;
+        child->m_previous_sibling = nullptr;
+        child = std::move(next);
+    }
+}
 
-    return child;
+NodeArena* Node::allocating_arena() const {
+    // Read from the node's own header, which keeps working after the
+    // owner document is gone
+    auto* slab = static_cast<NodeArena::Slab*>(header_of(this)->slab);
+    return slab ? slab->arena : nullptr;
 }
 
-RefPtr<Node> Node::insert_before(RefPtr<Node> node, Node* reference) {
-    if (!node) return nullptr;
+void Node::link_child(RefPtr<Node> child, Node* next) {
+    Node* previous = next ? next->m_previous_sibling : m_last_child;
+
+    child->m_parent = this;
+    child->m_previous_sibling = previous;
+    if (next) {
+        next->m_previous_sibling = child.get();
+    } else {
+        m_last_child = child.get();
+    }
+
+    // The new child takes over the owning link to `next`
+    RefPtr<Node>& owner = previous ? previous->m_next_sibling : m_first_child;
+    child->m_next_sibling = std::move(owner);
+    owner = std::move(child);
+
+    ++m_child_count;
+    m_child_cursor = nullptr;
+}
 
-    if (!reference) {
-        return append_child(node);
+void Node::unlink_child(Node& child) {
+    Node* previous = child.m_previous_sibling;
+    if (child.m_next_sibling) {
+        child.m_next_sibling->m_previous_sibling = previous;
+    } else {
+        m_last_child = previous;
     }
 
-    // Check if reference is a child
-    auto it = std::find_if(m_children.begin(), m_children.end(),
-        [reference](const RefPtr<Node>& n) { return n.get() == reference; });
+    // The caller holds a reference, so dropping the owning link is safe
+    RefPtr<Node>& owner = previous ? previous->m_next_sibling : m_first_child;
+    owner = std::move(child.m_next_sibling);
+
+    child.m_parent = nullptr;
+    child.m_previous_sibling = nullptr;
+
+    --m_child_count;
+    m_child_cursor = nullptr;
+}
+
+RefPtr<Node> Node::append_child(RefPtr<Node> child) {
+    return insert_before(std::move(child), nullptr);
+}
+
+RefPtr<Node> Node::insert_before(RefPtr<Node> node, Node* reference) {
+    if (!node) return nullptr;
 
-    if (it == m_children.end()) {
+    // The reference must be a child; inserting a node before itself
+    // leaves it where it is
+    if (reference && reference->m_parent != this) {
         return nullptr;
     }
+    if (reference == node.get()) {
+        reference = node->next_sibling();
+    }
 
     // Remove from previous parent
     if (node->m_parent) {
         node->m_parent->remove_child(node);
     }
 
-    // Set relationships
-    node->m_parent = this;
     node->set_owner_document(m_owner_document);
+    link_child(node, reference);
 
-    node->m_next_sibling = RefPtr<Node>(reference);
-    node->m_previous_sibling = reference->m_previous_sibling;
-
-    if (reference->m_previous_sibling) {
-        reference->m_previous_sibling->m_next_sibling = node;
-    } else {
-        m_first_child = node;
+    if (m_connected) {
+        m_owner_document->connect_subtree(*node);
     }
 
-    reference->m_previous_sibling = node.get();
-
-    m_children.insert(it, node);
-
     refresh_form_owners(node.get());
 
+    if (auto* observer = observer_of(*this)) {
+        observer->child_inserted(*this, *node);
+    }
+
     return node;
 }
 
@@ -158,31 +284,18 @@ RefPtr<Node> Node::remove_child(RefPtr<Node> child) {
         return nullptr;
     }
 
-    // Update sibling links
-    if (child->m_previous_sibling) {
-        child->m_previous_sibling->m_next_sibling = child->m_next_sibling;
-    } else {
-        m_first_child = child->m_next_sibling;
-    }
+    unlink_child(*child);
 
-    if (child->m_next_sibling) {
-        child->m_next_sibling->m_previous_sibling = child->m_previous_sibling;
-    } else {
-        m_last_child = child->m_previous_sibling;
+    if (child->m_connected) {
+        m_owner_document->disconnect_subtree(*child);
     }
 
-    child->m_parent = nullptr;
-    child->m_previous_sibling = nullptr;
-    child->m_next_sibling = nullptr;
+    refresh_form_owners(child.get());
 
-    // Remove from children vector
-    auto it = std::find(m_children.begin(), m_children.end(), child);
-    if (it != m_children.end()) {
-        m_children.erase(it);
+    if (auto* observer = observer_of(*this)) {
+        observer->child_removed(*this, *child);
     }
 
-    refresh_form_owners(child.get());
-
     return child;
 }
 
@@ -198,7 +311,7 @@ RefPtr<Node> Node::replace_child(RefPtr<Node> new_child, RefPtr<Node> old_child)
 String Node::text_content() const {
     String result;
 
-    for (const auto& child : m_children) {
+    for (const Node* child = first_child(); child; child = child->next_sibling()) {
         if (child->is_text()) {
             result = result + child->text_content();
         } else if (child->is_element()) {
@@ -234,6 +347,18 @@ bool Node::contains(const Node* other) const {
     return false;
 }
 
+Node* Node::next_in_subtree(const Node& root) const {
+    if (m_first_child) {
+        return m_first_child.get();
+    }
+    for (const Node* node = this; node && node != &root; node = node->m_parent) {
+        if (node->m_next_sibling) {
+            return node->m_next_sibling.get();
+        }
+    }
+    return nullptr;
+}
+
 Element* Node::as_element() {
     return is_element() ? static_cast<Element*>(this) : nullptr;
 }
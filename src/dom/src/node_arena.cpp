@@ -0,0 +1,97 @@
+/**
+ * DOM node slab allocator
+ */
+
+#include "lithium/dom/node_arena.hpp"
+#include <new>
+
+namespace lithium::dom {
+
+namespace {
+
+// Blocks hold this many bytes of slots (at least one slot)
+constexpr usize BLOCK_SIZE = 16 * 1024;
+
+usize round_up(usize size, usize alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+usize NodeArenaStats::live() const {
+    usize total = 0;
+    for (const auto& slab : slabs) {
+        total += slab.live;
+    }
+    return total;
+}
+
+usize NodeArenaStats::reserved() const {
+    usize total = 0;
+    for (const auto& slab : slabs) {
+        total += slab.slot_size * slab.capacity;
+    }
+    return total;
+}
+
+NodeArena::~NodeArena() {
+    for (auto* slab : m_slabs) {
+        for (auto* block : slab->blocks) {
+            ::operator delete(block);
+        }
+        delete slab;
+    }
+}
+
+NodeArenaStats NodeArena::stats() const {
+    NodeArenaStats stats;
+    for (const auto* slab : m_slabs) {
+        stats.slabs.push_back({slab->slot_size, slab->live, slab->capacity});
+    }
+    return stats;
+}
+
+std::pair<void*, NodeArena::Slab*> NodeArena::allocate(usize size) {
+    usize slot_size = round_up(size < sizeof(FreeSlot) ? sizeof(FreeSlot) : size, alignof(FreeSlot));
+
+    Slab* slab = nullptr;
+    for (auto* candidate : m_slabs) {
+        if (candidate->slot_size == slot_size) {
+            slab = candidate;
+            break;
+        }
+    }
+    if (!slab) {
+        slab = new Slab{this, slot_size, nullptr, {}, 0, 0};
+        m_slabs.push_back(slab);
+    }
+
+    if (!slab->free_list) {
+        usize count = BLOCK_SIZE / slot_size ? BLOCK_SIZE / slot_size : 1;
+        auto* block = static_cast<u8*>(::operator new(count * slot_size));
+        slab->blocks.push_back(block);
+        slab->capacity += count;
+        // Thread the new slots onto the free list, first slot on top
+        for (usize i = count; i-- > 0;) {
+            auto* slot = reinterpret_cast<FreeSlot*>(block + i * slot_size);
+            slot->next = slab->free_list;
+            slab->free_list = slot;
+        }
+    }
+
+    FreeSlot* slot = slab->free_list;
+    slab->free_list = slot->next;
+    ++slab->live;
+    add_ref();
+    return {slot, slab};
+}
+
+void NodeArena::deallocate(void* slot, Slab& slab) {
+    auto* free_slot = static_cast<FreeSlot*>(slot);
+    free_slot->next = slab.free_list;
+    slab.free_list = free_slot;
+    --slab.live;
+    slab.arena->release();
+}
+
+} // namespace lithium::dom
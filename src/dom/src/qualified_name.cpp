@@ -0,0 +1,109 @@
+/**
+ * Interned element and attribute names
+ */
+
+#include "lithium/dom/qualified_name.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace lithium::dom {
+
+// ============================================================================
+// QualifiedNameTable
+// ============================================================================
+//
+// Keyed by how the name was made (HTML or namespaced), the namespace and
+// the name as written, joined into one string; lookups build the key in a
+// per-thread buffer so a hit does not allocate.
+
+class QualifiedNameTable {
+public:
+    static QualifiedNameTable& instance() {
+        static QualifiedNameTable table;
+        return table;
+    }
+
+    const QualifiedName& intern(char kind, std::string_view namespace_uri, std::string_view name) {
+        thread_local std::string key;
+        key.clear();
+        key += kind;
+        key.append(namespace_uri);
+        key += '\0';
+        key.append(name);
+
+        std::lock_guard lock(m_mutex);
+        auto it = m_names.find(std::string_view(key));
+        if (it != m_names.end()) {
+            return *it->second;
+        }
+        auto record = kind == 'h' ? make_html(name) : make_namespaced(namespace_uri, name);
+        return *m_names.emplace(key, std::move(record)).first->second;
+    }
+
+private:
+    struct KeyHash {
+        using is_transparent = void;
+        usize operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    static std::unique_ptr<QualifiedName> make_html(std::string_view name) {
+        String qualified(name);
+        return std::unique_ptr<QualifiedName>(
+            new QualifiedName(qualified, qualified.to_lowercase(), String(), String()));
+    }
+
+    static std::unique_ptr<QualifiedName> make_namespaced(std::string_view namespace_uri, std::string_view name) {
+        auto colon = name.find(':');
+        String prefix = colon == std::string_view::npos ? String() : String(name.substr(0, colon));
+        String local(colon == std::string_view::npos ? name : name.substr(colon + 1));
+        return std::unique_ptr<QualifiedName>(
+            new QualifiedName(String(name), std::move(local), String(namespace_uri), std::move(prefix)));
+    }
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<QualifiedName>, KeyHash, std::equal_to<>> m_names;
+};
+
+// ============================================================================
+// QualifiedName
+// ============================================================================
+
+QualifiedName::QualifiedName(String qualified_name, String local_name, String namespace_uri, String prefix)
+    : m_qualified_name(std::move(qualified_name))
+    , m_local_name(std::move(local_name))
+    , m_namespace_uri(std::move(namespace_uri))
+    , m_prefix(std::move(prefix))
+    , m_uppercase_name(m_qualified_name.to_uppercase())
+    , m_local_name_atom(m_local_name)
+{
+}
+
+const QualifiedName& QualifiedName::html(std::string_view name) {
+    return QualifiedNameTable::instance().intern('h', {}, name);
+}
+
+const QualifiedName& QualifiedName::html(Atom name) {
+    constexpr auto STATIC_COUNT = static_cast<usize>(AtomId::StaticCount);
+    static std::array<std::atomic<const QualifiedName*>, STATIC_COUNT> by_atom{};
+
+    if (!name.is_static()) {
+        return html(name.view());
+    }
+    auto& slot = by_atom[name.id()];
+    const auto* record = slot.load(std::memory_order_acquire);
+    if (!record) {
+        record = &html(name.view());
+        slot.store(record, std::memory_order_release);
+    }
+    return *record;
+}
+
+const QualifiedName& QualifiedName::with_namespace(std::string_view namespace_uri, std::string_view qualified_name) {
+    return QualifiedNameTable::instance().intern('n', namespace_uri, qualified_name);
+}
+
+} // namespace lithium::dom
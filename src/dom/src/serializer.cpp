@@ -0,0 +1,229 @@
+/**
+ * HTML fragment serialization
+ */
+
+#include "lithium/dom/serializer.hpp"
+#include "lithium/dom/document.hpp"
+#include "lithium/dom/element.hpp"
+#include "lithium/dom/text.hpp"
+#include <array>
+
+namespace lithium::dom {
+
+namespace {
+
+// Bytes append_escaped stops at, per mode. 0xC2 leads U+00A0 in UTF-8.
+constexpr u8 ESCAPE_TEXT = 1;
+constexpr u8 ESCAPE_ATTRIBUTE = 2;
+
+constexpr std::array<u8, 256> ESCAPE_CLASS = [] {
+    std::array<u8, 256> table{};
+    table[static_cast<u8>('&')] = ESCAPE_TEXT | ESCAPE_ATTRIBUTE;
+    table[static_cast<u8>('<')] = ESCAPE_TEXT | ESCAPE_ATTRIBUTE;
+    table[static_cast<u8>('>')] = ESCAPE_TEXT | ESCAPE_ATTRIBUTE;
+    table[0xC2] = ESCAPE_TEXT | ESCAPE_ATTRIBUTE;
+    table[static_cast<u8>('"')] = ESCAPE_ATTRIBUTE;
+    return table;
+}();
+
+// HTML elements live in no namespace here; createElementNS can still put
+// one in the XHTML namespace
+bool is_html(const Element& element) {
+    const auto& ns = element.namespace_uri();
+    return ns.empty() || ns.view() == "http://www.w3.org/1999/xhtml";
+}
+
+bool is_void_element(const Element& element) {
+    if (!is_html(element)) {
+        return false;
+    }
+    switch (static_cast<AtomId>(element.local_name_atom().id())) {
+        case AtomId::area: case AtomId::base: case AtomId::basefont: case AtomId::bgsound:
+        case AtomId::br: case AtomId::col: case AtomId::embed: case AtomId::frame:
+        case AtomId::hr: case AtomId::img: case AtomId::input: case AtomId::keygen:
+        case AtomId::link: case AtomId::meta: case AtomId::param: case AtomId::source:
+        case AtomId::track: case AtomId::wbr:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Text inside these is written as is
+bool is_raw_text_parent(const Node* parent) {
+    if (!parent || !parent->is_element() || !is_html(*parent->as_element())) {
+        return false;
+    }
+    switch (static_cast<AtomId>(parent->as_element()->local_name_atom().id())) {
+        case AtomId::style: case AtomId::script: case AtomId::xmp: case AtomId::iframe:
+        case AtomId::noembed: case AtomId::noframes: case AtomId::plaintext:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// HTML elements are written by local name (lowercase whatever the element
+// was created with), others by qualified name. Attributes keep their
+// qualified name, which carries the xlink:/xml:/xmlns: prefixes and the
+// SVG camelCase the parser adjusted them to.
+const String& serialized_tag_name(const Element& element) {
+    return is_html(element) ? element.local_name() : element.tag_name();
+}
+
+// The output size before escaping, for reserving the buffer
+usize unescaped_size(const Node& node) {
+    switch (node.node_type()) {
+        case NodeType::Element: {
+            const auto& element = static_cast<const Element&>(node);
+            usize size = serialized_tag_name(element).size() * 2 + 5;  // <x></x>
+            for (const auto& attr : element.attributes()) {
+                size += attr.name().size() + attr.value.size() + 4;  // ' x=""'
+            }
+            return size;
+        }
+        case NodeType::Text:
+            return static_cast<const Text&>(node).data().size();
+        case NodeType::Comment:
+            return static_cast<const Comment&>(node).data().size() + 7;  // <!---->
+        case NodeType::DocumentType:
+            return static_cast<const DocumentType&>(node).name().size() + 11;  // <!DOCTYPE >
+        default:
+            return 0;
+    }
+}
+
+usize unescaped_subtree_size(const Node& root, bool include_root) {
+    usize size = include_root ? unescaped_size(root) : 0;
+    for (const Node* node = root.first_child(); node; node = node->next_in_subtree(root)) {
+        size += unescaped_size(*node);
+    }
+    return size;
+}
+
+// Writes everything of `node` up to its children; true when it is an
+// element whose children and end tag follow
+bool write_open(const Node& node, std::string& out) {
+    switch (node.node_type()) {
+        case NodeType::Element: {
+            const auto& element = static_cast<const Element&>(node);
+            out += '<';
+            out.append(serialized_tag_name(element).view());
+            for (const auto& attr : element.attributes()) {
+                out += ' ';
+                out.append(attr.name().view());
+                out.append("=\"");
+                append_escaped(out, attr.value.view(), true);
+                out += '"';
+            }
+            out += '>';
+            return !is_void_element(element);
+        }
+        case NodeType::Text: {
+            const auto& data = static_cast<const Text&>(node).data().view();
+            if (is_raw_text_parent(node.parent_node())) {
+                out.append(data);
+            } else {
+                append_escaped(out, data, false);
+            }
+            return false;
+        }
+        case NodeType::Comment:
+            out.append("<!--");
+            out.append(static_cast<const Comment&>(node).data().view());
+            out.append("-->");
+            return false;
+        case NodeType::DocumentType:
+            out.append("<!DOCTYPE ");
+            out.append(static_cast<const DocumentType&>(node).name().view());
+            out += '>';
+            return false;
+        default:
+            return false;
+    }
+}
+
+void write_close(const Element& element, std::string& out) {
+    out.append("</");
+    out.append(serialized_tag_name(element).view());
+    out += '>';
+}
+
+// Tree order without recursion: descend into elements, and on the way back
+// up write the end tag of each element left
+void write_children(const Node& root, std::string& out) {
+    const Node* node = root.first_child();
+    while (node) {
+        bool has_end_tag = write_open(*node, out);
+        if (has_end_tag && node->first_child()) {
+            node = node->first_child();
+            continue;
+        }
+        if (has_end_tag) {
+            write_close(*node->as_element(), out);
+        }
+        while (!node->next_sibling()) {
+            node = node->parent_node();
+            if (node == &root) {
+                return;
+            }
+            write_close(*node->as_element(), out);
+        }
+        node = node->next_sibling();
+    }
+}
+
+} // namespace
+
+void append_escaped(std::string& out, std::string_view text, bool attribute_mode) {
+    const u8 mask = attribute_mode ? ESCAPE_ATTRIBUTE : ESCAPE_TEXT;
+    const char* data = text.data();
+    usize run = 0;  // Start of the bytes not yet written
+
+    for (usize i = 0; i < text.size(); ++i) {
+        auto byte = static_cast<u8>(data[i]);
+        if (!(ESCAPE_CLASS[byte] & mask)) {
+            continue;
+        }
+
+        std::string_view replacement;
+        usize length = 1;
+        switch (byte) {
+            case '&': replacement = "&amp;"; break;
+            case '<': replacement = "&lt;"; break;
+            case '>': replacement = "&gt;"; break;
+            case '"': replacement = "&quot;"; break;
+            default:
+                if (i + 1 == text.size() || static_cast<u8>(data[i + 1]) != 0xA0) {
+                    continue;  // Another U+0080-U+00BF character
+                }
+                replacement = "&nbsp;";
+                length = 2;
+                break;
+        }
+        out.append(data + run, i - run);
+        out.append(replacement);
+        i += length - 1;
+        run = i + 1;
+    }
+    out.append(data + run, text.size() - run);
+}
+
+String serialize_children(const Node& node) {
+    std::string out;
+    out.reserve(unescaped_subtree_size(node, false));
+    write_children(node, out);
+    return String(std::move(out));
+}
+
+String serialize_node(const Node& node) {
+    std::string out;
+    out.reserve(unescaped_subtree_size(node, true));
+    if (write_open(node, out)) {
+        write_children(node, out);
+        write_close(*node.as_element(), out);
+    }
+    return String(std::move(out));
+}
+
+} // namespace lithium::dom
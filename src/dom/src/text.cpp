@@ -12,7 +12,11 @@ namespace lithium::dom {
 // ============================================================================
 
 void CharacterData::append_data(const String& data) {
-    m_data = m_data + data;
+    m_data.append(data);
+}
+
+void CharacterData::append_data(std::string_view data) {
+    m_data.append(data);
 }
 
 void CharacterData::insert_data(usize offset, const String& data) {
@@ -53,13 +57,13 @@ String CharacterData::substring_data(usize offset, usize count) const {
 // Text
 // ============================================================================
 
-Text::Text(const String& data)
-    : CharacterData(data)
+Text::Text(String data)
+    : CharacterData(std::move(data))
 {
 }
 
 RefPtr<Node> Text::clone_node(bool /*deep*/) const {
-    return make_ref<Text>(data());
+    return create_node<Text>(data());
 }
 
 String Text::whole_text() const {
@@ -89,7 +93,7 @@ RefPtr<Text> Text::split_text(usize offset) {
     String new_data = substring_data(offset, length() - offset);
     delete_data(offset, length() - offset);
 
-    auto new_text = make_ref<Text>(new_data);
+    auto new_text = create_node<Text>(new_data);
     new_text->set_owner_document(owner_document());
 
     // Insert after this node
@@ -110,7 +114,7 @@ Comment::Comment(const String& data)
 }
 
 RefPtr<Node> Comment::clone_node(bool /*deep*/) const {
-    return make_ref<Comment>(data());
+    return create_node<Comment>(data());
 }
 
 } // namespace lithium::dom
@@ -2,10 +2,12 @@
 
 #include "lithium/core/types.hpp"
 #include "lithium/core/string.hpp"
+#include "lithium/core/atom.hpp"
 #include <variant>
 #include <vector>
 #include <optional>
 #include <functional>
+#include <string_view>
 
 namespace lithium::html {
 
@@ -20,13 +22,17 @@ struct DoctypeToken {
     bool force_quirks{false};
 };
 
+// Tag and attribute names are interned as the tokenizer reads them (ASCII
+// lowercase), so the tree builder compares them as atoms
 struct TagToken {
-    String name;
-    std::vector<std::pair<String, String>> attributes;
+    Atom name;
+    std::vector<std::pair<Atom, String>> attributes;
     bool self_closing{false};
     bool is_end_tag{false};
 
-    [[nodiscard]] std::optional<String> get_attribute(const String& name) const;
+    [[nodiscard]] std::optional<String> get_attribute(Atom name) const;
+    [[nodiscard]] std::optional<String> get_attribute(const String& name) const;  // ASCII case-insensitive
+    void set_attribute(Atom name, const String& value);
     void set_attribute(const String& name, const String& value);
 };
 
@@ -38,6 +44,14 @@ struct CharacterToken {
     unicode::CodePoint code_point;
 };
 
+// A run of text with no markup, character references or NULs, as raw
+// (UTF-8) input bytes. `text` points into the tokenizer's input and stays
+// valid until that input next changes (set_input, append_input,
+// insert_input_at_current_position)
+struct CharacterRunToken {
+    std::string_view text;
+};
+
 struct EndOfFileToken {};
 
 using Token = std::variant<
@@ -45,6 +59,7 @@ using Token = std::variant<
     TagToken,
     CommentToken,
     CharacterToken,
+    CharacterRunToken,
     EndOfFileToken
 >;
 
@@ -53,11 +68,12 @@ using Token = std::variant<
 [[nodiscard]] bool is_start_tag(const Token& token);
 [[nodiscard]] bool is_end_tag(const Token& token);
 [[nodiscard]] bool is_character(const Token& token);
+[[nodiscard]] bool is_character_run(const Token& token);
 [[nodiscard]] bool is_comment(const Token& token);
 [[nodiscard]] bool is_eof(const Token& token);
 
-[[nodiscard]] bool is_start_tag_named(const Token& token, const String& name);
-[[nodiscard]] bool is_end_tag_named(const Token& token, const String& name);
+[[nodiscard]] bool is_start_tag_named(const Token& token, Atom name);
+[[nodiscard]] bool is_end_tag_named(const Token& token, Atom name);
 
 // ============================================================================
 // Tokenizer States (WHATWG HTML5 spec)
@@ -186,7 +202,7 @@ public:
     [[nodiscard]] TokenizerState state() const { return m_state; }
 
     // Set last start tag (for end tag matching)
-    void set_last_start_tag(const String& name) { m_last_start_tag_name = name; }
+    void set_last_start_tag(const String& name) { m_last_start_tag_name = Atom(name); }
 
 private:
     // Character consumption
@@ -200,6 +216,7 @@ private:
     // Token emission
     void emit(Token token);
     void emit_character(unicode::CodePoint cp);
+    void emit_character_run(usize length);
     void emit_current_token();
     void emit_eof();
 
@@ -300,6 +317,7 @@ private:
 
     // Helper methods
     [[nodiscard]] bool is_appropriate_end_tag_token() const;
+    void finish_tag_name();
     void start_new_attribute();
     void finish_attribute_name();
     void finish_attribute_value();
@@ -318,9 +336,10 @@ private:
 
     // Buffers
     StringBuilder m_temp_buffer;
-    String m_current_attribute_name;
+    StringBuilder m_current_tag_name;  // Interned into the token when the name ends
+    StringBuilder m_current_attribute_name;
     String m_current_attribute_value;
-    String m_last_start_tag_name;
+    Atom m_last_start_tag_name;
     u32 m_character_reference_code{0};
 
     // Callbacks
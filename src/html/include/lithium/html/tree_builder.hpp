@@ -121,11 +121,17 @@ private:
     // Using the rules for
     void process_using_rules_for(InsertionMode mode, const Token& token);
 
+    // Character runs: taken whole where the current mode inserts every
+    // character alike, otherwise fed through one code point at a time
+    void process_character_run(std::string_view text);
+    bool process_character_run_in_bulk(std::string_view text);
+
     // Tree manipulation
     RefPtr<dom::Element> create_element(const TagToken& token, const String& namespace_uri);
     RefPtr<dom::Element> create_element_for_token(const TagToken& token);
     void insert_element(RefPtr<dom::Element> element);
     void insert_character(unicode::CodePoint cp);
+    void insert_characters(std::string_view text);
     void insert_comment(const CommentToken& token, dom::Node* position = nullptr);
 
     // Stack of open elements
@@ -134,12 +140,12 @@ private:
     void push_open_element(RefPtr<dom::Element> element);
     void pop_current_element();
     void remove_from_stack(dom::Element* element);
-    [[nodiscard]] bool stack_contains(const String& tag_name) const;
-    [[nodiscard]] bool stack_contains_in_scope(const String& tag_name) const;
-    [[nodiscard]] bool stack_contains_in_list_item_scope(const String& tag_name) const;
-    [[nodiscard]] bool stack_contains_in_button_scope(const String& tag_name) const;
-    [[nodiscard]] bool stack_contains_in_table_scope(const String& tag_name) const;
-    [[nodiscard]] bool stack_contains_in_select_scope(const String& tag_name) const;
+    [[nodiscard]] bool stack_contains(Atom tag_name) const;
+    [[nodiscard]] bool stack_contains_in_scope(Atom tag_name) const;
+    [[nodiscard]] bool stack_contains_in_list_item_scope(Atom tag_name) const;
+    [[nodiscard]] bool stack_contains_in_button_scope(Atom tag_name) const;
+    [[nodiscard]] bool stack_contains_in_table_scope(Atom tag_name) const;
+    [[nodiscard]] bool stack_contains_in_select_scope(Atom tag_name) const;
 
     // Active formatting elements
     void push_active_formatting_element(RefPtr<dom::Element> element, const Token& token);
@@ -149,7 +155,7 @@ private:
     void remove_from_active_formatting(dom::Element* element);
 
     // Adoption agency algorithm
-    void adoption_agency_algorithm(const String& tag_name);
+    void adoption_agency_algorithm(Atom tag_name);
 
     // Foster parenting
     void set_foster_parenting(bool enabled) { m_foster_parenting = enabled; }
@@ -160,13 +166,13 @@ private:
     [[nodiscard]] InsertionLocation appropriate_insertion_place();
 
     // Implicit end tags
-    void generate_implied_end_tags(const String& except = String());
+    void generate_implied_end_tags(Atom except = Atom());
     void generate_all_implied_end_tags_thoroughly();
 
     // Special element checks
-    [[nodiscard]] static bool is_special_element(const String& tag_name);
-    [[nodiscard]] static bool is_formatting_element(const String& tag_name);
-    [[nodiscard]] static bool is_form_associated(const String& tag_name);
+    [[nodiscard]] static bool is_special_element(Atom tag_name);
+    [[nodiscard]] static bool is_formatting_element(Atom tag_name);
+    [[nodiscard]] static bool is_form_associated(Atom tag_name);
 
     // Error reporting
     void parse_error(const String& message);
@@ -208,8 +214,8 @@ private:
     bool m_foster_parenting{false};
     bool m_self_closing_flag_acknowledged{true};
 
-    // Pending table characters
-    std::vector<unicode::CodePoint> m_pending_table_characters;
+    // Pending table characters (UTF-8)
+    String m_pending_table_characters;
 
     // Tokenizer (for state adjustment)
     Tokenizer* m_tokenizer{nullptr};
@@ -225,5 +231,5 @@ private:
 
 // Shared helper for SVG camel-casing
 namespace lithium::html {
-String svg_camel_case(const String& name_lower);
+Atom svg_camel_case(Atom name);
 }
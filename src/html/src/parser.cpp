@@ -141,17 +141,17 @@ EncodingDecision determine_initial_encoding(const String& raw, const String& tra
 }
 
 std::optional<String> charset_from_token(const Token& token) {
-    if (!is_start_tag_named(token, "meta"_s)) {
+    if (!is_start_tag_named(token, atoms::meta)) {
         return std::nullopt;
     }
 
     auto& tag = std::get<TagToken>(token);
-    if (auto charset = tag.get_attribute("charset"_s)) {
+    if (auto charset = tag.get_attribute(atoms::charset)) {
         return normalize_charset(*charset);
     }
 
-    auto http_equiv = tag.get_attribute("http-equiv"_s);
-    auto content = tag.get_attribute("content"_s);
+    auto http_equiv = tag.get_attribute(atoms::http_equiv);
+    auto content = tag.get_attribute(atoms::content);
     if (!http_equiv || !content) return std::nullopt;
     if (http_equiv->to_lowercase() != "content-type"_s) return std::nullopt;
 
@@ -263,16 +263,18 @@ RefPtr<dom::Document> Parser::parse(const String& html) {
 
             builder.process_token(*token);
             if (m_script_callback) {
-                if (is_start_tag_named(*token, "script"_s)) {
+                if (is_start_tag_named(*token, atoms::script)) {
                     m_collecting_script = true;
                     m_script_buffer.clear();
                 }
                 if (m_collecting_script) {
                     if (auto* ch = std::get_if<CharacterToken>(&*token)) {
                         m_script_buffer.append(ch->code_point);
+                    } else if (auto* run = std::get_if<CharacterRunToken>(&*token)) {
+                        m_script_buffer.append(run->text);
                     }
                 }
-                if (m_collecting_script && is_end_tag_named(*token, "script"_s)) {
+                if (m_collecting_script && is_end_tag_named(*token, atoms::script)) {
                     auto text = m_script_buffer.build();
                     m_collecting_script = false;
                     m_in_script_callback = true;
@@ -321,17 +323,17 @@ RefPtr<dom::DocumentFragment> Parser::parse_fragment(
     tokenizer.set_input(decision.input);
 
     // Adjust tokenizer state based on context element per HTML fragment parsing algorithm.
-    auto context_tag = context_clone->local_name();
-    if (context_tag == "title"_s || context_tag == "textarea"_s) {
+    auto context_tag = context_clone->local_name_atom();
+    if (context_tag == atoms::title || context_tag == atoms::textarea) {
         tokenizer.set_state(TokenizerState::RCDATA);
-    } else if (context_tag == "style"_s || context_tag == "xmp"_s ||
-               context_tag == "iframe"_s || context_tag == "noembed"_s ||
-               context_tag == "noframes"_s ||
-               (context_tag == "noscript"_s && !m_scripting_enabled)) {
+    } else if (context_tag == atoms::style || context_tag == atoms::xmp ||
+               context_tag == atoms::iframe || context_tag == atoms::noembed ||
+               context_tag == atoms::noframes ||
+               (context_tag == atoms::noscript && !m_scripting_enabled)) {
         tokenizer.set_state(TokenizerState::RAWTEXT);
-    } else if (context_tag == "plaintext"_s) {
+    } else if (context_tag == atoms::plaintext) {
         tokenizer.set_state(TokenizerState::PLAINTEXT);
-    } else if (context_tag == "script"_s) {
+    } else if (context_tag == atoms::script) {
         tokenizer.set_state(TokenizerState::ScriptData);
     }
 
@@ -466,16 +468,18 @@ void Parser::process_streaming_tokens(bool mark_end_of_stream) {
 
         m_streaming_builder->process_token(*token);
         if (m_script_callback) {
-            if (is_start_tag_named(*token, "script"_s)) {
+            if (is_start_tag_named(*token, atoms::script)) {
                 m_collecting_script = true;
                 m_script_buffer.clear();
             }
             if (m_collecting_script) {
                 if (auto* ch = std::get_if<CharacterToken>(&*token)) {
                     m_script_buffer.append(ch->code_point);
+                } else if (auto* run = std::get_if<CharacterRunToken>(&*token)) {
+                    m_script_buffer.append(run->text);
                 }
             }
-            if (m_collecting_script && is_end_tag_named(*token, "script"_s)) {
+            if (m_collecting_script && is_end_tag_named(*token, atoms::script)) {
                 auto text = m_script_buffer.build();
                 m_collecting_script = false;
                 m_in_script_callback = true;
@@ -0,0 +1,125 @@
+/**
+ * Compile-time trie over the named character reference table
+ *
+ * Built by constexpr evaluation from NAMED_ENTITIES (entities.inc), so the
+ * generated table stays the single source of truth. Children of a node are
+ * a sorted sibling list; the root's children are additionally indexed by
+ * byte. A lookup walks one node per input byte and remembers the last node
+ * that ends an entity, which gives the longest match the tokenizer needs.
+ */
+
+#pragma once
+
+#include "entities.inc"
+#include "lithium/core/types.hpp"
+#include <array>
+#include <cstddef>
+
+namespace lithium::html::detail {
+
+struct EntityTrieNode {
+    char ch{0};
+    u16 first_child{0};   // 0 = none (the root is never a child)
+    u16 next_sibling{0};  // Siblings are sorted by ch
+    i16 entity{-1};       // Index into NAMED_ENTITIES, -1 if no entity ends here
+};
+
+constexpr std::size_t entity_name_bytes() {
+    std::size_t total = 1;
+    for (const auto& entity : NAMED_ENTITIES) {
+        total += entity.name_length;
+    }
+    return total;
+}
+
+template<std::size_t Capacity>
+struct EntityTrieBuilder {
+    std::array<EntityTrieNode, Capacity> nodes{};
+    std::size_t size{1};
+
+    constexpr void insert(const NamedEntity& entity, i16 index) {
+        u16 node = 0;
+        for (std::size_t i = 0; i < entity.name_length; ++i) {
+            char c = entity.name[i];
+            u16 prev = 0;
+            u16 child = nodes[node].first_child;
+            while (child != 0 && nodes[child].ch < c) {
+                prev = child;
+                child = nodes[child].next_sibling;
+            }
+            if (child == 0 || nodes[child].ch != c) {
+                auto created = static_cast<u16>(size++);
+                nodes[created] = EntityTrieNode{c, 0, child, -1};
+                if (prev != 0) {
+                    nodes[prev].next_sibling = created;
+                } else {
+                    nodes[node].first_child = created;
+                }
+                child = created;
+            }
+            node = child;
+        }
+        // First definition wins, as with the table scan this replaces
+        if (nodes[node].entity < 0) {
+            nodes[node].entity = index;
+        }
+    }
+
+    constexpr void insert_all() {
+        for (std::size_t i = 0; i < NAMED_ENTITIES.size(); ++i) {
+            insert(NAMED_ENTITIES[i], static_cast<i16>(i));
+        }
+    }
+};
+
+constexpr std::size_t entity_trie_size() {
+    EntityTrieBuilder<entity_name_bytes()> builder;
+    builder.insert_all();
+    return builder.size;
+}
+
+inline constexpr std::size_t ENTITY_TRIE_SIZE = entity_trie_size();
+static_assert(ENTITY_TRIE_SIZE <= 0xFFFF, "entity trie node indices must fit in u16");
+
+inline constexpr auto ENTITY_TRIE = [] {
+    EntityTrieBuilder<ENTITY_TRIE_SIZE> builder;
+    builder.insert_all();
+    return builder.nodes;
+}();
+
+// Root children indexed by byte (names are ASCII)
+inline constexpr auto ENTITY_TRIE_ROOT = [] {
+    std::array<u16, 128> table{};
+    for (u16 child = ENTITY_TRIE[0].first_child; child != 0; child = ENTITY_TRIE[child].next_sibling) {
+        table[static_cast<unsigned char>(ENTITY_TRIE[child].ch)] = child;
+    }
+    return table;
+}();
+
+// Longest entity name that is a prefix of `text`, or nullptr
+inline const NamedEntity* match_entity_prefix(const char* text, std::size_t length) {
+    if (length == 0) {
+        return nullptr;
+    }
+    auto first = static_cast<unsigned char>(text[0]);
+    u16 node = first < ENTITY_TRIE_ROOT.size() ? ENTITY_TRIE_ROOT[first] : 0;
+    const NamedEntity* best = nullptr;
+    std::size_t i = 1;
+    while (node != 0) {
+        if (ENTITY_TRIE[node].entity >= 0) {
+            best = &NAMED_ENTITIES[static_cast<std::size_t>(ENTITY_TRIE[node].entity)];
+        }
+        if (i == length) {
+            break;
+        }
+        char c = text[i++];
+        u16 child = ENTITY_TRIE[node].first_child;
+        while (child != 0 && ENTITY_TRIE[child].ch < c) {
+            child = ENTITY_TRIE[child].next_sibling;
+        }
+        node = (child != 0 && ENTITY_TRIE[child].ch == c) ? child : 0;
+    }
+    return best;
+}
+
+} // namespace lithium::html::detail
@@ -154,6 +154,11 @@ void Tokenizer::emit_character(unicode::CodePoint cp) {
     emit(CharacterToken{cp});
 }
 
+void Tokenizer::emit_character_run(usize length) {
+    emit(CharacterRunToken{m_input.view().substr(m_position, length)});
+    m_position += length;
+}
+
 void Tokenizer::emit_current_token() {
     if (m_current_token) {
         if (auto* tag = std::get_if<TagToken>(&*m_current_token)) {
@@ -439,6 +444,11 @@ bool Tokenizer::is_appropriate_end_tag_token() const {
     return tag.is_end_tag && tag.name == m_last_start_tag_name;
 }
 
+void Tokenizer::finish_tag_name() {
+    std::get<TagToken>(*m_current_token).name = Atom(m_current_tag_name.view());
+    m_current_tag_name.clear();
+}
+
 void Tokenizer::start_new_attribute() {
     m_current_attribute_name.clear();
     m_current_attribute_value.clear();
@@ -450,10 +460,11 @@ void Tokenizer::finish_attribute_name() {
 void Tokenizer::finish_attribute_value() {
     if (m_current_token && std::holds_alternative<TagToken>(*m_current_token)) {
         auto& tag = std::get<TagToken>(*m_current_token);
-        if (tag.get_attribute(m_current_attribute_name).has_value()) {
+        Atom name(m_current_attribute_name.view());
+        if (tag.get_attribute(name).has_value()) {
             parse_error("duplicate-attribute"_s);
         } else {
-            tag.set_attribute(m_current_attribute_name, m_current_attribute_value);
+            tag.attributes.emplace_back(name, m_current_attribute_value);
         }
     }
     m_current_attribute_name.clear();
@@ -3,7 +3,7 @@
  */
 
 #include "lithium/html/tokenizer.hpp"
-#include "entities.inc"
+#include "entity_trie.hpp"
 #include "lithium/core/string.hpp"
 #include <cctype>
 
@@ -71,24 +71,7 @@ inline unicode::CodePoint sanitize_numeric_code(u32 code) {
 }
 
 inline const detail::NamedEntity* match_named_entity(const String& input, usize position) {
-    const detail::NamedEntity* best = nullptr;
-    auto remaining = input.length() - position;
-
-    for (const auto& entity : detail::NAMED_ENTITIES) {
-        if (entity.name_length > remaining) continue;
-        bool matches = true;
-        for (usize i = 0; i < entity.name_length; ++i) {
-            if (input[position + i] != entity.name[i]) {
-                matches = false;
-                break;
-            }
-        }
-        if (!matches) continue;
-        if (!best || entity.name_length > best->name_length) {
-            best = &entity;
-        }
-    }
-    return best;
+    return detail::match_entity_prefix(input.data() + position, input.length() - position);
 }
 
 } // namespace
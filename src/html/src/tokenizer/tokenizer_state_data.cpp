@@ -7,6 +7,25 @@
 
 namespace lithium::html {
 
+namespace {
+
+// Number of bytes at the start of `text` before the first NUL or delimiter;
+// the data-like states hand that much to the tree builder as one run
+template<char... Delimiters>
+usize text_run_length(std::string_view text) {
+    usize length = 0;
+    while (length < text.size()) {
+        char c = text[length];
+        if (c == '\0' || ((c == Delimiters) || ...)) {
+            break;
+        }
+        ++length;
+    }
+    return length;
+}
+
+} // namespace
+
 void Tokenizer::handle_data_state() {
     auto cp = peek();
     if (!cp) {
@@ -14,6 +33,11 @@ void Tokenizer::handle_data_state() {
         return;
     }
 
+    if (auto length = text_run_length<'&', '<'>(m_input.view().substr(m_position))) {
+        emit_character_run(length);
+        return;
+    }
+
     consume();
 
     if (*cp == '&') {
@@ -36,6 +60,11 @@ void Tokenizer::handle_rcdata_state() {
         return;
     }
 
+    if (auto length = text_run_length<'&', '<'>(m_input.view().substr(m_position))) {
+        emit_character_run(length);
+        return;
+    }
+
     consume();
 
     if (*cp == '&') {
@@ -58,6 +87,11 @@ void Tokenizer::handle_rawtext_state() {
         return;
     }
 
+    if (auto length = text_run_length<'<'>(m_input.view().substr(m_position))) {
+        emit_character_run(length);
+        return;
+    }
+
     consume();
 
     if (*cp == '<') {
@@ -77,6 +111,11 @@ void Tokenizer::handle_script_data_state() {
         return;
     }
 
+    if (auto length = text_run_length<'<'>(m_input.view().substr(m_position))) {
+        emit_character_run(length);
+        return;
+    }
+
     consume();
 
     if (*cp == '<') {
@@ -96,6 +135,11 @@ void Tokenizer::handle_plaintext_state() {
         return;
     }
 
+    if (auto length = text_run_length<>(m_input.view().substr(m_position))) {
+        emit_character_run(length);
+        return;
+    }
+
     consume();
 
     if (*cp == 0) {
@@ -162,26 +206,25 @@ void Tokenizer::handle_rcdata_end_tag_name_state() {
         return;
     }
 
-    auto tag_name = m_temp_buffer.build();
-    bool is_appropriate = tag_name == m_last_start_tag_name;
+    bool is_appropriate = m_temp_buffer.view() == m_last_start_tag_name.view();
 
     if (is_appropriate && (*cp == '\t' || *cp == '\n' || *cp == '\f' || *cp == ' ')) {
         m_state = TokenizerState::BeforeAttributeName;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '/') {
         m_state = TokenizerState::SelfClosingStartTag;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '>') {
         consume();
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         emit_current_token();
         m_state = TokenizerState::Data;
         return;
@@ -247,26 +290,25 @@ void Tokenizer::handle_rawtext_end_tag_name_state() {
         return;
     }
 
-    auto tag_name = m_temp_buffer.build();
-    bool is_appropriate = tag_name == m_last_start_tag_name;
+    bool is_appropriate = m_temp_buffer.view() == m_last_start_tag_name.view();
 
     if (is_appropriate && (*cp == '\t' || *cp == '\n' || *cp == '\f' || *cp == ' ')) {
         m_state = TokenizerState::BeforeAttributeName;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '/') {
         m_state = TokenizerState::SelfClosingStartTag;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '>') {
         consume();
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         emit_current_token();
         m_state = TokenizerState::Data;
         return;
@@ -332,26 +374,25 @@ void Tokenizer::handle_script_data_end_tag_name_state() {
         return;
     }
 
-    auto tag_name = m_temp_buffer.build();
-    bool is_appropriate = tag_name == m_last_start_tag_name;
+    bool is_appropriate = m_temp_buffer.view() == m_last_start_tag_name.view();
 
     if (is_appropriate && (*cp == '\t' || *cp == '\n' || *cp == '\f' || *cp == ' ')) {
         m_state = TokenizerState::BeforeAttributeName;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '/') {
         m_state = TokenizerState::SelfClosingStartTag;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '>') {
         consume();
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         emit_current_token();
         m_state = TokenizerState::Data;
         return;
@@ -524,26 +565,25 @@ void Tokenizer::handle_script_data_escaped_end_tag_name_state() {
         return;
     }
 
-    auto tag_name = m_temp_buffer.build();
-    bool is_appropriate = tag_name == m_last_start_tag_name;
+    bool is_appropriate = m_temp_buffer.view() == m_last_start_tag_name.view();
 
     if (is_appropriate && (*cp == '\t' || *cp == '\n' || *cp == '\f' || *cp == ' ')) {
         m_state = TokenizerState::BeforeAttributeName;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '/') {
         m_state = TokenizerState::SelfClosingStartTag;
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         consume();
         return;
     }
 
     if (is_appropriate && *cp == '>') {
         consume();
-        std::get<TagToken>(*m_current_token).name = tag_name;
+        std::get<TagToken>(*m_current_token).name = m_last_start_tag_name;
         emit_current_token();
         m_state = TokenizerState::Data;
         return;
@@ -24,7 +24,7 @@ void Tokenizer::handle_tag_open_state() {
         m_state = TokenizerState::EndTagOpen;
     } else if (std::isalpha(*cp)) {
         m_current_token = TagToken{};
-        std::get<TagToken>(*m_current_token).name.clear();
+        m_current_tag_name.clear();
         reconsume();
         m_state = TokenizerState::TagName;
     } else if (*cp == '?') {
@@ -55,6 +55,7 @@ void Tokenizer::handle_end_tag_open_state() {
     if (std::isalpha(*cp)) {
         m_current_token = TagToken{};
         std::get<TagToken>(*m_current_token).is_end_tag = true;
+        m_current_tag_name.clear();
         reconsume();
         m_state = TokenizerState::TagName;
     } else if (*cp == '>') {
@@ -78,22 +79,23 @@ void Tokenizer::handle_tag_name_state() {
 
     consume();
 
-    auto& tag = std::get<TagToken>(*m_current_token);
-
     if (*cp == '\t' || *cp == '\n' || *cp == '\f' || *cp == ' ') {
+        finish_tag_name();
         m_state = TokenizerState::BeforeAttributeName;
     } else if (*cp == '/') {
+        finish_tag_name();
         m_state = TokenizerState::SelfClosingStartTag;
     } else if (*cp == '>') {
+        finish_tag_name();
         m_state = TokenizerState::Data;
         emit_current_token();
     } else if (std::isupper(*cp)) {
-        tag.name = tag.name + String(1, static_cast<char>(std::tolower(*cp)));
+        m_current_tag_name.append(static_cast<char>(std::tolower(*cp)));
     } else if (*cp == 0) {
         parse_error("unexpected-null-character"_s);
-        tag.name = tag.name + String(1, static_cast<char>(0xFFFD));
+        m_current_tag_name.append(static_cast<char>(0xFFFD));
     } else {
-        tag.name = tag.name + String(1, static_cast<char>(*cp));
+        m_current_tag_name.append(static_cast<char>(*cp));
     }
 }
 
@@ -115,7 +117,7 @@ void Tokenizer::handle_before_attribute_name_state() {
     } else if (*cp == '=') {
         parse_error("unexpected-equals-sign-before-attribute-name"_s);
         start_new_attribute();
-        m_current_attribute_name = String(1, static_cast<char>(*cp));
+        m_current_attribute_name.append(static_cast<char>(*cp));
         m_state = TokenizerState::AttributeName;
     } else {
         start_new_attribute();
@@ -143,15 +145,15 @@ void Tokenizer::handle_attribute_name_state() {
         finish_attribute_name();
         m_state = TokenizerState::BeforeAttributeValue;
     } else if (std::isupper(*cp)) {
-        m_current_attribute_name = m_current_attribute_name + String(1, static_cast<char>(std::tolower(*cp)));
+        m_current_attribute_name.append(static_cast<char>(std::tolower(*cp)));
     } else if (*cp == 0) {
         parse_error("unexpected-null-character"_s);
-        m_current_attribute_name = m_current_attribute_name + String(1, static_cast<char>(0xFFFD));
+        m_current_attribute_name.append(static_cast<char>(0xFFFD));
     } else if (*cp == '"' || *cp == '\'' || *cp == '<') {
         parse_error("unexpected-character-in-attribute-name"_s);
-        m_current_attribute_name = m_current_attribute_name + String(1, static_cast<char>(*cp));
+        m_current_attribute_name.append(static_cast<char>(*cp));
     } else {
-        m_current_attribute_name = m_current_attribute_name + String(1, static_cast<char>(*cp));
+        m_current_attribute_name.append(static_cast<char>(*cp));
     }
 }
 
@@ -6,26 +6,34 @@
 
 namespace lithium::html {
 
-std::optional<String> TagToken::get_attribute(const String& name) const {
-    auto lower_name = name.to_lowercase();
+std::optional<String> TagToken::get_attribute(Atom name) const {
     for (const auto& [attr_name, attr_value] : attributes) {
-        if (attr_name.to_lowercase() == lower_name) {
+        if (attr_name == name) {
             return attr_value;
         }
     }
     return std::nullopt;
 }
 
-void TagToken::set_attribute(const String& name, const String& value) {
-    auto lower_name = name.to_lowercase();
+std::optional<String> TagToken::get_attribute(const String& name) const {
+    // A name that was never interned is on no token
+    auto atom = Atom::find(name.to_lowercase().view());
+    return atom ? get_attribute(*atom) : std::nullopt;
+}
+
+void TagToken::set_attribute(Atom name, const String& value) {
     for (const auto& [attr_name, attr_value] : attributes) {
-        if (attr_name.to_lowercase() == lower_name) {
+        if (attr_name == name) {
             return; // Duplicate attribute ignored (first wins)
         }
     }
     attributes.emplace_back(name, value);
 }
 
+void TagToken::set_attribute(const String& name, const String& value) {
+    set_attribute(Atom(name.to_lowercase()), value);
+}
+
 bool is_doctype(const Token& token) {
     return std::holds_alternative<DoctypeToken>(token);
 }
@@ -48,6 +56,10 @@ bool is_character(const Token& token) {
     return std::holds_alternative<CharacterToken>(token);
 }
 
+bool is_character_run(const Token& token) {
+    return std::holds_alternative<CharacterRunToken>(token);
+}
+
 bool is_comment(const Token& token) {
     return std::holds_alternative<CommentToken>(token);
 }
@@ -56,16 +68,16 @@ bool is_eof(const Token& token) {
     return std::holds_alternative<EndOfFileToken>(token);
 }
 
-bool is_start_tag_named(const Token& token, const String& name) {
+bool is_start_tag_named(const Token& token, Atom name) {
     if (auto* tag = std::get_if<TagToken>(&token)) {
-        return !tag->is_end_tag && tag->name.to_lowercase() == name.to_lowercase();
+        return !tag->is_end_tag && tag->name == name;
     }
     return false;
 }
 
-bool is_end_tag_named(const Token& token, const String& name) {
+bool is_end_tag_named(const Token& token, Atom name) {
     if (auto* tag = std::get_if<TagToken>(&token)) {
-        return tag->is_end_tag && tag->name.to_lowercase() == name.to_lowercase();
+        return tag->is_end_tag && tag->name == name;
     }
     return false;
 }
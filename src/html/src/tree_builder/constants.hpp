@@ -1,32 +1,37 @@
 #pragma once
 
+#include "lithium/core/atom.hpp"
+#include "lithium/core/atom.hpp"
 #include "lithium/core/string.hpp"
 #include "lithium/core/types.hpp"
 #include <array>
 
 namespace lithium::html::detail {
 
-inline constexpr std::array<const char*, 82> SPECIAL_ELEMENTS = {
-    "address", "applet", "area", "article", "aside", "base", "basefont",
-    "bgsound", "blockquote", "body", "br", "button", "caption", "center",
-    "col", "colgroup", "dd", "details", "dir", "div", "dl", "dt", "embed",
-    "fieldset", "figcaption", "figure", "footer", "form", "frame", "frameset",
-    "h1", "h2", "h3", "h4", "h5", "h6", "head", "header", "hgroup", "hr",
-    "html", "iframe", "img", "input", "keygen", "li", "link", "listing",
-    "main", "marquee", "menu", "meta", "nav", "noembed", "noframes",
-    "noscript", "object", "ol", "p", "param", "plaintext", "pre", "script",
-    "section", "select", "source", "style", "summary", "table", "tbody",
-    "td", "template", "textarea", "tfoot", "th", "thead", "title", "tr",
-    "track", "ul", "wbr", "xmp"
+inline constexpr std::array<Atom, 82> SPECIAL_ELEMENTS = {
+    atoms::address, atoms::applet, atoms::area, atoms::article, atoms::aside, atoms::base,
+    atoms::basefont, atoms::bgsound, atoms::blockquote, atoms::body, atoms::br, atoms::button,
+    atoms::caption, atoms::center, atoms::col, atoms::colgroup, atoms::dd, atoms::details,
+    atoms::dir, atoms::div, atoms::dl, atoms::dt, atoms::embed, atoms::fieldset, atoms::figcaption,
+    atoms::figure, atoms::footer, atoms::form, atoms::frame, atoms::frameset, atoms::h1, atoms::h2,
+    atoms::h3, atoms::h4, atoms::h5, atoms::h6, atoms::head, atoms::header, atoms::hgroup,
+    atoms::hr, atoms::html, atoms::iframe, atoms::img, atoms::input, atoms::keygen, atoms::li,
+    atoms::link, atoms::listing, atoms::main, atoms::marquee, atoms::menu, atoms::meta, atoms::nav,
+    atoms::noembed, atoms::noframes, atoms::noscript, atoms::object, atoms::ol, atoms::p,
+    atoms::param, atoms::plaintext, atoms::pre, atoms::script, atoms::section, atoms::select,
+    atoms::source, atoms::style, atoms::summary, atoms::table, atoms::tbody, atoms::td,
+    atoms::template_, atoms::textarea, atoms::tfoot, atoms::th, atoms::thead, atoms::title,
+    atoms::tr, atoms::track, atoms::ul, atoms::wbr, atoms::xmp
 };
 
-inline constexpr std::array<const char*, 14> FORMATTING_ELEMENTS = {
-    "a", "b", "big", "code", "em", "font", "i", "nobr", "s", "small",
-    "strike", "strong", "tt", "u"
+inline constexpr std::array<Atom, 14> FORMATTING_ELEMENTS = {
+    atoms::a, atoms::b, atoms::big, atoms::code, atoms::em, atoms::font, atoms::i, atoms::nobr,
+    atoms::s, atoms::small, atoms::strike, atoms::strong, atoms::tt, atoms::u
 };
 
-inline constexpr std::array<const char*, 10> IMPLIED_END_TAG_ELEMENTS = {
-    "dd", "dt", "li", "optgroup", "option", "p", "rb", "rp", "rt", "rtc"
+inline constexpr std::array<Atom, 10> IMPLIED_END_TAG_ELEMENTS = {
+    atoms::dd, atoms::dt, atoms::li, atoms::optgroup, atoms::option, atoms::p, atoms::rb,
+    atoms::rp, atoms::rt, atoms::rtc
 };
 
 inline bool is_ascii_whitespace(unicode::CodePoint cp) {
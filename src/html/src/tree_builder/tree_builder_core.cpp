@@ -47,30 +47,34 @@ bool TreeBuilder::in_foreign_content() const {
     return true;
 }
 
-String svg_camel_case(const String& name_lower) {
-    struct Entry { const char* from; const char* to; };
-    static const Entry mappings[] = {
-        {"altglyph", "altGlyph"}, {"altglyphdef", "altGlyphDef"}, {"altglyphitem", "altGlyphItem"},
-        {"animatecolor", "animateColor"}, {"animatemotion", "animateMotion"}, {"animatetransform", "animateTransform"},
-        {"clippath", "clipPath"}, {"feblend", "feBlend"}, {"fecolormatrix", "feColorMatrix"},
-        {"fecomponenttransfer", "feComponentTransfer"}, {"fecomposite", "feComposite"},
-        {"feconvolvematrix", "feConvolveMatrix"}, {"fediffuselighting", "feDiffuseLighting"},
-        {"fedisplacementmap", "feDisplacementMap"}, {"fedistantlight", "feDistantLight"},
-        {"fedropshadow", "feDropShadow"}, {"feflood", "feFlood"}, {"fefunca", "feFuncA"},
-        {"fefuncb", "feFuncB"}, {"fefuncg", "feFuncG"}, {"fefuncr", "feFuncR"},
-        {"fegaussianblur", "feGaussianBlur"}, {"feimage", "feImage"}, {"femerge", "feMerge"},
-        {"femergenode", "feMergeNode"}, {"femorphology", "feMorphology"}, {"feoffset", "feOffset"},
-        {"fepointlight", "fePointLight"}, {"fespecularlighting", "feSpecularLighting"},
-        {"fespotlight", "feSpotLight"}, {"fetile", "feTile"}, {"feturbulence", "feTurbulence"},
-        {"foreignobject", "foreignObject"}, {"glyphref", "glyphRef"}, {"lineargradient", "linearGradient"},
-        {"radialgradient", "radialGradient"}, {"textpath", "textPath"}
+Atom svg_camel_case(Atom name) {
+    struct Entry { Atom from; Atom to; };
+    static constexpr Entry mappings[] = {
+        {atoms::altglyph, atoms::altGlyph}, {atoms::altglyphdef, atoms::altGlyphDef},
+        {atoms::altglyphitem, atoms::altGlyphItem}, {atoms::animatecolor, atoms::animateColor},
+        {atoms::animatemotion, atoms::animateMotion}, {atoms::animatetransform, atoms::animateTransform},
+        {atoms::clippath, atoms::clipPath}, {atoms::feblend, atoms::feBlend},
+        {atoms::fecolormatrix, atoms::feColorMatrix}, {atoms::fecomponenttransfer, atoms::feComponentTransfer},
+        {atoms::fecomposite, atoms::feComposite}, {atoms::feconvolvematrix, atoms::feConvolveMatrix},
+        {atoms::fediffuselighting, atoms::feDiffuseLighting}, {atoms::fedisplacementmap, atoms::feDisplacementMap},
+        {atoms::fedistantlight, atoms::feDistantLight}, {atoms::fedropshadow, atoms::feDropShadow},
+        {atoms::feflood, atoms::feFlood}, {atoms::fefunca, atoms::feFuncA}, {atoms::fefuncb, atoms::feFuncB},
+        {atoms::fefuncg, atoms::feFuncG}, {atoms::fefuncr, atoms::feFuncR},
+        {atoms::fegaussianblur, atoms::feGaussianBlur}, {atoms::feimage, atoms::feImage},
+        {atoms::femerge, atoms::feMerge}, {atoms::femergenode, atoms::feMergeNode},
+        {atoms::femorphology, atoms::feMorphology}, {atoms::feoffset, atoms::feOffset},
+        {atoms::fepointlight, atoms::fePointLight}, {atoms::fespecularlighting, atoms::feSpecularLighting},
+        {atoms::fespotlight, atoms::feSpotLight}, {atoms::fetile, atoms::feTile},
+        {atoms::feturbulence, atoms::feTurbulence}, {atoms::foreignobject, atoms::foreignObject},
+        {atoms::glyphref, atoms::glyphRef}, {atoms::lineargradient, atoms::linearGradient},
+        {atoms::radialgradient, atoms::radialGradient}, {atoms::textpath, atoms::textPath}
     };
     for (const auto& m : mappings) {
-        if (name_lower == String(m.from)) {
-            return String(m.to);
+        if (name == m.from) {
+            return m.to;
         }
     }
-    return name_lower;
+    return name;
 }
 
 String svg_attribute_camel_case(const String& name_lower) {
@@ -139,7 +143,7 @@ void TreeBuilder::prepare_for_fragment(RefPtr<dom::Element> context_element) {
     m_is_iframe_srcdoc = false;
 
     if (context_element) {
-        if (context_element->local_name() == "form"_s) {
+        if (context_element->local_name_atom() == atoms::form) {
             m_form_element = context_element.get();
         }
         m_open_elements.push_back(std::move(context_element));
@@ -150,6 +154,11 @@ void TreeBuilder::prepare_for_fragment(RefPtr<dom::Element> context_element) {
 }
 
 void TreeBuilder::process_token(const Token& token) {
+    if (auto* run = std::get_if<CharacterRunToken>(&token)) {
+        process_character_run(run->text);
+        return;
+    }
+
     bool check_self_closing = false;
     if (auto* tag = std::get_if<TagToken>(&token)) {
         if (!tag->is_end_tag && tag->self_closing) {
@@ -248,7 +257,7 @@ void TreeBuilder::process_token(const Token& token) {
     if (check_self_closing && !m_self_closing_flag_acknowledged) {
         String name;
         if (auto* tag = std::get_if<TagToken>(&token)) {
-            name = tag->name;
+            name = tag->name.string();
         }
         parse_error("non-void-self-closing"_s + (name.empty() ? String() : String(":"_s + name)));
         m_self_closing_flag_acknowledged = true;
@@ -262,10 +271,60 @@ void TreeBuilder::process_using_rules_for(InsertionMode mode, const Token& token
     m_insertion_mode = saved_mode;
 }
 
+void TreeBuilder::process_character_run(std::string_view text) {
+    m_self_closing_flag_acknowledged = true;
+    while (!text.empty()) {
+        if (process_character_run_in_bulk(text)) {
+            return;
+        }
+        // Modes that tell whitespace from other text (before head, in table
+        // body, after body...) take single characters until one of them
+        // switches to a mode that can have the rest of the run
+        auto decoded = unicode::utf8_decode(text.data(), text.size());
+        process_token(CharacterToken{decoded.code_point});
+        text.remove_prefix(std::clamp<usize>(decoded.bytes_consumed, 1, text.size()));
+    }
+}
+
+bool TreeBuilder::process_character_run_in_bulk(std::string_view text) {
+    // Runs never hold NULs, so these match the per-character rules applied
+    // to every character of the run
+    if (in_foreign_content()) {
+        insert_characters(text);
+        return true;
+    }
+
+    switch (m_insertion_mode) {
+        case InsertionMode::InBody:
+        case InsertionMode::InCaption:
+        case InsertionMode::InCell: {
+            reconstruct_active_formatting_elements();
+            insert_characters(text);
+            bool all_whitespace = std::all_of(text.begin(), text.end(), [](char c) {
+                return detail::is_ascii_whitespace(static_cast<unsigned char>(c));
+            });
+            if (!all_whitespace) {
+                m_frameset_ok = false;
+            }
+            return true;
+        }
+        case InsertionMode::Text:
+        case InsertionMode::InSelect:
+        case InsertionMode::InSelectInTable:
+            insert_characters(text);
+            return true;
+        case InsertionMode::InTableText:
+            m_pending_table_characters.append(text);
+            return true;
+        default:
+            return false;
+    }
+}
+
 RefPtr<dom::Element> TreeBuilder::create_element(const TagToken& token, const String& namespace_uri) {
     RefPtr<dom::Element> element;
     if (!namespace_uri.empty()) {
-        element = m_document->create_element_ns(namespace_uri, token.name);
+        element = m_document->create_element_ns(namespace_uri, token.name.string());
     } else {
         element = m_document->create_element(token.name);
     }
@@ -277,43 +336,51 @@ RefPtr<dom::Element> TreeBuilder::create_element_for_token(const TagToken& token
     static const String MATHML_NS = "http://www.w3.org/1998/Math/MathML"_s;
 
     auto adjusted = adjusted_current_node();
-    auto context_ns = adjusted ? adjusted->namespace_uri() : String();
-    auto context_name = adjusted ? adjusted->local_name() : String();
-    auto context_name_lower = context_name.to_lowercase();
-    auto name_lower = token.name.to_lowercase();
-
     String ns;
-    String adjusted_name = token.name;
+    Atom adjusted_name = token.name;
 
-    if (name_lower == "svg"_s) {
+    if (token.name == atoms::svg) {
         ns = SVG_NS;
-        adjusted_name = svg_camel_case(name_lower);
-    } else if (name_lower == "math"_s) {
+    } else if (token.name == atoms::math) {
         ns = MATHML_NS;
-        adjusted_name = name_lower;
-    } else if (context_ns == SVG_NS) {
-        if (context_name_lower == "foreignobject"_s || context_name_lower == "desc"_s || context_name_lower == "title"_s) {
-            ns = String(); // HTML namespace
-        } else {
-            ns = SVG_NS;
-            adjusted_name = svg_camel_case(name_lower);
-        }
-    } else if (context_ns == MATHML_NS) {
-        if (context_name_lower == "annotation-xml"_s) {
-            auto encoding = adjusted ? adjusted->get_attribute("encoding"_s).value_or(String()).to_lowercase() : String();
-            if (encoding == "text/html"_s || encoding == "application/xhtml+xml"_s) {
+    } else if (adjusted && !adjusted->namespace_uri().empty()) {
+        const auto& context_ns = adjusted->namespace_uri();
+        auto context_name_lower = adjusted->local_name().to_lowercase();
+        if (context_ns == SVG_NS) {
+            if (context_name_lower == "foreignobject"_s || context_name_lower == "desc"_s || context_name_lower == "title"_s) {
+                ns = String(); // HTML namespace
+            } else {
+                ns = SVG_NS;
+                adjusted_name = svg_camel_case(token.name);
+            }
+        } else if (context_ns == MATHML_NS) {
+            if (context_name_lower == "annotation-xml"_s) {
+                auto encoding = adjusted->get_attribute("encoding"_s).value_or(String()).to_lowercase();
+                if (encoding == "text/html"_s || encoding == "application/xhtml+xml"_s) {
+                    ns = String();
+                } else {
+                    ns = MATHML_NS;
+                }
+            } else if (is_mathml_text_integration_point(context_name_lower) &&
+                       token.name != atoms::mglyph && token.name != atoms::malignmark) {
                 ns = String();
             } else {
                 ns = MATHML_NS;
             }
-        } else if (is_mathml_text_integration_point(context_name_lower) &&
-                   name_lower != "mglyph"_s && name_lower != "malignmark"_s) {
-            ns = String();
-        } else {
-            ns = MATHML_NS;
         }
     }
 
+    // HTML elements: the tokenizer has already lowercased and deduplicated
+    // the attribute names, so they need no adjustment
+    if (ns.empty()) {
+        auto element = create_element(token, ns);
+        for (const auto& [attr_name, attr_value] : token.attributes) {
+            element->set_attribute(attr_name, attr_value);
+        }
+        associate_form_owner(element.get(), token);
+        return element;
+    }
+
     TagToken adjusted_token = token;
     adjusted_token.name = adjusted_name;
 
@@ -335,10 +402,10 @@ RefPtr<dom::Element> TreeBuilder::create_element_for_token(const TagToken& token
     adjusted_attributes.reserve(token.attributes.size());
 
     for (const auto& [attr_name, attr_value] : token.attributes) {
-        auto name_lower_attr = attr_name.to_lowercase();
+        auto name_lower_attr = attr_name.string();
         AdjustedAttribute adjusted_attr;
         adjusted_attr.value = attr_value;
-        adjusted_attr.name = attr_name;
+        adjusted_attr.name = name_lower_attr;
         adjusted_attr.local_name = name_lower_attr;
 
         if (element->namespace_uri() == SVG_NS) {
@@ -410,6 +477,13 @@ void TreeBuilder::insert_element(RefPtr<dom::Element> element) {
 }
 
 void TreeBuilder::insert_character(unicode::CodePoint cp) {
+    char buffer[4];
+    insert_characters(std::string_view(buffer, unicode::utf8_encode(cp, buffer)));
+}
+
+void TreeBuilder::insert_characters(std::string_view text) {
+    if (text.empty()) return;
+
     auto insertion = appropriate_insertion_place();
     auto* insert_parent = insertion.parent;
     if (!insert_parent) return;
@@ -418,17 +492,16 @@ void TreeBuilder::insert_character(unicode::CodePoint cp) {
         ? insertion.insert_before->previous_sibling()
         : insert_parent->last_child();
 
-    String as_string = String::from_code_point(cp);
     if (adjacent && adjacent->is_text()) {
-        adjacent->as_text()->append_data(as_string);
+        adjacent->as_text()->append_data(text);
         return;
     }
 
-    auto text = m_document->create_text_node(as_string);
+    auto node = m_document->create_text_node(String(text));
     if (insertion.insert_before) {
-        insert_parent->insert_before(text, insertion.insert_before);
+        insert_parent->insert_before(node, insertion.insert_before);
     } else {
-        insert_parent->append_child(text);
+        insert_parent->append_child(node);
     }
 }
 
@@ -472,28 +545,29 @@ void TreeBuilder::remove_from_stack(dom::Element* element) {
         m_open_elements.end());
 }
 
-bool TreeBuilder::stack_contains(const String& tag_name) const {
+bool TreeBuilder::stack_contains(Atom tag_name) const {
     for (const auto& elem : m_open_elements) {
-        if (elem->local_name() == tag_name) {
+        if (elem->local_name_atom() == tag_name) {
             return true;
         }
     }
     return false;
 }
 
-bool TreeBuilder::stack_contains_in_scope(const String& tag_name) const {
-    static const std::array<const char*, 18> scope_markers = {
-        "applet", "caption", "html", "table", "td", "th", "marquee", "object", "template",
-        "foreignObject", "desc", "title",
-        "mi", "mo", "mn", "ms", "mtext", "annotation-xml"
+bool TreeBuilder::stack_contains_in_scope(Atom tag_name) const {
+    static constexpr std::array<Atom, 18> scope_markers = {
+        atoms::applet, atoms::caption, atoms::html, atoms::table, atoms::td, atoms::th, atoms::marquee,
+        atoms::object, atoms::template_, atoms::foreignObject, atoms::desc, atoms::title,
+        atoms::mi, atoms::mo, atoms::mn, atoms::ms, atoms::mtext, atoms::annotation_xml
     };
 
     for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
-        if ((*it)->local_name() == tag_name) {
+        if ((*it)->local_name_atom() == tag_name) {
             return true;
         }
-        for (const char* marker : scope_markers) {
-            if ((*it)->local_name() == String(marker)) {
+        auto name = (*it)->local_name_atom();
+        for (Atom marker : scope_markers) {
+            if (name == marker) {
                 return false;
             }
         }
@@ -501,49 +575,49 @@ bool TreeBuilder::stack_contains_in_scope(const String& tag_name) const {
     return false;
 }
 
-bool TreeBuilder::stack_contains_in_list_item_scope(const String& tag_name) const {
+bool TreeBuilder::stack_contains_in_list_item_scope(Atom tag_name) const {
     for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
-        if ((*it)->local_name() == tag_name) {
+        if ((*it)->local_name_atom() == tag_name) {
             return true;
         }
-        if ((*it)->local_name() == "ol"_s || (*it)->local_name() == "ul"_s) {
+        if ((*it)->local_name_atom() == atoms::ol || (*it)->local_name_atom() == atoms::ul) {
             return false;
         }
     }
     return stack_contains_in_scope(tag_name);
 }
 
-bool TreeBuilder::stack_contains_in_button_scope(const String& tag_name) const {
+bool TreeBuilder::stack_contains_in_button_scope(Atom tag_name) const {
     for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
-        if ((*it)->local_name() == tag_name) {
+        if ((*it)->local_name_atom() == tag_name) {
             return true;
         }
-        if ((*it)->local_name() == "button"_s) {
+        if ((*it)->local_name_atom() == atoms::button) {
             return false;
         }
     }
     return stack_contains_in_scope(tag_name);
 }
 
-bool TreeBuilder::stack_contains_in_table_scope(const String& tag_name) const {
+bool TreeBuilder::stack_contains_in_table_scope(Atom tag_name) const {
     for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
-        if ((*it)->local_name() == tag_name) {
+        if ((*it)->local_name_atom() == tag_name) {
             return true;
         }
-        if ((*it)->local_name() == "html"_s || (*it)->local_name() == "table"_s ||
-            (*it)->local_name() == "template"_s) {
+        if ((*it)->local_name_atom() == atoms::html || (*it)->local_name_atom() == atoms::table ||
+            (*it)->local_name_atom() == atoms::template_) {
             return false;
         }
     }
     return false;
 }
 
-bool TreeBuilder::stack_contains_in_select_scope(const String& tag_name) const {
+bool TreeBuilder::stack_contains_in_select_scope(Atom tag_name) const {
     for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
-        if ((*it)->local_name() == tag_name) {
+        if ((*it)->local_name_atom() == tag_name) {
             return true;
         }
-        if ((*it)->local_name() != "optgroup"_s && (*it)->local_name() != "option"_s) {
+        if ((*it)->local_name_atom() != atoms::optgroup && (*it)->local_name_atom() != atoms::option) {
             return false;
         }
     }
@@ -557,7 +631,7 @@ void TreeBuilder::push_active_formatting_element(RefPtr<dom::Element> element, c
     for (usize i = 0; i < m_active_formatting_elements.size(); ++i) {
         auto& afe = m_active_formatting_elements[i];
         if (afe.type == ActiveFormattingElement::Type::Element &&
-            afe.element && afe.element->local_name() == element->local_name()) {
+            afe.element && afe.element->local_name_atom() == element->local_name_atom()) {
             if (!first_match.has_value()) {
                 first_match = i;
             }
@@ -631,14 +705,14 @@ void TreeBuilder::remove_from_active_formatting(dom::Element* element) {
         m_active_formatting_elements.end());
 }
 
-void TreeBuilder::adoption_agency_algorithm(const String& tag_name) {
+void TreeBuilder::adoption_agency_algorithm(Atom tag_name) {
     for (int iteration = 0; iteration < 8; ++iteration) {
         // 1. Find formatting element
         auto afe_it = std::find_if(m_active_formatting_elements.rbegin(),
             m_active_formatting_elements.rend(),
             [&](const ActiveFormattingElement& afe) {
                 return afe.type == ActiveFormattingElement::Type::Element &&
-                    afe.element && afe.element->local_name() == tag_name;
+                    afe.element && afe.element->local_name_atom() == tag_name;
             });
 
         if (afe_it == m_active_formatting_elements.rend()) {
@@ -672,7 +746,7 @@ void TreeBuilder::adoption_agency_algorithm(const String& tag_name) {
         auto formatting_index = static_cast<isize>(stack_it - m_open_elements.begin());
         std::optional<isize> furthest_index;
         for (isize i = formatting_index + 1; i < static_cast<isize>(m_open_elements.size()); ++i) {
-            auto name = m_open_elements[static_cast<usize>(i)]->local_name();
+            auto name = m_open_elements[static_cast<usize>(i)]->local_name_atom();
             if (is_special_element(name)) {
                 furthest_block = m_open_elements[static_cast<usize>(i)].get();
                 furthest_index = static_cast<isize>(i);
@@ -730,7 +804,7 @@ void TreeBuilder::adoption_agency_algorithm(const String& tag_name) {
             if (last_node->parent_node()) {
                 last_node->parent_node()->remove_child(RefPtr<dom::Node>(last_node));
             }
-            if (common_ancestor->local_name() == "table"_s) {
+            if (common_ancestor->local_name_atom() == atoms::table) {
                 if (auto* parent = common_ancestor->parent_node()) {
                     parent->insert_before(RefPtr<dom::Node>(last_node), common_ancestor);
                 }
@@ -768,11 +842,11 @@ TreeBuilder::InsertionLocation TreeBuilder::appropriate_insertion_place() {
     int last_template_index = -1;
     int last_table_index = -1;
     for (int i = static_cast<int>(m_open_elements.size()) - 1; i >= 0; --i) {
-        auto name = m_open_elements[static_cast<usize>(i)]->local_name();
-        if (last_template_index == -1 && name == "template"_s) {
+        auto name = m_open_elements[static_cast<usize>(i)]->local_name_atom();
+        if (last_template_index == -1 && name == atoms::template_) {
             last_template_index = i;
         }
-        if (last_table_index == -1 && name == "table"_s) {
+        if (last_table_index == -1 && name == atoms::table) {
             last_table_index = i;
         }
         if (last_template_index != -1 && last_table_index != -1) {
@@ -802,14 +876,14 @@ TreeBuilder::InsertionLocation TreeBuilder::appropriate_insertion_place() {
     return {adjusted_current_node(), nullptr};
 }
 
-void TreeBuilder::generate_implied_end_tags(const String& except) {
+void TreeBuilder::generate_implied_end_tags(Atom except) {
     while (current_node()) {
-        auto name = current_node()->local_name();
+        auto name = current_node()->local_name_atom();
         if (name == except) break;
 
         bool is_implied = false;
-        for (const char* tag : detail::IMPLIED_END_TAG_ELEMENTS) {
-            if (name == String(tag)) {
+        for (Atom tag : detail::IMPLIED_END_TAG_ELEMENTS) {
+            if (name == tag) {
                 is_implied = true;
                 break;
             }
@@ -822,18 +896,18 @@ void TreeBuilder::generate_implied_end_tags(const String& except) {
 
 void TreeBuilder::generate_all_implied_end_tags_thoroughly() {
     while (current_node()) {
-        auto name = current_node()->local_name();
+        auto name = current_node()->local_name_atom();
 
         bool is_implied = false;
-        for (const char* tag : detail::IMPLIED_END_TAG_ELEMENTS) {
-            if (name == String(tag)) {
+        for (Atom tag : detail::IMPLIED_END_TAG_ELEMENTS) {
+            if (name == tag) {
                 is_implied = true;
                 break;
             }
         }
-        if (name == "caption"_s || name == "colgroup"_s || name == "tbody"_s ||
-            name == "td"_s || name == "tfoot"_s || name == "th"_s ||
-            name == "thead"_s || name == "tr"_s) {
+        if (name == atoms::caption || name == atoms::colgroup || name == atoms::tbody ||
+            name == atoms::td || name == atoms::tfoot || name == atoms::th ||
+            name == atoms::thead || name == atoms::tr) {
             is_implied = true;
         }
 
@@ -842,31 +916,31 @@ void TreeBuilder::generate_all_implied_end_tags_thoroughly() {
     }
 }
 
-bool TreeBuilder::is_special_element(const String& tag_name) {
-    for (const char* special : detail::SPECIAL_ELEMENTS) {
-        if (tag_name == String(special)) {
+bool TreeBuilder::is_special_element(Atom tag_name) {
+    for (Atom special : detail::SPECIAL_ELEMENTS) {
+        if (tag_name == special) {
             return true;
         }
     }
     return false;
 }
 
-bool TreeBuilder::is_formatting_element(const String& tag_name) {
-    for (const char* fmt : detail::FORMATTING_ELEMENTS) {
-        if (tag_name == String(fmt)) {
+bool TreeBuilder::is_formatting_element(Atom tag_name) {
+    for (Atom fmt : detail::FORMATTING_ELEMENTS) {
+        if (tag_name == fmt) {
             return true;
         }
     }
     return false;
 }
 
-bool TreeBuilder::is_form_associated(const String& tag_name) {
-    static const std::array<const char*, 12> FORM_ASSOCIATED = {
-        "button", "fieldset", "input", "label", "object", "output",
-        "select", "textarea", "option", "optgroup", "meter", "progress"
+bool TreeBuilder::is_form_associated(Atom tag_name) {
+    static constexpr std::array<Atom, 12> FORM_ASSOCIATED = {
+        atoms::button, atoms::fieldset, atoms::input, atoms::label, atoms::object, atoms::output,
+        atoms::select, atoms::textarea, atoms::option, atoms::optgroup, atoms::meter, atoms::progress
     };
-    for (const char* name : FORM_ASSOCIATED) {
-        if (tag_name == String(name)) {
+    for (Atom name : FORM_ASSOCIATED) {
+        if (tag_name == name) {
             return true;
         }
     }
@@ -905,59 +979,59 @@ void TreeBuilder::reset_insertion_mode_appropriately() {
             }
         }
 
-        auto name = node->local_name();
+        auto name = node->local_name_atom();
 
-        if (name == "select"_s) {
+        if (name == atoms::select) {
             m_insertion_mode = InsertionMode::InSelect;
             return;
         }
-        if (name == "td"_s || name == "th"_s) {
+        if (name == atoms::td || name == atoms::th) {
             if (!last) {
                 m_insertion_mode = InsertionMode::InCell;
                 return;
             }
         }
-        if (name == "tr"_s) {
+        if (name == atoms::tr) {
             m_insertion_mode = InsertionMode::InRow;
             return;
         }
-        if (name == "tbody"_s || name == "thead"_s || name == "tfoot"_s) {
+        if (name == atoms::tbody || name == atoms::thead || name == atoms::tfoot) {
             m_insertion_mode = InsertionMode::InTableBody;
             return;
         }
-        if (name == "caption"_s) {
+        if (name == atoms::caption) {
             m_insertion_mode = InsertionMode::InCaption;
             return;
         }
-        if (name == "colgroup"_s) {
+        if (name == atoms::colgroup) {
             m_insertion_mode = InsertionMode::InColumnGroup;
             return;
         }
-        if (name == "table"_s) {
+        if (name == atoms::table) {
             m_insertion_mode = InsertionMode::InTable;
             return;
         }
-        if (name == "template"_s) {
+        if (name == atoms::template_) {
             m_insertion_mode = m_template_insertion_modes.empty()
                 ? InsertionMode::InTemplate
                 : m_template_insertion_modes.top();
             return;
         }
-        if (name == "head"_s) {
+        if (name == atoms::head) {
             if (!last) {
                 m_insertion_mode = InsertionMode::InHead;
                 return;
             }
         }
-        if (name == "body"_s) {
+        if (name == atoms::body) {
             m_insertion_mode = InsertionMode::InBody;
             return;
         }
-        if (name == "frameset"_s) {
+        if (name == atoms::frameset) {
             m_insertion_mode = InsertionMode::InFrameset;
             return;
         }
-        if (name == "html"_s) {
+        if (name == atoms::html) {
             if (!m_head_element) {
                 m_insertion_mode = InsertionMode::BeforeHead;
             } else {
@@ -973,18 +1047,18 @@ void TreeBuilder::reset_insertion_mode_appropriately() {
 }
 
 void TreeBuilder::associate_form_owner(dom::Element* element, const TagToken& token) {
-    if (!element || !is_form_associated(element->local_name())) {
+    if (!element || !is_form_associated(element->local_name_atom())) {
         return;
     }
 
-    if (stack_contains("template"_s)) {
+    if (stack_contains(atoms::template_)) {
         return;
     }
 
     dom::Element* owner = nullptr;
-    if (auto form_attr = token.get_attribute("form"_s)) {
+    if (auto form_attr = token.get_attribute(atoms::form)) {
         owner = m_document ? m_document->get_element_by_id(*form_attr) : nullptr;
-        if (owner && owner->local_name() != "form"_s) {
+        if (owner && owner->local_name_atom() != atoms::form) {
             owner = nullptr;
         }
         if (!owner) {
@@ -994,9 +1068,9 @@ void TreeBuilder::associate_form_owner(dom::Element* element, const TagToken& to
         }
     } else if (m_form_element) {
         owner = m_form_element;
-    } else if (element->local_name() == "option"_s || element->local_name() == "optgroup"_s) {
+    } else if (element->local_name_atom() == atoms::option || element->local_name_atom() == atoms::optgroup) {
         for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
-            if ((*it)->local_name() == "select"_s) {
+            if ((*it)->local_name_atom() == atoms::select) {
                 owner = (*it)->form_owner();
                 break;
             }
@@ -1028,17 +1102,17 @@ void TreeBuilder::refresh_form_owner_for_subtree(dom::Node* node) {
     if (!node) return;
     if (node->is_element()) {
         auto* element = node->as_element();
-        if (is_form_associated(element->local_name())) {
+        if (is_form_associated(element->local_name_atom())) {
             TagToken pseudo;
-            pseudo.name = element->local_name();
+            pseudo.name = element->local_name_atom();
             for (const auto& attr : element->attributes()) {
-                pseudo.set_attribute(attr.name, attr.value);
+                pseudo.set_attribute(attr.name(), attr.value);
             }
             associate_form_owner(element, pseudo);
         }
     }
     for (const auto& child : node->child_nodes()) {
-        refresh_form_owner_for_subtree(child.get());
+        refresh_form_owner_for_subtree(child);
     }
 }
 
@@ -1047,18 +1121,20 @@ bool TreeBuilder::process_foreign_content(const Token& token) {
         return false;
     }
 
-    static const std::array<const char*, 48> HTML_BREAKOUT = {
-        "b", "big", "blockquote", "body", "br", "center", "code", "dd", "div", "dl",
-        "dt", "em", "embed", "h1", "h2", "h3", "h4", "h5", "h6", "head", "hr", "i",
-        "html", "img", "li", "listing", "menu", "meta", "nav", "ol", "p", "pre", "ruby",
-        "section", "small", "span", "strong", "summary", "table", "tbody",
-        "td", "template", "tfoot", "th", "thead", "title", "tr", "ul"
+    static constexpr std::array<Atom, 48> HTML_BREAKOUT = {
+        atoms::b, atoms::big, atoms::blockquote, atoms::body, atoms::br, atoms::center, atoms::code,
+        atoms::dd, atoms::div, atoms::dl, atoms::dt, atoms::em, atoms::embed, atoms::h1, atoms::h2,
+        atoms::h3, atoms::h4, atoms::h5, atoms::h6, atoms::head, atoms::hr, atoms::i, atoms::html,
+        atoms::img, atoms::li, atoms::listing, atoms::menu, atoms::meta, atoms::nav, atoms::ol, atoms::p,
+        atoms::pre, atoms::ruby, atoms::section, atoms::small, atoms::span, atoms::strong, atoms::summary,
+        atoms::table, atoms::tbody, atoms::td, atoms::template_, atoms::tfoot, atoms::th, atoms::thead,
+        atoms::title, atoms::tr, atoms::ul
     };
 
     if (is_start_tag(token)) {
-        auto name_lower = std::get<TagToken>(token).name.to_lowercase();
-        for (const auto* html_tag : HTML_BREAKOUT) {
-            if (name_lower == String(html_tag)) {
+        auto name = std::get<TagToken>(token).name;
+        for (Atom html_tag : HTML_BREAKOUT) {
+            if (name == html_tag) {
                 return false;
             }
         }
@@ -1114,14 +1190,11 @@ bool TreeBuilder::process_foreign_content(const Token& token) {
         auto& tag = std::get<TagToken>(token);
         auto target = tag.name;
         static const String SVG_NS = "http://www.w3.org/2000/svg"_s;
-        static const String MATHML_NS = "http://www.w3.org/1998/Math/MathML"_s;
 
         auto* adjusted = adjusted_current_node();
         auto adjusted_ns = adjusted ? adjusted->namespace_uri() : String();
         if (adjusted_ns == SVG_NS) {
-            target = svg_camel_case(tag.name.to_lowercase());
-        } else if (adjusted_ns == MATHML_NS) {
-            target = tag.name.to_lowercase();
+            target = svg_camel_case(tag.name);
         }
 
         for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
@@ -1129,7 +1202,7 @@ bool TreeBuilder::process_foreign_content(const Token& token) {
             if (node->namespace_uri().empty()) {
                 break;
             }
-            if (node->local_name() == target) {
+            if (node->local_name_atom() == target) {
                 while (current_node() && current_node() != node) {
                     pop_current_element();
                 }
@@ -35,7 +35,7 @@ void TreeBuilder::process_in_body(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         parse_error("Unexpected html tag"_s);
         return;
     }
@@ -44,11 +44,11 @@ void TreeBuilder::process_in_body(const Token& token) {
         auto& tag = std::get<TagToken>(token);
 
         auto close_p = [&]() {
-            if (!stack_contains_in_button_scope("p"_s)) {
+            if (!stack_contains_in_button_scope(atoms::p)) {
                 return;
             }
-            generate_implied_end_tags("p"_s);
-            while (current_node() && current_node()->local_name() != "p"_s) {
+            generate_implied_end_tags(atoms::p);
+            while (current_node() && current_node()->local_name_atom() != atoms::p) {
                 pop_current_element();
             }
             if (current_node()) {
@@ -56,23 +56,23 @@ void TreeBuilder::process_in_body(const Token& token) {
             }
         };
 
-        if (tag.name == "base"_s || tag.name == "basefont"_s ||
-            tag.name == "bgsound"_s || tag.name == "link"_s ||
-            tag.name == "meta"_s || tag.name == "noframes"_s ||
-            tag.name == "script"_s || tag.name == "style"_s ||
-            tag.name == "template"_s || tag.name == "title"_s) {
+        if (tag.name == atoms::base || tag.name == atoms::basefont ||
+            tag.name == atoms::bgsound || tag.name == atoms::link ||
+            tag.name == atoms::meta || tag.name == atoms::noframes ||
+            tag.name == atoms::script || tag.name == atoms::style ||
+            tag.name == atoms::template_ || tag.name == atoms::title) {
             process_using_rules_for(InsertionMode::InHead, token);
             return;
         }
 
-        if (tag.name == "body"_s) {
+        if (tag.name == atoms::body) {
             parse_error("Unexpected body tag"_s);
             return;
         }
 
-        if (tag.name == "frameset"_s) {
+        if (tag.name == atoms::frameset) {
             parse_error("Unexpected frameset tag"_s);
-            if (!m_open_elements.empty() && m_open_elements[0]->local_name() == "html"_s) {
+            if (!m_open_elements.empty() && m_open_elements[0]->local_name_atom() == atoms::html) {
                 while (current_node()) {
                     pop_current_element();
                 }
@@ -83,19 +83,19 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "address"_s || tag.name == "article"_s ||
-            tag.name == "aside"_s || tag.name == "blockquote"_s ||
-            tag.name == "center"_s || tag.name == "details"_s ||
-            tag.name == "dialog"_s || tag.name == "dir"_s ||
-            tag.name == "div"_s || tag.name == "dl"_s ||
-            tag.name == "fieldset"_s || tag.name == "figcaption"_s ||
-            tag.name == "figure"_s || tag.name == "footer"_s ||
-            tag.name == "header"_s || tag.name == "hgroup"_s ||
-            tag.name == "main"_s || tag.name == "menu"_s ||
-            tag.name == "nav"_s || tag.name == "ol"_s ||
-            tag.name == "p"_s || tag.name == "section"_s ||
-            tag.name == "summary"_s || tag.name == "ul"_s) {
-            if (tag.name == "p"_s) {
+        if (tag.name == atoms::address || tag.name == atoms::article ||
+            tag.name == atoms::aside || tag.name == atoms::blockquote ||
+            tag.name == atoms::center || tag.name == atoms::details ||
+            tag.name == atoms::dialog || tag.name == atoms::dir ||
+            tag.name == atoms::div || tag.name == atoms::dl ||
+            tag.name == atoms::fieldset || tag.name == atoms::figcaption ||
+            tag.name == atoms::figure || tag.name == atoms::footer ||
+            tag.name == atoms::header || tag.name == atoms::hgroup ||
+            tag.name == atoms::main || tag.name == atoms::menu ||
+            tag.name == atoms::nav || tag.name == atoms::ol ||
+            tag.name == atoms::p || tag.name == atoms::section ||
+            tag.name == atoms::summary || tag.name == atoms::ul) {
+            if (tag.name == atoms::p) {
                 m_frameset_ok = false;
             }
             close_p();
@@ -104,16 +104,16 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "h1"_s || tag.name == "h2"_s ||
-            tag.name == "h3"_s || tag.name == "h4"_s ||
-            tag.name == "h5"_s || tag.name == "h6"_s) {
+        if (tag.name == atoms::h1 || tag.name == atoms::h2 ||
+            tag.name == atoms::h3 || tag.name == atoms::h4 ||
+            tag.name == atoms::h5 || tag.name == atoms::h6) {
             close_p();
             auto element = create_element_for_token(tag);
             insert_element(element);
             return;
         }
 
-        if (tag.name == "pre"_s || tag.name == "listing"_s) {
+        if (tag.name == atoms::pre || tag.name == atoms::listing) {
             close_p();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -121,73 +121,72 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "form"_s) {
-            if (m_form_element && !stack_contains("template"_s)) {
+        if (tag.name == atoms::form) {
+            if (m_form_element && !stack_contains(atoms::template_)) {
                 parse_error("Form already open"_s);
                 return;
             }
             close_p();
             auto element = create_element_for_token(tag);
             insert_element(element);
-            if (!stack_contains("template"_s)) {
+            if (!stack_contains(atoms::template_)) {
                 m_form_element = element.get();
             }
             resolve_pending_form_controls(element.get());
             return;
         }
 
-        if (tag.name == "isindex"_s) {
+        if (tag.name == atoms::isindex) {
             parse_error("isindex"_s);
-            if (m_form_element && !stack_contains("template"_s)) {
+            if (m_form_element && !stack_contains(atoms::template_)) {
                 if (tag.self_closing) acknowledge_self_closing_flag();
                 return;
             }
             close_p();
 
             TagToken form_token;
-            form_token.name = "form"_s;
+            form_token.name = atoms::form;
             auto form_element = create_element_for_token(form_token);
-            if (auto action = tag.get_attribute("action"_s)) {
+            if (auto action = tag.get_attribute(atoms::action)) {
                 form_element->set_attribute("action"_s, *action);
             }
             insert_element(form_element);
-            if (!stack_contains("template"_s)) {
+            if (!stack_contains(atoms::template_)) {
                 m_form_element = form_element.get();
             }
 
             TagToken hr_token;
-            hr_token.name = "hr"_s;
+            hr_token.name = atoms::hr;
             process_token(hr_token);
 
             TagToken label_token;
-            label_token.name = "label"_s;
+            label_token.name = atoms::label;
             process_token(label_token);
 
-            String prompt = tag.get_attribute("prompt"_s).value_or("This is a searchable index. Enter search keywords: "_s);
+            String prompt = tag.get_attribute(atoms::prompt).value_or("This is a searchable index. Enter search keywords: "_s);
             for (char c : prompt.view()) {
                 insert_character(static_cast<unicode::CodePoint>(c));
             }
 
             TagToken input_token;
-            input_token.name = "input"_s;
-            input_token.set_attribute("name"_s, "isindex"_s);
-            input_token.set_attribute("type"_s, "text"_s);
+            input_token.name = atoms::input;
+            input_token.set_attribute(atoms::name, "isindex"_s);
+            input_token.set_attribute(atoms::type, "text"_s);
             for (const auto& [name, value] : tag.attributes) {
-                auto lower = name.to_lowercase();
-                if (lower == "name"_s || lower == "prompt"_s || lower == "action"_s) continue;
+                if (name == atoms::name || name == atoms::prompt || name == atoms::action) continue;
                 input_token.set_attribute(name, value);
             }
             process_token(input_token);
 
-            if (current_node() && current_node()->local_name() == "label"_s) {
+            if (current_node() && current_node()->local_name_atom() == atoms::label) {
                 pop_current_element();
             }
 
             TagToken hr2_token;
-            hr2_token.name = "hr"_s;
+            hr2_token.name = atoms::hr;
             process_token(hr2_token);
 
-            while (current_node() && current_node()->local_name() != "form"_s) {
+            while (current_node() && current_node()->local_name_atom() != atoms::form) {
                 pop_current_element();
             }
             if (current_node()) {
@@ -198,11 +197,11 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "li"_s) {
+        if (tag.name == atoms::li) {
             m_frameset_ok = false;
-            if (stack_contains_in_list_item_scope("li"_s)) {
-                generate_implied_end_tags("li"_s);
-                while (current_node() && current_node()->local_name() != "li"_s) {
+            if (stack_contains_in_list_item_scope(atoms::li)) {
+                generate_implied_end_tags(atoms::li);
+                while (current_node() && current_node()->local_name_atom() != atoms::li) {
                     pop_current_element();
                 }
                 if (current_node()) {
@@ -214,11 +213,11 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "dd"_s || tag.name == "dt"_s) {
+        if (tag.name == atoms::dd || tag.name == atoms::dt) {
             m_frameset_ok = false;
-            if (stack_contains_in_scope("dd"_s) || stack_contains_in_scope("dt"_s)) {
-                while (current_node() && current_node()->local_name() != "dd"_s &&
-                       current_node()->local_name() != "dt"_s) {
+            if (stack_contains_in_scope(atoms::dd) || stack_contains_in_scope(atoms::dt)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::dd &&
+                       current_node()->local_name_atom() != atoms::dt) {
                     pop_current_element();
                 }
                 if (current_node()) {
@@ -230,15 +229,15 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "a"_s) {
+        if (tag.name == atoms::a) {
             for (auto it = m_active_formatting_elements.rbegin();
                  it != m_active_formatting_elements.rend(); ++it) {
                 if (it->type == ActiveFormattingElement::Type::Marker) {
                     break;
                 }
-                if (it->element && it->element->local_name() == "a"_s) {
+                if (it->element && it->element->local_name_atom() == atoms::a) {
                     parse_error("Nested <a> element"_s);
-                    adoption_agency_algorithm("a"_s);
+                    adoption_agency_algorithm(atoms::a);
                     remove_from_active_formatting(it->element.get());
                     remove_from_stack(it->element.get());
                     break;
@@ -251,10 +250,10 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "b"_s || tag.name == "big"_s || tag.name == "code"_s ||
-            tag.name == "em"_s || tag.name == "font"_s || tag.name == "i"_s ||
-            tag.name == "s"_s || tag.name == "small"_s || tag.name == "strike"_s ||
-            tag.name == "strong"_s || tag.name == "tt"_s || tag.name == "u"_s) {
+        if (tag.name == atoms::b || tag.name == atoms::big || tag.name == atoms::code ||
+            tag.name == atoms::em || tag.name == atoms::font || tag.name == atoms::i ||
+            tag.name == atoms::s || tag.name == atoms::small || tag.name == atoms::strike ||
+            tag.name == atoms::strong || tag.name == atoms::tt || tag.name == atoms::u) {
             reconstruct_active_formatting_elements();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -262,8 +261,8 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "area"_s || tag.name == "br"_s || tag.name == "embed"_s ||
-            tag.name == "img"_s || tag.name == "keygen"_s || tag.name == "wbr"_s) {
+        if (tag.name == atoms::area || tag.name == atoms::br || tag.name == atoms::embed ||
+            tag.name == atoms::img || tag.name == atoms::keygen || tag.name == atoms::wbr) {
             reconstruct_active_formatting_elements();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -273,12 +272,12 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "input"_s) {
+        if (tag.name == atoms::input) {
             reconstruct_active_formatting_elements();
             auto element = create_element_for_token(tag);
             insert_element(element);
             pop_current_element();
-            auto type_attr = tag.get_attribute("type"_s);
+            auto type_attr = tag.get_attribute(atoms::type);
             if (!type_attr || type_attr->to_lowercase() != "hidden"_s) {
                 m_frameset_ok = false;
             }
@@ -286,7 +285,7 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "hr"_s) {
+        if (tag.name == atoms::hr) {
             close_p();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -296,7 +295,7 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "select"_s) {
+        if (tag.name == atoms::select) {
             close_p();
             reconstruct_active_formatting_elements();
             auto element = create_element_for_token(tag);
@@ -313,7 +312,7 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "textarea"_s) {
+        if (tag.name == atoms::textarea) {
             close_p();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -326,7 +325,7 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "plaintext"_s) {
+        if (tag.name == atoms::plaintext) {
             close_p();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -339,10 +338,10 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "table"_s) {
+        if (tag.name == atoms::table) {
             if (m_document->quirks_mode() != dom::Document::QuirksMode::Quirks &&
-                stack_contains_in_button_scope("p"_s)) {
-                while (current_node() && current_node()->local_name() != "p"_s) {
+                stack_contains_in_button_scope(atoms::p)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::p) {
                     pop_current_element();
                 }
                 if (current_node()) {
@@ -369,13 +368,13 @@ void TreeBuilder::process_in_body(const Token& token) {
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
 
-        if (tag.name == "template"_s) {
+        if (tag.name == atoms::template_) {
             process_using_rules_for(InsertionMode::InHead, token);
             return;
         }
 
-        if (tag.name == "body"_s) {
-            if (!stack_contains_in_scope("body"_s)) {
+        if (tag.name == atoms::body) {
+            if (!stack_contains_in_scope(atoms::body)) {
                 parse_error("No body to close"_s);
                 return;
             }
@@ -383,8 +382,8 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "html"_s) {
-            if (!stack_contains_in_scope("body"_s)) {
+        if (tag.name == atoms::html) {
+            if (!stack_contains_in_scope(atoms::body)) {
                 parse_error("No body to close"_s);
                 return;
             }
@@ -393,25 +392,25 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "address"_s || tag.name == "article"_s ||
-            tag.name == "aside"_s || tag.name == "blockquote"_s ||
-            tag.name == "button"_s || tag.name == "center"_s ||
-            tag.name == "details"_s || tag.name == "dialog"_s ||
-            tag.name == "dir"_s || tag.name == "div"_s ||
-            tag.name == "dl"_s || tag.name == "fieldset"_s ||
-            tag.name == "figcaption"_s || tag.name == "figure"_s ||
-            tag.name == "footer"_s || tag.name == "header"_s ||
-            tag.name == "hgroup"_s || tag.name == "listing"_s ||
-            tag.name == "main"_s || tag.name == "menu"_s ||
-            tag.name == "nav"_s || tag.name == "ol"_s ||
-            tag.name == "pre"_s || tag.name == "section"_s ||
-            tag.name == "summary"_s || tag.name == "ul"_s) {
+        if (tag.name == atoms::address || tag.name == atoms::article ||
+            tag.name == atoms::aside || tag.name == atoms::blockquote ||
+            tag.name == atoms::button || tag.name == atoms::center ||
+            tag.name == atoms::details || tag.name == atoms::dialog ||
+            tag.name == atoms::dir || tag.name == atoms::div ||
+            tag.name == atoms::dl || tag.name == atoms::fieldset ||
+            tag.name == atoms::figcaption || tag.name == atoms::figure ||
+            tag.name == atoms::footer || tag.name == atoms::header ||
+            tag.name == atoms::hgroup || tag.name == atoms::listing ||
+            tag.name == atoms::main || tag.name == atoms::menu ||
+            tag.name == atoms::nav || tag.name == atoms::ol ||
+            tag.name == atoms::pre || tag.name == atoms::section ||
+            tag.name == atoms::summary || tag.name == atoms::ul) {
             if (!stack_contains_in_scope(tag.name)) {
                 parse_error("No matching tag in scope"_s);
                 return;
             }
             generate_implied_end_tags();
-            while (current_node() && current_node()->local_name() != tag.name) {
+            while (current_node() && current_node()->local_name_atom() != tag.name) {
                 pop_current_element();
             }
             if (current_node()) {
@@ -420,11 +419,11 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "form"_s) {
-            if (!stack_contains("template"_s)) {
+        if (tag.name == atoms::form) {
+            if (!stack_contains(atoms::template_)) {
                 auto* form = m_form_element;
                 m_form_element = nullptr;
-                if (!form || !stack_contains_in_scope("form"_s)) {
+                if (!form || !stack_contains_in_scope(atoms::form)) {
                     parse_error("No form to close"_s);
                     return;
                 }
@@ -434,33 +433,33 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "p"_s) {
-            if (!stack_contains_in_button_scope("p"_s)) {
+        if (tag.name == atoms::p) {
+            if (!stack_contains_in_button_scope(atoms::p)) {
                 parse_error("No p to close"_s);
                 auto p = m_document->create_element("p"_s);
                 insert_element(p);
             }
-            generate_implied_end_tags("p"_s);
-            if (!current_node() || current_node()->local_name() != "p"_s) {
+            generate_implied_end_tags(atoms::p);
+            if (!current_node() || current_node()->local_name_atom() != atoms::p) {
                 parse_error("Closing p but current node is different"_s);
             }
             while (current_node()) {
-                auto name = current_node()->local_name();
+                auto name = current_node()->local_name_atom();
                 pop_current_element();
-                if (name == "p"_s) {
+                if (name == atoms::p) {
                     break;
                 }
             }
             return;
         }
 
-        if (tag.name == "li"_s) {
-            if (!stack_contains_in_list_item_scope("li"_s)) {
+        if (tag.name == atoms::li) {
+            if (!stack_contains_in_list_item_scope(atoms::li)) {
                 parse_error("No li to close"_s);
                 return;
             }
-            generate_implied_end_tags("li"_s);
-            while (current_node() && current_node()->local_name() != "li"_s) {
+            generate_implied_end_tags(atoms::li);
+            while (current_node() && current_node()->local_name_atom() != atoms::li) {
                 pop_current_element();
             }
             if (current_node()) {
@@ -469,13 +468,13 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "dd"_s || tag.name == "dt"_s) {
+        if (tag.name == atoms::dd || tag.name == atoms::dt) {
             if (!stack_contains_in_scope(tag.name)) {
                 parse_error("No matching tag to close"_s);
                 return;
             }
             generate_implied_end_tags(tag.name);
-            while (current_node() && current_node()->local_name() != tag.name) {
+            while (current_node() && current_node()->local_name_atom() != tag.name) {
                 pop_current_element();
             }
             if (current_node()) {
@@ -484,52 +483,49 @@ void TreeBuilder::process_in_body(const Token& token) {
             return;
         }
 
-        if (tag.name == "h1"_s || tag.name == "h2"_s ||
-            tag.name == "h3"_s || tag.name == "h4"_s ||
-            tag.name == "h5"_s || tag.name == "h6"_s) {
-            if (!stack_contains_in_scope("h1"_s) &&
-                !stack_contains_in_scope("h2"_s) &&
-                !stack_contains_in_scope("h3"_s) &&
-                !stack_contains_in_scope("h4"_s) &&
-                !stack_contains_in_scope("h5"_s) &&
-                !stack_contains_in_scope("h6"_s)) {
+        if (tag.name == atoms::h1 || tag.name == atoms::h2 ||
+            tag.name == atoms::h3 || tag.name == atoms::h4 ||
+            tag.name == atoms::h5 || tag.name == atoms::h6) {
+            if (!stack_contains_in_scope(atoms::h1) &&
+                !stack_contains_in_scope(atoms::h2) &&
+                !stack_contains_in_scope(atoms::h3) &&
+                !stack_contains_in_scope(atoms::h4) &&
+                !stack_contains_in_scope(atoms::h5) &&
+                !stack_contains_in_scope(atoms::h6)) {
                 parse_error("No heading to close"_s);
                 return;
             }
             generate_implied_end_tags();
             while (current_node()) {
-                auto name = current_node()->local_name();
+                auto name = current_node()->local_name_atom();
                 pop_current_element();
-                if (name == "h1"_s || name == "h2"_s || name == "h3"_s ||
-                    name == "h4"_s || name == "h5"_s || name == "h6"_s) {
+                if (name == atoms::h1 || name == atoms::h2 || name == atoms::h3 ||
+                    name == atoms::h4 || name == atoms::h5 || name == atoms::h6) {
                     break;
                 }
             }
             return;
         }
 
-        if (tag.name == "a"_s || tag.name == "b"_s || tag.name == "big"_s ||
-            tag.name == "code"_s || tag.name == "em"_s || tag.name == "font"_s ||
-            tag.name == "i"_s || tag.name == "nobr"_s || tag.name == "s"_s ||
-            tag.name == "small"_s || tag.name == "strike"_s ||
-            tag.name == "strong"_s || tag.name == "tt"_s || tag.name == "u"_s) {
+        if (tag.name == atoms::a || tag.name == atoms::b || tag.name == atoms::big ||
+            tag.name == atoms::code || tag.name == atoms::em || tag.name == atoms::font ||
+            tag.name == atoms::i || tag.name == atoms::nobr || tag.name == atoms::s ||
+            tag.name == atoms::small || tag.name == atoms::strike ||
+            tag.name == atoms::strong || tag.name == atoms::tt || tag.name == atoms::u) {
             adoption_agency_algorithm(tag.name);
             return;
         }
 
         static const String SVG_NS = "http://www.w3.org/2000/svg"_s;
-        static const String MATHML_NS = "http://www.w3.org/1998/Math/MathML"_s;
 
         for (auto it = m_open_elements.rbegin(); it != m_open_elements.rend(); ++it) {
             auto* node = it->get();
             auto expected_name = tag.name;
             if (node->namespace_uri() == SVG_NS) {
-                expected_name = svg_camel_case(tag.name.to_lowercase());
-            } else if (node->namespace_uri() == MATHML_NS) {
-                expected_name = tag.name.to_lowercase();
+                expected_name = svg_camel_case(tag.name);
             }
 
-            if (node->local_name() == expected_name) {
+            if (node->local_name_atom() == expected_name) {
                 generate_implied_end_tags(expected_name);
                 while (current_node() != node) {
                     pop_current_element();
@@ -537,7 +533,7 @@ void TreeBuilder::process_in_body(const Token& token) {
                 pop_current_element();
                 return;
             }
-            if (is_special_element(node->local_name())) {
+            if (is_special_element(node->local_name_atom())) {
                 parse_error("Unexpected end tag"_s);
                 return;
             }
@@ -594,12 +590,12 @@ void TreeBuilder::process_after_body(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_end_tag_named(token, "html"_s)) {
+    if (is_end_tag_named(token, atoms::html)) {
         set_insertion_mode_if_allowed(InsertionMode::AfterAfterBody, "parser-cannot-change-mode"_s);
         return;
     }
@@ -633,7 +629,7 @@ void TreeBuilder::process_after_after_body(const Token& token) {
         }
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
@@ -211,7 +211,7 @@ void TreeBuilder::process_before_html(const Token& token) {
         }
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         auto& tag = std::get<TagToken>(token);
         auto element = create_element_for_token(tag);
         m_document->append_child(element);
@@ -222,8 +222,8 @@ void TreeBuilder::process_before_html(const Token& token) {
 
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name != "head"_s && tag.name != "body"_s &&
-            tag.name != "html"_s && tag.name != "br"_s) {
+        if (tag.name != atoms::head && tag.name != atoms::body &&
+            tag.name != atoms::html && tag.name != atoms::br) {
             parse_error("Unexpected end tag"_s);
             return;
         }
@@ -255,12 +255,12 @@ void TreeBuilder::process_before_head(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_start_tag_named(token, "head"_s)) {
+    if (is_start_tag_named(token, atoms::head)) {
         auto& tag = std::get<TagToken>(token);
         auto head = create_element_for_token(tag);
         insert_element(head);
@@ -271,8 +271,8 @@ void TreeBuilder::process_before_head(const Token& token) {
 
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name != "head"_s && tag.name != "body"_s &&
-            tag.name != "html"_s && tag.name != "br"_s) {
+        if (tag.name != atoms::head && tag.name != atoms::body &&
+            tag.name != atoms::html && tag.name != atoms::br) {
             parse_error("Unexpected end tag"_s);
             return;
         }
@@ -305,14 +305,14 @@ void TreeBuilder::process_in_head(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "template"_s) {
+        if (tag.name == atoms::template_) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             push_marker();
@@ -322,22 +322,22 @@ void TreeBuilder::process_in_head(const Token& token) {
             return;
         }
 
-        if (tag.name == "base"_s || tag.name == "basefont"_s ||
-            tag.name == "bgsound"_s || tag.name == "link"_s) {
+        if (tag.name == atoms::base || tag.name == atoms::basefont ||
+            tag.name == atoms::bgsound || tag.name == atoms::link) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             pop_current_element();
             return;
         }
 
-        if (tag.name == "meta"_s) {
+        if (tag.name == atoms::meta) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             pop_current_element();
             return;
         }
 
-        if (tag.name == "title"_s) {
+        if (tag.name == atoms::title) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             if (m_tokenizer) {
@@ -348,7 +348,7 @@ void TreeBuilder::process_in_head(const Token& token) {
             return;
         }
 
-        if (tag.name == "style"_s) {
+        if (tag.name == atoms::style) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             if (m_tokenizer) {
@@ -359,7 +359,7 @@ void TreeBuilder::process_in_head(const Token& token) {
             return;
         }
 
-        if (tag.name == "noscript"_s) {
+        if (tag.name == atoms::noscript) {
             if (m_scripting_enabled) {
                 auto element = create_element_for_token(tag);
                 insert_element(element);
@@ -376,7 +376,7 @@ void TreeBuilder::process_in_head(const Token& token) {
             return;
         }
 
-        if (tag.name == "script"_s) {
+        if (tag.name == atoms::script) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             if (m_tokenizer) {
@@ -387,24 +387,24 @@ void TreeBuilder::process_in_head(const Token& token) {
             return;
         }
 
-        if (tag.name == "head"_s) {
+        if (tag.name == atoms::head) {
             parse_error("Unexpected head tag"_s);
             return;
         }
     }
 
-    if (is_end_tag_named(token, "head"_s)) {
+    if (is_end_tag_named(token, atoms::head)) {
         pop_current_element();
         m_insertion_mode = InsertionMode::AfterHead;
         return;
     }
-    if (is_end_tag_named(token, "template"_s)) {
-        if (!stack_contains_in_scope("template"_s)) {
+    if (is_end_tag_named(token, atoms::template_)) {
+        if (!stack_contains_in_scope(atoms::template_)) {
             parse_error("No template to close"_s);
             return;
         }
         generate_implied_end_tags();
-        while (current_node() && current_node()->local_name() != "template"_s) {
+        while (current_node() && current_node()->local_name_atom() != atoms::template_) {
             pop_current_element();
         }
         if (current_node()) {
@@ -420,7 +420,7 @@ void TreeBuilder::process_in_head(const Token& token) {
 
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name != "body"_s && tag.name != "html"_s && tag.name != "br"_s) {
+        if (tag.name != atoms::body && tag.name != atoms::html && tag.name != atoms::br) {
             parse_error("Unexpected end tag"_s);
             return;
         }
@@ -449,12 +449,12 @@ void TreeBuilder::process_in_head_noscript(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_end_tag_named(token, "noscript"_s)) {
+    if (is_end_tag_named(token, atoms::noscript)) {
         pop_current_element();
         m_insertion_mode = InsertionMode::InHead;
         return;
@@ -462,13 +462,13 @@ void TreeBuilder::process_in_head_noscript(const Token& token) {
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "basefont"_s || tag.name == "bgsound"_s ||
-            tag.name == "link"_s || tag.name == "meta"_s || tag.name == "noframes"_s ||
-            tag.name == "style"_s) {
+        if (tag.name == atoms::basefont || tag.name == atoms::bgsound ||
+            tag.name == atoms::link || tag.name == atoms::meta || tag.name == atoms::noframes ||
+            tag.name == atoms::style) {
             process_using_rules_for(InsertionMode::InHead, token);
             return;
         }
-        if (tag.name == "head"_s || tag.name == "noscript"_s) {
+        if (tag.name == atoms::head || tag.name == atoms::noscript) {
             parse_error("Unexpected start tag in noscript head"_s);
             return;
         }
@@ -509,12 +509,12 @@ void TreeBuilder::process_after_head(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_start_tag_named(token, "body"_s)) {
+    if (is_start_tag_named(token, atoms::body)) {
         auto& tag = std::get<TagToken>(token);
         auto element = create_element_for_token(tag);
         insert_element(element);
@@ -523,7 +523,7 @@ void TreeBuilder::process_after_head(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "frameset"_s)) {
+    if (is_start_tag_named(token, atoms::frameset)) {
         auto& tag = std::get<TagToken>(token);
         auto element = create_element_for_token(tag);
         insert_element(element);
@@ -533,11 +533,11 @@ void TreeBuilder::process_after_head(const Token& token) {
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "base"_s || tag.name == "basefont"_s ||
-            tag.name == "bgsound"_s || tag.name == "link"_s ||
-            tag.name == "meta"_s || tag.name == "noframes"_s ||
-            tag.name == "script"_s || tag.name == "style"_s ||
-            tag.name == "template"_s || tag.name == "title"_s) {
+        if (tag.name == atoms::base || tag.name == atoms::basefont ||
+            tag.name == atoms::bgsound || tag.name == atoms::link ||
+            tag.name == atoms::meta || tag.name == atoms::noframes ||
+            tag.name == atoms::script || tag.name == atoms::style ||
+            tag.name == atoms::template_ || tag.name == atoms::title) {
             parse_error("Unexpected tag in after head"_s);
             push_open_element(RefPtr<dom::Element>(m_head_element));
             process_using_rules_for(InsertionMode::InHead, token);
@@ -545,7 +545,7 @@ void TreeBuilder::process_after_head(const Token& token) {
             return;
         }
 
-        if (tag.name == "head"_s) {
+        if (tag.name == atoms::head) {
             parse_error("Unexpected head tag"_s);
             return;
         }
@@ -553,11 +553,11 @@ void TreeBuilder::process_after_head(const Token& token) {
 
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "template"_s) {
+        if (tag.name == atoms::template_) {
             process_using_rules_for(InsertionMode::InHead, token);
             return;
         }
-        if (tag.name != "body"_s && tag.name != "html"_s && tag.name != "br"_s) {
+        if (tag.name != atoms::body && tag.name != atoms::html && tag.name != atoms::br) {
             parse_error("Unexpected end tag"_s);
             return;
         }
@@ -10,8 +10,8 @@ namespace lithium::html {
 void TreeBuilder::process_in_table(const Token& token) {
     auto clear_stack_back_to_table_context = [&] {
         while (current_node() &&
-               current_node()->local_name() != "table"_s &&
-               current_node()->local_name() != "html"_s) {
+               current_node()->local_name_atom() != atoms::table &&
+               current_node()->local_name_atom() != atoms::html) {
             pop_current_element();
         }
     };
@@ -21,8 +21,7 @@ void TreeBuilder::process_in_table(const Token& token) {
             parse_error("Unexpected null character in table"_s);
             return;
         }
-        m_pending_table_characters.clear();
-        m_pending_table_characters.push_back(character->code_point);
+        m_pending_table_characters = String::from_code_point(character->code_point);
         m_original_insertion_mode = m_insertion_mode;
         m_insertion_mode = InsertionMode::InTableText;
         return;
@@ -40,7 +39,7 @@ void TreeBuilder::process_in_table(const Token& token) {
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "caption"_s) {
+        if (tag.name == atoms::caption) {
             clear_stack_back_to_table_context();
             clear_active_formatting_to_last_marker();
             auto element = create_element_for_token(tag);
@@ -51,7 +50,7 @@ void TreeBuilder::process_in_table(const Token& token) {
             return;
         }
 
-        if (tag.name == "colgroup"_s) {
+        if (tag.name == atoms::colgroup) {
             clear_stack_back_to_table_context();
             auto element = create_element_for_token(tag);
             insert_element(element);
@@ -60,9 +59,9 @@ void TreeBuilder::process_in_table(const Token& token) {
             return;
         }
 
-        if (tag.name == "col"_s) {
+        if (tag.name == atoms::col) {
             TagToken colgroup_token;
-            colgroup_token.name = "colgroup"_s;
+            colgroup_token.name = atoms::colgroup;
             colgroup_token.is_end_tag = false;
             process_token(colgroup_token);
             process_token(token);
@@ -70,14 +69,14 @@ void TreeBuilder::process_in_table(const Token& token) {
             return;
         }
 
-        if (tag.name == "tbody"_s || tag.name == "tfoot"_s || tag.name == "thead"_s) {
+        if (tag.name == atoms::tbody || tag.name == atoms::tfoot || tag.name == atoms::thead) {
             clear_stack_back_to_table_context();
             auto element = create_element_for_token(tag);
             insert_element(element);
             m_insertion_mode = InsertionMode::InTableBody;
             return;
         }
-        if (tag.name == "tr"_s) {
+        if (tag.name == atoms::tr) {
             auto tbody = m_document->create_element("tbody"_s);
             insert_element(tbody);
             m_insertion_mode = InsertionMode::InTableBody;
@@ -86,8 +85,8 @@ void TreeBuilder::process_in_table(const Token& token) {
         }
     }
 
-    if (is_end_tag_named(token, "table"_s)) {
-        while (current_node() && current_node()->local_name() != "table"_s) {
+    if (is_end_tag_named(token, atoms::table)) {
+        while (current_node() && current_node()->local_name_atom() != atoms::table) {
             pop_current_element();
         }
         if (current_node()) {
@@ -108,14 +107,14 @@ void TreeBuilder::process_in_table_text(const Token& token) {
             parse_error("Unexpected null character in table text"_s);
             return;
         }
-        m_pending_table_characters.push_back(character->code_point);
+        m_pending_table_characters.append(character->code_point);
         return;
     }
 
     bool previous_foster = m_foster_parenting;
     bool any_non_whitespace = false;
-    for (auto cp : m_pending_table_characters) {
-        if (!detail::is_ascii_whitespace(cp)) {
+    for (char c : m_pending_table_characters.view()) {
+        if (!detail::is_ascii_whitespace(static_cast<unsigned char>(c))) {
             any_non_whitespace = true;
             break;
         }
@@ -126,9 +125,7 @@ void TreeBuilder::process_in_table_text(const Token& token) {
         m_foster_parenting = true;
     }
 
-    for (auto cp : m_pending_table_characters) {
-        insert_character(cp);
-    }
+    insert_characters(m_pending_table_characters.view());
 
     m_pending_table_characters.clear();
     m_foster_parenting = previous_foster;
@@ -137,13 +134,13 @@ void TreeBuilder::process_in_table_text(const Token& token) {
 }
 
 void TreeBuilder::process_in_caption(const Token& token) {
-    if (is_end_tag_named(token, "caption"_s)) {
-        if (!stack_contains_in_table_scope("caption"_s)) {
+    if (is_end_tag_named(token, atoms::caption)) {
+        if (!stack_contains_in_table_scope(atoms::caption)) {
             parse_error("No caption to close in table scope"_s);
             return;
         }
         generate_implied_end_tags();
-        while (current_node() && current_node()->local_name() != "caption"_s) {
+        while (current_node() && current_node()->local_name_atom() != atoms::caption) {
             pop_current_element();
         }
         if (current_node()) {
@@ -156,13 +153,13 @@ void TreeBuilder::process_in_caption(const Token& token) {
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "table"_s || tag.name == "caption"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s ||
-            tag.name == "thead"_s || tag.name == "tr"_s ||
-            tag.name == "td"_s || tag.name == "th"_s) {
+        if (tag.name == atoms::table || tag.name == atoms::caption ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot ||
+            tag.name == atoms::thead || tag.name == atoms::tr ||
+            tag.name == atoms::td || tag.name == atoms::th) {
             parse_error("Unexpected table tag inside caption"_s);
-            if (stack_contains_in_table_scope("caption"_s)) {
-                while (current_node() && current_node()->local_name() != "caption"_s) {
+            if (stack_contains_in_table_scope(atoms::caption)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::caption) {
                     pop_current_element();
                 }
                 if (current_node()) {
@@ -178,10 +175,10 @@ void TreeBuilder::process_in_caption(const Token& token) {
 
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "body"_s || tag.name == "col"_s ||
-            tag.name == "colgroup"_s || tag.name == "html"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s ||
-            tag.name == "thead"_s || tag.name == "tr"_s) {
+        if (tag.name == atoms::body || tag.name == atoms::col ||
+            tag.name == atoms::colgroup || tag.name == atoms::html ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot ||
+            tag.name == atoms::thead || tag.name == atoms::tr) {
             parse_error("Ignoring end tag in caption context"_s);
             return;
         }
@@ -197,7 +194,7 @@ void TreeBuilder::process_in_column_group(const Token& token) {
             return;
         }
         parse_error("Non-whitespace character in colgroup"_s);
-        if (current_node() && current_node()->local_name() == "colgroup"_s) {
+        if (current_node() && current_node()->local_name_atom() == atoms::colgroup) {
             pop_current_element();
             m_insertion_mode = InsertionMode::InTable;
             process_token(token);
@@ -215,12 +212,12 @@ void TreeBuilder::process_in_column_group(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_start_tag_named(token, "col"_s)) {
+    if (is_start_tag_named(token, atoms::col)) {
         auto& tag = std::get<TagToken>(token);
         auto element = create_element_for_token(tag);
         insert_element(element);
@@ -228,8 +225,8 @@ void TreeBuilder::process_in_column_group(const Token& token) {
         return;
     }
 
-    if (is_end_tag_named(token, "colgroup"_s)) {
-        if (current_node() && current_node()->local_name() == "colgroup"_s) {
+    if (is_end_tag_named(token, atoms::colgroup)) {
+        if (current_node() && current_node()->local_name_atom() == atoms::colgroup) {
             pop_current_element();
             m_insertion_mode = InsertionMode::InTable;
         } else {
@@ -244,7 +241,7 @@ void TreeBuilder::process_in_column_group(const Token& token) {
     }
 
     parse_error("Unexpected token in colgroup"_s);
-    if (current_node() && current_node()->local_name() == "colgroup"_s) {
+    if (current_node() && current_node()->local_name_atom() == atoms::colgroup) {
         pop_current_element();
         m_insertion_mode = InsertionMode::InTable;
         process_token(token);
@@ -252,7 +249,7 @@ void TreeBuilder::process_in_column_group(const Token& token) {
 }
 
 void TreeBuilder::process_in_table_body(const Token& token) {
-    if (is_start_tag_named(token, "tr"_s)) {
+    if (is_start_tag_named(token, atoms::tr)) {
         auto& tag = std::get<TagToken>(token);
         auto element = create_element_for_token(tag);
         insert_element(element);
@@ -261,23 +258,23 @@ void TreeBuilder::process_in_table_body(const Token& token) {
     }
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "th"_s || tag.name == "td"_s) {
+        if (tag.name == atoms::th || tag.name == atoms::td) {
             auto tr = m_document->create_element("tr"_s);
             insert_element(tr);
             m_insertion_mode = InsertionMode::InRow;
             process_token(token);
             return;
         }
-        if (tag.name == "tbody"_s || tag.name == "tfoot"_s || tag.name == "thead"_s) {
-            if (!stack_contains_in_table_scope("tbody"_s) &&
-                !stack_contains_in_table_scope("thead"_s) &&
-                !stack_contains_in_table_scope("tfoot"_s)) {
+        if (tag.name == atoms::tbody || tag.name == atoms::tfoot || tag.name == atoms::thead) {
+            if (!stack_contains_in_table_scope(atoms::tbody) &&
+                !stack_contains_in_table_scope(atoms::thead) &&
+                !stack_contains_in_table_scope(atoms::tfoot)) {
                 parse_error("No table section to close"_s);
                 return;
             }
-            while (current_node() && current_node()->local_name() != "tbody"_s &&
-                   current_node()->local_name() != "thead"_s &&
-                   current_node()->local_name() != "tfoot"_s) {
+            while (current_node() && current_node()->local_name_atom() != atoms::tbody &&
+                   current_node()->local_name_atom() != atoms::thead &&
+                   current_node()->local_name_atom() != atoms::tfoot) {
                 pop_current_element();
             }
             if (current_node()) pop_current_element();
@@ -288,13 +285,13 @@ void TreeBuilder::process_in_table_body(const Token& token) {
     }
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "tbody"_s || tag.name == "tfoot"_s ||
-            tag.name == "thead"_s) {
+        if (tag.name == atoms::tbody || tag.name == atoms::tfoot ||
+            tag.name == atoms::thead) {
             if (!stack_contains_in_table_scope(tag.name)) {
                 parse_error("No table section to close"_s);
                 return;
             }
-            while (current_node() && current_node()->local_name() != tag.name) {
+            while (current_node() && current_node()->local_name_atom() != tag.name) {
                 pop_current_element();
             }
             if (current_node()) {
@@ -303,14 +300,14 @@ void TreeBuilder::process_in_table_body(const Token& token) {
             m_insertion_mode = InsertionMode::InTable;
             return;
         }
-        if (tag.name == "table"_s) {
-            if (!stack_contains_in_table_scope("tbody"_s) &&
-                !stack_contains_in_table_scope("thead"_s) &&
-                !stack_contains_in_table_scope("tfoot"_s)) {
+        if (tag.name == atoms::table) {
+            if (!stack_contains_in_table_scope(atoms::tbody) &&
+                !stack_contains_in_table_scope(atoms::thead) &&
+                !stack_contains_in_table_scope(atoms::tfoot)) {
                 parse_error("No table section to close"_s);
                 return;
             }
-            while (current_node() && current_node()->local_name() != "table"_s) {
+            while (current_node() && current_node()->local_name_atom() != atoms::table) {
                 pop_current_element();
             }
             m_insertion_mode = InsertionMode::InTable;
@@ -324,17 +321,17 @@ void TreeBuilder::process_in_table_body(const Token& token) {
 void TreeBuilder::process_in_row(const Token& token) {
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "th"_s || tag.name == "td"_s) {
+        if (tag.name == atoms::th || tag.name == atoms::td) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             m_insertion_mode = InsertionMode::InCell;
             push_marker();
             return;
         }
-        if (tag.name == "caption"_s || tag.name == "col"_s || tag.name == "colgroup"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s || tag.name == "thead"_s ||
-            tag.name == "tr"_s || tag.name == "table"_s) {
-            if (!stack_contains_in_table_scope("tr"_s)) {
+        if (tag.name == atoms::caption || tag.name == atoms::col || tag.name == atoms::colgroup ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot || tag.name == atoms::thead ||
+            tag.name == atoms::tr || tag.name == atoms::table) {
+            if (!stack_contains_in_table_scope(atoms::tr)) {
                 parse_error("No tr to close"_s);
                 return;
             }
@@ -344,8 +341,8 @@ void TreeBuilder::process_in_row(const Token& token) {
             return;
         }
     }
-    if (is_end_tag_named(token, "tr"_s)) {
-        if (!stack_contains_in_table_scope("tr"_s)) {
+    if (is_end_tag_named(token, atoms::tr)) {
+        if (!stack_contains_in_table_scope(atoms::tr)) {
             parse_error("No tr to close"_s);
             return;
         }
@@ -357,9 +354,9 @@ void TreeBuilder::process_in_row(const Token& token) {
     }
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "table"_s || tag.name == "tbody"_s ||
-            tag.name == "tfoot"_s || tag.name == "thead"_s) {
-            if (!stack_contains_in_table_scope("tr"_s)) {
+        if (tag.name == atoms::table || tag.name == atoms::tbody ||
+            tag.name == atoms::tfoot || tag.name == atoms::thead) {
+            if (!stack_contains_in_table_scope(atoms::tr)) {
                 parse_error("No tr to close"_s);
                 return;
             }
@@ -375,16 +372,16 @@ void TreeBuilder::process_in_row(const Token& token) {
 void TreeBuilder::process_in_cell(const Token& token) {
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "caption"_s || tag.name == "col"_s || tag.name == "colgroup"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s || tag.name == "thead"_s ||
-            tag.name == "td"_s || tag.name == "th"_s || tag.name == "tr"_s || tag.name == "table"_s) {
-            if (!stack_contains_in_table_scope("td"_s) &&
-                !stack_contains_in_table_scope("th"_s)) {
+        if (tag.name == atoms::caption || tag.name == atoms::col || tag.name == atoms::colgroup ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot || tag.name == atoms::thead ||
+            tag.name == atoms::td || tag.name == atoms::th || tag.name == atoms::tr || tag.name == atoms::table) {
+            if (!stack_contains_in_table_scope(atoms::td) &&
+                !stack_contains_in_table_scope(atoms::th)) {
                 parse_error("No cell to close"_s);
                 return;
             }
-            while (current_node() && current_node()->local_name() != "td"_s &&
-                   current_node()->local_name() != "th"_s) {
+            while (current_node() && current_node()->local_name_atom() != atoms::td &&
+                   current_node()->local_name_atom() != atoms::th) {
                 pop_current_element();
             }
             if (current_node()) pop_current_element();
@@ -396,13 +393,13 @@ void TreeBuilder::process_in_cell(const Token& token) {
     }
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "td"_s || tag.name == "th"_s) {
+        if (tag.name == atoms::td || tag.name == atoms::th) {
             if (!stack_contains_in_table_scope(tag.name)) {
                 parse_error("No cell to close"_s);
                 return;
             }
             generate_implied_end_tags();
-            while (current_node() && current_node()->local_name() != tag.name) {
+            while (current_node() && current_node()->local_name_atom() != tag.name) {
                 pop_current_element();
             }
             if (current_node()) pop_current_element();
@@ -410,16 +407,16 @@ void TreeBuilder::process_in_cell(const Token& token) {
             m_insertion_mode = InsertionMode::InRow;
             return;
         }
-        if (tag.name == "table"_s || tag.name == "tbody"_s ||
-            tag.name == "tfoot"_s || tag.name == "thead"_s ||
-            tag.name == "tr"_s) {
-            if (!stack_contains_in_table_scope("td"_s) &&
-                !stack_contains_in_table_scope("th"_s)) {
+        if (tag.name == atoms::table || tag.name == atoms::tbody ||
+            tag.name == atoms::tfoot || tag.name == atoms::thead ||
+            tag.name == atoms::tr) {
+            if (!stack_contains_in_table_scope(atoms::td) &&
+                !stack_contains_in_table_scope(atoms::th)) {
                 parse_error("No cell to close"_s);
                 return;
             }
-            while (current_node() && current_node()->local_name() != "td"_s &&
-                   current_node()->local_name() != "th"_s) {
+            while (current_node() && current_node()->local_name_atom() != atoms::td &&
+                   current_node()->local_name_atom() != atoms::th) {
                 pop_current_element();
             }
             if (current_node()) pop_current_element();
@@ -454,12 +451,12 @@ void TreeBuilder::process_in_select(const Token& token) {
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "html"_s) {
+        if (tag.name == atoms::html) {
             process_using_rules_for(InsertionMode::InBody, token);
             return;
         }
-        if (tag.name == "option"_s) {
-            if (current_node() && current_node()->local_name() == "option"_s) {
+        if (tag.name == atoms::option) {
+            if (current_node() && current_node()->local_name_atom() == atoms::option) {
                 pop_current_element();
             }
             auto element = create_element_for_token(tag);
@@ -467,11 +464,11 @@ void TreeBuilder::process_in_select(const Token& token) {
             if (tag.self_closing) acknowledge_self_closing_flag();
             return;
         }
-        if (tag.name == "optgroup"_s) {
-            if (current_node() && current_node()->local_name() == "option"_s) {
+        if (tag.name == atoms::optgroup) {
+            if (current_node() && current_node()->local_name_atom() == atoms::option) {
                 pop_current_element();
             }
-            if (current_node() && current_node()->local_name() == "optgroup"_s) {
+            if (current_node() && current_node()->local_name_atom() == atoms::optgroup) {
                 pop_current_element();
             }
             auto element = create_element_for_token(tag);
@@ -479,20 +476,20 @@ void TreeBuilder::process_in_select(const Token& token) {
             if (tag.self_closing) acknowledge_self_closing_flag();
             return;
         }
-        if (tag.name == "select"_s) {
+        if (tag.name == atoms::select) {
             parse_error("Nested select"_s);
             while (current_node()) {
-                auto name = current_node()->local_name();
+                auto name = current_node()->local_name_atom();
                 pop_current_element();
-                if (name == "select"_s) break;
+                if (name == atoms::select) break;
             }
             reset_insertion_mode_appropriately();
             return;
         }
-        if (tag.name == "input"_s || tag.name == "keygen"_s || tag.name == "textarea"_s) {
+        if (tag.name == atoms::input || tag.name == atoms::keygen || tag.name == atoms::textarea) {
             parse_error("Form control inside select"_s);
-            if (stack_contains("select"_s)) {
-                while (current_node() && current_node()->local_name() != "select"_s) {
+            if (stack_contains(atoms::select)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::select) {
                     pop_current_element();
                 }
                 if (current_node()) {
@@ -503,7 +500,7 @@ void TreeBuilder::process_in_select(const Token& token) {
             }
             return;
         }
-        if (tag.name == "script"_s || tag.name == "template"_s) {
+        if (tag.name == atoms::script || tag.name == atoms::template_) {
             process_using_rules_for(InsertionMode::InHead, token);
             return;
         }
@@ -513,30 +510,30 @@ void TreeBuilder::process_in_select(const Token& token) {
 
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "optgroup"_s) {
-            if (current_node() && current_node()->local_name() == "option"_s &&
+        if (tag.name == atoms::optgroup) {
+            if (current_node() && current_node()->local_name_atom() == atoms::option &&
                 current_node()->parent_node() && current_node()->parent_node()->is_element() &&
-                current_node()->parent_node()->as_element()->local_name() == "optgroup"_s) {
+                current_node()->parent_node()->as_element()->local_name_atom() == atoms::optgroup) {
                 pop_current_element();
             }
-            if (current_node() && current_node()->local_name() == "optgroup"_s) {
+            if (current_node() && current_node()->local_name_atom() == atoms::optgroup) {
                 pop_current_element();
                 return;
             }
             parse_error("No optgroup to close"_s);
             return;
         }
-        if (tag.name == "option"_s) {
-            if (current_node() && current_node()->local_name() == "option"_s) {
+        if (tag.name == atoms::option) {
+            if (current_node() && current_node()->local_name_atom() == atoms::option) {
                 pop_current_element();
                 return;
             }
             parse_error("No option to close"_s);
             return;
         }
-        if (tag.name == "select"_s) {
-            if (stack_contains("select"_s)) {
-                while (current_node() && current_node()->local_name() != "select"_s) {
+        if (tag.name == atoms::select) {
+            if (stack_contains(atoms::select)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::select) {
                     pop_current_element();
                 }
                 if (current_node()) {
@@ -548,7 +545,7 @@ void TreeBuilder::process_in_select(const Token& token) {
             }
             return;
         }
-        if (tag.name == "template"_s) {
+        if (tag.name == atoms::template_) {
             process_using_rules_for(InsertionMode::InHead, token);
             reset_insertion_mode_appropriately();
             return;
@@ -563,13 +560,13 @@ void TreeBuilder::process_in_select(const Token& token) {
 void TreeBuilder::process_in_select_in_table(const Token& token) {
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "caption"_s || tag.name == "table"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s ||
-            tag.name == "thead"_s || tag.name == "tr"_s ||
-            tag.name == "td"_s || tag.name == "th"_s) {
+        if (tag.name == atoms::caption || tag.name == atoms::table ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot ||
+            tag.name == atoms::thead || tag.name == atoms::tr ||
+            tag.name == atoms::td || tag.name == atoms::th) {
             parse_error("Table element inside select"_s);
-            if (stack_contains("select"_s)) {
-                while (current_node() && current_node()->local_name() != "select"_s) {
+            if (stack_contains(atoms::select)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::select) {
                     pop_current_element();
                 }
                 if (current_node()) pop_current_element();
@@ -581,13 +578,13 @@ void TreeBuilder::process_in_select_in_table(const Token& token) {
     }
     if (is_end_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "caption"_s || tag.name == "table"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s ||
-            tag.name == "thead"_s || tag.name == "tr"_s ||
-            tag.name == "td"_s || tag.name == "th"_s) {
+        if (tag.name == atoms::caption || tag.name == atoms::table ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot ||
+            tag.name == atoms::thead || tag.name == atoms::tr ||
+            tag.name == atoms::td || tag.name == atoms::th) {
             parse_error("Table end tag inside select"_s);
-            if (stack_contains("select"_s)) {
-                while (current_node() && current_node()->local_name() != "select"_s) {
+            if (stack_contains(atoms::select)) {
+                while (current_node() && current_node()->local_name_atom() != atoms::select) {
                     pop_current_element();
                 }
                 if (current_node()) pop_current_element();
@@ -611,18 +608,18 @@ void TreeBuilder::process_in_template(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "template"_s)) {
+    if (is_start_tag_named(token, atoms::template_)) {
         process_using_rules_for(InsertionMode::InHead, token);
         return;
     }
 
-    if (is_end_tag_named(token, "template"_s)) {
-        if (!stack_contains("template"_s)) {
+    if (is_end_tag_named(token, atoms::template_)) {
+        if (!stack_contains(atoms::template_)) {
             parse_error("No template to close"_s);
             return;
         }
         generate_implied_end_tags();
-        while (current_node() && current_node()->local_name() != "template"_s) {
+        while (current_node() && current_node()->local_name_atom() != atoms::template_) {
             pop_current_element();
         }
         if (current_node()) {
@@ -638,16 +635,16 @@ void TreeBuilder::process_in_template(const Token& token) {
 
     if (is_start_tag(token)) {
         auto& tag = std::get<TagToken>(token);
-        if (tag.name == "base"_s || tag.name == "basefont"_s ||
-            tag.name == "bgsound"_s || tag.name == "link"_s ||
-            tag.name == "meta"_s || tag.name == "noframes"_s ||
-            tag.name == "script"_s || tag.name == "style"_s ||
-            tag.name == "title"_s) {
+        if (tag.name == atoms::base || tag.name == atoms::basefont ||
+            tag.name == atoms::bgsound || tag.name == atoms::link ||
+            tag.name == atoms::meta || tag.name == atoms::noframes ||
+            tag.name == atoms::script || tag.name == atoms::style ||
+            tag.name == atoms::title) {
             process_using_rules_for(InsertionMode::InHead, token);
             return;
         }
 
-        if (tag.name == "select"_s) {
+        if (tag.name == atoms::select) {
             auto element = create_element_for_token(tag);
             insert_element(element);
             if (!m_template_insertion_modes.empty()) {
@@ -657,9 +654,9 @@ void TreeBuilder::process_in_template(const Token& token) {
             return;
         }
 
-        if (tag.name == "caption"_s || tag.name == "colgroup"_s ||
-            tag.name == "tbody"_s || tag.name == "tfoot"_s ||
-            tag.name == "thead"_s || tag.name == "table"_s) {
+        if (tag.name == atoms::caption || tag.name == atoms::colgroup ||
+            tag.name == atoms::tbody || tag.name == atoms::tfoot ||
+            tag.name == atoms::thead || tag.name == atoms::table) {
             if (!m_template_insertion_modes.empty()) {
                 m_template_insertion_modes.top() = InsertionMode::InTable;
             }
@@ -668,7 +665,7 @@ void TreeBuilder::process_in_template(const Token& token) {
             return;
         }
 
-        if (tag.name == "tr"_s) {
+        if (tag.name == atoms::tr) {
             if (!m_template_insertion_modes.empty()) {
                 m_template_insertion_modes.top() = InsertionMode::InTableBody;
             }
@@ -677,7 +674,7 @@ void TreeBuilder::process_in_template(const Token& token) {
             return;
         }
 
-        if (tag.name == "td"_s || tag.name == "th"_s) {
+        if (tag.name == atoms::td || tag.name == atoms::th) {
             if (!m_template_insertion_modes.empty()) {
                 m_template_insertion_modes.top() = InsertionMode::InRow;
             }
@@ -715,19 +712,19 @@ void TreeBuilder::process_in_frameset(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_start_tag_named(token, "frameset"_s)) {
+    if (is_start_tag_named(token, atoms::frameset)) {
         auto& tag = std::get<TagToken>(token);
         auto element = create_element_for_token(tag);
         insert_element(element);
         return;
     }
 
-    if (is_start_tag_named(token, "frame"_s)) {
+    if (is_start_tag_named(token, atoms::frame)) {
         auto element = create_element_for_token(std::get<TagToken>(token));
         insert_element(element);
         pop_current_element();
@@ -735,18 +732,18 @@ void TreeBuilder::process_in_frameset(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "noframes"_s)) {
+    if (is_start_tag_named(token, atoms::noframes)) {
         process_using_rules_for(InsertionMode::InHead, token);
         return;
     }
 
-    if (is_end_tag_named(token, "frameset"_s)) {
-        if (!current_node() || current_node()->local_name() != "frameset"_s) {
+    if (is_end_tag_named(token, atoms::frameset)) {
+        if (!current_node() || current_node()->local_name_atom() != atoms::frameset) {
             parse_error("No frameset to close"_s);
             return;
         }
         pop_current_element();
-        if (!current_node() || current_node()->local_name() != "frameset"_s) {
+        if (!current_node() || current_node()->local_name_atom() != atoms::frameset) {
             m_insertion_mode = InsertionMode::AfterFrameset;
         }
         return;
@@ -777,17 +774,17 @@ void TreeBuilder::process_after_frameset(const Token& token) {
         return;
     }
 
-    if (is_start_tag_named(token, "html"_s)) {
+    if (is_start_tag_named(token, atoms::html)) {
         process_using_rules_for(InsertionMode::InBody, token);
         return;
     }
 
-    if (is_end_tag_named(token, "html"_s)) {
+    if (is_end_tag_named(token, atoms::html)) {
         set_insertion_mode_if_allowed(InsertionMode::AfterAfterFrameset, "parser-cannot-change-mode"_s);
         return;
     }
 
-    if (is_start_tag_named(token, "noframes"_s)) {
+    if (is_start_tag_named(token, atoms::noframes)) {
         process_using_rules_for(InsertionMode::InHead, token);
         return;
     }
@@ -3,6 +3,7 @@
 #include "lithium/core/string.hpp"
 #include "lithium/core/types.hpp"
 #include "lithium/js/value.hpp"
+#include "lithium/js/inline_cache.hpp"
 #include <memory>
 #include <optional>
 #include <unordered_map>
@@ -33,6 +34,10 @@ enum class OpCode : u8 {
     SetVar,         // u16 name_idx
     GetLocal,       // u16 slot_idx
     SetLocal,       // u16 slot_idx
+    GetScoped,      // u8 depth, u16 slot_idx (local of an enclosing function)
+    SetScoped,      // u8 depth, u16 slot_idx
+    GetGlobal,      // u16 name_idx, u16 cell_cache_slot
+    SetGlobal,      // u16 name_idx, u16 cell_cache_slot
 
     // Property access (slow path, no IC)
     GetProp,        // u16 name_idx
@@ -105,6 +110,16 @@ enum class OpCode : u8 {
     OpCode_COUNT
 };
 
+// ============================================================================
+// Binding - a named variable; bindings of the global environment double as
+// property cells that GetGlobal/SetGlobal sites cache by address
+// ============================================================================
+
+struct Binding {
+    Value value;
+    bool is_const{false};
+};
+
 // ============================================================================
 // Debug Information - Bytecode location tracking
 // ============================================================================
@@ -216,9 +231,6 @@ private:
 // Function & Module
 // ============================================================================
 
-// Forward declaration for IC
-struct InlineCacheEntry;
-
 struct FunctionCode {
     String name;
     std::vector<String> params;
@@ -227,12 +239,25 @@ struct FunctionCode {
     // Inline cache slots for this function
     u16 ic_slot_count{0};
 
+    // Feedback vector: one inline cache per slot, shared by every invocation
+    // (and every closure) of this function so caches stay warm across calls
+    std::vector<InlineCacheEntry> feedback;
+
+    // Global access sites: each remembers the global cell its name resolved to
+    u16 global_slot_count{0};
+    std::vector<Binding*> global_cells;
+
     // Local slots for parameters and variable declarations
     u16 local_count{0};
     std::vector<String> local_names;
     std::vector<bool> local_is_const;
     std::unordered_map<String, u16> local_slots;
 
+    // False when no nested closure can observe the locals (decided by the
+    // compiler); calls then keep the locals in a register window on the VM
+    // stack instead of allocating an Environment
+    bool needs_environment{true};
+
     std::optional<u16> resolve_local(const String& name) const {
         auto it = local_slots.find(name);
         if (it == local_slots.end()) {
@@ -259,6 +284,25 @@ struct FunctionCode {
 
     // Allocate a new IC slot and return its index
     u16 alloc_ic_slot() { return ic_slot_count++; }
+
+    // Feedback vector sized for every IC slot; allocated on first use only
+    InlineCacheEntry* feedback_vector() {
+        if (feedback.size() < ic_slot_count) {
+            feedback.resize(ic_slot_count);
+        }
+        return feedback.data();
+    }
+
+    // Allocate a global cell cache slot and return its index
+    u16 alloc_global_slot() { return global_slot_count++; }
+
+    // Cell cache sized for every global access site
+    Binding** global_cell_cache() {
+        if (global_cells.size() < global_slot_count) {
+            global_cells.resize(global_slot_count, nullptr);
+        }
+        return global_cells.data();
+    }
 };
 
 struct ModuleBytecode {
@@ -1,52 +1,211 @@
 #pragma once
 
 #include "lithium/core/types.hpp"
-#include <vector>
+#include <array>
 #include <memory>
-#include <functional>
+#include <new>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace lithium::js {
 
 class Object;
 class Value;
 class VM;
+class GarbageCollector;
+struct HeapBlock;
 
 // ============================================================================
-// Garbage Collector - Mark and Sweep
+// Traceable - anything that holds Values the collector must scan
 // ============================================================================
+//
+// Objects and VM environments both derive from this. The collector keeps its
+// per-cell bookkeeping (generation, remembered-set membership) here so the
+// write barrier can treat either kind of holder uniformly.
+
+class Traceable {
+public:
+    virtual ~Traceable();
+
+    // Mark every Value / Object reachable from this holder
+    virtual void trace(GarbageCollector& gc) = 0;
+
+    // Allocated by a GarbageCollector (as opposed to make_shared / new by native code)
+    [[nodiscard]] bool is_managed() const { return (m_gc_flags & GC_MANAGED) != 0; }
+    // Allocated since the last collection (only meaningful for managed cells)
+    [[nodiscard]] bool is_young() const { return (m_gc_flags & GC_YOUNG) != 0; }
+    // Currently recorded in a remembered set / external holder set
+    [[nodiscard]] bool is_remembered() const { return (m_gc_flags & GC_REMEMBERED) != 0; }
+
+protected:
+    Traceable() = default;
+    // GC bookkeeping belongs to the storage, never to the value being copied
+    Traceable(const Traceable&) {}
+    Traceable& operator=(const Traceable&) { return *this; }
+
+private:
+    friend class GarbageCollector;
+
+    static constexpr u8 GC_MANAGED    = 1 << 0;
+    static constexpr u8 GC_YOUNG      = 1 << 1;
+    static constexpr u8 GC_REMEMBERED = 1 << 2;
+
+    u8 m_gc_flags{0};
+    u32 m_gc_epoch{0};                          // Last cycle that visited this holder
+    GarbageCollector* m_remembered_in{nullptr}; // Set that must forget us on destruction
+};
+
+// ============================================================================
+// Garbage Collector - generational mark and sweep over a size-classed heap
+// ============================================================================
+//
+// Heap layout:
+// - Objects live in 64 KiB HeapBlocks. Each block serves one size class and
+//   carves its payload into equal cells, handed out by bumping a cursor
+//   (fresh cells) or by popping the block's free list (recycled cells).
+// - Objects larger than the biggest size class get a dedicated block.
+//
+// Generations (non-moving, "sticky mark bits"):
+// - Young: allocated since the last collection. Once the nursery budget is
+//   used up a minor collection runs.
+// - Old: survived a collection. Promotion happens in place by clearing the
+//   young bit; objects never move because Values and native code hold raw
+//   pointers to them.
+//
+// Minor collections only trace young objects. Their roots are the VM roots
+// plus the remembered set: old objects and captured environments that had a
+// young object stored into them since the last collection, as recorded by the
+// write barrier. Major collections trace and sweep the whole heap.
+//
+// Objects created outside the heap by native code (e.g. DOM wrappers made
+// with make_shared) are owned by that code. Once they store a reference to a
+// heap object they are scanned as roots by every collection until destroyed.
+//
+// Incremental marking (tri-color):
+// - When enabled, a major collection starts by marking the roots gray and
+//   then drains the gray stack in slices of at most the configured budget,
+//   interleaved with bytecode execution. A slice runs each time the mutator
+//   has allocated another mark step worth of bytes.
+// - While marking, the write barrier shades every object stored into any
+//   holder (Dijkstra insertion barrier) and new objects are allocated gray,
+//   so no black object can end up pointing at a white one.
+// - Once the gray stack is empty the roots are re-scanned (stack slots and
+//   frame environments are not barriered) and marking is finished. Minor
+//   collections are postponed until then.
+//
+// Lazy sweeping:
+// - After marking, size-classed blocks are only queued for sweeping. A block
+//   is swept (dead cells finalized and put on its free list) right before the
+//   allocator hands out cells from it, or by small sweep steps taken at GC
+//   checks. Large objects are swept eagerly.
+// - Mark bits stay set on live objects until their block is swept. Minor
+//   collections only trace young objects, and all young objects live in
+//   swept blocks, so they never see those bits.
+// - Pending sweeping is completed before the next major cycle starts.
+// - There is no sweeper thread: finalizers release interned strings, and the
+//   intern pool belongs to the mutator thread.
 
 class GarbageCollector {
     friend class VM;  // VM needs access to mark_roots()
 
 public:
+    // Pause times bucketed by powers of two: bucket 0 holds pauses below
+    // 2us, bucket i (i > 0) holds pauses in [2^i, 2^(i+1)) microseconds.
+    struct PauseHistogram {
+        static constexpr usize BUCKET_COUNT = 24;
+
+        std::array<usize, BUCKET_COUNT> buckets{};
+        usize pauses{0};
+        u64 total_us{0};
+        u64 max_us{0};
+
+        void record(u64 micros);
+        [[nodiscard]] static u64 bucket_lower_bound(usize index) { return index == 0 ? 0 : u64{1} << index; }
+    };
+
+    struct CollectionStats {
+        usize collections{0};
+        usize objects_freed{0};
+        usize bytes_freed{0};
+        usize bytes_promoted{0};  // Minor collections only
+        usize mark_slices{0};     // Major collections only (incremental marking)
+        usize sweep_steps{0};     // Major collections only (lazy sweeping)
+        PauseHistogram pauses;    // Every mutator pause spent in this kind of collection
+    };
+
     GarbageCollector();
     ~GarbageCollector();
 
+    GarbageCollector(const GarbageCollector&) = delete;
+    GarbageCollector& operator=(const GarbageCollector&) = delete;
+
     // Configuration
     void set_heap_grow_factor(f64 factor) { m_heap_grow_factor = factor; }
     void set_initial_threshold(usize bytes) { m_next_gc = bytes; }
+    void set_nursery_size(usize bytes) { m_nursery_size = bytes; }
+    void set_incremental_marking(bool enabled) { m_incremental_marking = enabled; }
+    // Upper bound on the time one incremental marking slice may take
+    void set_mark_slice_budget_us(u64 micros) { m_slice_budget_us = micros; }
+    // Bytes the mutator allocates between two marking slices
+    void set_mark_step_bytes(usize bytes) { m_mark_step_bytes = bytes; }
+    // Sweep major-cycle garbage on demand instead of at the end of marking
+    void set_lazy_sweeping(bool enabled) { m_lazy_sweeping = enabled; }
 
     // GC stats
-    [[nodiscard]] usize bytes_allocated() const { return m_bytes_allocated; }
-    [[nodiscard]] usize total_objects() const { return m_objects.size(); }
-    [[nodiscard]] usize gc_count() const { return m_gc_count; }
+    [[nodiscard]] usize bytes_allocated() const {
+        return m_young_bytes + m_old_bytes + m_external_bytes + m_bytes_awaiting_sweep;
+    }
+    // Cell bytes of dead objects whose blocks have not been swept yet
+    [[nodiscard]] usize bytes_awaiting_sweep() const { return m_bytes_awaiting_sweep; }
+    [[nodiscard]] bool is_sweeping() const { return m_sweep_cursor < m_unswept_blocks.size(); }
+    [[nodiscard]] usize young_bytes() const { return m_young_bytes; }
+    [[nodiscard]] usize old_bytes() const { return m_old_bytes + m_external_bytes; }
+    [[nodiscard]] usize total_objects() const { return m_object_count; }
+    [[nodiscard]] usize gc_count() const { return m_minor_stats.collections + m_major_stats.collections; }
+    [[nodiscard]] usize minor_gc_count() const { return m_minor_stats.collections; }
+    [[nodiscard]] usize major_gc_count() const { return m_major_stats.collections; }
+    [[nodiscard]] const CollectionStats& minor_stats() const { return m_minor_stats; }
+    [[nodiscard]] const CollectionStats& major_stats() const { return m_major_stats; }
+    [[nodiscard]] usize heap_block_count() const;
+    [[nodiscard]] bool is_marking() const { return m_marking; }
+    [[nodiscard]] bool incremental_marking() const { return m_incremental_marking; }
+    [[nodiscard]] u64 mark_slice_budget_us() const { return m_slice_budget_us; }
 
-    // Object tracking
+    // Allocate a managed object. The heap owns the returned object; it stays
+    // alive for as long as it is reachable from the VM roots.
     template<typename T, typename... Args>
-    std::shared_ptr<T> allocate(Args&&... args) {
-        auto obj = std::make_shared<T>(std::forward<Args>(args)...);
-        track(obj);
+    T* allocate(Args&&... args) {
+        static_assert(std::is_base_of_v<Object, T>, "GC heap only holds js::Object subclasses");
+        void* cell = allocate_cell(sizeof(T));
+        T* obj = nullptr;
+        try {
+            obj = new (cell) T(std::forward<Args>(args)...);
+        } catch (...) {
+            release_cell(cell);
+            throw;
+        }
+        adopt(obj, cell);
         return obj;
     }
 
-    void track(std::shared_ptr<Object> obj);
-
-    // Manual GC trigger
+    // Manual GC trigger: full collection including sweeping (finishes an
+    // in-progress marking cycle)
     void collect(VM& vm);
 
+    // Young-generation collection (finishes the major cycle instead while marking)
+    void collect_minor(VM& vm);
+
+    // Run whichever collection the current heap state calls for (if any)
+    void collect_if_needed(VM& vm);
+
     // Check if GC should run
     [[nodiscard]] bool should_collect() const {
-        return m_stress_gc || m_bytes_allocated > m_next_gc;
+        if (m_marking) {
+            return m_stress_gc || needs_mark_slice();
+        }
+        return m_stress_gc || needs_minor() || needs_major() || is_sweeping();
     }
 
     // Stress testing (GC on every allocation)
@@ -62,31 +221,132 @@ public:
     // Mark phase - public so Object::trace() can use them
     void mark_value(const Value& value);
     void mark_object(Object* obj);
+    // Visit a non-object holder (environment) at most once per collection
+    void mark_holder(Traceable* holder);
+
+    // Weak containers register during trace and prune dead keys after marking
+    void defer_weak_processing(Object* container) { m_weak_containers.push_back(container); }
+    // Liveness query for weak processing
+    [[nodiscard]] bool is_live(const Object* obj) const;
+
+    // Write barrier slow path: `holder` just received a reference to `target`
+    static void record_write(Traceable& holder, const Traceable& target);
+    // Write barrier for non-object holders (captured environments)
+    static void write_barrier(Traceable& holder, const Value& value);
+    // Insertion barrier while incremental marking is running anywhere
+    [[nodiscard]] static bool marking_barrier_active() { return s_active_markers != 0; }
+    static void shade(const Object& target);
+
+    // Holder destruction hook (see Traceable::~Traceable)
+    void forget(Traceable* holder);
 
 private:
+    struct SizeClass {
+        usize cell_size{0};
+        std::vector<HeapBlock*> blocks;
+        usize alloc_index{0};  // First block that may still have free cells
+    };
+
+    [[nodiscard]] bool needs_minor() const { return m_young_bytes >= m_nursery_size; }
+    [[nodiscard]] bool needs_major() const { return m_old_bytes + m_external_bytes > m_next_gc; }
+    [[nodiscard]] bool needs_mark_slice() const { return m_young_bytes >= m_slice_alloc_mark + m_mark_step_bytes; }
+
+    // Allocation
+    void* allocate_cell(usize size);
+    void* allocate_large(usize size);
+    void release_cell(void* cell);
+    void adopt(Object* obj, void* cell);
+    [[nodiscard]] static HeapBlock* block_of(const void* cell);
+    [[nodiscard]] static usize cell_size_of(const Object* obj);
+    void free_object(Object* obj);
+
+    // Remembered set / external holders
+    void remember(Traceable& holder);
+    void retain_external_holder(Traceable& holder);
+    void clear_remembered_set();
+
     // Mark phase - internal methods
+    void begin_cycle(bool minor);
     void mark_roots(VM& vm);
     void trace_references();
+    void process_weak_containers();
+    void end_cycle();
+
+    // Incremental marking
+    void start_marking(VM& vm);
+    void mark_slice(VM& vm);
+    void finish_marking(VM& vm);
+    bool drain_gray_stack(u64 budget_us);
+    void finish_major();
+
+    // Lazy sweeping
+    void sweep_block(HeapBlock* block);
+    void sweep_step();
+    void finish_sweeping();
 
     // Sweep phase
-    void sweep();
+    void sweep_young();
+    void sweep_large_objects();
+    void release_empty_blocks();
+
+    // Size classes (index by 16-byte granule)
+    std::vector<SizeClass> m_size_classes;
+    std::vector<u8> m_class_for_granule;
+    std::vector<HeapBlock*> m_large_blocks;
+
+    // Objects allocated since the last collection
+    std::vector<Object*> m_young_objects;
+
+    // Blocks holding mark bits from the last major cycle, swept in order
+    std::vector<HeapBlock*> m_unswept_blocks;
+    usize m_sweep_cursor{0};
 
-    // All managed objects
-    std::vector<std::shared_ptr<Object>> m_objects;
+    // Old / unmanaged holders that received young references since the last GC
+    std::unordered_set<Traceable*> m_remembered;
+    // Unmanaged holders referencing heap objects (scanned as roots)
+    std::unordered_set<Traceable*> m_external_holders;
 
     // Gray stack for mark phase
     std::vector<Object*> m_gray_stack;
 
+    // Unmanaged objects marked this cycle (unmarked again in end_cycle)
+    std::vector<Object*> m_marked_unmanaged;
+    std::vector<Object*> m_weak_containers;
+
     // Temporary roots
     std::vector<const Value*> m_roots;
 
     // Memory tracking
-    usize m_bytes_allocated{0};
-    usize m_next_gc{1024 * 1024};  // 1MB initial threshold
+    usize m_young_bytes{0};       // Cell bytes allocated since the last collection
+    usize m_old_bytes{0};         // Cell bytes of promoted objects
+    usize m_external_bytes{0};    // Out-of-line storage (slots, elements, ...) as of the last visit
+    usize m_bytes_awaiting_sweep{0};
+    usize m_marked_bytes{0};      // Cell bytes marked by the current major cycle
+    usize m_marked_external{0};   // Out-of-line bytes of those objects
+    usize m_object_count{0};
+    usize m_nursery_size{1024 * 1024};  // 1MB nursery
+    usize m_next_gc{4 * 1024 * 1024};   // 4MB initial old-generation threshold
     f64 m_heap_grow_factor{2.0};
 
+    // Cycle state
+    u32 m_epoch{0};
+    bool m_minor_cycle{false};
+    bool m_tearing_down{false};
+
+    // Incremental marking state
+    bool m_incremental_marking{true};
+    bool m_marking{false};
+    u64 m_slice_budget_us{1000};
+    usize m_mark_step_bytes{256 * 1024};
+    usize m_slice_alloc_mark{0};          // m_young_bytes when the last slice ran
+    bool m_lazy_sweeping{true};
+
+    // Collectors currently marking incrementally (gates the insertion barrier)
+    static u32 s_active_markers;
+
     // Stats
-    usize m_gc_count{0};
+    CollectionStats m_minor_stats;
+    CollectionStats m_major_stats;
 
     // Debug flags
     bool m_stress_gc{false};
@@ -115,7 +375,10 @@ private:
     GarbageCollector& m_gc;
 };
 
+#define LITHIUM_GC_CONCAT_IMPL(a, b) a##b
+#define LITHIUM_GC_CONCAT(a, b) LITHIUM_GC_CONCAT_IMPL(a, b)
+
 #define GC_ROOT(gc, value) \
-    ::lithium::js::GCRootGuard _gc_root_##__LINE__(gc, &(value))
+    ::lithium::js::GCRootGuard LITHIUM_GC_CONCAT(_gc_root_, __LINE__)(gc, &(value))
 
 } // namespace lithium::js
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "lithium/core/string.hpp"
+#include "lithium/js/diagnostic.hpp"
+#include "lithium/js/shape.hpp"
+#include "lithium/js/value.hpp"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lithium::js {
+
+class GarbageCollector;
+class Object;
+
+// Outcome of a JSON operation: a value, or the error to throw
+struct JsonResult {
+    Value value;
+    String error;
+    ErrorType error_type{ErrorType::None};
+
+    [[nodiscard]] bool ok() const { return error.empty(); }
+};
+
+// Nesting limit for the recursive walks (stringify, reviver); deeper
+// structures fail with a RangeError instead of overflowing the native stack
+inline constexpr usize JSON_MAX_DEPTH = 4096;
+
+// Calls a JS function (replacer, reviver, toJSON) on behalf of JSON code
+using JsonInvoker = std::function<Value(const Value& function, const Value& this_value, const std::vector<Value>& args)>;
+
+// ============================================================================
+// JsonParser - JSON.parse
+// ============================================================================
+//
+// A single pass over the text with an explicit container stack (no
+// recursion, so nesting depth is bounded only by memory). Plain strings are
+// sliced straight out of the input, and object keys without escapes are
+// shared through a key cache. Objects are built with their complete Shape:
+// every shape remembers the last key that was added to it during the parse,
+// so arrays of records with the same key set take the cached transition
+// instead of a property lookup per key.
+
+class JsonParser {
+public:
+    JsonParser(GarbageCollector& gc, Object* object_prototype, Object* array_prototype);
+
+    [[nodiscard]] JsonResult parse(std::string_view text);
+
+    // JSON.parse reviver walk (InternalizeJSONProperty) over a parsed value
+    [[nodiscard]] JsonResult revive(const Value& root, const Value& reviver, const JsonInvoker& invoke);
+
+private:
+    struct Transition {
+        ShapePtr from;  // Keeps the map key alive so its address is never reused
+        String key;
+        ShapePtr to;
+    };
+
+    struct Container;
+
+    // Contents of the string literal at m_pos: a slice of the input, or of
+    // m_scratch when it had escapes (valid until the next string)
+    [[nodiscard]] bool parse_string(std::string_view& out);
+    [[nodiscard]] bool parse_number(Value& out);
+    [[nodiscard]] bool parse_literal(std::string_view word);
+    bool fail(const char* message);  // Records the first error; always false
+    void skip_whitespace();
+
+    [[nodiscard]] bool parse_key(String& out);
+    [[nodiscard]] Value finish_object(Container& container);
+    void add_property(Container& container, const String& key, Value value);
+    [[nodiscard]] Value internalize(Object* holder, const String& key, const Value& reviver,
+                                    const JsonInvoker& invoke, usize depth);
+
+    GarbageCollector& m_gc;
+    Object* m_object_prototype;
+    Object* m_array_prototype;
+
+    std::string_view m_text;
+    usize m_pos{0};
+    String m_error;
+
+    std::unordered_map<std::string_view, String> m_keys;            // Unescaped keys seen so far
+    std::unordered_map<const Shape*, Transition> m_transitions;     // Last key added to each shape
+    std::string m_scratch;                                          // Escaped string decoding
+};
+
+// ============================================================================
+// JsonStringifier - JSON.stringify
+// ============================================================================
+//
+// Writes the whole document into one growable buffer. Supports function
+// and array replacers, numeric or string indentation, toJSON methods, and
+// reports cyclic structures as an error instead of recursing forever.
+
+class JsonStringifier {
+public:
+    JsonStringifier(GarbageCollector& gc, Object* object_prototype, JsonInvoker invoke);
+
+    void set_replacer(const Value& replacer);
+    void set_space(const Value& space);
+
+    // Result is a string, or undefined when the value has no JSON form
+    [[nodiscard]] JsonResult stringify(const Value& value);
+
+private:
+    // Appends the serialization of holder[key], where key is `name` or, for
+    // array elements, `index`; false when the value has no JSON form
+    [[nodiscard]] bool serialize_property(const Value& holder, const String* name, u32 index, Value value);
+    void serialize_object(Object* object);
+    void serialize_array(Object* array);
+    void newline_and_indent();
+    // Pushes a container onto the cycle-check stack; false (with the error set) if it cannot be entered
+    [[nodiscard]] bool enter(const Object* container);
+
+    GarbageCollector& m_gc;
+    Object* m_object_prototype;
+    JsonInvoker m_invoke;
+    Value m_replacer_function;
+    std::vector<String> m_property_list;
+    bool m_has_property_list{false};
+    std::string m_gap;
+    std::string m_indent;
+    std::string m_out;
+    std::vector<const Object*> m_stack;  // Containers being serialized (cycle check)
+
+    // Enumeration order of each shape seen, so plain objects skip name lookups
+    struct ShapeKeys {
+        ShapePtr shape;
+        std::vector<String> names;
+    };
+    std::unordered_map<const Shape*, ShapeKeys> m_shape_keys;
+    String m_error;
+    ErrorType m_error_type{ErrorType::None};
+};
+
+// Appends a JSON string literal for `str` to `out`
+void json_quote(std::string& out, std::string_view str);
+
+// Appends the ECMAScript Number::toString form of a finite number
+void json_append_number(std::string& out, f64 number);
+
+} // namespace lithium::js
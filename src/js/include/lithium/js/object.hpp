@@ -2,6 +2,9 @@
 
 #include "value.hpp"
 #include "shape.hpp"
+#include "gc.hpp"
+#include "inline_cache.hpp"
+#include "ordered_hash_table.hpp"
 #include <functional>
 #include <unordered_map>
 #include <unordered_set>
@@ -11,68 +14,14 @@ namespace lithium::js {
 class VM;
 class BoundFunction;
 
-// ============================================================================
-// Polymorphic Inline Cache Entry - cached property access for multiple shapes
-// ============================================================================
-//
-// Caches up to 4 different shapes at each property access site.
-// This handles the common case where a property is accessed on objects
-// with 2-4 different shapes (e.g., in polymorphic code).
-//
-// Benefits over monomorphic IC:
-// - Handles polymorphic code without constant cache invalidation
-// - Still O(1) lookup for up to 4 shapes
-// - Falls back to slow path only for megamorphic sites (>4 shapes)
-
-struct InlineCacheEntry {
-    static constexpr u32 MAX_SHAPES = 4;
-
-    struct ShapeSlot {
-        u32 shape_id{0};
-        i32 slot{-1};
-
-        [[nodiscard]] bool is_valid() const { return slot >= 0; }
-        void clear() { shape_id = 0; slot = -1; }
-    };
-
-    ShapeSlot shapes[MAX_SHAPES];
-    u8 next_slot{0};      // Round-robin index for adding new shapes
-    bool valid{false};    // Is any entry valid?
-
-    // Find cached slot for a shape, returns -1 if not found
-    [[nodiscard]] i32 find_slot(u32 shape_id) const {
-        for (u32 i = 0; i < MAX_SHAPES; ++i) {
-            if (shapes[i].shape_id == shape_id && shapes[i].slot >= 0) {
-                return shapes[i].slot;
-            }
-        }
-        return -1;
-    }
-
-    // Add a new shape->slot mapping (round-robin replacement)
-    void add_shape(u32 shape_id, i32 slot) {
-        shapes[next_slot] = {shape_id, slot};
-        next_slot = static_cast<u8>((next_slot + 1) % MAX_SHAPES);
-        valid = true;
-    }
-
-    void invalidate() {
-        for (auto& s : shapes) {
-            s.clear();
-        }
-        next_slot = 0;
-        valid = false;
-    }
-};
-
 // ============================================================================
 // Object - Base class for all JS objects (with Shape-based property storage)
 // ============================================================================
 
-class Object {
+class Object : public Traceable {
 public:
     Object();
-    virtual ~Object() = default;
+    ~Object() override = default;
 
     // Property access (slow path - for compatibility)
     [[nodiscard]] virtual bool has_property(const String& name) const;
@@ -93,6 +42,10 @@ public:
     [[nodiscard]] u32 shape_id() const { return m_shape ? m_shape->id() : 0; }
     [[nodiscard]] ShapePtr shape() const { return m_shape; }
 
+    // Install a complete layout at once (slots.size() == shape->slot_count()),
+    // for builders that computed the final shape up front
+    void adopt_layout(ShapePtr shape, std::vector<Value> slots);
+
     // Element access (for arrays)
     [[nodiscard]] virtual bool has_element(u32 index) const;
     [[nodiscard]] virtual Value get_element(u32 index) const;
@@ -105,10 +58,16 @@ public:
 
     // Enumeration
     [[nodiscard]] virtual std::vector<String> own_property_names() const;
+    // True once a delete has moved properties out of the shape
+    [[nodiscard]] bool has_overflow_properties() const { return !m_overflow_properties.empty(); }
 
     // Prototype
-    [[nodiscard]] Object* prototype() const { return m_prototype.get(); }
-    void set_prototype(std::shared_ptr<Object> proto) { m_prototype = std::move(proto); }
+    [[nodiscard]] Object* prototype() const { return m_prototype; }
+    void set_prototype(Object* proto) {
+        m_prototype = proto;
+        write_barrier(proto);
+    }
+    void set_prototype(const std::shared_ptr<Object>& proto) { set_prototype(proto.get()); }
 
     // Type identification
     [[nodiscard]] virtual bool is_callable() const { return false; }
@@ -125,9 +84,37 @@ public:
 
     // Trace object references - must be called with GC instance
     // to properly mark nested objects and add them to gray stack
-    virtual void trace(class GarbageCollector& gc);
+    void trace(GarbageCollector& gc) override;
+
+    // Bytes of out-of-line storage owned by this object (slot vectors, maps, ...)
+    [[nodiscard]] virtual usize external_bytes() const;
+
+    // Weak containers drop entries whose keys died (see GarbageCollector::defer_weak_processing)
+    virtual void sweep_weak_references(GarbageCollector& gc) { (void)gc; }
 
 protected:
+    // Generational write barrier - call after storing a reference into this object
+    void write_barrier(const Value& value) {
+        if (value.is_object()) {
+            write_barrier(value.as_object());
+        }
+    }
+    void write_barrier(const Object* target) {
+        if (!target || !target->is_managed()) {
+            return;
+        }
+        if (GarbageCollector::marking_barrier_active() && !target->is_marked()) {
+            GarbageCollector::shade(*target);
+        }
+        if (is_remembered()) {
+            return;
+        }
+        if (is_managed() && (is_young() || !target->is_young())) {
+            return;
+        }
+        GarbageCollector::record_write(*this, *target);
+    }
+
     // Shape-based property storage
     ShapePtr m_shape;
     std::vector<Value> m_slots;  // Dense property value storage
@@ -135,7 +122,7 @@ protected:
     // Fallback for deleted/special properties
     std::unordered_map<String, Value> m_overflow_properties;
 
-    std::shared_ptr<Object> m_prototype;
+    Object* m_prototype{nullptr};
     bool m_marked{false};
     bool m_stack_allocated{false};
 };
@@ -211,6 +198,7 @@ public:
     void set_property(const String& name, const Value& value) override;
 
     void trace(GarbageCollector& gc) override;
+    [[nodiscard]] usize external_bytes() const override;
 
 private:
     std::vector<Value> m_elements;
@@ -254,20 +242,23 @@ public:
     void clear();
     [[nodiscard]] usize size() const { return m_entries.size(); }
 
-    // Iteration support - returns internal entries for JS iteration
-    [[nodiscard]] const std::vector<Entry>& internal_entries() const { return m_entries; }
+    // Iteration support - returns internal entries for JS iteration (insertion order)
+    [[nodiscard]] const std::vector<Entry>& internal_entries() const { return m_entries.entries(); }
 
     // Dynamic property support for 'size'
     [[nodiscard]] bool has_dynamic_property(const String& name) const override;
     [[nodiscard]] Value get_dynamic_property(const String& name) const override;
 
     void trace(GarbageCollector& gc) override;
+    [[nodiscard]] usize external_bytes() const override;
 
 private:
-    std::vector<Entry> m_entries;
+    struct KeyOf {
+        const Value& operator()(const Entry& entry) const { return entry.key; }
+    };
 
-    // Find entry index by key (using SameValueZero equality)
-    [[nodiscard]] std::optional<usize> find_entry(const Value& key) const;
+    // Keyed by SameValueZero
+    OrderedHashTable<Entry, KeyOf> m_entries;
 };
 
 // ============================================================================
@@ -285,20 +276,23 @@ public:
     void clear();
     [[nodiscard]] usize size() const { return m_values.size(); }
 
-    // Iteration support
-    [[nodiscard]] const std::vector<Value>& values() const { return m_values; }
+    // Iteration support (insertion order)
+    [[nodiscard]] const std::vector<Value>& values() const { return m_values.entries(); }
 
     // Dynamic property support for 'size'
     [[nodiscard]] bool has_dynamic_property(const String& name) const override;
     [[nodiscard]] Value get_dynamic_property(const String& name) const override;
 
     void trace(GarbageCollector& gc) override;
+    [[nodiscard]] usize external_bytes() const override;
 
 private:
-    std::vector<Value> m_values;
+    struct KeyOf {
+        const Value& operator()(const Value& value) const { return value; }
+    };
 
-    // Find value index (using SameValueZero equality)
-    [[nodiscard]] std::optional<usize> find_value(const Value& value) const;
+    // Keyed by SameValueZero
+    OrderedHashTable<Value, KeyOf> m_values;
 };
 
 // ============================================================================
@@ -316,6 +310,8 @@ public:
     bool remove(const Value& key);
 
     void trace(GarbageCollector& gc) override;
+    [[nodiscard]] usize external_bytes() const override;
+    void sweep_weak_references(GarbageCollector& gc) override;
 
 private:
     // Use raw pointers for keys (weak references)
@@ -336,6 +332,8 @@ public:
     bool remove(const Value& value);
 
     void trace(GarbageCollector& gc) override;
+    [[nodiscard]] usize external_bytes() const override;
+    void sweep_weak_references(GarbageCollector& gc) override;
 
 private:
     // Use raw pointers (weak references)
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "lithium/core/types.hpp"
+#include "lithium/js/value.hpp"
+#include <vector>
+
+namespace lithium::js {
+
+// SameValueZero (like === but NaN equals NaN) and a hash consistent with it:
+// numbers hash by value (int and double forms agree, -0 folds to +0, every
+// NaN is one key), strings by content, everything else by its NaN-boxed bits
+[[nodiscard]] bool same_value_zero(const Value& a, const Value& b);
+[[nodiscard]] u32 same_value_zero_hash(const Value& value);
+
+// ============================================================================
+// OrderedHashTable - deterministic insertion-ordered hash table
+// ============================================================================
+//
+// Entries live densely in insertion order; an open-addressed index of entry
+// positions (linear probing, load factor <= 1/2) finds them by key. Removal
+// leaves a tombstone in both arrays, and the table compacts once tombstones
+// outnumber live entries, so deletion stays amortized O(1). entries()
+// compacts on demand so callers always iterate live entries in order.
+
+template<typename Entry, typename KeyOf>
+class OrderedHashTable {
+public:
+    [[nodiscard]] Entry* find(const Value& key) {
+        u32 pos = lookup(key, hash_of(key));
+        return pos == NOT_FOUND ? nullptr : &m_entries[pos];
+    }
+
+    [[nodiscard]] const Entry* find(const Value& key) const {
+        u32 pos = lookup(key, hash_of(key));
+        return pos == NOT_FOUND ? nullptr : &m_entries[pos];
+    }
+
+    // Append an entry whose key is not present yet
+    void insert(Entry entry) {
+        if ((m_entries.size() + 1) * 2 > m_index.size()) {
+            rebuild(m_live + 1);
+        }
+        u32 hash = hash_of(KeyOf{}(entry));
+        u32 pos = static_cast<u32>(m_entries.size());
+        m_entries.push_back(std::move(entry));
+        m_hashes.push_back(hash);
+        place(hash, pos);
+        ++m_live;
+    }
+
+    bool remove(const Value& key) {
+        if (m_index.empty()) {
+            return false;
+        }
+        u32 hash = hash_of(key);
+        usize mask = m_index.size() - 1;
+        for (usize i = hash & mask;; i = (i + 1) & mask) {
+            u32 pos = m_index[i];
+            if (pos == EMPTY) {
+                return false;
+            }
+            if (pos != DELETED && m_hashes[pos] == hash && same_value_zero(KeyOf{}(m_entries[pos]), key)) {
+                m_index[i] = DELETED;
+                m_hashes[pos] = REMOVED;
+                m_entries[pos] = Entry{};
+                --m_live;
+                ++m_removed;
+                if (m_removed > 16 && m_removed > m_live) {
+                    rebuild(m_live);
+                }
+                return true;
+            }
+        }
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_hashes.clear();
+        m_index.clear();
+        m_live = 0;
+        m_removed = 0;
+    }
+
+    [[nodiscard]] usize size() const { return m_live; }
+
+    // Live entries in insertion order
+    [[nodiscard]] const std::vector<Entry>& entries() const {
+        if (m_removed > 0) {
+            const_cast<OrderedHashTable*>(this)->rebuild(m_live);
+        }
+        return m_entries;
+    }
+
+    // Every stored entry including tombstones (default-constructed), for tracing
+    template<typename Fn>
+    void for_each_slot(Fn&& fn) {
+        for (auto& entry : m_entries) {
+            fn(entry);
+        }
+    }
+
+    [[nodiscard]] usize external_bytes() const {
+        return m_entries.capacity() * sizeof(Entry) +
+               m_hashes.capacity() * sizeof(u32) +
+               m_index.capacity() * sizeof(u32);
+    }
+
+private:
+    static constexpr u32 EMPTY = 0xFFFFFFFFu;
+    static constexpr u32 DELETED = 0xFFFFFFFEu;
+    static constexpr u32 NOT_FOUND = EMPTY;
+    static constexpr u32 REMOVED = 0x80000000u;  // Hash of a tombstoned entry
+
+    // Stored hashes keep the top bit clear so they never look like REMOVED
+    [[nodiscard]] static u32 hash_of(const Value& key) {
+        return same_value_zero_hash(key) & 0x7FFFFFFFu;
+    }
+
+    [[nodiscard]] u32 lookup(const Value& key, u32 hash) const {
+        if (m_index.empty()) {
+            return NOT_FOUND;
+        }
+        usize mask = m_index.size() - 1;
+        for (usize i = hash & mask;; i = (i + 1) & mask) {
+            u32 pos = m_index[i];
+            if (pos == EMPTY) {
+                return NOT_FOUND;
+            }
+            if (pos != DELETED && m_hashes[pos] == hash && same_value_zero(KeyOf{}(m_entries[pos]), key)) {
+                return pos;
+            }
+        }
+    }
+
+    void place(u32 hash, u32 pos) {
+        usize mask = m_index.size() - 1;
+        usize i = hash & mask;
+        while (m_index[i] != EMPTY && m_index[i] != DELETED) {
+            i = (i + 1) & mask;
+        }
+        m_index[i] = pos;
+    }
+
+    // Drop tombstones (keeping order) and size the index for `live` entries
+    void rebuild(usize live) {
+        if (m_removed > 0) {
+            usize out = 0;
+            for (usize in = 0; in < m_entries.size(); ++in) {
+                if (m_hashes[in] == REMOVED) {
+                    continue;
+                }
+                if (out != in) {
+                    m_entries[out] = std::move(m_entries[in]);
+                    m_hashes[out] = m_hashes[in];
+                }
+                ++out;
+            }
+            m_entries.resize(out);
+            m_hashes.resize(out);
+            m_removed = 0;
+        }
+
+        usize capacity = 8;
+        while (capacity < live * 2) {
+            capacity *= 2;
+        }
+        m_index.assign(capacity, EMPTY);
+        for (usize pos = 0; pos < m_entries.size(); ++pos) {
+            place(m_hashes[pos], static_cast<u32>(pos));
+        }
+    }
+
+    std::vector<Entry> m_entries;  // Insertion order
+    std::vector<u32> m_hashes;     // Parallel to m_entries; REMOVED marks tombstones
+    std::vector<u32> m_index;      // Power-of-two open-addressed positions
+    usize m_live{0};
+    usize m_removed{0};
+};
+
+} // namespace lithium::js
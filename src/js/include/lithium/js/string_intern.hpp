@@ -17,6 +17,7 @@
 #include "lithium/core/types.hpp"
 #include <atomic>
 #include <mutex>
+#include <string_view>
 #include <unordered_set>
 
 namespace lithium::js {
@@ -30,18 +31,33 @@ struct InternedString {
     explicit InternedString(String&& s) : str(std::move(s)) {}
 };
 
-// Hash functor for InternedString pointers (hash by string content)
+// Hash functor for InternedString pointers (hash by string content).
+// Transparent, so the pool can be probed with a string_view without
+// building a temporary InternedString.
 struct InternedStringHash {
+    using is_transparent = void;
+
     size_t operator()(const InternedString* s) const {
-        return std::hash<std::string>{}(s->str.std_string());
+        return std::hash<std::string_view>{}(s->str.view());
+    }
+    size_t operator()(std::string_view s) const {
+        return std::hash<std::string_view>{}(s);
     }
 };
 
 // Equality functor for InternedString pointers (compare by string content)
 struct InternedStringEqual {
+    using is_transparent = void;
+
     bool operator()(const InternedString* a, const InternedString* b) const {
         return a->str == b->str;
     }
+    bool operator()(std::string_view a, const InternedString* b) const {
+        return a == b->str.view();
+    }
+    bool operator()(const InternedString* a, std::string_view b) const {
+        return a->str.view() == b;
+    }
 };
 
 /**
@@ -58,6 +74,7 @@ public:
     // Get or create an interned string
     // Returns a pointer that remains valid as long as ref_count > 0
     InternedString* intern(const String& str);
+    InternedString* intern(std::string_view str);
 
     // Increment reference count
     static void inc_ref(InternedString* s);
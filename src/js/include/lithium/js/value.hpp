@@ -235,6 +235,8 @@ public:
     static Value number(f64 n) { return Value(n); }
     static Value boolean(bool b) { return Value(b); }
     static Value string(const String& s) { return Value(s); }
+    // String value straight from a character range, without an intermediate String
+    static Value string_from(std::string_view s);
     static Value object(std::shared_ptr<Object> obj) { return Value(std::move(obj)); }
     static Value native_function(NativeFn fn, u8 arity = 0, const String& name = ""_s);
 
@@ -43,15 +43,12 @@ class GarbageCollector;
     [[nodiscard]] GarbageCollector& gc() { return m_gc; }
 
 private:
-    struct Binding {
-        Value value;
-        bool is_const{false};
-    };
+    using Binding = js::Binding;
 
 public:
-    class Environment {
+    class Environment : public Traceable {
     public:
-        explicit Environment(std::shared_ptr<Environment> parent = nullptr, std::shared_ptr<Object> global_object = nullptr);
+        explicit Environment(std::shared_ptr<Environment> parent = nullptr, Object* global_object = nullptr);
         Environment(std::shared_ptr<Environment> parent, Value with_object);
 
         void define(const String& name, Value value, bool is_const);
@@ -63,17 +60,31 @@ public:
 
         [[nodiscard]] std::shared_ptr<Environment> parent() const { return m_parent; }
         [[nodiscard]] bool is_with_env() const { return m_with_object.has_value(); }
-        [[nodiscard]] std::shared_ptr<Object> global_object() const { return m_global_object; }
+        [[nodiscard]] Object* global_object() const { return m_global_object; }
+
+        // Marks this environment and its parents as reachable from a closure
+        void mark_captured();
+        [[nodiscard]] bool is_captured() const { return m_captured; }
+
+        void trace(GarbageCollector& gc) override;
 
     private:
+        // Captured environments outlive their frame, so stores need the write barrier
+        void note_store(const Value& value) {
+            if (m_captured) {
+                GarbageCollector::write_barrier(*this, value);
+            }
+        }
+
         std::shared_ptr<Environment> m_parent;
         std::unordered_map<String, Binding> m_values;
         std::vector<Value> m_locals;
         std::vector<bool> m_local_is_const;
         std::shared_ptr<FunctionCode> m_function;
         std::optional<Value> m_with_object;
-        std::shared_ptr<Object> m_global_object;
+        Object* m_global_object{nullptr};
         bool m_is_global{false};
+        bool m_captured{false};
         friend class VM;
     };
 
@@ -81,18 +92,22 @@ public:
     struct CallFrame {
         std::shared_ptr<FunctionCode> function;
         std::shared_ptr<Environment> env;
-        std::shared_ptr<Environment> lexical_env;
+        std::shared_ptr<Environment> lexical_env;  // Null when locals live on the VM stack
         usize ip{0};
         usize stack_base{0};
         Value receiver;
 
-        // Inline cache for this function invocation
-        std::vector<InlineCacheEntry> ic_cache;
+        // Inline caches of the running function (its feedback vector)
+        InlineCacheEntry* ic_cache{nullptr};
+
+        // First VM stack slot owned by this frame: the register window for
+        // locals when lexical_env is null, otherwise equal to stack_base
+        usize locals_base{0};
 
-        // Initialize IC cache with proper size
+        // Point at the function's persistent feedback vector
         void init_ic_cache() {
             if (function && function->ic_slot_count > 0) {
-                ic_cache.resize(function->ic_slot_count);
+                ic_cache = function->feedback_vector();
             }
         }
     };
@@ -116,6 +131,10 @@ public:
     void handle_exception(const Value& thrown);
     void enter_with_env(const Value& object);
     void exit_with_env();
+    // Environment holding the locals of the function `depth` levels out
+    [[nodiscard]] Environment* scoped_environment(const CallFrame& frame, u8 depth) const;
+    // Global property cell for a name; stable for the lifetime of the VM
+    [[nodiscard]] Binding* global_cell(const String& name);
     [[nodiscard]] Value current_this() const;
 
     // Error handling
@@ -139,10 +158,12 @@ public:
     std::shared_ptr<Environment> m_global_env;
     std::vector<std::shared_ptr<Environment>> m_env_stack;
     std::vector<Value> m_this_stack;
-    std::shared_ptr<Object> m_global_object;
-    std::shared_ptr<Object> m_object_prototype;
-    std::shared_ptr<Object> m_function_prototype;
-    std::shared_ptr<Object> m_array_prototype;
+    Object* m_global_object{nullptr};
+    Object* m_object_prototype{nullptr};
+    Object* m_function_prototype{nullptr};
+    Object* m_array_prototype{nullptr};
+    // Built-in prototypes referenced from native closures (kept alive regardless of JS reachability)
+    std::vector<Object*> m_builtin_roots;
     DiagnosticSink m_diagnostics;
 
     Value m_last_value;
@@ -235,6 +235,256 @@ private:
     }
 };
 
+// ============================================================================
+// Capture Analysis - decides which functions need a heap Environment
+// ============================================================================
+//
+// A function's locals can live in a register window on the VM stack when no
+// nested closure can observe them. Every identifier mentioned inside a nested
+// function is treated as captured (shadowing is ignored, which only costs
+// precision), and `with` / `eval` force an environment because they resolve
+// names at runtime.
+
+class CaptureAnalyzer {
+public:
+    void analyze(const std::vector<StatementPtr>& body, const Expression* concise_body) {
+        m_captured.clear();
+        m_dynamic_scope = false;
+        m_depth = 0;
+        if (concise_body) {
+            visit_expression(*concise_body);
+        }
+        for (const auto& stmt : body) {
+            visit_statement(*stmt);
+        }
+    }
+
+    [[nodiscard]] bool needs_environment(const FunctionCode& fn) const {
+        if (m_dynamic_scope) {
+            return true;
+        }
+        for (const auto& name : fn.local_names) {
+            if (m_captured.count(name) > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // True when names must be resolved at runtime (with / eval)
+    [[nodiscard]] bool has_dynamic_scope() const { return m_dynamic_scope; }
+
+private:
+    std::unordered_set<String> m_captured;  // Names referenced from nested functions
+    bool m_dynamic_scope{false};            // with / eval in this function
+    int m_depth{0};                         // Nested function depth
+
+    void note_identifier(const String& name) {
+        if (m_depth > 0) {
+            m_captured.insert(name);
+        }
+        if (name == "eval"_s) {
+            m_dynamic_scope = true;
+        }
+    }
+
+    void visit_function(const std::vector<StatementPtr>& body, const Expression* concise_body) {
+        ++m_depth;
+        if (concise_body) {
+            visit_expression(*concise_body);
+        }
+        for (const auto& stmt : body) {
+            visit_statement(*stmt);
+        }
+        --m_depth;
+    }
+
+    void visit_statement(const Statement& stmt) {
+        if (auto* expr_stmt = dynamic_cast<const ExpressionStatement*>(&stmt)) {
+            visit_expression(*expr_stmt->expression);
+            return;
+        }
+        if (auto* block = dynamic_cast<const BlockStatement*>(&stmt)) {
+            for (const auto& s : block->body) {
+                visit_statement(*s);
+            }
+            return;
+        }
+        if (auto* decl = dynamic_cast<const VariableDeclaration*>(&stmt)) {
+            for (const auto& var : decl->declarations) {
+                if (var.init) {
+                    visit_expression(*var.init);
+                }
+            }
+            return;
+        }
+        if (auto* fn_decl = dynamic_cast<const FunctionDeclaration*>(&stmt)) {
+            visit_function(fn_decl->body, nullptr);
+            return;
+        }
+        if (auto* ret = dynamic_cast<const ReturnStatement*>(&stmt)) {
+            if (ret->argument) visit_expression(*ret->argument);
+            return;
+        }
+        if (auto* if_stmt = dynamic_cast<const IfStatement*>(&stmt)) {
+            visit_expression(*if_stmt->test);
+            visit_statement(*if_stmt->consequent);
+            if (if_stmt->alternate) visit_statement(*if_stmt->alternate);
+            return;
+        }
+        if (auto* while_stmt = dynamic_cast<const WhileStatement*>(&stmt)) {
+            visit_expression(*while_stmt->test);
+            visit_statement(*while_stmt->body);
+            return;
+        }
+        if (auto* do_while = dynamic_cast<const DoWhileStatement*>(&stmt)) {
+            visit_statement(*do_while->body);
+            visit_expression(*do_while->test);
+            return;
+        }
+        if (auto* for_stmt = dynamic_cast<const ForStatement*>(&stmt)) {
+            if (for_stmt->init_statement) visit_statement(*for_stmt->init_statement);
+            if (for_stmt->init_expression) visit_expression(*for_stmt->init_expression);
+            if (for_stmt->test) visit_expression(*for_stmt->test);
+            if (for_stmt->update) visit_expression(*for_stmt->update);
+            if (for_stmt->body) visit_statement(*for_stmt->body);
+            return;
+        }
+        if (auto* for_in_stmt = dynamic_cast<const ForInStatement*>(&stmt)) {
+            note_identifier(for_in_stmt->variable);
+            visit_expression(*for_in_stmt->object);
+            if (for_in_stmt->body) visit_statement(*for_in_stmt->body);
+            return;
+        }
+        if (auto* switch_stmt = dynamic_cast<const SwitchStatement*>(&stmt)) {
+            visit_expression(*switch_stmt->discriminant);
+            for (const auto& case_stmt : switch_stmt->cases) {
+                if (case_stmt.test) visit_expression(*case_stmt.test);
+                for (const auto& cons : case_stmt.consequent) {
+                    visit_statement(*cons);
+                }
+            }
+            return;
+        }
+        if (auto* throw_stmt = dynamic_cast<const ThrowStatement*>(&stmt)) {
+            visit_expression(*throw_stmt->argument);
+            return;
+        }
+        if (auto* try_stmt = dynamic_cast<const TryStatement*>(&stmt)) {
+            visit_statement(*try_stmt->block);
+            if (try_stmt->handler) visit_statement(*try_stmt->handler);
+            if (try_stmt->finalizer) visit_statement(*try_stmt->finalizer);
+            return;
+        }
+        if (auto* with_stmt = dynamic_cast<const WithStatement*>(&stmt)) {
+            if (m_depth == 0) {
+                m_dynamic_scope = true;
+            }
+            visit_expression(*with_stmt->object);
+            visit_statement(*with_stmt->body);
+            return;
+        }
+        if (auto* class_decl = dynamic_cast<const ClassDeclaration*>(&stmt)) {
+            if (class_decl->super_class) visit_expression(*class_decl->super_class);
+            for (const auto& method : class_decl->body) {
+                visit_function(method.body, nullptr);
+            }
+            return;
+        }
+        if (auto* export_named = dynamic_cast<const ExportNamedDeclaration*>(&stmt)) {
+            if (export_named->declaration) visit_statement(*export_named->declaration);
+            return;
+        }
+        if (auto* export_default = dynamic_cast<const ExportDefaultDeclaration*>(&stmt)) {
+            if (export_default->declaration) visit_statement(*export_default->declaration);
+            if (export_default->expression) visit_expression(*export_default->expression);
+            return;
+        }
+    }
+
+    void visit_expression(const Expression& expr) {
+        if (auto* id = dynamic_cast<const Identifier*>(&expr)) {
+            note_identifier(id->name);
+            return;
+        }
+        if (auto* fn_expr = dynamic_cast<const FunctionExpression*>(&expr)) {
+            visit_function(fn_expr->body, fn_expr->concise_body.get());
+            return;
+        }
+        if (auto* array = dynamic_cast<const ArrayExpression*>(&expr)) {
+            for (const auto& elem : array->elements) {
+                if (elem) visit_expression(*elem);
+            }
+            return;
+        }
+        if (auto* obj = dynamic_cast<const ObjectExpression*>(&expr)) {
+            for (const auto& prop : obj->properties) {
+                if (prop.computed_key) visit_expression(*prop.computed_key);
+                if (prop.value) visit_expression(*prop.value);
+            }
+            return;
+        }
+        if (auto* member = dynamic_cast<const MemberExpression*>(&expr)) {
+            visit_expression(*member->object);
+            if (member->computed && member->property) visit_expression(*member->property);
+            return;
+        }
+        if (auto* call = dynamic_cast<const CallExpression*>(&expr)) {
+            visit_expression(*call->callee);
+            for (const auto& arg : call->arguments) {
+                visit_expression(*arg);
+            }
+            return;
+        }
+        if (auto* new_expr = dynamic_cast<const NewExpression*>(&expr)) {
+            visit_expression(*new_expr->callee);
+            for (const auto& arg : new_expr->arguments) {
+                visit_expression(*arg);
+            }
+            return;
+        }
+        if (auto* unary = dynamic_cast<const UnaryExpression*>(&expr)) {
+            visit_expression(*unary->argument);
+            return;
+        }
+        if (auto* binary = dynamic_cast<const BinaryExpression*>(&expr)) {
+            visit_expression(*binary->left);
+            visit_expression(*binary->right);
+            return;
+        }
+        if (auto* logical = dynamic_cast<const LogicalExpression*>(&expr)) {
+            visit_expression(*logical->left);
+            visit_expression(*logical->right);
+            return;
+        }
+        if (auto* assign = dynamic_cast<const AssignmentExpression*>(&expr)) {
+            visit_expression(*assign->left);
+            visit_expression(*assign->right);
+            return;
+        }
+        if (auto* cond = dynamic_cast<const ConditionalExpression*>(&expr)) {
+            visit_expression(*cond->test);
+            visit_expression(*cond->consequent);
+            visit_expression(*cond->alternate);
+            return;
+        }
+        if (auto* update = dynamic_cast<const UpdateExpression*>(&expr)) {
+            visit_expression(*update->argument);
+            return;
+        }
+        if (auto* spread = dynamic_cast<const SpreadElement*>(&expr)) {
+            visit_expression(*spread->argument);
+            return;
+        }
+        if (auto* tpl = dynamic_cast<const TemplateLiteral*>(&expr)) {
+            for (const auto& e : tpl->expressions) {
+                visit_expression(*e);
+            }
+            return;
+        }
+    }
+};
+
 class CompilerImpl {
 public:
     Compiler::Result compile(const Program& program) {
@@ -244,9 +494,14 @@ public:
         m_functions.clear();
         m_functions.push_back(entry);
 
-        collect_locals(*entry, program.body);
+        // Top-level declarations are global bindings, so the script collects
+        // no locals of its own and names resolve through global cells
+        CaptureAnalyzer captures;
+        captures.analyze(program.body, nullptr);
+        m_scopes.push_back(Scope{entry.get(), true, captures.has_dynamic_scope()});
         compile_statements(program.body, *entry, /*is_entry*/true);
         emit_return(*entry);
+        m_scopes.pop_back();
 
         result.module.functions = m_functions;
         result.module.entry = 0;
@@ -255,6 +510,13 @@ public:
     }
 
 private:
+    // A function being compiled, innermost last
+    struct Scope {
+        FunctionCode* fn{nullptr};
+        bool is_entry{false};
+        bool dynamic{false};  // with / eval: free names are looked up by string
+    };
+
     struct LoopContext {
         std::vector<usize> break_patches;
         std::vector<usize> continue_patches;
@@ -394,6 +656,112 @@ private:
         emit_u16(fn, cache_slot);
     }
 
+    // ========================================================================
+    // Scope analysis - resolve identifiers to a storage location
+    // ========================================================================
+    //
+    // Locals of the running function are frame slots. Locals of an enclosing
+    // function are (depth, slot) pairs, where depth counts the environments
+    // between the closure and the owner (functions without an environment
+    // add none). Anything else is a global reached through a cached cell;
+    // string lookups remain only where `with` / `eval` make scope dynamic.
+
+    struct VariableLocation {
+        enum class Kind { Local, Scoped, Global, Dynamic };
+        Kind kind{Kind::Dynamic};
+        u16 slot{0};
+        u8 depth{0};
+    };
+
+    VariableLocation resolve_variable(FunctionCode& fn, const String& name) const {
+        using Kind = VariableLocation::Kind;
+        if (auto slot = fn.resolve_local(name)) {
+            return {Kind::Local, *slot, 0};
+        }
+        u32 depth = 0;
+        for (usize i = m_scopes.size(); i-- > 0;) {
+            const Scope& scope = m_scopes[i];
+            if (scope.dynamic) {
+                return {};
+            }
+            if (scope.is_entry) {
+                return {Kind::Global, 0, 0};
+            }
+            if (scope.fn == &fn) {
+                continue;
+            }
+            if (auto slot = scope.fn->resolve_local(name)) {
+                if (!scope.fn->needs_environment || depth > 0xFF) {
+                    return {};
+                }
+                return {Kind::Scoped, *slot, static_cast<u8>(depth)};
+            }
+            if (scope.fn->needs_environment) {
+                ++depth;
+            }
+        }
+        return {Kind::Global, 0, 0};
+    }
+
+    void emit_get_variable(FunctionCode& fn, const String& name) {
+        auto loc = resolve_variable(fn, name);
+        switch (loc.kind) {
+            case VariableLocation::Kind::Local:
+                emit(fn, OpCode::GetLocal);
+                emit_u16(fn, loc.slot);
+                break;
+            case VariableLocation::Kind::Scoped:
+                emit(fn, OpCode::GetScoped);
+                emit_u8(fn, loc.depth);
+                emit_u16(fn, loc.slot);
+                break;
+            case VariableLocation::Kind::Global:
+                emit(fn, OpCode::GetGlobal);
+                emit_u16(fn, add_name(fn, name));
+                emit_u16(fn, fn.alloc_global_slot());
+                break;
+            case VariableLocation::Kind::Dynamic:
+                emit(fn, OpCode::GetVar);
+                emit_u16(fn, add_name(fn, name));
+                break;
+        }
+    }
+
+    void emit_set_variable(FunctionCode& fn, const String& name) {
+        auto loc = resolve_variable(fn, name);
+        switch (loc.kind) {
+            case VariableLocation::Kind::Local:
+                emit(fn, OpCode::SetLocal);
+                emit_u16(fn, loc.slot);
+                break;
+            case VariableLocation::Kind::Scoped:
+                emit(fn, OpCode::SetScoped);
+                emit_u8(fn, loc.depth);
+                emit_u16(fn, loc.slot);
+                break;
+            case VariableLocation::Kind::Global:
+                emit(fn, OpCode::SetGlobal);
+                emit_u16(fn, add_name(fn, name));
+                emit_u16(fn, fn.alloc_global_slot());
+                break;
+            case VariableLocation::Kind::Dynamic:
+                emit(fn, OpCode::SetVar);
+                emit_u16(fn, add_name(fn, name));
+                break;
+        }
+    }
+
+    // Store to a binding DefineVar just created: a global cell at script
+    // level, otherwise the defining environment itself
+    void emit_set_declared(FunctionCode& fn, const String& name, u16 name_idx) {
+        if (m_scopes.back().is_entry) {
+            emit_set_variable(fn, name);
+            return;
+        }
+        emit(fn, OpCode::SetVar);
+        emit_u16(fn, name_idx);
+    }
+
     void emit_constant(FunctionCode& fn, const Value& v) {
         u16 idx = add_constant(fn, v);
         emit(fn, OpCode::LoadConst);
@@ -451,6 +819,7 @@ private:
                 u16 name_idx = 0;
                 if (!local_slot) {
                     name_idx = add_name(fn, var.id);
+                    fn.needs_environment = true;
                     emit(fn, OpCode::DefineVar);
                     emit_u16(fn, name_idx);
                     emit_u8(fn, decl->kind == VariableDeclaration::Kind::Const ? 1 : 0);
@@ -473,8 +842,7 @@ private:
                         emit(fn, OpCode::SetLocal);
                         emit_u16(fn, *local_slot);
                     } else {
-                        emit(fn, OpCode::SetVar);
-                        emit_u16(fn, name_idx);
+                        emit_set_declared(fn, var.id, name_idx);
                     }
                 }
             }
@@ -491,11 +859,11 @@ private:
                 emit(fn, OpCode::SetLocal);
                 emit_u16(fn, *local_slot);
             } else {
+                fn.needs_environment = true;
                 emit(fn, OpCode::DefineVar);
                 emit_u16(fn, name_idx);
                 emit_u8(fn, 1); // const binding
-                emit(fn, OpCode::SetVar);
-                emit_u16(fn, name_idx);
+                emit_set_declared(fn, fn_decl->name, name_idx);
             }
             return;
         }
@@ -834,11 +1202,11 @@ private:
                         emit_u16(fn, *local_slot);
                     } else {
                         auto name_idx = add_name(fn, try_stmt->handler_param);
+                        fn.needs_environment = true;
                         emit(fn, OpCode::DefineVar);
                         emit_u16(fn, name_idx);
                         emit_u8(fn, 0);
-                        emit(fn, OpCode::SetVar);
-                        emit_u16(fn, name_idx);
+                        emit_set_declared(fn, try_stmt->handler_param, name_idx);
                     }
                 }
                 compile_statement(*try_stmt->handler, fn, false);
@@ -906,14 +1274,7 @@ private:
             return;
         }
         if (auto* id = dynamic_cast<const Identifier*>(&expr)) {
-            if (auto slot = fn.resolve_local(id->name)) {
-                emit(fn, OpCode::GetLocal);
-                emit_u16(fn, *slot);
-            } else {
-                u16 name_idx = add_name(fn, id->name);
-                emit(fn, OpCode::GetVar);
-                emit_u16(fn, name_idx);
-            }
+            emit_get_variable(fn, id->name);
             return;
         }
         if (auto* tpl = dynamic_cast<const TemplateLiteral*>(&expr)) {
@@ -1064,27 +1425,13 @@ private:
         }
         if (auto* update = dynamic_cast<const UpdateExpression*>(&expr)) {
             if (auto* id = dynamic_cast<Identifier*>(update->argument.get())) {
-                auto local_slot = fn.resolve_local(id->name);
-                u16 name_idx = local_slot ? 0 : add_name(fn, id->name);
-                if (local_slot) {
-                    emit(fn, OpCode::GetLocal);
-                    emit_u16(fn, *local_slot);
-                } else {
-                    emit(fn, OpCode::GetVar);
-                    emit_u16(fn, name_idx);
-                }
+                emit_get_variable(fn, id->name);
                 if (!update->prefix) {
                     emit(fn, OpCode::Dup);
                 }
                 emit_constant(fn, Value(1.0));
                 emit(fn, update->op == UpdateExpression::Operator::Increment ? OpCode::Add : OpCode::Subtract);
-                if (local_slot) {
-                    emit(fn, OpCode::SetLocal);
-                    emit_u16(fn, *local_slot);
-                } else {
-                    emit(fn, OpCode::SetVar);
-                    emit_u16(fn, name_idx);
-                }
+                emit_set_variable(fn, id->name);
                 if (!update->prefix) {
                     emit(fn, OpCode::Pop);
                 }
@@ -1183,9 +1530,6 @@ private:
         bool is_logical = (expr.op == Op::LogicalAndAssign || expr.op == Op::LogicalOrAssign || expr.op == Op::NullishAssign);
 
         if (auto* id = dynamic_cast<Identifier*>(expr.left.get())) {
-            auto local_slot = fn.resolve_local(id->name);
-            u16 name_idx = local_slot ? 0 : add_name(fn, id->name);
-
             if (is_logical) {
                 // Logical assignment operators have short-circuit semantics
                 // a &&= b  -->  a && (a = b)
@@ -1193,13 +1537,7 @@ private:
                 // a ??= b  -->  a ?? (a = b)
 
                 // Load current value
-                if (local_slot) {
-                    emit(fn, OpCode::GetLocal);
-                    emit_u16(fn, *local_slot);
-                } else {
-                    emit(fn, OpCode::GetVar);
-                    emit_u16(fn, name_idx);
-                }
+                emit_get_variable(fn, id->name);
 
                 // Duplicate for both condition check and potential result
                 emit(fn, OpCode::Dup);
@@ -1212,13 +1550,7 @@ private:
                     emit(fn, OpCode::Pop);
                     // Compile right side and assign
                     compile_expression(*expr.right, fn);
-                    if (local_slot) {
-                        emit(fn, OpCode::SetLocal);
-                        emit_u16(fn, *local_slot);
-                    } else {
-                        emit(fn, OpCode::SetVar);
-                        emit_u16(fn, name_idx);
-                    }
+                    emit_set_variable(fn, id->name);
                     patch_jump(fn, short_circuit_jump);
                 } else if (expr.op == Op::LogicalOrAssign) {
                     // For ||=, assign only if current value is falsy
@@ -1229,13 +1561,7 @@ private:
                     emit(fn, OpCode::Pop);
                     // Compile right side and assign
                     compile_expression(*expr.right, fn);
-                    if (local_slot) {
-                        emit(fn, OpCode::SetLocal);
-                        emit_u16(fn, *local_slot);
-                    } else {
-                        emit(fn, OpCode::SetVar);
-                        emit_u16(fn, name_idx);
-                    }
+                    emit_set_variable(fn, id->name);
                     patch_jump(fn, skip_assign);
                 } else {  // NullishAssign
                     // For ??=, assign only if current value is nullish
@@ -1246,44 +1572,20 @@ private:
                     emit(fn, OpCode::Pop);
                     // Compile right side and assign
                     compile_expression(*expr.right, fn);
-                    if (local_slot) {
-                        emit(fn, OpCode::SetLocal);
-                        emit_u16(fn, *local_slot);
-                    } else {
-                        emit(fn, OpCode::SetVar);
-                        emit_u16(fn, name_idx);
-                    }
+                    emit_set_variable(fn, id->name);
                     patch_jump(fn, skip_assign);
                 }
             } else if (is_compound) {
                 // Arithmetic/bitwise compound assignment
                 // Load current value first
-                if (local_slot) {
-                    emit(fn, OpCode::GetLocal);
-                    emit_u16(fn, *local_slot);
-                } else {
-                    emit(fn, OpCode::GetVar);
-                    emit_u16(fn, name_idx);
-                }
+                emit_get_variable(fn, id->name);
                 compile_expression(*expr.right, fn);
                 emit_compound_op(expr.op, fn);
-                if (local_slot) {
-                    emit(fn, OpCode::SetLocal);
-                    emit_u16(fn, *local_slot);
-                } else {
-                    emit(fn, OpCode::SetVar);
-                    emit_u16(fn, name_idx);
-                }
+                emit_set_variable(fn, id->name);
             } else {
                 // Simple assignment
                 compile_expression(*expr.right, fn);
-                if (local_slot) {
-                    emit(fn, OpCode::SetLocal);
-                    emit_u16(fn, *local_slot);
-                } else {
-                    emit(fn, OpCode::SetVar);
-                    emit_u16(fn, name_idx);
-                }
+                emit_set_variable(fn, id->name);
             }
             return;
         }
@@ -1412,6 +1714,7 @@ private:
         auto fn = std::make_shared<FunctionCode>();
         fn->name = name;
         fn->params = params;
+        fn->needs_environment = false;
         for (const auto& param : params) {
             fn->add_local(param, false);
         }
@@ -1419,6 +1722,15 @@ private:
             collect_locals(*fn, body);
         }
 
+        // Locals only need a heap environment if a nested closure may see
+        // them; decided up front so nested functions can count environments
+        CaptureAnalyzer captures;
+        captures.analyze(body, concise_body);
+        if (captures.needs_environment(*fn)) {
+            fn->needs_environment = true;
+        }
+        m_scopes.push_back(Scope{fn.get(), false, captures.has_dynamic_scope()});
+
         // Run escape analysis before compilation
         EscapeAnalyzer saved_analyzer = m_escape_analyzer;
         if (!concise_body) {
@@ -1436,6 +1748,7 @@ private:
 
         // Restore analyzer for outer function
         m_escape_analyzer = saved_analyzer;
+        m_scopes.pop_back();
 
         m_functions.push_back(fn);
         return static_cast<u16>(m_functions.size() - 1);
@@ -1444,6 +1757,7 @@ private:
     std::vector<std::shared_ptr<FunctionCode>> m_functions;
     std::vector<String> m_errors;
     std::vector<LoopContext> m_loop_stack;
+    std::vector<Scope> m_scopes;
     EscapeAnalyzer m_escape_analyzer;
     bool m_use_stack_alloc{false};  // Flag for stack-allocating the next new expression
 };
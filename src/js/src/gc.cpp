@@ -1,5 +1,5 @@
 /**
- * Garbage Collector implementation - Mark and Sweep
+ * Garbage Collector implementation - generational mark and sweep
  */
 
 #include "lithium/js/gc.hpp"
@@ -7,6 +7,8 @@
 #include "lithium/js/value.hpp"
 #include "lithium/js/vm.hpp"
 #include <algorithm>
+#include <cassert>
+#include <chrono>
 
 #ifdef LITHIUM_DEBUG_GC
 #include <iostream>
@@ -14,49 +16,605 @@
 
 namespace lithium::js {
 
+// ============================================================================
+// HeapBlock - 64 KiB aligned chunk of equally sized cells
+// ============================================================================
+//
+// Blocks are aligned to their size so the owning block (and through it the
+// owning collector) of any cell can be found by masking the cell address.
+// Large blocks hold a single object of arbitrary size; the object still
+// starts inside the first 64 KiB, so the same masking works.
+
+namespace {
+
+struct FreeCell {
+    FreeCell* next;
+};
+
+constexpr usize GRANULE = 16;
+
+// Cell sizes for the size-classed spaces (multiples of GRANULE)
+constexpr usize SIZE_CLASSES[] = {
+    64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512,
+    640, 768, 1024, 1536, 2048,
+};
+
+constexpr usize round_up(usize value, usize align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+// Objects traced between two clock reads while draining the gray stack
+constexpr usize MARK_CHECK_INTERVAL = 64;
+
+// Blocks swept by one sweep step taken at a GC check
+constexpr usize SWEEP_STEP_BLOCKS = 16;
+
+using Clock = std::chrono::steady_clock;
+
+u64 micros_since(Clock::time_point start) {
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+// Records the lifetime of a scope as one mutator pause
+class PauseTimer {
+public:
+    explicit PauseTimer(GarbageCollector::PauseHistogram& histogram)
+        : m_histogram(histogram), m_start(Clock::now()) {}
+    ~PauseTimer() { m_histogram.record(micros_since(m_start)); }
+
+    PauseTimer(const PauseTimer&) = delete;
+    PauseTimer& operator=(const PauseTimer&) = delete;
+
+private:
+    GarbageCollector::PauseHistogram& m_histogram;
+    Clock::time_point m_start;
+};
+
+} // namespace
+
+struct HeapBlock {
+    static constexpr usize SIZE = 64 * 1024;
+    static constexpr usize MIN_CELL = 64;
+    static constexpr usize MAX_CELLS = SIZE / MIN_CELL;
+
+    GarbageCollector* owner{nullptr};
+    usize cell_size{0};
+    usize allocation_size{SIZE};  // Total bytes reserved for this block
+    u32 cell_count{0};
+    u32 bump{0};                  // Cells [0, bump) have been handed out at least once
+    u32 live{0};                  // Cells currently holding an object
+    bool large{false};
+    bool needs_sweep{false};      // Holds mark bits from the last major cycle
+    FreeCell* free_list{nullptr};
+    u8* cells{nullptr};
+    u8 used[MAX_CELLS]{};         // 1 if the cell holds a constructed object
+
+    static usize header_size() { return round_up(sizeof(HeapBlock), GRANULE); }
+
+    static HeapBlock* create(GarbageCollector* owner, usize cell_size) {
+        void* memory = ::operator new(SIZE, std::align_val_t{SIZE});
+        auto* block = new (memory) HeapBlock();
+        block->owner = owner;
+        block->cell_size = cell_size;
+        block->cells = static_cast<u8*>(memory) + header_size();
+        block->cell_count = static_cast<u32>((SIZE - header_size()) / cell_size);
+        return block;
+    }
+
+    static HeapBlock* create_large(GarbageCollector* owner, usize object_size) {
+        usize total = round_up(header_size() + object_size, SIZE);
+        void* memory = ::operator new(total, std::align_val_t{SIZE});
+        auto* block = new (memory) HeapBlock();
+        block->owner = owner;
+        block->cell_size = round_up(object_size, GRANULE);
+        block->allocation_size = total;
+        block->cells = static_cast<u8*>(memory) + header_size();
+        block->cell_count = 1;
+        block->large = true;
+        return block;
+    }
+
+    static void destroy(HeapBlock* block) {
+        usize total = block->allocation_size;
+        block->~HeapBlock();
+        ::operator delete(static_cast<void*>(block), total, std::align_val_t{SIZE});
+    }
+
+    [[nodiscard]] void* cell_at(u32 index) const { return cells + static_cast<usize>(index) * cell_size; }
+
+    [[nodiscard]] u32 index_of(const void* cell) const {
+        return static_cast<u32>(static_cast<usize>(static_cast<const u8*>(cell) - cells) / cell_size);
+    }
+
+    [[nodiscard]] bool is_full() const { return free_list == nullptr && bump >= cell_count; }
+
+    void* take_cell() {
+        void* cell = nullptr;
+        if (free_list) {
+            cell = free_list;
+            free_list = free_list->next;
+        } else if (bump < cell_count) {
+            cell = cell_at(bump++);
+        } else {
+            return nullptr;
+        }
+        used[index_of(cell)] = 1;
+        ++live;
+        return cell;
+    }
+
+    void give_back(void* cell) {
+        used[index_of(cell)] = 0;
+        --live;
+        auto* free_cell = static_cast<FreeCell*>(cell);
+        free_cell->next = free_list;
+        free_list = free_cell;
+    }
+};
+
+// ============================================================================
+// Traceable
+// ============================================================================
+
+Traceable::~Traceable() {
+    if (m_remembered_in) {
+        m_remembered_in->forget(this);
+    }
+}
+
+// ============================================================================
+// PauseHistogram
+// ============================================================================
+
+void GarbageCollector::PauseHistogram::record(u64 micros) {
+    usize bucket = 0;
+    while (bucket + 1 < BUCKET_COUNT && (micros >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+    ++buckets[bucket];
+    ++pauses;
+    total_us += micros;
+    max_us = std::max(max_us, micros);
+}
+
 // ============================================================================
 // GarbageCollector implementation
 // ============================================================================
 
-GarbageCollector::GarbageCollector() = default;
+u32 GarbageCollector::s_active_markers = 0;
+
+GarbageCollector::GarbageCollector() {
+    constexpr usize class_count = sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+    m_size_classes.resize(class_count);
+    m_class_for_granule.assign(SIZE_CLASSES[class_count - 1] / GRANULE + 1, 0);
+    usize cls = 0;
+    for (usize granule = 0; granule < m_class_for_granule.size(); ++granule) {
+        while (SIZE_CLASSES[cls] < granule * GRANULE) {
+            ++cls;
+        }
+        m_class_for_granule[granule] = static_cast<u8>(cls);
+    }
+    for (usize i = 0; i < class_count; ++i) {
+        m_size_classes[i].cell_size = SIZE_CLASSES[i];
+    }
+}
+
+GarbageCollector::~GarbageCollector() {
+    m_tearing_down = true;
+    if (m_marking) {
+        m_marking = false;
+        --s_active_markers;
+    }
+
+    // Holders that outlive the heap must not call back into it
+    for (auto* holder : m_remembered) {
+        holder->m_gc_flags &= static_cast<u8>(~Traceable::GC_REMEMBERED);
+        holder->m_remembered_in = nullptr;
+    }
+    for (auto* holder : m_external_holders) {
+        holder->m_gc_flags &= static_cast<u8>(~Traceable::GC_REMEMBERED);
+        holder->m_remembered_in = nullptr;
+    }
+    m_remembered.clear();
+    m_external_holders.clear();
+
+    // Finalize every remaining object, then return the blocks
+    for (auto& size_class : m_size_classes) {
+        for (auto* block : size_class.blocks) {
+            for (u32 i = 0; i < block->bump; ++i) {
+                if (block->used[i]) {
+                    static_cast<Object*>(block->cell_at(i))->~Object();
+                }
+            }
+            HeapBlock::destroy(block);
+        }
+    }
+    for (auto* block : m_large_blocks) {
+        static_cast<Object*>(block->cell_at(0))->~Object();
+        HeapBlock::destroy(block);
+    }
+}
+
+usize GarbageCollector::heap_block_count() const {
+    usize count = m_large_blocks.size();
+    for (const auto& size_class : m_size_classes) {
+        count += size_class.blocks.size();
+    }
+    return count;
+}
+
+// ============================================================================
+// Allocation
+// ============================================================================
+
+void* GarbageCollector::allocate_cell(usize size) {
+    usize granule = (size + GRANULE - 1) / GRANULE;
+    if (granule >= m_class_for_granule.size()) {
+        return allocate_large(size);
+    }
+
+    auto& size_class = m_size_classes[m_class_for_granule[granule]];
+    while (size_class.alloc_index < size_class.blocks.size()) {
+        HeapBlock* block = size_class.blocks[size_class.alloc_index];
+        if (block->needs_sweep) {
+            sweep_block(block);
+        }
+        if (void* cell = block->take_cell()) {
+            return cell;
+        }
+        ++size_class.alloc_index;
+    }
+
+    auto* block = HeapBlock::create(this, size_class.cell_size);
+    size_class.blocks.push_back(block);
+    size_class.alloc_index = size_class.blocks.size() - 1;
+    return block->take_cell();
+}
+
+void* GarbageCollector::allocate_large(usize size) {
+    auto* block = HeapBlock::create_large(this, size);
+    m_large_blocks.push_back(block);
+    return block->take_cell();
+}
+
+void GarbageCollector::release_cell(void* cell) {
+    HeapBlock* block = block_of(cell);
+    if (block->large) {
+        m_large_blocks.erase(std::find(m_large_blocks.begin(), m_large_blocks.end(), block));
+        HeapBlock::destroy(block);
+        return;
+    }
+    block->give_back(cell);
+}
+
+void GarbageCollector::adopt(Object* obj, void* cell) {
+    assert(static_cast<void*>(obj) == cell && "Object must start at its cell");
+    (void)cell;
+    obj->m_gc_flags |= Traceable::GC_MANAGED | Traceable::GC_YOUNG;
+    if (m_marking) {
+        // Allocate gray: constructor stores bypass the barrier, so the new
+        // object is traced once before marking finishes
+        obj->mark();
+        obj->m_gc_flags &= static_cast<u8>(~Traceable::GC_YOUNG);
+        m_marked_bytes += cell_size_of(obj);
+        m_gray_stack.push_back(obj);
+    }
+    m_young_objects.push_back(obj);
+    m_young_bytes += cell_size_of(obj);
+    ++m_object_count;
+}
+
+HeapBlock* GarbageCollector::block_of(const void* cell) {
+    auto address = reinterpret_cast<uintptr_t>(cell);
+    return reinterpret_cast<HeapBlock*>(address & ~static_cast<uintptr_t>(HeapBlock::SIZE - 1));
+}
+
+usize GarbageCollector::cell_size_of(const Object* obj) {
+    return block_of(obj)->cell_size;
+}
+
+void GarbageCollector::free_object(Object* obj) {
+    obj->~Object();
+    release_cell(obj);
+    --m_object_count;
+}
+
+// ============================================================================
+// Write barrier / remembered set
+// ============================================================================
+
+void GarbageCollector::record_write(Traceable& holder, const Traceable& target) {
+    GarbageCollector* owner = block_of(&target)->owner;
+    if (holder.is_managed()) {
+        owner->remember(holder);
+    } else {
+        owner->retain_external_holder(holder);
+    }
+}
+
+void GarbageCollector::write_barrier(Traceable& holder, const Value& value) {
+    if (!value.is_object()) {
+        return;
+    }
+    Object* target = value.as_object();
+    if (!target || !target->is_managed()) {
+        return;
+    }
+    if (marking_barrier_active() && !target->is_marked()) {
+        shade(*target);
+    }
+    if (!holder.is_remembered() && target->is_young()) {
+        block_of(target)->owner->remember(holder);
+    }
+}
+
+void GarbageCollector::shade(const Object& target) {
+    GarbageCollector* owner = block_of(&target)->owner;
+    if (owner->m_marking) {
+        owner->mark_object(const_cast<Object*>(&target));
+    }
+}
+
+void GarbageCollector::remember(Traceable& holder) {
+    holder.m_gc_flags |= Traceable::GC_REMEMBERED;
+    holder.m_remembered_in = this;
+    m_remembered.insert(&holder);
+}
+
+void GarbageCollector::retain_external_holder(Traceable& holder) {
+    holder.m_gc_flags |= Traceable::GC_REMEMBERED;
+    holder.m_remembered_in = this;
+    m_external_holders.insert(&holder);
+}
 
-GarbageCollector::~GarbageCollector() = default;
+void GarbageCollector::forget(Traceable* holder) {
+    if (m_tearing_down) {
+        return;
+    }
+    m_remembered.erase(holder);
+    m_external_holders.erase(holder);
+}
 
-void GarbageCollector::track(std::shared_ptr<Object> obj) {
-    m_objects.push_back(std::move(obj));
-    m_bytes_allocated += sizeof(Object); // Approximate
+void GarbageCollector::clear_remembered_set() {
+    for (auto* holder : m_remembered) {
+        holder->m_gc_flags &= static_cast<u8>(~Traceable::GC_REMEMBERED);
+        holder->m_remembered_in = nullptr;
+    }
+    m_remembered.clear();
+}
+
+// ============================================================================
+// Collection
+// ============================================================================
+
+void GarbageCollector::collect_if_needed(VM& vm) {
+    if (m_marking) {
+        if (m_stress_gc) {
+            collect(vm);
+        } else if (needs_mark_slice()) {
+            mark_slice(vm);
+        }
+        return;
+    }
+    if (m_stress_gc) {
+        collect(vm);
+        return;
+    }
+    if (needs_minor()) {
+        collect_minor(vm);
+    }
+    if (needs_major()) {
+        if (m_incremental_marking) {
+            start_marking(vm);
+        } else {
+            collect(vm);
+        }
+    } else if (is_sweeping()) {
+        sweep_step();
+    }
+}
+
+void GarbageCollector::collect_minor(VM& vm) {
+    if (m_marking) {
+        // The nursery is part of the running major cycle
+        PauseTimer timer(m_major_stats.pauses);
+        finish_marking(vm);
+        return;
+    }
+
+    PauseTimer timer(m_minor_stats.pauses);
+
+#ifdef LITHIUM_DEBUG_GC
+    if (m_log_gc) {
+        std::cout << "-- minor GC begin\n";
+        std::cout << "   " << m_young_objects.size() << " young objects, "
+                  << m_remembered.size() << " remembered holders\n";
+    }
+#endif
+
+    begin_cycle(true);
+    mark_roots(vm);
+    trace_references();
+    process_weak_containers();
+    clear_remembered_set();
+    sweep_young();
+    end_cycle();
+
+    ++m_minor_stats.collections;
+
+#ifdef LITHIUM_DEBUG_GC
+    if (m_log_gc) {
+        std::cout << "   " << m_object_count << " objects remaining\n";
+        std::cout << "-- minor GC end\n";
+    }
+#endif
 }
 
 void GarbageCollector::collect(VM& vm) {
+    PauseTimer timer(m_major_stats.pauses);
+
+    if (m_marking) {
+        finish_marking(vm);
+        finish_sweeping();
+        return;
+    }
+
+    // Mark bits of the previous cycle must be gone before marking again
+    finish_sweeping();
+
 #ifdef LITHIUM_DEBUG_GC
     if (m_log_gc) {
         std::cout << "-- GC begin\n";
-        std::cout << "   " << m_objects.size() << " objects tracked\n";
+        std::cout << "   " << m_object_count << " objects tracked\n";
     }
 #endif
 
-    usize before = m_objects.size();
+    usize before = m_object_count;
 
     // Mark phase
+    begin_cycle(false);
     mark_roots(vm);
     trace_references();
 
     // Sweep phase
-    sweep();
-
-    // Update threshold
-    m_next_gc = m_bytes_allocated * static_cast<usize>(m_heap_grow_factor);
-    ++m_gc_count;
+    finish_major();
+    finish_sweeping();
 
 #ifdef LITHIUM_DEBUG_GC
     if (m_log_gc) {
-        std::cout << "   collected " << (before - m_objects.size()) << " objects\n";
-        std::cout << "   " << m_objects.size() << " remaining\n";
+        std::cout << "   collected " << (before - m_object_count) << " objects\n";
+        std::cout << "   " << m_object_count << " remaining\n";
         std::cout << "-- GC end\n";
     }
+#else
+    (void)before;
+#endif
+}
+
+void GarbageCollector::start_marking(VM& vm) {
+    PauseTimer timer(m_major_stats.pauses);
+
+#ifdef LITHIUM_DEBUG_GC
+    if (m_log_gc) {
+        std::cout << "-- incremental GC begin\n";
+        std::cout << "   " << m_object_count << " objects tracked\n";
+    }
+#endif
+
+    finish_sweeping();
+    begin_cycle(false);
+    m_marking = true;
+    ++s_active_markers;
+    mark_roots(vm);
+
+    ++m_major_stats.mark_slices;
+    m_slice_alloc_mark = m_young_bytes;
+    if (drain_gray_stack(m_slice_budget_us)) {
+        finish_marking(vm);
+    }
+}
+
+void GarbageCollector::mark_slice(VM& vm) {
+    PauseTimer timer(m_major_stats.pauses);
+
+    ++m_major_stats.mark_slices;
+    m_slice_alloc_mark = m_young_bytes;
+    if (drain_gray_stack(m_slice_budget_us)) {
+        finish_marking(vm);
+    }
+}
+
+void GarbageCollector::finish_marking(VM& vm) {
+    // Stack slots and frame environments are stored to without a barrier, so
+    // re-scan the roots. A new epoch lets holders be traced again.
+    ++m_epoch;
+    mark_roots(vm);
+    trace_references();
+
+    m_marking = false;
+    --s_active_markers;
+    finish_major();
+
+#ifdef LITHIUM_DEBUG_GC
+    if (m_log_gc) {
+        std::cout << "   " << m_object_count << " objects remaining\n";
+        std::cout << "-- incremental GC end\n";
+    }
 #endif
 }
 
+bool GarbageCollector::drain_gray_stack(u64 budget_us) {
+    auto start = Clock::now();
+    usize traced = 0;
+    while (!m_gray_stack.empty()) {
+        Object* obj = m_gray_stack.back();
+        m_gray_stack.pop_back();
+        obj->trace(*this);
+        if (++traced % MARK_CHECK_INTERVAL == 0 && micros_since(start) >= budget_us) {
+            break;
+        }
+    }
+    return m_gray_stack.empty();
+}
+
+void GarbageCollector::finish_major() {
+    process_weak_containers();
+
+    // No young objects survive a full collection, so nothing stays remembered
+    clear_remembered_set();
+
+    // Everything left unmarked is garbage; its bytes stay accounted until swept
+    usize heap_bytes = m_young_bytes + m_old_bytes;
+    m_bytes_awaiting_sweep = heap_bytes > m_marked_bytes ? heap_bytes - m_marked_bytes : 0;
+    m_old_bytes = m_marked_bytes;
+    m_external_bytes = m_marked_external;
+    m_young_bytes = 0;
+    m_young_objects.clear();
+    m_slice_alloc_mark = 0;
+
+    sweep_large_objects();
+
+    m_unswept_blocks.clear();
+    m_sweep_cursor = 0;
+    for (auto& size_class : m_size_classes) {
+        for (auto* block : size_class.blocks) {
+            block->needs_sweep = true;
+            m_unswept_blocks.push_back(block);
+        }
+        size_class.alloc_index = 0;
+    }
+
+    end_cycle();
+
+    // Update threshold
+    usize live = m_old_bytes + m_external_bytes;
+    m_next_gc = std::max(static_cast<usize>(static_cast<f64>(live) * m_heap_grow_factor), m_nursery_size);
+    ++m_major_stats.collections;
+
+    if (!m_lazy_sweeping) {
+        finish_sweeping();
+    }
+}
+
+void GarbageCollector::begin_cycle(bool minor) {
+    ++m_epoch;
+    m_minor_cycle = minor;
+    if (!minor) {
+        m_marked_bytes = 0;
+        m_marked_external = 0;
+    }
+}
+
+void GarbageCollector::end_cycle() {
+    for (Object* obj : m_marked_unmanaged) {
+        obj->unmark();
+    }
+    m_marked_unmanaged.clear();
+    m_weak_containers.clear();
+    m_minor_cycle = false;
+}
+
 void GarbageCollector::push_root(const Value* value) {
     m_roots.push_back(value);
 }
@@ -77,6 +635,18 @@ void GarbageCollector::mark_roots(VM& vm) {
             mark_value(*root);
         }
     }
+
+    // Native-owned objects that reference the heap
+    for (Traceable* holder : m_external_holders) {
+        mark_holder(holder);
+    }
+
+    // Old holders that received young references
+    if (m_minor_cycle) {
+        for (Traceable* holder : m_remembered) {
+            mark_holder(holder);
+        }
+    }
 }
 
 void GarbageCollector::mark_value(const Value& value) {
@@ -86,11 +656,27 @@ void GarbageCollector::mark_value(const Value& value) {
 }
 
 void GarbageCollector::mark_object(Object* obj) {
-    if (!obj || obj->is_marked()) {
+    if (!obj) {
+        return;
+    }
+    // Old objects are live by definition during a minor collection
+    if (m_minor_cycle && obj->is_managed() && !obj->is_young()) {
+        return;
+    }
+    if (obj->is_marked()) {
         return;
     }
 
     obj->mark();
+    if (!obj->is_managed()) {
+        m_marked_unmanaged.push_back(obj);
+    } else if (!m_minor_cycle) {
+        // Survivors of a major cycle are old; promote now since their block
+        // may only be swept much later
+        obj->m_gc_flags &= static_cast<u8>(~Traceable::GC_YOUNG);
+        m_marked_bytes += cell_size_of(obj);
+        m_marked_external += obj->external_bytes();
+    }
     m_gray_stack.push_back(obj);
 
 #ifdef LITHIUM_DEBUG_GC
@@ -100,6 +686,24 @@ void GarbageCollector::mark_object(Object* obj) {
 #endif
 }
 
+void GarbageCollector::mark_holder(Traceable* holder) {
+    if (!holder || holder->m_gc_epoch == m_epoch) {
+        return;
+    }
+    holder->m_gc_epoch = m_epoch;
+    holder->trace(*this);
+}
+
+bool GarbageCollector::is_live(const Object* obj) const {
+    if (!obj || !obj->is_managed()) {
+        return true;
+    }
+    if (m_minor_cycle && !obj->is_young()) {
+        return true;
+    }
+    return obj->is_marked();
+}
+
 void GarbageCollector::trace_references() {
     while (!m_gray_stack.empty()) {
         Object* obj = m_gray_stack.back();
@@ -109,24 +713,158 @@ void GarbageCollector::trace_references() {
     }
 }
 
-void GarbageCollector::sweep() {
-    // Remove unmarked objects
-    auto it = std::remove_if(m_objects.begin(), m_objects.end(),
-        [this](const std::shared_ptr<Object>& obj) {
-            if (!obj->is_marked()) {
+void GarbageCollector::process_weak_containers() {
+    for (Object* container : m_weak_containers) {
+        container->sweep_weak_references(*this);
+    }
+    m_weak_containers.clear();
+}
+
+void GarbageCollector::sweep_young() {
+    usize freed = 0;
+    usize freed_bytes = 0;
+    usize promoted_bytes = 0;
+
+    for (Object* obj : m_young_objects) {
+        usize size = cell_size_of(obj);
+        if (obj->is_marked()) {
+            // Promote in place
+            obj->unmark();
+            obj->m_gc_flags &= static_cast<u8>(~Traceable::GC_YOUNG);
+            promoted_bytes += size;
+            m_external_bytes += obj->external_bytes();
+        } else {
 #ifdef LITHIUM_DEBUG_GC
-                if (m_log_gc) {
-                    std::cout << "   sweep " << static_cast<void*>(obj.get()) << "\n";
-                }
-#endif
-                m_bytes_allocated -= sizeof(Object);
-                return true;  // Remove
+            if (m_log_gc) {
+                std::cout << "   sweep " << static_cast<void*>(obj) << "\n";
             }
+#endif
+            free_object(obj);
+            ++freed;
+            freed_bytes += size;
+        }
+    }
+    m_young_objects.clear();
+
+    m_old_bytes += promoted_bytes;
+    m_young_bytes = 0;
+    m_minor_stats.objects_freed += freed;
+    m_minor_stats.bytes_freed += freed_bytes;
+    m_minor_stats.bytes_promoted += promoted_bytes;
+
+    // Recycled cells may sit in any block now
+    for (auto& size_class : m_size_classes) {
+        size_class.alloc_index = 0;
+    }
+}
+
+void GarbageCollector::sweep_large_objects() {
+    usize freed = 0;
+    usize freed_bytes = 0;
+
+    // free_object() would erase from the list we iterate
+    std::vector<HeapBlock*> large_blocks;
+    large_blocks.swap(m_large_blocks);
+    for (auto* block : large_blocks) {
+        auto* obj = static_cast<Object*>(block->cell_at(0));
+        if (obj->is_marked()) {
             obj->unmark();
-            return false;  // Keep
-        });
+            m_large_blocks.push_back(block);
+            continue;
+        }
+#ifdef LITHIUM_DEBUG_GC
+        if (m_log_gc) {
+            std::cout << "   sweep " << static_cast<void*>(obj) << "\n";
+        }
+#endif
+        ++freed;
+        freed_bytes += block->cell_size;
+        obj->~Object();
+        HeapBlock::destroy(block);
+        --m_object_count;
+    }
+
+    m_bytes_awaiting_sweep -= std::min(m_bytes_awaiting_sweep, freed_bytes);
+    m_major_stats.objects_freed += freed;
+    m_major_stats.bytes_freed += freed_bytes;
+}
+
+void GarbageCollector::sweep_block(HeapBlock* block) {
+    usize freed = 0;
+    usize freed_bytes = 0;
+
+    for (u32 i = 0; i < block->bump; ++i) {
+        if (!block->used[i]) {
+            continue;
+        }
+        auto* obj = static_cast<Object*>(block->cell_at(i));
+        if (obj->is_marked()) {
+            obj->unmark();
+            continue;
+        }
+#ifdef LITHIUM_DEBUG_GC
+        if (m_log_gc) {
+            std::cout << "   sweep " << static_cast<void*>(obj) << "\n";
+        }
+#endif
+        free_object(obj);
+        ++freed;
+        freed_bytes += block->cell_size;
+    }
+    block->needs_sweep = false;
+
+    m_bytes_awaiting_sweep -= std::min(m_bytes_awaiting_sweep, freed_bytes);
+    m_major_stats.objects_freed += freed;
+    m_major_stats.bytes_freed += freed_bytes;
+}
+
+void GarbageCollector::sweep_step() {
+    PauseTimer timer(m_major_stats.pauses);
+    ++m_major_stats.sweep_steps;
 
-    m_objects.erase(it, m_objects.end());
+    usize swept = 0;
+    while (m_sweep_cursor < m_unswept_blocks.size() && swept < SWEEP_STEP_BLOCKS) {
+        HeapBlock* block = m_unswept_blocks[m_sweep_cursor++];
+        if (block->needs_sweep) {
+            sweep_block(block);
+            ++swept;
+        }
+    }
+    if (m_sweep_cursor == m_unswept_blocks.size()) {
+        finish_sweeping();
+    }
+}
+
+void GarbageCollector::finish_sweeping() {
+    if (m_unswept_blocks.empty()) {
+        return;
+    }
+    for (; m_sweep_cursor < m_unswept_blocks.size(); ++m_sweep_cursor) {
+        HeapBlock* block = m_unswept_blocks[m_sweep_cursor];
+        if (block->needs_sweep) {
+            sweep_block(block);
+        }
+    }
+    m_unswept_blocks.clear();
+    m_sweep_cursor = 0;
+    m_bytes_awaiting_sweep = 0;
+
+    release_empty_blocks();
+}
+
+void GarbageCollector::release_empty_blocks() {
+    for (auto& size_class : m_size_classes) {
+        auto& blocks = size_class.blocks;
+        auto it = std::remove_if(blocks.begin(), blocks.end(), [](HeapBlock* block) {
+            if (block->live != 0) {
+                return false;
+            }
+            HeapBlock::destroy(block);
+            return true;
+        });
+        blocks.erase(it, blocks.end());
+        size_class.alloc_index = 0;
+    }
 }
 
 } // namespace lithium::js
@@ -0,0 +1,871 @@
+/**
+ * JSON.parse / JSON.stringify
+ */
+
+#include "lithium/js/json.hpp"
+#include "lithium/js/object.hpp"
+#include "lithium/js/gc.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <typeinfo>
+#include <unordered_set>
+
+namespace lithium::js {
+
+namespace {
+
+constexpr usize MAX_GAP = 10;
+
+[[nodiscard]] bool is_json_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+[[nodiscard]] bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+[[nodiscard]] i32 hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void append_utf8(std::string& out, u32 cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+[[nodiscard]] String index_key(u32 index) {
+    char buf[16];
+    auto result = std::to_chars(buf, buf + sizeof(buf), index);
+    return String(buf, static_cast<usize>(result.ptr - buf));
+}
+
+// Date.prototype.toJSON: UTC "YYYY-MM-DDTHH:MM:SS.mmmZ", or null when invalid
+[[nodiscard]] Value date_to_json(f64 time) {
+    if (!std::isfinite(time)) {
+        return Value::null();
+    }
+    auto ms = static_cast<i64>(std::floor(time));
+    i64 days = ms / 86400000;
+    i64 ms_of_day = ms % 86400000;
+    if (ms_of_day < 0) {
+        ms_of_day += 86400000;
+        --days;
+    }
+
+    // Civil date from days since 1970-01-01 (proleptic Gregorian)
+    i64 z = days + 719468;
+    i64 era = (z >= 0 ? z : z - 146096) / 146097;
+    i64 doe = z - era * 146097;
+    i64 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    i64 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    i64 mp = (5 * doy + 2) / 153;
+    i64 day = doy - (153 * mp + 2) / 5 + 1;
+    i64 month = mp < 10 ? mp + 3 : mp - 9;
+    i64 year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+    char buf[40];
+    int len = std::snprintf(buf, sizeof(buf), "%04lld-%02lld-%02lldT%02lld:%02lld:%02lld.%03lldZ",
+                            static_cast<long long>(year), static_cast<long long>(month),
+                            static_cast<long long>(day), static_cast<long long>(ms_of_day / 3600000),
+                            static_cast<long long>(ms_of_day / 60000 % 60),
+                            static_cast<long long>(ms_of_day / 1000 % 60),
+                            static_cast<long long>(ms_of_day % 1000));
+    return Value(String(buf, static_cast<usize>(len)));
+}
+
+} // namespace
+
+// ============================================================================
+// Serialization helpers
+// ============================================================================
+
+void json_quote(std::string& out, std::string_view str) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    out += '"';
+    usize run_start = 0;
+    for (usize i = 0; i < str.size(); ++i) {
+        auto c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(str.data() + run_start, i - run_start);
+        run_start = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+                break;
+        }
+    }
+    out.append(str.data() + run_start, str.size() - run_start);
+    out += '"';
+}
+
+void json_append_number(std::string& out, f64 number) {
+    char buf[32];
+    if (number == 0.0) {
+        out += '0';  // Also -0
+        return;
+    }
+    if (std::abs(number) < 9007199254740992.0 && number == std::trunc(number)) {
+        auto result = std::to_chars(buf, buf + sizeof(buf), static_cast<i64>(number));
+        out.append(buf, result.ptr);
+        return;
+    }
+
+    // Shortest round-trip digits, then laid out as Number::toString does
+    if (number < 0) {
+        out += '-';
+        number = -number;
+    }
+    auto result = std::to_chars(buf, buf + sizeof(buf), number, std::chars_format::scientific);
+    std::string_view sci(buf, static_cast<usize>(result.ptr - buf));
+    usize e_pos = sci.find('e');
+    std::string digits;
+    digits += sci[0];
+    if (e_pos > 1) {
+        digits.append(sci.substr(2, e_pos - 2));
+    }
+    int exponent = 0;
+    std::from_chars(sci.data() + e_pos + (sci[e_pos + 1] == '+' ? 2 : 1), sci.data() + sci.size(), exponent);
+
+    int k = static_cast<int>(digits.size());
+    int n = exponent + 1;
+    if (k <= n && n <= 21) {
+        out += digits;
+        out.append(static_cast<usize>(n - k), '0');
+    } else if (0 < n && n <= 21) {
+        out.append(digits, 0, static_cast<usize>(n));
+        out += '.';
+        out.append(digits, static_cast<usize>(n));
+    } else if (-6 < n && n <= 0) {
+        out += "0.";
+        out.append(static_cast<usize>(-n), '0');
+        out += digits;
+    } else {
+        out += digits[0];
+        if (k > 1) {
+            out += '.';
+            out.append(digits, 1);
+        }
+        out += 'e';
+        out += n - 1 < 0 ? '-' : '+';
+        out += std::to_string(std::abs(n - 1));
+    }
+}
+
+// ============================================================================
+// JsonParser
+// ============================================================================
+
+struct JsonParser::Container {
+    Array* array{nullptr};      // Set for arrays
+    ShapePtr shape;             // Objects: layout built so far
+    std::vector<Value> slots;   // Objects: values in slot order
+    String key;                 // Objects: key of the value being parsed
+};
+
+JsonParser::JsonParser(GarbageCollector& gc, Object* object_prototype, Object* array_prototype)
+    : m_gc(gc)
+    , m_object_prototype(object_prototype)
+    , m_array_prototype(array_prototype) {
+}
+
+bool JsonParser::fail(const char* message) {
+    if (m_error.empty()) {
+        std::string text = message;
+        if (m_pos >= m_text.size()) {
+            text += " (unexpected end of JSON input)";
+        } else {
+            text += " at position " + std::to_string(m_pos);
+        }
+        m_error = String(std::move(text));
+    }
+    return false;
+}
+
+void JsonParser::skip_whitespace() {
+    while (m_pos < m_text.size() && is_json_whitespace(m_text[m_pos])) {
+        ++m_pos;
+    }
+}
+
+bool JsonParser::parse_literal(std::string_view word) {
+    if (m_text.substr(m_pos, word.size()) != word) {
+        return fail("Unexpected token in JSON");
+    }
+    m_pos += word.size();
+    return true;
+}
+
+bool JsonParser::parse_string(std::string_view& out) {
+    // m_text[m_pos] is the opening quote
+    usize start = ++m_pos;
+    while (m_pos < m_text.size()) {
+        auto c = static_cast<unsigned char>(m_text[m_pos]);
+        if (c == '"') {
+            out = m_text.substr(start, m_pos - start);
+            ++m_pos;
+            return true;
+        }
+        if (c == '\\') {
+            break;
+        }
+        if (c < 0x20) {
+            return fail("Bad control character in string literal in JSON");
+        }
+        ++m_pos;
+    }
+
+    // Slow path: the string has escapes
+    m_scratch.assign(m_text.data() + start, m_pos - start);
+    while (m_pos < m_text.size()) {
+        auto c = static_cast<unsigned char>(m_text[m_pos]);
+        if (c == '"') {
+            ++m_pos;
+            out = m_scratch;
+            return true;
+        }
+        if (c < 0x20) {
+            return fail("Bad control character in string literal in JSON");
+        }
+        if (c != '\\') {
+            m_scratch += static_cast<char>(c);
+            ++m_pos;
+            continue;
+        }
+        if (++m_pos >= m_text.size()) {
+            break;
+        }
+        char escape = m_text[m_pos++];
+        switch (escape) {
+            case '"': m_scratch += '"'; break;
+            case '\\': m_scratch += '\\'; break;
+            case '/': m_scratch += '/'; break;
+            case 'b': m_scratch += '\b'; break;
+            case 'f': m_scratch += '\f'; break;
+            case 'n': m_scratch += '\n'; break;
+            case 'r': m_scratch += '\r'; break;
+            case 't': m_scratch += '\t'; break;
+            case 'u': {
+                auto read_hex4 = [this](u32& unit) {
+                    if (m_pos + 4 > m_text.size()) {
+                        return false;
+                    }
+                    unit = 0;
+                    for (usize i = 0; i < 4; ++i) {
+                        i32 digit = hex_value(m_text[m_pos + i]);
+                        if (digit < 0) {
+                            return false;
+                        }
+                        unit = (unit << 4) | static_cast<u32>(digit);
+                    }
+                    m_pos += 4;
+                    return true;
+                };
+                u32 unit = 0;
+                if (!read_hex4(unit)) {
+                    return fail("Bad Unicode escape in JSON");
+                }
+                // Combine a surrogate pair; lone surrogates are kept as-is
+                if (unit >= 0xD800 && unit <= 0xDBFF && m_text.substr(m_pos, 2) == "\\u") {
+                    usize saved = m_pos;
+                    m_pos += 2;
+                    u32 low = 0;
+                    if (read_hex4(low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        m_pos = saved;
+                    }
+                }
+                append_utf8(m_scratch, unit);
+                break;
+            }
+            default:
+                --m_pos;
+                return fail("Bad escaped character in JSON");
+        }
+    }
+    return fail("Unterminated string in JSON");
+}
+
+bool JsonParser::parse_number(Value& out) {
+    usize start = m_pos;
+    bool negative = false;
+    if (m_text[m_pos] == '-') {
+        negative = true;
+        ++m_pos;
+    }
+    if (m_pos >= m_text.size() || !is_digit(m_text[m_pos])) {
+        return fail("No number after minus sign in JSON");
+    }
+
+    // Small integers skip the floating-point conversion entirely
+    i64 integer = 0;
+    usize int_start = m_pos;
+    if (m_text[m_pos] == '0') {
+        ++m_pos;
+    } else {
+        while (m_pos < m_text.size() && is_digit(m_text[m_pos])) {
+            integer = integer * 10 + (m_text[m_pos] - '0');
+            if (m_pos - int_start > 15) {
+                integer = 0;  // Too long for the fast path; from_chars handles it
+            }
+            ++m_pos;
+        }
+    }
+    usize int_digits = m_pos - int_start;
+
+    // Decimal position of the first significant digit, to tell overflow
+    // from underflow when from_chars reports the value out of range
+    bool zero_integer = m_text[int_start] == '0';
+    i64 magnitude = zero_integer ? 0 : static_cast<i64>(int_digits);
+
+    bool is_integer = true;
+    if (m_pos < m_text.size() && m_text[m_pos] == '.') {
+        is_integer = false;
+        ++m_pos;
+        if (m_pos >= m_text.size() || !is_digit(m_text[m_pos])) {
+            return fail("Unterminated fractional number in JSON");
+        }
+        bool leading_zeros = zero_integer;
+        while (m_pos < m_text.size() && is_digit(m_text[m_pos])) {
+            leading_zeros = leading_zeros && m_text[m_pos] == '0';
+            if (leading_zeros) {
+                --magnitude;
+            }
+            ++m_pos;
+        }
+    }
+    if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E')) {
+        is_integer = false;
+        ++m_pos;
+        bool negative_exponent = false;
+        if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-')) {
+            negative_exponent = m_text[m_pos] == '-';
+            ++m_pos;
+        }
+        if (m_pos >= m_text.size() || !is_digit(m_text[m_pos])) {
+            return fail("Exponent part is missing a number in JSON");
+        }
+        i64 exponent = 0;
+        while (m_pos < m_text.size() && is_digit(m_text[m_pos])) {
+            if (exponent < 100000) {
+                exponent = exponent * 10 + (m_text[m_pos] - '0');
+            }
+            ++m_pos;
+        }
+        magnitude += negative_exponent ? -exponent : exponent;
+    }
+
+    if (is_integer && int_digits <= 9 && !(negative && integer == 0)) {
+        out = Value(static_cast<i32>(negative ? -integer : integer));
+        return true;
+    }
+    f64 number = 0.0;
+    auto result = std::from_chars(m_text.data() + start, m_text.data() + m_pos, number);
+    if (result.ec == std::errc::result_out_of_range) {
+        // Beyond the range of a double: Infinity, or zero, keeping the sign
+        number = magnitude > 0 ? std::numeric_limits<f64>::infinity() : 0.0;
+        if (negative) {
+            number = -number;
+        }
+    }
+    out = Value(number);
+    return true;
+}
+
+bool JsonParser::parse_key(String& out) {
+    skip_whitespace();
+    if (m_pos >= m_text.size() || m_text[m_pos] != '"') {
+        return fail("Expected property name in JSON");
+    }
+    std::string_view key;
+    if (!parse_string(key)) {
+        return false;
+    }
+    bool in_input = key.data() >= m_text.data() && key.data() <= m_text.data() + m_text.size();
+    if (!in_input) {
+        out = String(key);  // Had escapes; the scratch buffer is reused
+    } else {
+        auto it = m_keys.find(key);
+        if (it == m_keys.end()) {
+            it = m_keys.emplace(key, String(key)).first;
+        }
+        out = it->second;
+    }
+    skip_whitespace();
+    if (m_pos >= m_text.size() || m_text[m_pos] != ':') {
+        return fail("Expected ':' after property name in JSON");
+    }
+    ++m_pos;
+    return true;
+}
+
+void JsonParser::add_property(Container& container, const String& key, Value value) {
+    // Same key set as the previous object built from this shape
+    auto it = m_transitions.find(container.shape.get());
+    if (it != m_transitions.end() && it->second.key == key) {
+        container.shape = it->second.to;
+        container.slots.push_back(std::move(value));
+        return;
+    }
+
+    // Duplicate key: the last occurrence wins
+    i32 slot = container.shape->find_slot(key);
+    if (slot >= 0) {
+        container.slots[static_cast<usize>(slot)] = std::move(value);
+        return;
+    }
+
+    ShapePtr next = container.shape->add_property(key);
+    m_transitions[container.shape.get()] = Transition{container.shape, key, next};
+    container.shape = std::move(next);
+    container.slots.push_back(std::move(value));
+}
+
+Value JsonParser::finish_object(Container& container) {
+    auto* object = m_gc.allocate<Object>();
+    object->set_prototype(m_object_prototype);
+    object->adopt_layout(std::move(container.shape), std::move(container.slots));
+    return Value(object);
+}
+
+JsonResult JsonParser::parse(std::string_view text) {
+    m_text = text;
+    m_pos = 0;
+    m_error = String();
+
+    std::vector<Container> stack;
+    Value value;
+    while (true) {
+        // Parse one value; containers only push a frame
+        skip_whitespace();
+        if (m_pos >= m_text.size()) {
+            fail("Unexpected end of JSON input");
+            break;
+        }
+        char c = m_text[m_pos];
+        bool ok = true;
+        if (c == '{') {
+            ++m_pos;
+            skip_whitespace();
+            if (m_pos < m_text.size() && m_text[m_pos] == '}') {
+                ++m_pos;
+                Container empty;
+                empty.shape = ShapeRegistry::instance().root_shape();
+                value = finish_object(empty);
+            } else {
+                Container container;
+                container.shape = ShapeRegistry::instance().root_shape();
+                if (!parse_key(container.key)) {
+                    break;
+                }
+                stack.push_back(std::move(container));
+                continue;
+            }
+        } else if (c == '[') {
+            ++m_pos;
+            auto* array = m_gc.allocate<Array>();
+            array->set_prototype(m_array_prototype);
+            skip_whitespace();
+            if (m_pos < m_text.size() && m_text[m_pos] == ']') {
+                ++m_pos;
+                value = Value(array);
+            } else {
+                Container container;
+                container.array = array;
+                stack.push_back(std::move(container));
+                continue;
+            }
+        } else if (c == '"') {
+            std::string_view str;
+            ok = parse_string(str);
+            value = Value::string_from(str);
+        } else if (c == '-' || is_digit(c)) {
+            ok = parse_number(value);
+        } else if (c == 't') {
+            ok = parse_literal("true");
+            value = Value(true);
+        } else if (c == 'f') {
+            ok = parse_literal("false");
+            value = Value(false);
+        } else if (c == 'n') {
+            ok = parse_literal("null");
+            value = Value::null();
+        } else {
+            ok = fail("Unexpected token in JSON");
+        }
+        if (!ok) {
+            break;
+        }
+
+        // Store the value into its container, closing finished containers
+        bool next_value = false;
+        while (!stack.empty()) {
+            Container& top = stack.back();
+            if (top.array) {
+                top.array->push(value);
+            } else {
+                add_property(top, top.key, std::move(value));
+            }
+            skip_whitespace();
+            if (m_pos >= m_text.size()) {
+                fail(top.array ? "Expected ',' or ']' after array element in JSON"
+                               : "Expected ',' or '}' after property value in JSON");
+                break;
+            }
+            char next = m_text[m_pos++];
+            if (next == ',') {
+                if (!top.array && !parse_key(top.key)) {
+                    break;
+                }
+                next_value = true;
+                break;
+            }
+            if (top.array && next == ']') {
+                value = Value(top.array);
+            } else if (!top.array && next == '}') {
+                value = finish_object(top);
+            } else {
+                --m_pos;
+                fail(top.array ? "Expected ',' or ']' after array element in JSON"
+                               : "Expected ',' or '}' after property value in JSON");
+                break;
+            }
+            stack.pop_back();
+        }
+        if (!m_error.empty()) {
+            break;
+        }
+        if (next_value) {
+            continue;
+        }
+
+        skip_whitespace();
+        if (m_pos < m_text.size()) {
+            fail("Unexpected non-whitespace character after JSON");
+            break;
+        }
+        return JsonResult{value, String()};
+    }
+    return JsonResult{Value::undefined(), m_error, ErrorType::SyntaxError};
+}
+
+Value JsonParser::internalize(Object* holder, const String& key, const Value& reviver,
+                              const JsonInvoker& invoke, usize depth) {
+    if (!m_error.empty()) {
+        return Value::undefined();
+    }
+    Value value = holder->get_property(key);
+    if (value.is_object() && !value.is_callable()) {
+        if (depth >= JSON_MAX_DEPTH) {
+            m_error = "Maximum nesting depth exceeded in JSON.parse reviver"_s;
+            return Value::undefined();
+        }
+        Object* object = value.as_object();
+        if (auto* array = dynamic_cast<Array*>(object)) {
+            for (usize i = 0; i < array->length(); ++i) {
+                auto index = static_cast<u32>(i);
+                Value element = internalize(array, index_key(index), reviver, invoke, depth + 1);
+                if (element.is_undefined()) {
+                    array->delete_element(index);
+                } else {
+                    array->set_element(index, element);
+                }
+            }
+        } else {
+            for (const auto& name : object->own_property_names()) {
+                Value element = internalize(object, name, reviver, invoke, depth + 1);
+                if (element.is_undefined()) {
+                    object->delete_property(name);
+                } else {
+                    object->set_property(name, element);
+                }
+            }
+        }
+    }
+    return invoke(reviver, Value(holder), {Value(key), value});
+}
+
+JsonResult JsonParser::revive(const Value& root, const Value& reviver, const JsonInvoker& invoke) {
+    auto* holder = m_gc.allocate<Object>();
+    holder->set_prototype(m_object_prototype);
+    holder->set_property(String(), root);
+    m_error = String();
+    Value result = internalize(holder, String(), reviver, invoke, 0);
+    if (!m_error.empty()) {
+        return JsonResult{Value::undefined(), m_error, ErrorType::RangeError};
+    }
+    return JsonResult{result, String()};
+}
+
+// ============================================================================
+// JsonStringifier
+// ============================================================================
+
+JsonStringifier::JsonStringifier(GarbageCollector& gc, Object* object_prototype, JsonInvoker invoke)
+    : m_gc(gc)
+    , m_object_prototype(object_prototype)
+    , m_invoke(std::move(invoke)) {
+}
+
+void JsonStringifier::set_replacer(const Value& replacer) {
+    if (replacer.is_callable()) {
+        m_replacer_function = replacer;
+        return;
+    }
+    auto* array = replacer.is_object() ? dynamic_cast<Array*>(replacer.as_object()) : nullptr;
+    if (!array) {
+        return;
+    }
+
+    // Allowlist of property names, in order, without duplicates
+    m_has_property_list = true;
+    std::unordered_set<std::string_view> seen;
+    m_property_list.reserve(array->length());
+    for (usize i = 0; i < array->length(); ++i) {
+        Value element = array->get_element(static_cast<u32>(i));
+        String name;
+        if (element.is_string()) {
+            name = element.as_string();
+        } else if (element.is_number()) {
+            std::string text;
+            json_append_number(text, element.as_number());
+            name = String(std::move(text));
+        } else {
+            continue;
+        }
+        m_property_list.push_back(std::move(name));
+    }
+    auto end = std::remove_if(m_property_list.begin(), m_property_list.end(), [&](const String& name) {
+        return !seen.insert(name.view()).second;
+    });
+    m_property_list.erase(end, m_property_list.end());
+}
+
+void JsonStringifier::set_space(const Value& space) {
+    if (space.is_number()) {
+        f64 count = std::min(static_cast<f64>(MAX_GAP), std::trunc(space.as_number()));
+        if (count >= 1.0) {
+            m_gap.assign(static_cast<usize>(count), ' ');
+        }
+    } else if (space.is_string()) {
+        std::string_view text = space.as_string().view();
+        m_gap.assign(text.substr(0, MAX_GAP));
+    }
+}
+
+bool JsonStringifier::enter(const Object* container) {
+    if (m_stack.size() >= JSON_MAX_DEPTH) {
+        m_error = "Maximum nesting depth exceeded in JSON.stringify"_s;
+        m_error_type = ErrorType::RangeError;
+        return false;
+    }
+    if (std::find(m_stack.begin(), m_stack.end(), container) != m_stack.end()) {
+        m_error = "Converting circular structure to JSON"_s;
+        m_error_type = ErrorType::TypeError;
+        return false;
+    }
+    m_stack.push_back(container);
+    return true;
+}
+
+void JsonStringifier::newline_and_indent() {
+    m_out += '\n';
+    m_out += m_indent;
+}
+
+JsonResult JsonStringifier::stringify(const Value& value) {
+    m_out.clear();
+    m_error = String();
+
+    // The wrapper {"": value} is only observable as `this` of the replacer
+    Value holder;
+    if (!m_replacer_function.is_undefined()) {
+        auto* wrapper = m_gc.allocate<Object>();
+        wrapper->set_prototype(m_object_prototype);
+        wrapper->set_property(String(), value);
+        holder = Value(wrapper);
+    }
+
+    String empty;
+    bool has_json = serialize_property(holder, &empty, 0, value);
+    if (!m_error.empty()) {
+        return JsonResult{Value::undefined(), m_error, m_error_type};
+    }
+    if (!has_json) {
+        return JsonResult{Value::undefined(), String()};
+    }
+    return JsonResult{Value(String(std::move(m_out))), String()};
+}
+
+bool JsonStringifier::serialize_property(const Value& holder, const String* name, u32 index, Value value) {
+    auto key = [&]() { return Value(name ? *name : index_key(index)); };
+
+    if (value.is_object()) {
+        Object* object = value.as_object();
+        static const String to_json_name = "toJSON"_s;
+        Value to_json = object->get_property(to_json_name);
+        if (to_json.is_callable()) {
+            value = m_invoke(to_json, value, {key()});
+        } else if (auto* date = dynamic_cast<DateObject*>(object)) {
+            value = date_to_json(date->time_value());
+        }
+    }
+    if (!m_replacer_function.is_undefined()) {
+        value = m_invoke(m_replacer_function, holder, {key(), value});
+    }
+
+    if (value.is_null()) {
+        m_out += "null";
+    } else if (value.is_boolean()) {
+        m_out += value.as_boolean() ? "true" : "false";
+    } else if (value.is_string()) {
+        json_quote(m_out, value.as_string().view());
+    } else if (value.is_number()) {
+        f64 number = value.as_number();
+        if (std::isfinite(number)) {
+            json_append_number(m_out, number);
+        } else {
+            m_out += "null";
+        }
+    } else if (value.is_object() && !value.is_callable()) {
+        Object* object = value.as_object();
+        if (object->is_array()) {
+            serialize_array(object);
+        } else {
+            serialize_object(object);
+        }
+    } else {
+        return false;  // undefined and functions
+    }
+    return true;
+}
+
+void JsonStringifier::serialize_object(Object* object) {
+    if (!enter(object)) {
+        return;
+    }
+    usize stepback = m_indent.size();
+    m_indent += m_gap;
+    m_out += '{';
+
+    Value holder(object);
+    bool any = false;
+    auto append_member = [&](const String& name, Value value) {
+        usize mark = m_out.size();
+        if (any) {
+            m_out += ',';
+        }
+        if (!m_gap.empty()) {
+            newline_and_indent();
+        }
+        json_quote(m_out, name.view());
+        m_out += ':';
+        if (!m_gap.empty()) {
+            m_out += ' ';
+        }
+        if (!serialize_property(holder, &name, 0, std::move(value))) {
+            m_out.resize(mark);
+            return;
+        }
+        any = true;
+    };
+
+    ShapePtr shape = object->shape();
+    if (!m_has_property_list && shape && typeid(*object) == typeid(Object) && !object->has_overflow_properties()) {
+        // Plain object: every own property is a slot of its shape
+        auto it = m_shape_keys.find(shape.get());
+        if (it == m_shape_keys.end()) {
+            auto names = shape->property_names();
+            it = m_shape_keys.emplace(shape.get(), ShapeKeys{shape, std::move(names)}).first;
+        }
+        const auto& names = it->second.names;
+        for (usize slot = 0; slot < names.size() && m_error.empty(); ++slot) {
+            append_member(names[slot], object->get_slot(static_cast<u32>(slot)));
+        }
+    } else {
+        std::vector<String> own_names;
+        if (!m_has_property_list) {
+            own_names = object->own_property_names();
+        }
+        const auto& names = m_has_property_list ? m_property_list : own_names;
+        for (usize i = 0; i < names.size() && m_error.empty(); ++i) {
+            append_member(names[i], object->get_property(names[i]));
+        }
+    }
+    if (!m_error.empty()) {
+        return;
+    }
+
+    m_indent.resize(stepback);
+    if (any && !m_gap.empty()) {
+        newline_and_indent();
+    }
+    m_out += '}';
+    m_stack.pop_back();
+}
+
+void JsonStringifier::serialize_array(Object* array) {
+    if (!enter(array)) {
+        return;
+    }
+    usize stepback = m_indent.size();
+    m_indent += m_gap;
+    m_out += '[';
+
+    Value holder(array);
+    auto* dense = dynamic_cast<Array*>(array);
+    auto length = dense ? static_cast<u32>(dense->length()) : array->get_property("length"_s).to_uint32();
+    for (u32 i = 0; i < length; ++i) {
+        if (i > 0) {
+            m_out += ',';
+        }
+        if (!m_gap.empty()) {
+            newline_and_indent();
+        }
+        if (!serialize_property(holder, nullptr, i, array->get_element(i))) {
+            m_out += "null";
+        }
+        if (!m_error.empty()) {
+            return;
+        }
+    }
+
+    m_indent.resize(stepback);
+    if (length > 0 && !m_gap.empty()) {
+        newline_and_indent();
+    }
+    m_out += ']';
+    m_stack.pop_back();
+}
+
+} // namespace lithium::js
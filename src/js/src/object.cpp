@@ -7,6 +7,7 @@
 #include "lithium/js/gc.hpp"
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <optional>
@@ -14,6 +15,31 @@
 
 namespace lithium::js {
 
+namespace {
+
+// Canonical array index ("0", "17", not "017" or "1e3"); no exceptions so
+// ordinary property names like "push" stay cheap
+[[nodiscard]] bool parse_array_index(const String& name, u32& index) {
+    std::string_view text = name.view();
+    if (text.empty() || (text.size() > 1 && text[0] == '0')) {
+        return false;
+    }
+    u64 value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<u64>(c - '0');
+        if (value >= 0xFFFFFFFFull) {
+            return false;
+        }
+    }
+    index = static_cast<u32>(value);
+    return true;
+}
+
+} // namespace
+
 // ============================================================================
 // Object - Shape-based implementation
 // ============================================================================
@@ -78,6 +104,7 @@ void Object::set_property(const String& name, const Value& value) {
                 m_slots.resize(slot + 1);
             }
             m_slots[slot] = value;
+            write_barrier(value);
             return;
         }
     }
@@ -92,12 +119,14 @@ void Object::set_property(const String& name, const Value& value) {
                 m_slots.resize(new_slot + 1);
             }
             m_slots[new_slot] = value;
+            write_barrier(value);
             return;
         }
     }
 
     // Fallback to overflow properties
     m_overflow_properties[name] = value;
+    write_barrier(value);
 }
 
 bool Object::delete_property(const String& name) {
@@ -153,6 +182,7 @@ void Object::set_property_cached(const String& name, const Value& value, InlineC
         if (cached_slot >= 0 && static_cast<usize>(cached_slot) < m_slots.size()) {
             // Cache hit - direct slot update
             m_slots[cached_slot] = value;
+            write_barrier(value);
             return;
         }
     }
@@ -182,6 +212,7 @@ void Object::set_slot(u32 slot, const Value& value) {
         m_slots.resize(slot + 1);
     }
     m_slots[slot] = value;
+    write_barrier(value);
 }
 
 bool Object::has_element(u32 index) const {
@@ -200,6 +231,14 @@ bool Object::delete_element(u32 index) {
     return delete_property(String(std::to_string(index)));
 }
 
+void Object::adopt_layout(ShapePtr shape, std::vector<Value> slots) {
+    m_shape = std::move(shape);
+    m_slots = std::move(slots);
+    for (const auto& value : m_slots) {
+        write_barrier(value);
+    }
+}
+
 std::vector<String> Object::own_property_names() const {
     std::vector<String> names;
 
@@ -228,10 +267,18 @@ void Object::trace(GarbageCollector& gc) {
     }
     // Mark prototype
     if (m_prototype) {
-        gc.mark_object(m_prototype.get());
+        gc.mark_object(m_prototype);
     }
 }
 
+usize Object::external_bytes() const {
+    // Hash nodes carry a key, a value and a next pointer
+    constexpr usize overflow_node = sizeof(String) + sizeof(Value) + sizeof(void*);
+    return m_slots.capacity() * sizeof(Value) +
+           m_overflow_properties.size() * overflow_node +
+           m_overflow_properties.bucket_count() * sizeof(void*);
+}
+
 // ============================================================================
 // NativeFunction
 // ============================================================================
@@ -278,6 +325,7 @@ void Array::set_length(usize len) {
 
 void Array::push(const Value& value) {
     m_elements.push_back(value);
+    write_barrier(value);
 }
 
 Value Array::pop() {
@@ -300,6 +348,7 @@ Value Array::shift() {
 
 void Array::unshift(const Value& value) {
     m_elements.insert(m_elements.begin(), value);
+    write_barrier(value);
 }
 
 bool Array::has_element(u32 index) const {
@@ -318,6 +367,7 @@ void Array::set_element(u32 index, const Value& value) {
         m_elements.resize(index + 1);
     }
     m_elements[index] = value;
+    write_barrier(value);
 }
 
 bool Array::delete_element(u32 index) {
@@ -333,12 +383,10 @@ Value Array::get_property(const String& name) const {
         return Value(static_cast<f64>(m_elements.size()));
     }
 
-    try {
-        usize index = std::stoull(std::string(name.data(), name.size()));
-        if (index < m_elements.size()) {
-            return m_elements[index];
-        }
-    } catch (...) {}
+    u32 index = 0;
+    if (parse_array_index(name, index) && index < m_elements.size()) {
+        return m_elements[index];
+    }
 
     return Object::get_property(name);
 }
@@ -352,11 +400,11 @@ void Array::set_property(const String& name, const Value& value) {
         return;
     }
 
-    try {
-        usize index = std::stoull(std::string(name.data(), name.size()));
-        set_element(static_cast<u32>(index), value);
+    u32 index = 0;
+    if (parse_array_index(name, index)) {
+        set_element(index, value);
         return;
-    } catch (...) {}
+    }
 
     Object::set_property(name, value);
 }
@@ -368,6 +416,10 @@ void Array::trace(GarbageCollector& gc) {
     }
 }
 
+usize Array::external_bytes() const {
+    return Object::external_bytes() + m_elements.capacity() * sizeof(Value);
+}
+
 // ============================================================================
 // DateObject
 // ============================================================================
@@ -411,7 +463,7 @@ String DateObject::string_value() const {
 MapObject::MapObject() = default;
 
 // SameValueZero equality check for Map/Set (like === but NaN === NaN)
-static bool same_value_zero(const Value& a, const Value& b) {
+bool same_value_zero(const Value& a, const Value& b) {
     // Handle NaN case (NaN should equal NaN in SameValueZero)
     if (a.is_number() && b.is_number()) {
         f64 a_num = a.to_number();
@@ -431,43 +483,61 @@ static bool same_value_zero(const Value& a, const Value& b) {
     return a.strict_equals(b);
 }
 
-std::optional<usize> MapObject::find_entry(const Value& key) const {
-    for (usize i = 0; i < m_entries.size(); ++i) {
-        if (same_value_zero(m_entries[i].key, key)) {
-            return i;
+// Hash consistent with same_value_zero
+u32 same_value_zero_hash(const Value& value) {
+    u64 bits = value.raw_bits();
+    if (value.is_number()) {
+        // Integer-tagged and double forms of a number must collide
+        f64 num = value.to_number();
+        if (std::isnan(num)) {
+            bits = QNAN_MASK;
+        } else {
+            if (num == 0.0) {
+                num = 0.0;  // -0 and +0 are the same key
+            }
+            std::memcpy(&bits, &num, sizeof(num));
+        }
+    } else if (value.is_string()) {
+        // FNV-1a over the contents
+        const String& str = value.as_string();
+        bits = 14695981039346656037ULL;
+        for (usize i = 0; i < str.size(); ++i) {
+            bits ^= static_cast<u8>(str.data()[i]);
+            bits *= 1099511628211ULL;
         }
     }
-    return std::nullopt;
+    // Finalizer (splitmix64) spreads pointer and double bits over the low word
+    bits ^= bits >> 30;
+    bits *= 0xBF58476D1CE4E5B9ULL;
+    bits ^= bits >> 27;
+    bits *= 0x94D049BB133111EBULL;
+    bits ^= bits >> 31;
+    return static_cast<u32>(bits);
 }
 
 void MapObject::set(const Value& key, const Value& value) {
-    auto idx = find_entry(key);
-    if (idx.has_value()) {
-        m_entries[idx.value()].value = value;
+    if (auto* entry = m_entries.find(key)) {
+        entry->value = value;
     } else {
-        m_entries.push_back({key, value});
+        m_entries.insert({key, value});
+        write_barrier(key);
     }
+    write_barrier(value);
 }
 
 Value MapObject::get(const Value& key) const {
-    auto idx = find_entry(key);
-    if (idx.has_value()) {
-        return m_entries[idx.value()].value;
+    if (const auto* entry = m_entries.find(key)) {
+        return entry->value;
     }
     return Value::undefined();
 }
 
 bool MapObject::has(const Value& key) const {
-    return find_entry(key).has_value();
+    return m_entries.find(key) != nullptr;
 }
 
 bool MapObject::remove(const Value& key) {
-    auto idx = find_entry(key);
-    if (idx.has_value()) {
-        m_entries.erase(m_entries.begin() + idx.value());
-        return true;
-    }
-    return false;
+    return m_entries.remove(key);
 }
 
 void MapObject::clear() {
@@ -476,10 +546,14 @@ void MapObject::clear() {
 
 void MapObject::trace(GarbageCollector& gc) {
     Object::trace(gc);
-    for (auto& entry : m_entries) {
+    m_entries.for_each_slot([&gc](Entry& entry) {
         gc.mark_value(entry.key);
         gc.mark_value(entry.value);
-    }
+    });
+}
+
+usize MapObject::external_bytes() const {
+    return Object::external_bytes() + m_entries.external_bytes();
 }
 
 bool MapObject::has_dynamic_property(const String& name) const {
@@ -499,32 +573,19 @@ Value MapObject::get_dynamic_property(const String& name) const {
 
 SetObject::SetObject() = default;
 
-std::optional<usize> SetObject::find_value(const Value& value) const {
-    for (usize i = 0; i < m_values.size(); ++i) {
-        if (same_value_zero(m_values[i], value)) {
-            return i;
-        }
-    }
-    return std::nullopt;
-}
-
 void SetObject::add(const Value& value) {
-    if (!find_value(value).has_value()) {
-        m_values.push_back(value);
+    if (!m_values.find(value)) {
+        m_values.insert(value);
+        write_barrier(value);
     }
 }
 
 bool SetObject::has(const Value& value) const {
-    return find_value(value).has_value();
+    return m_values.find(value) != nullptr;
 }
 
 bool SetObject::remove(const Value& value) {
-    auto idx = find_value(value);
-    if (idx.has_value()) {
-        m_values.erase(m_values.begin() + idx.value());
-        return true;
-    }
-    return false;
+    return m_values.remove(value);
 }
 
 void SetObject::clear() {
@@ -533,9 +594,13 @@ void SetObject::clear() {
 
 void SetObject::trace(GarbageCollector& gc) {
     Object::trace(gc);
-    for (auto& value : m_values) {
+    m_values.for_each_slot([&gc](Value& value) {
         gc.mark_value(value);
-    }
+    });
+}
+
+usize SetObject::external_bytes() const {
+    return Object::external_bytes() + m_values.external_bytes();
 }
 
 bool SetObject::has_dynamic_property(const String& name) const {
@@ -561,6 +626,8 @@ void WeakMapObject::set(const Value& key, const Value& value) {
         return;
     }
     m_entries[key.as_object()] = value;
+    write_barrier(key);
+    write_barrier(value);
 }
 
 Value WeakMapObject::get(const Value& key) const {
@@ -594,6 +661,22 @@ void WeakMapObject::trace(GarbageCollector& gc) {
     for (auto& [key, value] : m_entries) {
         gc.mark_value(value);
     }
+    gc.defer_weak_processing(this);
+}
+
+usize WeakMapObject::external_bytes() const {
+    constexpr usize node = sizeof(Object*) + sizeof(Value) + sizeof(void*);
+    return Object::external_bytes() + m_entries.size() * node + m_entries.bucket_count() * sizeof(void*);
+}
+
+void WeakMapObject::sweep_weak_references(GarbageCollector& gc) {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (gc.is_live(it->first)) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+        }
+    }
 }
 
 // ============================================================================
@@ -608,6 +691,7 @@ void WeakSetObject::add(const Value& value) {
         return;
     }
     m_values.insert(value.as_object());
+    write_barrier(value);
 }
 
 bool WeakSetObject::has(const Value& value) const {
@@ -627,6 +711,22 @@ bool WeakSetObject::remove(const Value& value) {
 void WeakSetObject::trace(GarbageCollector& gc) {
     Object::trace(gc);
     // No need to trace values (weak references)
+    gc.defer_weak_processing(this);
+}
+
+usize WeakSetObject::external_bytes() const {
+    constexpr usize node = sizeof(Object*) + sizeof(void*);
+    return Object::external_bytes() + m_values.size() * node + m_values.bucket_count() * sizeof(void*);
+}
+
+void WeakSetObject::sweep_weak_references(GarbageCollector& gc) {
+    for (auto it = m_values.begin(); it != m_values.end();) {
+        if (gc.is_live(*it)) {
+            ++it;
+        } else {
+            it = m_values.erase(it);
+        }
+    }
 }
 
 } // namespace lithium::js
@@ -26,6 +26,10 @@ StringInternPool& StringInternPool::instance() {
 }
 
 InternedString* StringInternPool::intern(const String& str) {
+    return intern(str.view());
+}
+
+InternedString* StringInternPool::intern(std::string_view str) {
     // Fast path for empty strings
     if (str.empty()) {
         static InternedString empty_string(""_s);
@@ -34,11 +38,8 @@ InternedString* StringInternPool::intern(const String& str) {
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    // Create a temporary for lookup
-    InternedString lookup_key(str);
-
     // Check if already interned
-    auto it = m_pool.find(&lookup_key);
+    auto it = m_pool.find(str);
     if (it != m_pool.end()) {
         // Found - increment ref count and return
         (*it)->ref_count.fetch_add(1, std::memory_order_relaxed);
@@ -46,7 +47,7 @@ InternedString* StringInternPool::intern(const String& str) {
     }
 
     // Not found - create new interned string
-    auto* interned = new InternedString(str);
+    auto* interned = new InternedString(String(str));
     m_pool.insert(interned);
     return interned;
 }
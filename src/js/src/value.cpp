@@ -58,6 +58,12 @@ Value::Value(const String& s) {
     m_bits = make_tagged_ptr(TAG_STRING, interned);
 }
 
+Value Value::string_from(std::string_view s) {
+    Value value;
+    value.m_bits = make_tagged_ptr(TAG_STRING, StringInternPool::instance().intern(s));
+    return value;
+}
+
 Value::Value(String* s) {
     // Use string interning for all strings
     auto* interned = StringInternPool::instance().intern(*s);
@@ -9,7 +9,9 @@
 
 #include "lithium/js/vm.hpp"
 #include "lithium/js/compiler.hpp"
+#include "lithium/js/json.hpp"
 #include "lithium/js/parser.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstdlib>
@@ -63,6 +65,11 @@ struct VMFunctionObject : public Object {
 
     [[nodiscard]] bool is_callable() const override { return true; }
 
+    void trace(GarbageCollector& gc) override {
+        Object::trace(gc);
+        gc.mark_holder(closure.get());
+    }
+
     std::shared_ptr<FunctionCode> function;
     std::shared_ptr<VM::Environment> closure;
 };
@@ -71,13 +78,13 @@ struct VMFunctionObject : public Object {
 // Environment
 // ============================================================================
 
-VM::Environment::Environment(std::shared_ptr<Environment> parent, std::shared_ptr<Object> global_object)
+VM::Environment::Environment(std::shared_ptr<Environment> parent, Object* global_object)
     : m_parent(std::move(parent))
 {
     if (m_parent) {
         m_global_object = m_parent->m_global_object;
     } else {
-        m_global_object = std::move(global_object);
+        m_global_object = global_object;
     }
 }
 
@@ -89,6 +96,38 @@ VM::Environment::Environment(std::shared_ptr<Environment> parent, Value with_obj
     }
 }
 
+void VM::Environment::mark_captured() {
+    for (auto* env = this; env && !env->m_captured; env = env->m_parent.get()) {
+        env->m_captured = true;
+        if (GarbageCollector::marking_barrier_active()) {
+            // Earlier stores bypassed the barrier, and once only a closure
+            // refers to this environment the final root scan will not see it
+            for (const auto& [name, binding] : env->m_values) {
+                env->note_store(binding.value);
+            }
+            for (const auto& local : env->m_locals) {
+                env->note_store(local);
+            }
+            if (env->m_with_object) {
+                env->note_store(env->m_with_object.value());
+            }
+        }
+    }
+}
+
+void VM::Environment::trace(GarbageCollector& gc) {
+    for (const auto& [name, binding] : m_values) {
+        gc.mark_value(binding.value);
+    }
+    for (const auto& local : m_locals) {
+        gc.mark_value(local);
+    }
+    if (m_with_object) {
+        gc.mark_value(m_with_object.value());
+    }
+    gc.mark_holder(m_parent.get());
+}
+
 void VM::Environment::bind_function(const std::shared_ptr<FunctionCode>& function) {
     m_function = function;
     if (m_function) {
@@ -116,6 +155,7 @@ bool VM::Environment::set_local(u16 slot, const Value& value) {
         return false;
     }
     m_locals[slot] = value;
+    note_store(value);
     if (m_is_global && m_global_object && m_function && slot < m_function->local_names.size()) {
         m_global_object->set_property(m_function->local_names[slot], value);
     }
@@ -133,6 +173,7 @@ void VM::Environment::define(const String& name, Value value, bool is_const) {
             return;
         }
     }
+    note_store(value);
     m_values[name] = Binding{std::move(value), is_const};
     if (m_is_global && m_global_object) {
         m_global_object->set_property(name, m_values[name].value);
@@ -158,6 +199,7 @@ bool VM::Environment::assign(const String& name, const Value& value) {
             return false;
         }
         it->second.value = value;
+        note_store(value);
         if (m_is_global && m_global_object) {
             m_global_object->set_property(name, value);
         }
@@ -365,20 +407,62 @@ void VM::init_builtins() {
     math->set_property("PI"_s, Value(3.141592653589793));
     install_global("Math"_s, Value(math), true);
 
-    // JSON object
+    // JSON object. Callbacks (reviver, replacer, toJSON) run synchronously
+    // inside the native, so they must be native functions themselves: there
+    // is no re-entrant path into the interpreter loop.
+    auto json_invoker = [](VM& vm) -> JsonInvoker {
+        return [&vm](const Value& function, const Value& this_value, const std::vector<Value>& args) -> Value {
+            Value callee = function;
+            Value receiver = this_value;
+            if (auto* bound = dynamic_cast<BoundFunction*>(callee.as_object())) {
+                receiver = bound->receiver();
+                callee = bound->target();
+            }
+            auto* native = callee.as_native_function();
+            if (!native) {
+                vm.runtime_error(ErrorType::TypeError, "JSON callbacks must be built-in functions"_s);
+            }
+            vm.m_this_stack.push_back(receiver);
+            Value result = native->call(vm, args);
+            vm.m_this_stack.pop_back();
+            return result;
+        };
+    };
+
     auto json = m_gc.allocate<Object>();
     json->set_prototype(m_object_prototype);
-    json->set_property("stringify"_s, make_fn("stringify"_s, [](VM&, const std::vector<Value>& args) -> Value {
-        if (args.empty() || args[0].is_undefined()) {
-            return Value("undefined"_s);
+    json->set_property("parse"_s, make_fn("parse"_s, [json_invoker](VM& vm, const std::vector<Value>& args) -> Value {
+        String text = args.empty() ? "undefined"_s : args[0].to_string();
+        JsonParser parser(vm.m_gc, vm.m_object_prototype, vm.m_array_prototype);
+        JsonResult result = parser.parse(text.view());
+        if (result.ok() && args.size() > 1 && args[1].is_callable()) {
+            result = parser.revive(result.value, args[1], json_invoker(vm));
         }
-        return args[0].to_string();
-    }, 1));
+        if (!result.ok()) {
+            vm.runtime_error(result.error_type, result.error);
+        }
+        return result.value;
+    }, 2));
+    json->set_property("stringify"_s, make_fn("stringify"_s, [json_invoker](VM& vm, const std::vector<Value>& args) -> Value {
+        JsonStringifier stringifier(vm.m_gc, vm.m_object_prototype, json_invoker(vm));
+        if (args.size() > 1) {
+            stringifier.set_replacer(args[1]);
+        }
+        if (args.size() > 2) {
+            stringifier.set_space(args[2]);
+        }
+        JsonResult result = stringifier.stringify(args.empty() ? Value::undefined() : args[0]);
+        if (!result.ok()) {
+            vm.runtime_error(result.error_type, result.error);
+        }
+        return result.value;
+    }, 3));
     install_global("JSON"_s, Value(json), true);
 
     // Date object (minimal - time value and basic stringification)
     auto date_proto = m_gc.allocate<DateObject>();
     date_proto->set_prototype(m_object_prototype);
+    m_builtin_roots.push_back(date_proto);
 
     auto date_ctor = make_fn("Date"_s, [this, date_proto](VM&, const std::vector<Value>& args) -> Value {
         f64 timestamp = args.empty() ? current_time_millis() : args[0].to_number();
@@ -426,6 +510,7 @@ void VM::init_builtins() {
     // Map constructor and prototype
     auto map_proto = m_gc.allocate<MapObject>();
     map_proto->set_prototype(m_object_prototype);
+    m_builtin_roots.push_back(map_proto);
 
     auto map_ctor = make_fn("Map"_s, [this, map_proto](VM&, const std::vector<Value>&) -> Value {
         auto map = m_gc.allocate<MapObject>();
@@ -482,6 +567,7 @@ void VM::init_builtins() {
     // Set constructor and prototype
     auto set_proto = m_gc.allocate<SetObject>();
     set_proto->set_prototype(m_object_prototype);
+    m_builtin_roots.push_back(set_proto);
 
     auto set_ctor = make_fn("Set"_s, [this, set_proto](VM&, const std::vector<Value>&) -> Value {
         auto set = m_gc.allocate<SetObject>();
@@ -530,6 +616,7 @@ void VM::init_builtins() {
     // WeakMap constructor and prototype
     auto weakmap_proto = m_gc.allocate<WeakMapObject>();
     weakmap_proto->set_prototype(m_object_prototype);
+    m_builtin_roots.push_back(weakmap_proto);
 
     auto weakmap_ctor = make_fn("WeakMap"_s, [this, weakmap_proto](VM&, const std::vector<Value>&) -> Value {
         auto weakmap = m_gc.allocate<WeakMapObject>();
@@ -575,6 +662,7 @@ void VM::init_builtins() {
     // WeakSet constructor and prototype
     auto weakset_proto = m_gc.allocate<WeakSetObject>();
     weakset_proto->set_prototype(m_object_prototype);
+    m_builtin_roots.push_back(weakset_proto);
 
     auto weakset_ctor = make_fn("WeakSet"_s, [this, weakset_proto](VM&, const std::vector<Value>&) -> Value {
         auto weakset = m_gc.allocate<WeakSetObject>();
@@ -713,7 +801,8 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
         static void* dispatch_table[] = {
             &&op_LoadConst, &&op_LoadNull, &&op_LoadUndefined, &&op_LoadTrue,
             &&op_LoadFalse, &&op_Pop, &&op_Dup, &&op_Dup2, &&op_DefineVar,
-            &&op_GetVar, &&op_SetVar, &&op_GetLocal, &&op_SetLocal, &&op_GetProp,
+            &&op_GetVar, &&op_SetVar, &&op_GetLocal, &&op_SetLocal, &&op_GetScoped,
+            &&op_SetScoped, &&op_GetGlobal, &&op_SetGlobal, &&op_GetProp,
             &&op_SetProp, &&op_GetElem, &&op_SetElem, &&op_GetPropIC, &&op_SetPropIC,
             &&op_Add, &&op_Subtract, &&op_Multiply, &&op_Divide, &&op_Modulo,
             &&op_Exponent, &&op_LeftShift, &&op_RightShift, &&op_UnsignedRightShift,
@@ -763,7 +852,7 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
             if (++gc_check_counter >= GC_CHECK_INTERVAL) { \
                 gc_check_counter = 0; \
                 if (m_gc.should_collect()) { \
-                    m_gc.collect(*this); \
+                    m_gc.collect_if_needed(*this); \
                 } \
             } \
             frame_ptr = &m_frames.back(); \
@@ -810,7 +899,7 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
             if (++gc_check_counter >= GC_CHECK_INTERVAL) {
                 gc_check_counter = 0;
                 if (m_gc.should_collect()) {
-                    m_gc.collect(*this);
+                    m_gc.collect_if_needed(*this);
                 }
             }
 
@@ -887,8 +976,12 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                 VM_CASE(GetLocal): {
                     u16 slot = frame.function->chunk.read_u16(frame.ip);
                     frame.ip += 2;
-                    // Fast path: direct array access (most common case)
-                    if (!frame.env->is_with_env()) {
+                    if (!frame.lexical_env) {
+                        // Register window on the VM stack
+                        Value local = m_stack[frame.locals_base + slot];
+                        VM_PUSH(local);
+                    } else if (!frame.env->is_with_env()) {
+                        // Fast path: direct array access (most common case)
                         VM_PUSH(VM_GET_LOCAL_FAST(slot));
                     } else {
                         // Slow path: with-env requires name lookup
@@ -905,8 +998,15 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                     u16 slot = frame.function->chunk.read_u16(frame.ip);
                     frame.ip += 2;
                     Value val = VM_POP();
-                    // Fast path: direct array access (most common case)
-                    if (!frame.env->is_with_env()) {
+                    if (!frame.lexical_env) {
+                        // Register window on the VM stack
+                        Value& local = m_stack[frame.locals_base + slot];
+                        if (frame.function->local_is_const[slot] && !local.is_undefined() && !val.is_undefined()) {
+                            runtime_error("Assignment to constant variable"_s);
+                        }
+                        local = val;
+                    } else if (!frame.env->is_with_env()) {
+                        // Fast path: direct array access (most common case)
                         // Check if the local is const before assigning (allow initial assignment)
                         bool is_const = slot < frame.lexical_env->m_local_is_const.size() &&
                                        frame.lexical_env->m_local_is_const[slot];
@@ -915,6 +1015,9 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                             runtime_error("Assignment to constant variable"_s);
                         }
                         VM_SET_LOCAL_FAST(slot, val);
+                        if (frame.lexical_env->m_captured) {
+                            GarbageCollector::write_barrier(*frame.lexical_env, val);
+                        }
                     } else {
                         // Slow path: with-env requires name lookup
                         const auto& name = frame.function->local_names[slot];
@@ -925,6 +1028,71 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                     VM_PUSH(val);
                     VM_NEXT();
                 }
+                VM_CASE(GetScoped): {
+                    u8 depth = frame.function->chunk.read(frame.ip++);
+                    u16 slot = frame.function->chunk.read_u16(frame.ip);
+                    frame.ip += 2;
+                    Environment* env = scoped_environment(frame, depth);
+                    VM_PUSH(env->m_locals[slot]);
+                    VM_NEXT();
+                }
+                VM_CASE(SetScoped): {
+                    u8 depth = frame.function->chunk.read(frame.ip++);
+                    u16 slot = frame.function->chunk.read_u16(frame.ip);
+                    frame.ip += 2;
+                    Environment* env = scoped_environment(frame, depth);
+                    Value val = VM_POP();
+                    if (!env->set_local(slot, val)) {
+                        runtime_error("Assignment to constant variable"_s);
+                    }
+                    VM_PUSH(val);
+                    VM_NEXT();
+                }
+                VM_CASE(GetGlobal): {
+                    u16 name_idx = frame.function->chunk.read_u16(frame.ip);
+                    u16 cache_slot = frame.function->chunk.read_u16(frame.ip + 2);
+                    frame.ip += 4;
+                    Binding*& cell = frame.function->global_cell_cache()[cache_slot];
+                    if (!cell) {
+                        auto name = read_constant(frame, name_idx).to_string();
+                        cell = global_cell(name);
+                        if (!cell) {
+                            // Script locals and names only on the global object stay uncached
+                            auto binding = m_global_env->get(name);
+                            if (!binding) {
+                                runtime_error(ErrorType::ReferenceError, name + " is not defined"_s);
+                            }
+                            VM_PUSH(binding->value);
+                            VM_NEXT();
+                        }
+                    }
+                    VM_PUSH(cell->value);
+                    VM_NEXT();
+                }
+                VM_CASE(SetGlobal): {
+                    u16 name_idx = frame.function->chunk.read_u16(frame.ip);
+                    u16 cache_slot = frame.function->chunk.read_u16(frame.ip + 2);
+                    frame.ip += 4;
+                    Binding*& cell = frame.function->global_cell_cache()[cache_slot];
+                    const String& name = frame.function->chunk.constants()[name_idx].as_string();
+                    Value val = VM_POP();
+                    if (!cell) {
+                        cell = global_cell(name);
+                    }
+                    if (cell) {
+                        // Script bindings live in their cell; like let/const they
+                        // are not reflected onto the global object
+                        if (cell->is_const && !cell->value.is_undefined()) {
+                            runtime_error("Assignment to undeclared or const variable: "_s + name);
+                        }
+                        cell->value = val;
+                        m_global_env->note_store(val);
+                    } else if (!m_global_env->assign(name, val)) {
+                        runtime_error("Assignment to undeclared or const variable: "_s + name);
+                    }
+                    VM_PUSH(val);
+                    VM_NEXT();
+                }
                 VM_CASE(GetProp): {
                     u16 name_idx = frame.function->chunk.read_u16(frame.ip);
                     frame.ip += 2;
@@ -1369,6 +1537,7 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                     if (func_idx >= m_module.functions.size()) {
                         runtime_error("Invalid function index"_s);
                     }
+                    frame.env->mark_captured();
                     auto fn_obj = m_gc.allocate<VMFunctionObject>(m_module.functions[func_idx], frame.env);
                     fn_obj->set_prototype(m_function_prototype);
                     auto proto_obj = m_gc.allocate<Object>();
@@ -1377,7 +1546,7 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                     fn_obj->set_property("prototype"_s, Value(proto_obj));
                     fn_obj->set_property("length"_s, Value(static_cast<f64>(fn_obj->function->params.size())));
                     fn_obj->set_property("name"_s, Value(fn_obj->function->name));
-                    push(Value(std::static_pointer_cast<Object>(fn_obj)));
+                    push(Value(fn_obj));
                     VM_NEXT();
                 }
                 VM_CASE(Call): {
@@ -1428,7 +1597,7 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                     if (callee.is_object()) {
                         Value proto_val = callee.as_object()->get_property("prototype"_s);
                         if (proto_val.is_object()) {
-                            new_obj->set_prototype(std::shared_ptr<Object>(proto_val.as_object(), [](Object*) {}));
+                            new_obj->set_prototype(proto_val.as_object());
                         }
                     }
                     Value receiver(new_obj);
@@ -1475,8 +1644,8 @@ VM::InterpretResult VM::interpret(const String& source, const String& filename)
                     if (!ret.is_object() && receiver.is_object()) {
                         ret = receiver;
                     }
-                    // Save current frame's stack_base before popping - this is where we should reset the stack to
-                    usize return_stack_base = frame.stack_base;
+                    // Save where the frame's stack region starts before popping - this is where we should reset the stack to
+                    usize return_stack_base = frame.locals_base;
                     m_frames.pop_back();
                     if (!m_this_stack.empty()) {
                         m_this_stack.pop_back();
@@ -1524,6 +1693,27 @@ void VM::call_function(VMFunctionObject* func_obj, usize arg_count, const Value&
         runtime_error("Attempted to call a non-function"_s);
     }
     auto fn = func_obj->function;
+
+    if (!fn->needs_environment) {
+        // Locals live in a register window on the VM stack, reusing the slots
+        // of the callee and its arguments: [callee, args...] -> [locals...]
+        usize locals_base = m_stack.size() - arg_count - 1;
+        usize passed = std::min<usize>(std::min<usize>(arg_count, fn->params.size()), fn->local_count);
+        for (usize i = 0; i < passed; ++i) {
+            m_stack[locals_base + i] = m_stack[locals_base + 1 + i];
+        }
+        usize window_end = std::min(m_stack.size(), locals_base + fn->local_count);
+        for (usize i = locals_base + passed; i < window_end; ++i) {
+            m_stack[i] = Value::undefined();
+        }
+        m_stack.resize(locals_base + fn->local_count);
+
+        m_this_stack.push_back(receiver);
+        m_frames.push_back(CallFrame{fn, func_obj->closure, nullptr, 0, m_stack.size(), receiver, {}, locals_base});
+        m_frames.back().init_ic_cache();
+        return;
+    }
+
     auto env = std::make_shared<Environment>(func_obj->closure);
     env->bind_function(fn);
 
@@ -1537,7 +1727,7 @@ void VM::call_function(VMFunctionObject* func_obj, usize arg_count, const Value&
     }
 
     m_this_stack.push_back(receiver);
-    m_frames.push_back(CallFrame{fn, env, env, 0, m_stack.size(), receiver, {}});
+    m_frames.push_back(CallFrame{fn, env, env, 0, m_stack.size(), receiver, {}, m_stack.size()});
     m_frames.back().init_ic_cache();
 }
 
@@ -1593,6 +1783,20 @@ void VM::exit_with_env() {
     }
 }
 
+VM::Environment* VM::scoped_environment(const CallFrame& frame, u8 depth) const {
+    // Depth 0 is the environment the running closure was created in
+    Environment* env = frame.lexical_env ? frame.lexical_env->m_parent.get() : frame.env.get();
+    for (u8 i = 0; i < depth; ++i) {
+        env = env->m_parent.get();
+    }
+    return env;
+}
+
+VM::Binding* VM::global_cell(const String& name) {
+    auto it = m_global_env->m_values.find(name);
+    return it != m_global_env->m_values.end() ? &it->second : nullptr;
+}
+
 Value VM::current_this() const {
     if (m_this_stack.empty()) {
         return Value::undefined();
@@ -1686,41 +1890,13 @@ void VM::mark_roots(GarbageCollector& gc) {
         // Mark receiver
         gc.mark_value(frame.receiver);
 
-        // Mark environment (which will mark locals and parent environments)
-        if (frame.env) {
-            // Mark all local variables
-            for (const auto& [name, binding] : frame.env->m_values) {
-                gc.mark_value(binding.value);
-            }
-            for (const auto& local : frame.env->m_locals) {
-                gc.mark_value(local);
-            }
-            // Mark with-object if present
-            if (frame.env->m_with_object) {
-                gc.mark_value(frame.env->m_with_object.value());
-            }
-        }
-
-        // Mark lexical environment
-        if (frame.lexical_env && frame.lexical_env != frame.env) {
-            for (const auto& [name, binding] : frame.lexical_env->m_values) {
-                gc.mark_value(binding.value);
-            }
-            for (const auto& local : frame.lexical_env->m_locals) {
-                gc.mark_value(local);
-            }
-        }
+        // Mark environments (locals, with-objects and the whole parent chain)
+        gc.mark_holder(frame.env.get());
+        gc.mark_holder(frame.lexical_env.get());
     }
 
     // Mark global environment
-    if (m_global_env) {
-        for (const auto& [name, binding] : m_global_env->m_values) {
-            gc.mark_value(binding.value);
-        }
-        for (const auto& local : m_global_env->m_locals) {
-            gc.mark_value(local);
-        }
-    }
+    gc.mark_holder(m_global_env.get());
 
     // Mark this stack
     for (const auto& value : m_this_stack) {
@@ -1728,17 +1904,12 @@ void VM::mark_roots(GarbageCollector& gc) {
     }
 
     // Mark global objects
-    if (m_global_object) {
-        gc.mark_object(m_global_object.get());
-    }
-    if (m_object_prototype) {
-        gc.mark_object(m_object_prototype.get());
-    }
-    if (m_function_prototype) {
-        gc.mark_object(m_function_prototype.get());
-    }
-    if (m_array_prototype) {
-        gc.mark_object(m_array_prototype.get());
+    gc.mark_object(m_global_object);
+    gc.mark_object(m_object_prototype);
+    gc.mark_object(m_function_prototype);
+    gc.mark_object(m_array_prototype);
+    for (auto* obj : m_builtin_roots) {
+        gc.mark_object(obj);
     }
 
     // Mark last value
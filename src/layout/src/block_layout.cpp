@@ -37,7 +37,7 @@ f32 computed_font_size_for(const LayoutBox& box, const LayoutContext& context) {
     while (current) {
         const auto& style = current->style();
         // Compute this element's font size based on its parent
-        f32 current_font_size = static_cast<f32>(style.font_size.to_px(
+        f32 current_font_size = static_cast<f32>(style.font().font_size.to_px(
             parent_font_size,  // Use parent's font size for em units
             context.root_font_size,
             context.viewport_width,
@@ -48,7 +48,7 @@ f32 computed_font_size_for(const LayoutBox& box, const LayoutContext& context) {
 
     // Now compute the target element's font size
     const auto& style = box.style();
-    return static_cast<f32>(style.font_size.to_px(
+    return static_cast<f32>(style.font().font_size.to_px(
         parent_font_size,  // Use computed parent font size
         context.root_font_size,
         context.viewport_width,
@@ -145,16 +145,16 @@ void BlockFormattingContext::calculate_width(LayoutBox& box) {
     f32 font_size_px = computed_font_size_for(box, m_context);
 
     // For margins/paddings/borders: use font_size as reference for em units
-    f32 margin_left = resolve_length_with_font(style.margin_left, containing_width, font_size_px);
-    f32 margin_right = resolve_length_with_font(style.margin_right, containing_width, font_size_px);
-    f32 padding_left = resolve_length_with_font(style.padding_left, containing_width, font_size_px);
-    f32 padding_right = resolve_length_with_font(style.padding_right, containing_width, font_size_px);
-    f32 border_left = resolve_length_with_font(style.border_left_width, containing_width, font_size_px);
-    f32 border_right = resolve_length_with_font(style.border_right_width, containing_width, font_size_px);
-
-    f32 used_width = !style.width.has_value()
+    f32 margin_left = resolve_length_with_font(style.box().margin_left, containing_width, font_size_px);
+    f32 margin_right = resolve_length_with_font(style.box().margin_right, containing_width, font_size_px);
+    f32 padding_left = resolve_length_with_font(style.box().padding_left, containing_width, font_size_px);
+    f32 padding_right = resolve_length_with_font(style.box().padding_right, containing_width, font_size_px);
+    f32 border_left = resolve_length_with_font(style.border().border_left_width, containing_width, font_size_px);
+    f32 border_right = resolve_length_with_font(style.border().border_right_width, containing_width, font_size_px);
+
+    f32 used_width = !style.box().width.has_value()
         ? containing_width - margin_left - margin_right - padding_left - padding_right - border_left - border_right
-        : resolve_length_with_font(*style.width, containing_width, font_size_px);
+        : resolve_length_with_font(*style.box().width, containing_width, font_size_px);
 
     if (used_width < 0) {
         used_width = 0;
@@ -169,12 +169,12 @@ void BlockFormattingContext::calculate_width(LayoutBox& box) {
     d.content.width = used_width;
 
     // Also set top and bottom margins (using font size for em units)
-    d.margin.top = resolve_length_with_font(style.margin_top, containing_width, font_size_px);
-    d.margin.bottom = resolve_length_with_font(style.margin_bottom, containing_width, font_size_px);
-    d.padding.top = resolve_length_with_font(style.padding_top, containing_width, font_size_px);
-    d.padding.bottom = resolve_length_with_font(style.padding_bottom, containing_width, font_size_px);
-    d.border.top = resolve_length_with_font(style.border_top_width, containing_width, font_size_px);
-    d.border.bottom = resolve_length_with_font(style.border_bottom_width, containing_width, font_size_px);
+    d.margin.top = resolve_length_with_font(style.box().margin_top, containing_width, font_size_px);
+    d.margin.bottom = resolve_length_with_font(style.box().margin_bottom, containing_width, font_size_px);
+    d.padding.top = resolve_length_with_font(style.box().padding_top, containing_width, font_size_px);
+    d.padding.bottom = resolve_length_with_font(style.box().padding_bottom, containing_width, font_size_px);
+    d.border.top = resolve_length_with_font(style.border().border_top_width, containing_width, font_size_px);
+    d.border.bottom = resolve_length_with_font(style.border().border_bottom_width, containing_width, font_size_px);
 
     if (auto* el = dynamic_cast<dom::Element*>(box.node())) {
         std::cout << "  calculate_width '" << el->tag_name().c_str()
@@ -196,12 +196,12 @@ void BlockFormattingContext::calculate_position(LayoutBox& box) {
     // Get the element's computed font size in pixels for resolving em units
     f32 font_size_px = computed_font_size_for(box, m_context);
 
-    d.margin.top = resolve_length_with_font(style.margin_top, containing_width, font_size_px);
-    d.margin.bottom = resolve_length_with_font(style.margin_bottom, containing_width, font_size_px);
-    d.padding.top = resolve_length_with_font(style.padding_top, containing_width, font_size_px);
-    d.padding.bottom = resolve_length_with_font(style.padding_bottom, containing_width, font_size_px);
-    d.border.top = resolve_length_with_font(style.border_top_width, containing_width, font_size_px);
-    d.border.bottom = resolve_length_with_font(style.border_bottom_width, containing_width, font_size_px);
+    d.margin.top = resolve_length_with_font(style.box().margin_top, containing_width, font_size_px);
+    d.margin.bottom = resolve_length_with_font(style.box().margin_bottom, containing_width, font_size_px);
+    d.padding.top = resolve_length_with_font(style.box().padding_top, containing_width, font_size_px);
+    d.padding.bottom = resolve_length_with_font(style.box().padding_bottom, containing_width, font_size_px);
+    d.border.top = resolve_length_with_font(style.border().border_top_width, containing_width, font_size_px);
+    d.border.bottom = resolve_length_with_font(style.border().border_bottom_width, containing_width, font_size_px);
 
     // Calculate X position (horizontal)
     if (box.parent()) {
@@ -219,8 +219,8 @@ void BlockFormattingContext::calculate_height(LayoutBox& box) {
     auto& d = box.dimensions();
     const auto& style = box.style();
 
-    if (style.height.has_value()) {
-        d.content.height = resolve_length(*style.height, d.content.height);
+    if (style.box().height.has_value()) {
+        d.content.height = resolve_length(*style.box().height, d.content.height);
         return;
     }
 
@@ -300,7 +300,7 @@ f32 BlockFormattingContext::layout_inline_sequence(LayoutBox& container, const s
     for (auto* child : inline_children) {
         if (child->is_text()) {
             const auto& style = child->style();
-            f32 font_px = static_cast<f32>(style.font_size.to_px(
+            f32 font_px = static_cast<f32>(style.font().font_size.to_px(
                 m_context.root_font_size,
                 m_context.root_font_size,
                 m_context.viewport_width,
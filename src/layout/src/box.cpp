@@ -166,7 +166,7 @@ std::unique_ptr<LayoutBox> LayoutTreeBuilder::build_element_box(
     css::ComputedValue computed = resolver.resolve(element);
 
     // Check display property
-    if (computed.display == css::Display::None) {
+    if (computed.box().display == css::Display::None) {
         std::cout << "build_element_box: element '" << element.tag_name().c_str() << "' has display:none" << std::endl;
         return nullptr;
     }
@@ -227,7 +227,7 @@ std::unique_ptr<LayoutBox> LayoutTreeBuilder::build_text_box(
 }
 
 BoxType LayoutTreeBuilder::determine_box_type(const css::ComputedValue& style) {
-    switch (style.display) {
+    switch (style.box().display) {
         case css::Display::Block:
             return BoxType::Block;
         case css::Display::Inline:
@@ -27,7 +27,7 @@ f32 computed_font_size_for(const LayoutBox& box, const LayoutContext& context) {
     const LayoutBox* current = box.parent();
     while (current) {
         const auto& style = current->style();
-        f32 current_font_size = static_cast<f32>(style.font_size.to_px(
+        f32 current_font_size = static_cast<f32>(style.font().font_size.to_px(
             parent_font_size,
             context.root_font_size,
             context.viewport_width,
@@ -38,7 +38,7 @@ f32 computed_font_size_for(const LayoutBox& box, const LayoutContext& context) {
 
     // Now compute the target element's font size
     const auto& style = box.style();
-    return static_cast<f32>(style.font_size.to_px(
+    return static_cast<f32>(style.font().font_size.to_px(
         parent_font_size,
         context.root_font_size,
         context.viewport_width,
@@ -154,11 +154,11 @@ void InlineFormattingContext::break_lines(std::vector<LayoutBox*>& boxes) {
                 if (m_context.font_backend) {
                     beryl::FontDescription desc;
                     desc.size = font_px;
-                    desc.family = box->style().font_family.empty() ? String("sans-serif") : box->style().font_family[0];
-                    desc.weight = (box->style().font_weight == css::FontWeight::Bold ||
-                                  box->style().font_weight == css::FontWeight::W700)
+                    desc.family = box->style().font().font_family.empty() ? String("sans-serif") : box->style().font().font_family[0];
+                    desc.weight = (box->style().font().font_weight == css::FontWeight::Bold ||
+                                  box->style().font().font_weight == css::FontWeight::W700)
                         ? beryl::FontWeight::Bold : beryl::FontWeight::Normal;
-                    desc.style = (box->style().font_style == css::FontStyle::Italic)
+                    desc.style = (box->style().font().font_style == css::FontStyle::Italic)
                         ? beryl::FontStyle::Italic : beryl::FontStyle::Normal;
 
                     if (auto font = m_context.font_backend->get_system_font(desc)) {
@@ -223,11 +223,11 @@ f32 InlineFormattingContext::measure_text(const String& text, const LayoutBox& b
     if (m_context.font_backend) {
         beryl::FontDescription desc;
         desc.size = font_px;
-        desc.family = box.style().font_family.empty() ? String("sans-serif") : box.style().font_family[0];
-        desc.weight = (box.style().font_weight == css::FontWeight::Bold ||
-                      box.style().font_weight == css::FontWeight::W700)
+        desc.family = box.style().font().font_family.empty() ? String("sans-serif") : box.style().font().font_family[0];
+        desc.weight = (box.style().font().font_weight == css::FontWeight::Bold ||
+                      box.style().font().font_weight == css::FontWeight::W700)
             ? beryl::FontWeight::Bold : beryl::FontWeight::Normal;
-        desc.style = (box.style().font_style == css::FontStyle::Italic)
+        desc.style = (box.style().font().font_style == css::FontStyle::Italic)
             ? beryl::FontStyle::Italic : beryl::FontStyle::Normal;
 
         if (auto font = m_context.font_backend->get_system_font(desc)) {
@@ -242,7 +242,7 @@ f32 InlineFormattingContext::measure_text(const String& text, const LayoutBox& b
 f32 InlineFormattingContext::calculate_line_height(const LayoutBox& box) {
     f32 font_px = computed_font_size_for(box, m_context);
     const auto& style = box.style();
-    f32 lh = to_pixels(style.line_height, m_context, font_px);
+    f32 lh = to_pixels(style.font().line_height, m_context, font_px);
     if (lh <= 0) {
         lh = font_px * 1.2f;
     }
@@ -269,18 +269,18 @@ f32 measure_inline_width(LayoutBox& box, const LayoutContext& context) {
     }
 
     const auto& style = box.style();
-    f32 font_px = to_pixels(style.font_size, context, context.root_font_size);
+    f32 font_px = to_pixels(style.font().font_size, context, context.root_font_size);
 
     if (box.is_text()) {
         // Try to use font context for accurate measurement
         if (context.font_backend) {
             beryl::FontDescription desc;
             desc.size = font_px;
-            desc.family = style.font_family.empty() ? String("sans-serif") : style.font_family[0];
-            desc.weight = (style.font_weight == css::FontWeight::Bold ||
-                          style.font_weight == css::FontWeight::W700)
+            desc.family = style.font().font_family.empty() ? String("sans-serif") : style.font().font_family[0];
+            desc.weight = (style.font().font_weight == css::FontWeight::Bold ||
+                          style.font().font_weight == css::FontWeight::W700)
                 ? beryl::FontWeight::Bold : beryl::FontWeight::Normal;
-            desc.style = (style.font_style == css::FontStyle::Italic)
+            desc.style = (style.font().font_style == css::FontStyle::Italic)
                 ? beryl::FontStyle::Italic : beryl::FontStyle::Normal;
 
             if (auto font = context.font_backend->get_system_font(desc)) {
@@ -303,7 +303,7 @@ std::vector<BreakOpportunity> find_break_opportunities(const String& text, const
     std::vector<BreakOpportunity> breaks;
     f32 accumulated_width = 0;
     f32 char_width = static_cast<f32>(text.size()) > 0
-        ? (to_pixels(style.font_size, LayoutContext{}, 16.0f) * 0.6f)
+        ? (to_pixels(style.font().font_size, LayoutContext{}, 16.0f) * 0.6f)
         : 0.0f;
 
     for (usize i = 0; i < text.size(); ++i) {
@@ -24,7 +24,7 @@ f32 computed_font_size_for(const LayoutBox& box, const LayoutContext& context) {
     while (current) {
         const auto& style = current->style();
         // Compute this element's font size based on its parent
-        f32 current_font_size = static_cast<f32>(style.font_size.to_px(
+        f32 current_font_size = static_cast<f32>(style.font().font_size.to_px(
             parent_font_size,  // Use parent's font size for em units
             context.root_font_size,
             context.viewport_width,
@@ -35,7 +35,7 @@ f32 computed_font_size_for(const LayoutBox& box, const LayoutContext& context) {
 
     // Now compute the target element's font size
     const auto& style = box.style();
-    return static_cast<f32>(style.font_size.to_px(
+    return static_cast<f32>(style.font().font_size.to_px(
         parent_font_size,  // Use computed parent font size
         context.root_font_size,
         context.viewport_width,
@@ -34,10 +34,10 @@ int main() {
 
         if (is_start_tag(*token)) {
             auto& tag = std::get<TagToken>(*token);
-            std::cout << "Start tag: " << tag.name.data() << std::endl;
+            std::cout << "Start tag: " << tag.name.view() << std::endl;
         } else if (is_end_tag(*token)) {
             auto& tag = std::get<TagToken>(*token);
-            std::cout << "End tag: " << tag.name.data() << std::endl;
+            std::cout << "End tag: " << tag.name.view() << std::endl;
         } else if (is_character(*token)) {
             auto& char_token = std::get<CharacterToken>(*token);
             // Skip whitespace for readability
@@ -50,6 +50,8 @@ int main() {
         } else if (is_doctype(*token)) {
             auto& doctype = std::get<DoctypeToken>(*token);
             std::cout << "DOCTYPE: " << doctype.name.data() << std::endl;
+        } else if (is_character_run(*token)) {
+            std::cout << "Text: " << std::get<CharacterRunToken>(*token).text << std::endl;
         } else if (is_eof(*token)) {
             std::cout << "End of file" << std::endl;
             break;
@@ -78,13 +80,15 @@ int main() {
 
         if (is_start_tag(*token)) {
             auto& tag = std::get<TagToken>(*token);
-            std::cout << "Start tag: " << tag.name.data() << std::endl;
+            std::cout << "Start tag: " << tag.name.view() << std::endl;
         } else if (is_end_tag(*token)) {
             auto& tag = std::get<TagToken>(*token);
-            std::cout << "End tag: " << tag.name.data() << std::endl;
+            std::cout << "End tag: " << tag.name.view() << std::endl;
         } else if (is_character(*token)) {
             auto& char_token = std::get<CharacterToken>(*token);
             std::cout << "Character: " << static_cast<char>(char_token.code_point) << std::endl;
+        } else if (is_character_run(*token)) {
+            std::cout << "Text: " << std::get<CharacterRunToken>(*token).text << std::endl;
         } else if (is_eof(*token)) {
             std::cout << "End of file" << std::endl;
             break;
@@ -110,13 +114,15 @@ int main() {
 
         if (is_start_tag(*token)) {
             auto& tag = std::get<TagToken>(*token);
-            std::cout << "Start tag: " << tag.name.data() << std::endl;
+            std::cout << "Start tag: " << tag.name.view() << std::endl;
         } else if (is_end_tag(*token)) {
             auto& tag = std::get<TagToken>(*token);
-            std::cout << "End tag: " << tag.name.data() << std::endl;
+            std::cout << "End tag: " << tag.name.view() << std::endl;
         } else if (is_character(*token)) {
             auto& char_token = std::get<CharacterToken>(*token);
             std::cout << "Character: " << static_cast<char>(char_token.code_point) << " (U+" << static_cast<int>(char_token.code_point) << ")" << std::endl;
+        } else if (is_character_run(*token)) {
+            std::cout << "Text: " << std::get<CharacterRunToken>(*token).text << std::endl;
         } else if (is_eof(*token)) {
             std::cout << "End of file" << std::endl;
             break;
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "lithium/core/atom.hpp"
+#include <thread>
+#include <vector>
+
+using namespace lithium;
+
+// ============================================================================
+// Atom Tests
+// ============================================================================
+
+TEST(AtomTest, StaticNamesResolveToTheirConstants) {
+    EXPECT_EQ(Atom("div"), atoms::div);
+    EXPECT_EQ(Atom("class"_s), atoms::class_);
+    EXPECT_EQ(Atom("foreignObject"), atoms::foreignObject);
+    EXPECT_NE(Atom("foreignobject"), atoms::foreignObject);
+    EXPECT_EQ(Atom("xlink:href"), atoms::xlink_href);
+
+    EXPECT_TRUE(atoms::div.is_static());
+    EXPECT_EQ(atoms::div.id(), static_cast<u32>(AtomId::div));
+    EXPECT_EQ(atoms::div.view(), "div");
+    EXPECT_EQ(atoms::http_equiv.string(), "http-equiv"_s);
+
+    Atom empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, Atom(""));
+    EXPECT_EQ(empty.id(), 0u);
+}
+
+TEST(AtomTest, UnknownNamesAreInternedOnce) {
+    EXPECT_FALSE(Atom::find("x-atom-test-widget"));
+
+    Atom first("x-atom-test-widget");
+    Atom second(String("x-atom-test-widget"));
+    EXPECT_EQ(first, second);
+    EXPECT_FALSE(first.is_static());
+    EXPECT_GE(first.id(), static_cast<u32>(AtomId::StaticCount));
+    EXPECT_EQ(first.view(), "x-atom-test-widget");
+    EXPECT_EQ(std::hash<Atom>{}(first), std::hash<Atom>{}(second));
+
+    auto found = Atom::find("x-atom-test-widget");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(*found, first);
+    EXPECT_NE(first, Atom("x-atom-test-widget-2"));
+}
+
+TEST(AtomTest, ConcurrentInterningAgrees) {
+    constexpr int THREADS = 4;
+    std::vector<std::vector<Atom>> results(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&results, t] {
+            for (int i = 0; i < 200; ++i) {
+                auto name = "x-concurrent-" + std::to_string(i);
+                results[static_cast<usize>(t)].emplace_back(std::string_view(name));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 1; t < THREADS; ++t) {
+        EXPECT_EQ(results[static_cast<usize>(t)], results[0]);
+    }
+}
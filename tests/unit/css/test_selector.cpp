@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "lithium/css/selector.hpp"
+#include "lithium/dom/document.hpp"
 
 using namespace lithium;
 using namespace lithium::css;
@@ -8,3 +9,110 @@ using namespace lithium::css;
 TEST(CSSSelectorTest, Placeholder) {
     EXPECT_TRUE(true);
 }
+
+namespace {
+
+ComplexSelector parse_selector(const char* text) {
+    auto list = SelectorList::parse(String(text));
+    EXPECT_EQ(list.selectors.size(), 1u) << text;
+    return list.selectors.empty() ? ComplexSelector{} : list.selectors.front();
+}
+
+class SelectorMatchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        document = make_ref<dom::Document>();
+        root = document->create_element("html"_s);
+        document->append_child(root);
+    }
+
+    RefPtr<dom::Element> element(const char* tag, std::initializer_list<std::pair<const char*, const char*>> attributes,
+                                 dom::Element* parent) {
+        auto created = document->create_element(String(tag));
+        for (const auto& [name, value] : attributes) {
+            created->set_attribute(String(name), String(value));
+        }
+        parent->append_child(created);
+        return created;
+    }
+
+    RefPtr<dom::Document> document;
+    RefPtr<dom::Element> root;
+};
+
+} // namespace
+
+TEST(CSSSelectorTest, CompilesSubjectCompoundFirst) {
+    using Op = CompiledSelector::Op;
+    auto selector = parse_selector("DIV.a > .b + p:first-child");
+    ASSERT_FALSE(selector.compiled.empty());
+
+    std::vector<Op> ops;
+    for (const auto& instruction : selector.compiled.code()) {
+        ops.push_back(instruction.op);
+    }
+    EXPECT_EQ(ops, (std::vector<Op>{Op::Tag, Op::FirstChild, Op::NextSibling, Op::Class, Op::Child, Op::Tag,
+                                    Op::Class, Op::Match}));
+}
+
+TEST_F(SelectorMatchTest, CompiledSelectorsMatchLikeTheirParts) {
+    auto list = element("ul", {{"class", "list  main"}, {"data-Kind", "Primary-Nav"}}, root.get());
+    auto first = element("li", {{"class", "item"}, {"id", "one"}}, list.get());
+    auto second = element("li", {{"class", "item active"}, {"lang", "en-US"}}, list.get());
+    auto link = element("a", {{"href", "https://example.com/a.png"}}, second.get());
+
+    EXPECT_TRUE(parse_selector(".list > .item").matches(*first));
+    EXPECT_TRUE(parse_selector("ul.main li#one").matches(*first));
+    EXPECT_TRUE(parse_selector(".item + .item.active").matches(*second));
+    EXPECT_TRUE(parse_selector("#one ~ li").matches(*second));
+    EXPECT_FALSE(parse_selector("#one ~ li").matches(*first));
+    EXPECT_TRUE(parse_selector("html ul a").matches(*link));
+    EXPECT_FALSE(parse_selector(".main > a").matches(*link));
+    EXPECT_TRUE(parse_selector("li:first-child").matches(*first));
+    EXPECT_FALSE(parse_selector("li:first-child").matches(*second));
+    EXPECT_TRUE(parse_selector("a:empty").matches(*link));
+    EXPECT_TRUE(parse_selector(":root").matches(*root));
+    EXPECT_FALSE(parse_selector("li:hover").matches(*first));
+
+    EXPECT_TRUE(parse_selector("[DATA-KIND]").matches(*list));
+    EXPECT_FALSE(parse_selector("[data-kind=primary-nav]").matches(*list));
+    EXPECT_TRUE(parse_selector("[data-kind=primary-nav i]").matches(*list));
+    EXPECT_TRUE(parse_selector("[lang|=en]").matches(*second));
+    EXPECT_TRUE(parse_selector("[href^=https]").matches(*link));
+    EXPECT_TRUE(parse_selector("[href$=\".png\"]").matches(*link));
+    EXPECT_TRUE(parse_selector("[href*=example]").matches(*link));
+    EXPECT_TRUE(parse_selector("[class~=active]").matches(*second));
+    EXPECT_FALSE(parse_selector("[class~=act]").matches(*second));
+}
+
+TEST_F(SelectorMatchTest, ClassListFollowsAttributeChanges) {
+    auto item = element("div", {{"class", "a\tb"}}, root.get());
+    EXPECT_EQ(item->class_list(), (std::vector<String>{"a"_s, "b"_s}));
+    EXPECT_TRUE(parse_selector(".b").matches(*item));
+
+    item->set_attribute("CLASS"_s, "c"_s);
+    EXPECT_EQ(item->class_list(), (std::vector<String>{"c"_s}));
+    EXPECT_FALSE(parse_selector(".b").matches(*item));
+    EXPECT_TRUE(parse_selector(".c").matches(*item));
+
+    item->set_id("main"_s);
+    EXPECT_TRUE(parse_selector("#main.c").matches(*item));
+    item->remove_attribute("class"_s);
+    item->remove_attribute("id"_s);
+    EXPECT_TRUE(item->class_list().empty());
+    EXPECT_TRUE(item->id().empty());
+    EXPECT_FALSE(parse_selector("#main").matches(*item));
+}
+
+TEST_F(SelectorMatchTest, QuerySelectorAllReturnsTreeOrder) {
+    auto a = element("section", {{"class", "x"}}, root.get());
+    auto b = element("div", {{"class", "x"}}, a.get());
+    auto c = element("p", {}, b.get());
+    auto d = element("div", {{"class", "x"}}, root.get());
+
+    auto selectors = SelectorList::parse(".x, p"_s);
+    auto found = SelectorMatcher::query_selector_all(selectors, *root);
+    EXPECT_EQ(found, (std::vector<dom::Element*>{a.get(), b.get(), c.get(), d.get()}));
+    EXPECT_EQ(SelectorMatcher::query_selector(SelectorList::parse("div p"_s), *root), c.get());
+    EXPECT_EQ(SelectorMatcher::query_selector(SelectorList::parse("span"_s), *root), nullptr);
+}
@@ -0,0 +1,439 @@
+#include <gtest/gtest.h>
+#include "lithium/css/style_resolver.hpp"
+#include "lithium/dom/element.hpp"
+
+using namespace lithium;
+using namespace lithium::css;
+
+namespace {
+
+f64 width_px(const ComputedValue& style) {
+    return style.box().width ? style.box().width->value : -1.0;
+}
+
+} // namespace
+
+class StyleResolverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        document = make_ref<dom::Document>();
+        root = document->create_element("html"_s);
+        document->append_child(root);
+    }
+
+    RefPtr<dom::Element> element(const String& tag, std::initializer_list<std::pair<const char*, const char*>> attributes = {},
+                                 dom::Element* parent = nullptr) {
+        auto created = document->create_element(tag);
+        for (const auto& [name, value] : attributes) {
+            created->set_attribute(String(name), String(value));
+        }
+        (parent ? parent : root.get())->append_child(created);
+        return created;
+    }
+
+    void add_author_css(const String& css) {
+        Parser parser;
+        resolver.add_stylesheet(parser.parse_stylesheet(css));
+    }
+
+    RefPtr<dom::Document> document;
+    RefPtr<dom::Element> root;
+    StyleResolver resolver;
+};
+
+TEST_F(StyleResolverTest, BucketedRulesKeepSpecificityOrder) {
+    add_author_css("#main { width: 3px } .box.wide { width: 4px } .box { width: 2px } "
+                   "div { width: 1px } * { height: 5px }");
+
+    auto by_id = element("div"_s, {{"id", "main"}, {"class", "box wide"}});
+    auto by_classes = element("div"_s, {{"class", "wide box"}});
+    auto by_class = element("div"_s, {{"class", "box"}});
+    auto by_tag = element("div"_s);
+
+    auto style = resolver.resolve(*by_id);
+    EXPECT_EQ(width_px(style), 3.0);
+    ASSERT_TRUE(style.box().height.has_value());
+    EXPECT_EQ(style.box().height->value, 5.0);
+    EXPECT_EQ(width_px(resolver.resolve(*by_classes)), 4.0);
+    EXPECT_EQ(width_px(resolver.resolve(*by_class)), 2.0);
+    EXPECT_EQ(width_px(resolver.resolve(*by_tag)), 1.0);
+}
+
+TEST_F(StyleResolverTest, BucketedRulesKeepSourceOrder) {
+    // Equal specificity from different buckets: the later rule wins
+    add_author_css(".b { width: 1px } [data-x] { width: 2px } .a { width: 3px }");
+    add_author_css("span { height: 1px } .a { height: 2px }");
+
+    auto both = element("span"_s, {{"class", "a b"}, {"data-x", ""}});
+    auto style = resolver.resolve(*both);
+    EXPECT_EQ(width_px(style), 3.0);
+    ASSERT_TRUE(style.box().height.has_value());
+    EXPECT_EQ(style.box().height->value, 2.0);
+
+    auto only_b = element("span"_s, {{"class", "b"}, {"data-x", ""}});
+    EXPECT_EQ(width_px(resolver.resolve(*only_b)), 2.0);
+}
+
+TEST_F(StyleResolverTest, KeysFollowTheRightmostCompound) {
+    add_author_css("SPAN { width: 1px } [DATA-Kind] { width: 2px } .outer > p { width: 3px } "
+                   ".inner, #none { width: 4px }");
+
+    auto outer = element("div"_s, {{"class", "outer"}});
+    auto span = element("span"_s, {}, outer.get());
+    auto attributed = element("span"_s, {{"data-kind", "x"}}, outer.get());
+    auto paragraph = element("p"_s, {}, outer.get());
+    auto stray = element("p"_s);
+    auto inner = element("em"_s, {{"class", "inner"}}, paragraph.get());
+
+    EXPECT_EQ(width_px(resolver.resolve(*outer)), -1.0);
+    EXPECT_EQ(width_px(resolver.resolve(*span)), 1.0);
+    EXPECT_EQ(width_px(resolver.resolve(*attributed)), 2.0);
+    EXPECT_EQ(width_px(resolver.resolve(*paragraph)), 3.0);
+    EXPECT_EQ(width_px(resolver.resolve(*stray)), -1.0);
+    EXPECT_EQ(width_px(resolver.resolve(*inner)), 4.0);
+}
+
+TEST_F(StyleResolverTest, AncestorFilterTracksPushedElements) {
+    auto outer = element("div"_s, {{"id", "nav"}, {"class", "outer wide"}});
+
+    AncestorBloomFilter filter;
+    filter.push_element(*outer);
+    EXPECT_TRUE(filter.may_contain(AncestorBloomFilter::tag_hash("div")));
+    EXPECT_TRUE(filter.may_contain(AncestorBloomFilter::id_hash("nav")));
+    EXPECT_TRUE(filter.may_contain(AncestorBloomFilter::class_hash("wide")));
+    EXPECT_FALSE(filter.may_contain(AncestorBloomFilter::class_hash("nav")));
+
+    filter.push_element(*root);
+    filter.pop_element();
+    EXPECT_TRUE(filter.may_contain(AncestorBloomFilter::class_hash("outer")));
+    filter.pop_element();
+    EXPECT_FALSE(filter.may_contain(AncestorBloomFilter::class_hash("outer")));
+    EXPECT_EQ(filter.depth(), 0u);
+}
+
+TEST_F(StyleResolverTest, AncestorFilterRejectsBeforeMatching) {
+    add_author_css(".outer > .middle > p { width: 3px } #nav > P { width: 5px } "
+                   "div + .middle > p { height: 7px }");
+
+    auto outer = element("div"_s, {{"class", "outer"}});
+    auto middle = element("div"_s, {{"class", "middle"}}, outer.get());
+    auto inside = element("p"_s, {}, middle.get());
+    auto other = element("div"_s, {{"class", "other"}});
+    auto other_middle = element("div"_s, {{"class", "middle"}}, other.get());
+    auto outside = element("p"_s, {}, other_middle.get());
+    auto nav = element("nav"_s, {{"id", "nav"}});
+    auto in_nav = element("p"_s, {}, nav.get());
+    auto sibling = element("div"_s);
+    auto after_sibling = element("section"_s, {{"class", "middle"}});
+    auto after_sibling_p = element("p"_s, {}, after_sibling.get());
+
+    resolver.resolve_document(*document);
+
+    const auto& stats = resolver.ancestor_filter_stats();
+    EXPECT_GT(stats.rejected, 0u);
+    EXPECT_GT(stats.passed, 0u);
+
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*inside)), 3.0);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*outside)), -1.0);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*in_nav)), 5.0);
+    const auto* sibling_style = resolver.get_computed_style(*after_sibling_p);
+    ASSERT_TRUE(sibling_style->box().height.has_value());
+    EXPECT_EQ(sibling_style->box().height->value, 7.0);
+
+    // Resolving outside resolve_document never consults the filter
+    resolver.reset_ancestor_filter_stats();
+    resolver.invalidate_all();
+    EXPECT_EQ(width_px(resolver.resolve(*inside)), 3.0);
+    EXPECT_EQ(resolver.ancestor_filter_stats().rejected + resolver.ancestor_filter_stats().passed, 0u);
+}
+
+TEST_F(StyleResolverTest, DeclarationsAreParsedToTypedValues) {
+    std::vector<TypedDeclaration> parsed;
+    EXPECT_TRUE(ValueParser::parse_declaration("MARGIN"_s, "4px"_s, parsed));
+    EXPECT_TRUE(ValueParser::parse_declaration("width"_s, "auto"_s, parsed));
+    EXPECT_TRUE(ValueParser::parse_declaration("color"_s, "#ff0000"_s, parsed));
+    EXPECT_FALSE(ValueParser::parse_declaration("width"_s, "wide"_s, parsed));
+    EXPECT_FALSE(ValueParser::parse_declaration("cursor"_s, "pointer"_s, parsed));
+
+    ASSERT_EQ(parsed.size(), 6u);
+    EXPECT_EQ(parsed[0].property, PropertyId::MarginTop);
+    EXPECT_EQ(parsed[3].property, PropertyId::MarginLeft);
+    EXPECT_EQ(std::get<Length>(parsed[3].value), (Length{4, LengthUnit::Px}));
+    EXPECT_EQ(parsed[4].property, PropertyId::Width);
+    EXPECT_TRUE(std::holds_alternative<AutoValue>(parsed[4].value));
+    EXPECT_EQ(parsed[5].property, PropertyId::Color);
+    EXPECT_EQ(std::get<Color>(parsed[5].value).r, 255);
+}
+
+TEST_F(StyleResolverTest, CascadeAppliesTypedDeclarations) {
+    add_author_css(".a { width: 10px; margin: 2px; cursor: pointer; opacity: 0.5 } "
+                   ".a.b { width: auto; margin-left: 3em; text-align: center; display: block }");
+
+    auto both = element("span"_s, {{"class", "a b"}});
+    auto style = resolver.resolve(*both);
+    EXPECT_FALSE(style.box().width.has_value());
+    EXPECT_EQ(style.box().margin_top, (Length{2, LengthUnit::Px}));
+    EXPECT_EQ(style.box().margin_left, (Length{3, LengthUnit::Em}));
+    EXPECT_FLOAT_EQ(style.box().opacity, 0.5f);
+    EXPECT_EQ(style.inherited_text().text_align, TextAlign::Center);
+    EXPECT_EQ(style.box().display, Display::Block);
+
+    auto only_a = element("span"_s, {{"class", "a"}});
+    EXPECT_EQ(width_px(resolver.resolve(*only_a)), 10.0);
+}
+
+TEST_F(StyleResolverTest, SiblingsAndCousinsShareOneStyle) {
+    add_author_css(".item { width: 5px } .item.on { width: 6px } #first { height: 1px }");
+
+    auto list = element("ul"_s, {{"class", "list"}});
+    auto other_list = element("ul"_s, {{"class", "list"}});
+    auto a = element("li"_s, {{"class", "item"}}, list.get());
+    auto b = element("li"_s, {{"class", "item"}}, list.get());
+    auto on = element("li"_s, {{"class", "item on"}}, list.get());
+    auto with_id = element("li"_s, {{"class", "item"}, {"id", "first"}}, list.get());
+    auto cousin = element("li"_s, {{"class", "item"}}, other_list.get());
+
+    resolver.resolve_document(*document);
+
+    EXPECT_EQ(resolver.get_computed_style(*a), resolver.get_computed_style(*b));
+    EXPECT_EQ(resolver.get_computed_style(*a), resolver.get_computed_style(*cousin));
+    EXPECT_NE(resolver.get_computed_style(*a), resolver.get_computed_style(*on));
+    EXPECT_NE(resolver.get_computed_style(*a), resolver.get_computed_style(*with_id));
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*cousin)), 5.0);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*on)), 6.0);
+    EXPECT_TRUE(resolver.get_computed_style(*with_id)->box().height.has_value());
+
+    // other_list shares with list, b and cousin with a
+    const auto& stats = resolver.style_sharing_stats();
+    EXPECT_EQ(stats.shared, 3u);
+    EXPECT_GT(stats.hit_rate(), 0.0);
+}
+
+TEST_F(StyleResolverTest, SiblingRulesDisableSharing) {
+    add_author_css("li + li { width: 2px } li:first-child { height: 3px }");
+
+    auto list = element("ul"_s);
+    auto first = element("li"_s, {}, list.get());
+    auto second = element("li"_s, {}, list.get());
+
+    resolver.resolve_document(*document);
+
+    EXPECT_EQ(resolver.style_sharing_stats().shared, 0u);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*first)), -1.0);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*second)), 2.0);
+    EXPECT_TRUE(resolver.get_computed_style(*first)->box().height.has_value());
+    EXPECT_FALSE(resolver.get_computed_style(*second)->box().height.has_value());
+}
+
+TEST_F(StyleResolverTest, PropertyGroupsAreSharedUntilWritten) {
+    add_author_css(".big { font-size: 20px } .wide { width: 9px }");
+
+    auto parent = element("div"_s, {{"class", "big"}});
+    auto plain = element("span"_s, {}, parent.get());
+    auto wide = element("span"_s, {{"class", "wide"}}, parent.get());
+
+    auto parent_style = resolver.resolve(*parent);
+    auto plain_style = resolver.resolve(*plain);
+    auto wide_style = resolver.resolve(*wide);
+
+    // Inherited groups are the parent's own objects
+    EXPECT_EQ(&plain_style.font(), &parent_style.font());
+    EXPECT_EQ(&wide_style.inherited_text(), &parent_style.inherited_text());
+    EXPECT_EQ(plain_style.font().font_size, (Length{20, LengthUnit::Px}));
+
+    // Untouched groups keep their shared initial values
+    EXPECT_EQ(&plain_style.box(), &ComputedValue{}.box());
+    EXPECT_EQ(&plain_style.border(), &wide_style.border());
+
+    // A write copies the group first
+    EXPECT_NE(&wide_style.box(), &plain_style.box());
+    EXPECT_EQ(width_px(wide_style), 9.0);
+    EXPECT_EQ(width_px(plain_style), -1.0);
+
+    ComputedValue copy = wide_style;
+    copy.mutable_box().width = Length{1, LengthUnit::Px};
+    EXPECT_EQ(width_px(wide_style), 9.0);
+    EXPECT_EQ(width_px(copy), 1.0);
+}
+
+TEST_F(StyleResolverTest, ParallelWalkMatchesSerialWalk) {
+    add_author_css(".a { width: 1px } .b > .a { width: 2px } #x-3 { color: red } .row > div { font-size: 20px } "
+                   ".c { margin: 3px } .c.a { height: 4px } section > .b > .a { padding: 5px }");
+
+    std::vector<RefPtr<dom::Element>> elements;
+    for (int i = 0; i < 40; ++i) {
+        auto section = element("section"_s, {{"class", i % 2 ? "row" : "b"}});
+        elements.push_back(section);
+        for (int j = 0; j < 30; ++j) {
+            auto id = "x-" + std::to_string(j);
+            auto item = element("div"_s, {{"class", j % 3 ? "a" : "b c"}, {"id", j % 5 ? "" : id.c_str()}},
+                                section.get());
+            elements.push_back(item);
+            elements.push_back(element("span"_s, {{"class", j % 2 ? "a c" : "a"}}, item.get()));
+        }
+    }
+
+    auto describe = [](const ComputedValue& style) {
+        return std::to_string(width_px(style)) + "/" +
+               std::to_string(style.box().height ? style.box().height->value : -1.0) + "/" +
+               std::to_string(style.box().margin_top.value) + "/" + std::to_string(style.box().padding_left.value) +
+               "/" + std::to_string(style.font().font_size.value) + "/" +
+               std::to_string(style.inherited_text().color.r) + "/" +
+               std::to_string(static_cast<int>(style.box().display));
+    };
+
+    resolver.resolve_document(*document);
+    std::vector<std::string> serial;
+    for (const auto& e : elements) {
+        serial.push_back(describe(*resolver.get_computed_style(*e)));
+    }
+
+    for (usize threads : {2u, 4u, 8u}) {
+        resolver.invalidate_all();
+        resolver.set_thread_count(threads);
+        EXPECT_EQ(resolver.thread_count(), threads);
+        resolver.resolve_document(*document);
+        for (usize i = 0; i < elements.size(); ++i) {
+            const auto* style = resolver.get_computed_style(*elements[i]);
+            ASSERT_NE(style, nullptr);
+            EXPECT_EQ(describe(*style), serial[i]) << "element " << i << " with " << threads << " threads";
+        }
+    }
+}
+
+TEST_F(StyleResolverTest, InvalidationSetsFollowSelectorPositions) {
+    RuleSet rules;
+    Parser parser;
+    rules.add_stylesheet(parser.parse_stylesheet(".a > .b { width: 1px } .c + .d { width: 2px } "
+                                                 "#x ~ p { width: 3px } [DATA-K] { width: 4px }"_s),
+                         CascadeOrigin::Author);
+
+    EXPECT_TRUE(rules.class_invalidation("a"_s).subtree);
+    EXPECT_TRUE(rules.class_invalidation("b"_s).subtree);
+    EXPECT_FALSE(rules.class_invalidation("b"_s).following_siblings);
+    EXPECT_TRUE(rules.class_invalidation("c"_s).following_siblings);
+    EXPECT_FALSE(rules.class_invalidation("c"_s).subtree);
+    EXPECT_TRUE(rules.id_invalidation("x"_s).following_siblings);
+    EXPECT_TRUE(rules.attribute_invalidation("data-k"_s).subtree);
+    EXPECT_TRUE(rules.class_invalidation("unused"_s).empty());
+}
+
+namespace {
+
+// Forwards a document's mutations to a resolver, as the browser engine does
+class ResolverObserver : public dom::DocumentObserver {
+public:
+    explicit ResolverObserver(StyleResolver& resolver) : m_resolver(resolver) {}
+
+    void attribute_changed(dom::Element& element, const String& name,
+                           const std::optional<String>& old_value) override {
+        m_resolver.invalidate_attribute_change(element, name, old_value);
+    }
+    void child_inserted(dom::Node& parent, dom::Node& child) override {
+        m_resolver.invalidate_child_inserted(parent, child);
+    }
+    void child_removed(dom::Node& parent, dom::Node& child) override {
+        m_resolver.invalidate_child_removed(parent, child);
+    }
+
+private:
+    StyleResolver& m_resolver;
+};
+
+} // namespace
+
+TEST_F(StyleResolverTest, AttributeChangesRestyleOnlyAffectedSubtrees) {
+    add_author_css(".wide { width: 5px } .open > .item { width: 7px } .mark + .item { height: 2px }");
+
+    auto first = element("div"_s, {{"class", "list"}});
+    auto first_item = element("div"_s, {{"class", "item"}}, first.get());
+    auto second = element("div"_s, {{"class", "list item"}});
+    auto second_item = element("div"_s, {{"class", "item"}}, second.get());
+    resolver.resolve_document(*document);
+
+    ResolverObserver observer(resolver);
+    document->set_observer(&observer);
+    const auto* untouched = resolver.get_computed_style(*second_item);
+
+    // A class no selector mentions restyles nothing
+    first->set_attribute("class"_s, "list unrelated"_s);
+    EXPECT_EQ(resolver.pending_restyle_roots(), 0u);
+    EXPECT_NE(resolver.get_computed_style(*first_item), nullptr);
+
+    // Left of a child combinator: the element's subtree only
+    first->set_attribute("class"_s, "list unrelated open"_s);
+    EXPECT_EQ(resolver.pending_restyle_roots(), 1u);
+    EXPECT_EQ(resolver.get_computed_style(*first), nullptr);
+    EXPECT_EQ(resolver.get_computed_style(*first_item), nullptr);
+    resolver.resolve_document(*document);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*first_item)), 7.0);
+    EXPECT_EQ(resolver.get_computed_style(*second_item), untouched);
+
+    // Left of a sibling combinator: the later siblings, not the element
+    const auto* first_style = resolver.get_computed_style(*first);
+    first->set_attribute("class"_s, "list open mark"_s);
+    EXPECT_EQ(resolver.get_computed_style(*first), first_style);
+    EXPECT_EQ(resolver.get_computed_style(*second), nullptr);
+    resolver.resolve_document(*document);
+    ASSERT_TRUE(resolver.get_computed_style(*second)->box().height.has_value());
+    EXPECT_EQ(resolver.get_computed_style(*second)->box().height->value, 2.0);
+
+    first->remove_attribute("class"_s);
+    resolver.resolve_document(*document);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*first_item)), -1.0);
+    EXPECT_FALSE(resolver.get_computed_style(*second)->box().height.has_value());
+
+    document->set_observer(nullptr);
+}
+
+TEST_F(StyleResolverTest, ChildMutationsRestyleInsertedSubtrees) {
+    add_author_css(".list > .item { width: 3px } .wide { width: 9px }");
+
+    auto list = element("div"_s, {{"class", "list"}});
+    auto other = element("div"_s);
+    auto other_child = element("span"_s, {}, other.get());
+    resolver.resolve_document(*document);
+
+    ResolverObserver observer(resolver);
+    document->set_observer(&observer);
+    const auto* untouched = resolver.get_computed_style(*other_child);
+
+    auto item = document->create_element("div"_s);
+    item->set_attribute("class"_s, "item"_s);
+    list->append_child(item);
+    EXPECT_EQ(resolver.pending_restyle_roots(), 1u);
+    resolver.resolve_document(*document);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*item)), 3.0);
+    EXPECT_EQ(resolver.get_computed_style(*other_child), untouched);
+
+    // Moving it restyles it under its new parent
+    other->append_child(item);
+    EXPECT_EQ(resolver.get_computed_style(*item), nullptr);
+    resolver.resolve_document(*document);
+    EXPECT_EQ(width_px(*resolver.get_computed_style(*item)), -1.0);
+
+    other->remove_child(item);
+    EXPECT_EQ(resolver.get_computed_style(*item), nullptr);
+    resolver.resolve_document(*document);
+    EXPECT_EQ(resolver.get_computed_style(*item), nullptr);
+    EXPECT_EQ(resolver.get_computed_style(*other_child), untouched);
+
+    document->set_observer(nullptr);
+}
+
+TEST_F(StyleResolverTest, DetachedMutationsAreNotObserved) {
+    ResolverObserver observer(resolver);
+    document->set_observer(&observer);
+
+    // Nodes outside the tree may outlive their document; mutating them
+    // afterwards must not reach it or its observer
+    auto parent = document->create_element("div"_s);
+    auto child = document->create_element("span"_s);
+    document = nullptr;
+    root = nullptr;
+
+    parent->append_child(child);
+    child->set_attribute("class"_s, "item"_s);
+    parent->remove_child(child);
+    EXPECT_EQ(resolver.pending_restyle_roots(), 0u);
+}
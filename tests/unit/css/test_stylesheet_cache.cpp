@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include "lithium/css/style_resolver.hpp"
+#include "lithium/css/stylesheet_cache.hpp"
+#include "lithium/dom/element.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace lithium;
+using namespace lithium::css;
+
+namespace {
+
+const char* const SAMPLE_CSS =
+    "@import url(base.css);\n"
+    "@media screen and (min-width: 900px) { .wide > p { width: 9px } }\n"
+    "#main, .box.wide, [DATA-Role|=\"nav\" i], DIV:first-child + span::before { width: 3px; color: #f00 }\n"
+    ".card { margin: 1px 2px; background: rgb(1, 2, 3) !important }\n"
+    "a.x ~ b, * { height: 5px; opacity: 0.5 }\n";
+
+f64 width_px(const ComputedValue& style) {
+    return style.box().width ? style.box().width->value : -1.0;
+}
+
+std::string serialized(const PreparedStylesheet& stylesheet) {
+    std::string bytes;
+    stylesheet.serialize(bytes);
+    return bytes;
+}
+
+} // namespace
+
+TEST(StylesheetCacheTest, PreparedStylesheetFilesSelectorsByKey) {
+    PreparedStylesheet prepared(parse_css(String(SAMPLE_CSS)));
+
+    ASSERT_EQ(prepared.style_rules().size(), 3u);
+    ASSERT_EQ(prepared.declarations().size(), 3u);
+    ASSERT_EQ(prepared.selectors().size(), 7u);
+
+    const auto& selectors = prepared.selectors();
+    EXPECT_EQ(selectors[0].bucket, RuleBucket::Id);
+    EXPECT_EQ(selectors[0].key, "main");
+    EXPECT_EQ(selectors[1].bucket, RuleBucket::Class);
+    EXPECT_EQ(selectors[1].key, "box");
+    EXPECT_EQ(selectors[2].bucket, RuleBucket::Attribute);
+    EXPECT_EQ(selectors[2].key, "data-role");
+    EXPECT_EQ(selectors[3].bucket, RuleBucket::Tag);
+    EXPECT_EQ(selectors[3].key, "span");
+    EXPECT_TRUE(selectors[3].depends_on_siblings);
+    EXPECT_FALSE(selectors[0].depends_on_siblings);
+    EXPECT_EQ(selectors[6].bucket, RuleBucket::Universal);
+    EXPECT_EQ(selectors[6].rule, 2u);
+    EXPECT_EQ(selectors[6].selector_index, 1u);
+}
+
+TEST(StylesheetCacheTest, RepeatedSourceIsAHit) {
+    StylesheetCache cache;
+    auto first = cache.get(String(SAMPLE_CSS));
+    auto second = cache.get(String(SAMPLE_CSS));
+    auto other = cache.get(".other { width: 1px }"_s);
+
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first.get(), other.get());
+    EXPECT_EQ(cache.stats().hits, 1u);
+    EXPECT_EQ(cache.stats().misses, 2u);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_GT(cache.memory_size(), std::string(SAMPLE_CSS).size());
+
+    cache.enable_cache(false);
+    EXPECT_NE(cache.get(String(SAMPLE_CSS)).get(), first.get());
+    EXPECT_EQ(cache.stats().misses, 3u);
+}
+
+TEST(StylesheetCacheTest, EvictsLeastRecentlyUsedPastTheSizeBound) {
+    StylesheetCache cache;
+    auto a = cache.get(".a { width: 1px }"_s);
+    auto b = cache.get(".b { width: 2px }"_s);
+    (void)cache.get(".a { width: 1px }"_s);  // b is now the oldest
+
+    cache.set_max_size(cache.memory_size() - 1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(cache.get(".a { width: 1px }"_s).get(), a.get());
+    EXPECT_NE(cache.get(".b { width: 2px }"_s).get(), b.get());
+
+    cache.set_max_size(0);
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.memory_size(), 0u);
+}
+
+TEST(StylesheetCacheTest, SerializedFormRoundTrips) {
+    PreparedStylesheet prepared(parse_css(String(SAMPLE_CSS)));
+    auto bytes = serialized(prepared);
+
+    auto loaded = PreparedStylesheet::deserialize(bytes);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(serialized(*loaded), bytes);
+    EXPECT_EQ(loaded->stylesheet().rules.size(), prepared.stylesheet().rules.size());
+    ASSERT_EQ(loaded->selectors().size(), prepared.selectors().size());
+    for (usize i = 0; i < prepared.selectors().size(); ++i) {
+        EXPECT_EQ(loaded->selectors()[i].key, prepared.selectors()[i].key);
+        EXPECT_EQ(loaded->selectors()[i].specificity, prepared.selectors()[i].specificity);
+        EXPECT_EQ(loaded->selectors()[i].ancestor_hashes, prepared.selectors()[i].ancestor_hashes);
+    }
+    // Selectors are recompiled on load
+    EXPECT_FALSE(loaded->style_rules()[0]->selectors.selectors[0].compiled.empty());
+}
+
+TEST(StylesheetCacheTest, TruncatedOrCorruptBytesAreRejected) {
+    PreparedStylesheet prepared(parse_css(String(SAMPLE_CSS)));
+    auto bytes = serialized(prepared);
+
+    for (usize length = 0; length < bytes.size(); ++length) {
+        EXPECT_FALSE(PreparedStylesheet::deserialize(std::string_view(bytes).substr(0, length)))
+            << "length " << length;
+    }
+    EXPECT_FALSE(PreparedStylesheet::deserialize(bytes + "x"));
+
+    auto corrupt = bytes;
+    corrupt[4] = '\x7F';  // The first rule's kind
+    EXPECT_FALSE(PreparedStylesheet::deserialize(corrupt));
+}
+
+TEST(StylesheetCacheTest, DiskEntriesServeANewCache) {
+    auto directory = std::filesystem::temp_directory_path() /
+                     ("lithium-css-cache-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                      "-" + std::to_string(StylesheetCache::hash_source(SAMPLE_CSS)));
+    std::filesystem::remove_all(directory);
+
+    RefPtr<const PreparedStylesheet> parsed;
+    {
+        StylesheetCache writer;
+        writer.set_directory(String(directory.string()));
+        parsed = writer.get(String(SAMPLE_CSS));
+        EXPECT_EQ(writer.stats().misses, 1u);
+    }
+
+    StylesheetCache reader;
+    reader.set_directory(String(directory.string()));
+    auto loaded = reader.get(String(SAMPLE_CSS));
+    EXPECT_EQ(reader.stats().disk_hits, 1u);
+    EXPECT_EQ(reader.stats().misses, 0u);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(serialized(*loaded), serialized(*parsed));
+
+    // Different source under the same directory is parsed, not confused
+    (void)reader.get(".other { width: 1px }"_s);
+    EXPECT_EQ(reader.stats().misses, 1u);
+
+    // A loaded stylesheet styles elements like the parsed one
+    auto document = make_ref<dom::Document>();
+    auto root = document->create_element("html"_s);
+    document->append_child(root);
+    auto element = document->create_element("div"_s);
+    element->set_attribute("class"_s, "box wide"_s);
+    root->append_child(element);
+
+    StyleResolver from_parse;
+    from_parse.add_stylesheet(parsed);
+    StyleResolver from_disk;
+    from_disk.add_stylesheet(loaded);
+    EXPECT_EQ(width_px(from_disk.resolve(*element)), 3.0);
+    EXPECT_EQ(width_px(from_disk.resolve(*element)), width_px(from_parse.resolve(*element)));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(StylesheetCacheTest, MistypedDeclarationsInAFileAreAMiss) {
+    const char* css = ".a { display: block; width: 3px }";
+    auto directory = std::filesystem::temp_directory_path() /
+                     ("lithium-css-cache-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                      "-" + std::to_string(StylesheetCache::hash_source(css)));
+
+    // A display declaration holding a color, and one out of Display's range
+    std::vector<PropertyValue> replacements = {Color(1, 2, 3), static_cast<Display>(99)};
+    for (const auto& replacement : replacements) {
+        std::filesystem::remove_all(directory);
+        RefPtr<const PreparedStylesheet> parsed;
+        {
+            StylesheetCache writer;
+            writer.set_directory(String(directory.string()));
+            parsed = writer.get(String(css));
+        }
+        const auto& declaration = parsed->declarations().at(0).at(0);
+        ASSERT_EQ(declaration.property, PropertyId::Display);
+
+        // Overwrite the declaration in place: the file keeps its length and
+        // its header still matches
+        auto path = std::filesystem::directory_iterator(directory)->path();
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        auto at = bytes.find(std::string_view(reinterpret_cast<const char*>(&declaration), sizeof(TypedDeclaration)));
+        ASSERT_NE(at, std::string::npos);
+        TypedDeclaration corrupt = declaration;
+        corrupt.value = replacement;
+        std::memcpy(bytes.data() + at, &corrupt, sizeof(TypedDeclaration));
+        std::ofstream(path, std::ios::binary | std::ios::trunc)
+            .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+        StylesheetCache reader;
+        reader.set_directory(String(directory.string()));
+        auto loaded = reader.get(String(css));
+        EXPECT_EQ(reader.stats().disk_hits, 0u);
+        EXPECT_EQ(reader.stats().misses, 1u);
+        ASSERT_TRUE(loaded);
+        EXPECT_EQ(std::get<Display>(loaded->declarations()[0][0].value), Display::Block);
+    }
+
+    std::filesystem::remove_all(directory);
+}
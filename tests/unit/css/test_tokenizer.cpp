@@ -33,3 +33,103 @@ TEST(CSSTokenizerTest, ParsesScientificAndNegativeNumbers) {
     EXPECT_NEAR(numbers[3].value, -0.3, 1e-9);
     EXPECT_FALSE(numbers[3].is_integer);
 }
+
+static std::vector<TokenView> collect_views(TokenStream& stream) {
+    std::vector<TokenView> tokens;
+    for (auto token = stream.next(); token.kind != TokenKind::EndOfFile; token = stream.next()) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+TEST(CSSTokenizerTest, TokenViewsAreRangesOfTheSource) {
+    std::string_view css = ".card-1:hover { width: 10.5px; content: \"hi\" } /* done */";
+    TokenStream stream(css);
+    auto tokens = collect_views(stream);
+
+    ASSERT_EQ(tokens.size(), 13u);
+    EXPECT_EQ(tokens[0].kind, TokenKind::Delim);
+    EXPECT_EQ(stream.delim(tokens[0]), '.');
+    EXPECT_EQ(tokens[1].kind, TokenKind::Ident);
+    EXPECT_EQ(stream.text(tokens[1]), "card-1");
+    EXPECT_EQ(tokens[1].offset, 1u);
+    EXPECT_FALSE(tokens[1].has(TokenView::ESCAPED));
+    EXPECT_EQ(tokens[2].kind, TokenKind::Colon);
+    EXPECT_EQ(stream.text(tokens[3]), "hover");
+    EXPECT_EQ(tokens[4].kind, TokenKind::OpenCurly);
+
+    const auto& width = tokens[7];
+    EXPECT_EQ(width.kind, TokenKind::Dimension);
+    EXPECT_EQ(stream.number_text(width), "10.5");
+    EXPECT_EQ(stream.unit_text(width), "px");
+    EXPECT_FALSE(width.has(TokenView::INTEGER));
+    EXPECT_DOUBLE_EQ(stream.number(width), 10.5);
+    EXPECT_EQ(stream.value(width), "px"_s);
+
+    EXPECT_EQ(tokens[11].kind, TokenKind::String);
+    EXPECT_EQ(stream.text(tokens[11]), "hi");
+    EXPECT_EQ(tokens[12].kind, TokenKind::CloseCurly);
+    EXPECT_TRUE(stream.at_end());
+}
+
+TEST(CSSTokenizerTest, DecodesEscapesOnlyWhenPresent) {
+    std::string_view css = ".\\31 23 \"a\\\"b\\\nc\" url( x\\29 y.png ) #\\@id caf\xC3\xA9";
+    TokenStream stream(css);
+    auto tokens = collect_views(stream);
+
+    ASSERT_EQ(tokens.size(), 6u);
+    EXPECT_EQ(tokens[1].kind, TokenKind::Ident);
+    EXPECT_TRUE(tokens[1].has(TokenView::ESCAPED));
+    EXPECT_EQ(stream.text(tokens[1]), "\\31 23");
+    EXPECT_EQ(stream.value(tokens[1]), "123"_s);
+
+    EXPECT_EQ(tokens[2].kind, TokenKind::String);
+    EXPECT_EQ(stream.value(tokens[2]), "a\"bc"_s);
+
+    EXPECT_EQ(tokens[3].kind, TokenKind::Url);
+    EXPECT_EQ(stream.value(tokens[3]), "x)y.png"_s);
+
+    EXPECT_EQ(tokens[4].kind, TokenKind::Hash);
+    EXPECT_TRUE(tokens[4].has(TokenView::ID));
+    EXPECT_EQ(stream.value(tokens[4]), "@id"_s);
+
+    // Non-ASCII bytes are name code points and are kept as they are
+    EXPECT_FALSE(tokens[5].has(TokenView::ESCAPED));
+    EXPECT_EQ(stream.value(tokens[5]), "caf\xC3\xA9"_s);
+}
+
+TEST(CSSTokenizerTest, ScansRunsLongerThanOneBlock) {
+    std::string name(70, 'n');
+    name[33] = '-';
+    std::string css = "\n\t  " + std::string(40, ' ') + name + "/*" + std::string(50, '*') + " x */" +
+                      "\"" + std::string(45, 's') + "\\\"" + std::string(20, 't') + "\"" +
+                      "url(data:" + std::string(60, 'A') + ")" + std::string(37, '9') + "px";
+    TokenStream stream(css);
+    auto tokens = collect_views(stream);
+
+    ASSERT_EQ(tokens.size(), 4u);
+    EXPECT_EQ(tokens[0].kind, TokenKind::Ident);
+    EXPECT_EQ(stream.text(tokens[0]), name);
+    EXPECT_EQ(tokens[1].kind, TokenKind::String);
+    EXPECT_EQ(stream.value(tokens[1]).length(), 66u);
+    EXPECT_EQ(tokens[2].kind, TokenKind::Url);
+    EXPECT_EQ(stream.text(tokens[2]).size(), 65u);
+    EXPECT_EQ(tokens[3].kind, TokenKind::Dimension);
+    EXPECT_EQ(stream.number_text(tokens[3]).size(), 37u);
+    EXPECT_EQ(stream.unit_text(tokens[3]), "px");
+}
+
+TEST(CSSTokenizerTest, TokenizerConvertsViewsToTokens) {
+    Tokenizer tokenizer;
+    tokenizer.set_input("@media 50% -moz-box url(a.png) #0f0"_s);
+    auto tokens = tokenizer.tokenize();
+
+    ASSERT_EQ(tokens.size(), 5u);
+    EXPECT_EQ(std::get<AtKeywordToken>(tokens[0]).value, "media"_s);
+    EXPECT_DOUBLE_EQ(std::get<PercentageToken>(tokens[1]).value, 50.0);
+    EXPECT_TRUE(is_ident_with_value(tokens[2], "-MOZ-BOX"_s));
+    EXPECT_EQ(std::get<UrlToken>(tokens[3]).value, "a.png"_s);
+    EXPECT_EQ(std::get<HashToken>(tokens[4]).value, "0f0"_s);
+    EXPECT_FALSE(std::get<HashToken>(tokens[4]).is_id);
+    EXPECT_TRUE(tokenizer.at_end());
+}
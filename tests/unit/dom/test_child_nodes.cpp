@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "lithium/dom/document.hpp"
+#include "lithium/dom/element.hpp"
+#include <vector>
+
+using namespace lithium;
+
+class ChildNodesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        document = make_ref<dom::Document>();
+        parent = document->create_element("ul"_s);
+        document->append_child(parent);
+    }
+
+    RefPtr<dom::Element> append(const char* id) {
+        auto child = document->create_element("li"_s);
+        child->set_id(String(id));
+        parent->append_child(child);
+        return child;
+    }
+
+    // Children's ids, walked forwards and checked against the backward links
+    std::string ids() const {
+        std::string forward;
+        for (const auto& child : parent->child_nodes()) {
+            forward += child->as_element()->id().c_str();
+        }
+        std::string backward;
+        for (auto* child = parent->last_child(); child; child = child->previous_sibling()) {
+            backward.insert(0, child->as_element()->id().c_str());
+        }
+        EXPECT_EQ(forward, backward);
+        return forward;
+    }
+
+    RefPtr<dom::Document> document;
+    RefPtr<dom::Element> parent;
+};
+
+TEST_F(ChildNodesTest, ViewIsLiveAndIndexable) {
+    auto children = parent->child_nodes();
+    EXPECT_TRUE(children.empty());
+    EXPECT_EQ(children[0], nullptr);
+
+    auto a = append("a");
+    auto b = append("b");
+    auto c = append("c");
+    ASSERT_EQ(children.size(), 3u);
+    EXPECT_EQ(children[0], a.get());
+    EXPECT_EQ(children[2], c.get());
+    EXPECT_EQ(children[1], b.get());
+    EXPECT_EQ(children[3], nullptr);
+
+    parent->remove_child(b);
+    EXPECT_EQ(children.size(), 2u);
+    EXPECT_EQ(children[1], c.get());
+    EXPECT_EQ(parent->child_count(), 2u);
+}
+
+TEST_F(ChildNodesTest, InsertAndRemoveKeepBothLinksConsistent) {
+    auto a = append("a");
+    auto c = append("c");
+    auto b = document->create_element("li"_s);
+    b->set_id("b"_s);
+
+    parent->insert_before(b, c.get());
+    EXPECT_EQ(ids(), "abc");
+    EXPECT_EQ(b->parent_node(), parent.get());
+
+    auto start = document->create_element("li"_s);
+    start->set_id("0"_s);
+    parent->insert_before(start, a.get());
+    EXPECT_EQ(ids(), "0abc");
+
+    // Moving an existing child, and inserting a node before itself
+    parent->insert_before(c, a.get());
+    EXPECT_EQ(ids(), "0cab");
+    parent->insert_before(c, c.get());
+    EXPECT_EQ(ids(), "0cab");
+    parent->append_child(start);
+    EXPECT_EQ(ids(), "cab0");
+
+    // A reference that is not a child is rejected
+    auto stranger = document->create_element("li"_s);
+    EXPECT_EQ(parent->insert_before(stranger, stranger.get()), nullptr);
+    EXPECT_EQ(parent->insert_before(a, document->document_element()), nullptr);
+
+    parent->remove_child(c);
+    parent->remove_child(start);
+    EXPECT_EQ(ids(), "ab");
+    EXPECT_EQ(c->parent_node(), nullptr);
+    EXPECT_EQ(c->next_sibling(), nullptr);
+    EXPECT_EQ(start->previous_sibling(), nullptr);
+    EXPECT_EQ(parent->child_count(), 2u);
+
+    parent->replace_child(c, a);
+    EXPECT_EQ(ids(), "cb");
+    parent->set_text_content(""_s);
+    EXPECT_EQ(parent->child_count(), 0u);
+    EXPECT_EQ(parent->first_child(), nullptr);
+    EXPECT_EQ(parent->last_child(), nullptr);
+}
+
+TEST_F(ChildNodesTest, IndexedWalksFollowMutations) {
+    std::vector<RefPtr<dom::Element>> children;
+    for (int i = 0; i < 100; ++i) {
+        children.push_back(append(std::to_string(i % 10).c_str()));
+    }
+
+    auto view = parent->child_nodes();
+    for (usize i = 0; i < view.size(); ++i) {
+        ASSERT_EQ(view[i], children[i].get());
+    }
+    for (usize i = view.size(); i-- > 0;) {
+        ASSERT_EQ(view[i], children[i].get());
+    }
+
+    // Mutations between indexed reads drop the cached position
+    EXPECT_EQ(view[50], children[50].get());
+    parent->remove_child(children[10]);
+    EXPECT_EQ(view[50], children[51].get());
+    parent->insert_before(children[10], children[0].get());
+    EXPECT_EQ(view[0], children[10].get());
+    EXPECT_EQ(view[50], children[50].get());
+}
+
+TEST_F(ChildNodesTest, ChildrenOutliveTheirParent) {
+    RefPtr<dom::Element> kept;
+    {
+        auto list = document->create_element("ol"_s);
+        for (int i = 0; i < 100000; ++i) {
+            list->append_child(document->create_element("li"_s));
+        }
+        kept = RefPtr<dom::Element>(list->child_nodes()[500]->as_element());
+    }
+    EXPECT_EQ(kept->parent_node(), nullptr);
+    EXPECT_EQ(kept->previous_sibling(), nullptr);
+    EXPECT_EQ(kept->next_sibling(), nullptr);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "lithium/dom/document.hpp"
+#include "lithium/dom/element.hpp"
+
+using namespace lithium;
+
+class DocumentIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        document = make_ref<dom::Document>();
+        root = document->create_element("html"_s);
+        document->append_child(root);
+    }
+
+    RefPtr<dom::Element> element(const String& tag, const char* id = nullptr, const char* classes = nullptr) {
+        auto created = document->create_element(tag);
+        if (id) {
+            created->set_attribute("id"_s, String(id));
+        }
+        if (classes) {
+            created->set_attribute("class"_s, String(classes));
+        }
+        return created;
+    }
+
+    RefPtr<dom::Document> document;
+    RefPtr<dom::Element> root;
+};
+
+TEST_F(DocumentIndexTest, IdLookupFollowsTreeAndAttributeChanges) {
+    auto detached = element("div"_s, "main");
+    EXPECT_EQ(document->get_element_by_id("main"_s), nullptr);
+
+    root->append_child(detached);
+    EXPECT_EQ(document->get_element_by_id("main"_s), detached.get());
+
+    detached->set_attribute("id"_s, "renamed"_s);
+    EXPECT_EQ(document->get_element_by_id("main"_s), nullptr);
+    EXPECT_EQ(document->get_element_by_id("renamed"_s), detached.get());
+
+    detached->remove_attribute("id"_s);
+    EXPECT_EQ(document->get_element_by_id("renamed"_s), nullptr);
+
+    detached->set_id("again"_s);
+    root->remove_child(detached);
+    EXPECT_FALSE(detached->is_connected());
+    EXPECT_EQ(document->get_element_by_id("again"_s), nullptr);
+    EXPECT_EQ(document->get_element_by_id(""_s), nullptr);
+}
+
+TEST_F(DocumentIndexTest, SubtreesAreIndexedWhenInserted) {
+    // Built while detached, then connected in one insertion
+    auto section = element("section"_s);
+    auto inner = element("p"_s, "inner");
+    section->append_child(inner);
+    EXPECT_EQ(document->get_element_by_id("inner"_s), nullptr);
+
+    auto anchor = element("div"_s);
+    root->append_child(anchor);
+    root->insert_before(section, anchor.get());
+    EXPECT_TRUE(inner->is_connected());
+    EXPECT_EQ(document->get_element_by_id("inner"_s), inner.get());
+
+    root->remove_child(section);
+    EXPECT_FALSE(inner->is_connected());
+    EXPECT_EQ(document->get_element_by_id("inner"_s), nullptr);
+}
+
+TEST_F(DocumentIndexTest, DuplicateIdsResolveToTheFirstInTreeOrder) {
+    auto first = element("div"_s);
+    auto second = element("div"_s, "dup");
+    auto nested = element("span"_s, "dup");
+    root->append_child(first);
+    root->append_child(second);
+    first->append_child(nested);  // Connected after `second`, but before it in tree order
+
+    EXPECT_EQ(document->get_element_by_id("dup"_s), nested.get());
+    first->remove_child(nested);
+    EXPECT_EQ(document->get_element_by_id("dup"_s), second.get());
+}
+
+TEST_F(DocumentIndexTest, CollectionsAreRebuiltAfterMutations) {
+    auto a = element("div"_s, nullptr, "card active");
+    auto b = element("span"_s, nullptr, "card");
+    root->append_child(a);
+    a->append_child(b);
+
+    auto cards = document->get_elements_by_class_name("card"_s);
+    ASSERT_EQ(cards.size(), 2u);
+    EXPECT_EQ(cards[0], a.get());
+    EXPECT_EQ(cards[1], b.get());
+    EXPECT_EQ(document->get_elements_by_class_name("active card"_s).size(), 1u);
+    EXPECT_EQ(document->get_elements_by_tag_name("DIV"_s).size(), 1u);
+    EXPECT_EQ(document->get_elements_by_tag_name("*"_s).size(), 3u);
+
+    b->set_attribute("class"_s, "card active"_s);
+    EXPECT_EQ(document->get_elements_by_class_name("active card"_s).size(), 2u);
+
+    auto c = element("div"_s, nullptr, "card");
+    root->append_child(c);
+    EXPECT_EQ(document->get_elements_by_class_name("card"_s).size(), 3u);
+    EXPECT_EQ(document->get_elements_by_tag_name("div"_s).size(), 2u);
+
+    root->remove_child(a);
+    EXPECT_EQ(document->get_elements_by_class_name("card"_s).size(), 1u);
+    EXPECT_EQ(document->get_elements_by_tag_name("span"_s).size(), 0u);
+    EXPECT_TRUE(document->get_elements_by_class_name(" "_s).empty());
+}
+
+TEST_F(DocumentIndexTest, SubtreesOutlivingTheDocumentAreDetached) {
+    auto section = element("section"_s, "kept");
+    auto inner = element("p"_s);
+    root->append_child(section);
+    section->append_child(inner);
+
+    document = nullptr;
+    EXPECT_FALSE(root->is_connected());
+    EXPECT_FALSE(section->is_connected());
+    EXPECT_EQ(section->owner_document(), nullptr);
+    EXPECT_EQ(inner->owner_document(), nullptr);
+
+    // Mutating the surviving tree no longer touches the document's index
+    section->remove_child(inner);
+    root->append_child(inner);
+    EXPECT_FALSE(inner->is_connected());
+    EXPECT_EQ(inner->parent_node(), root.get());
+}
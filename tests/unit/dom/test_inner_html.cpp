@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "lithium/dom/document.hpp"
 #include "lithium/dom/element.hpp"
+#include "lithium/dom/text.hpp"
 #include "lithium/html/parser.hpp"
 
 using namespace lithium;
@@ -73,3 +74,56 @@ TEST_F(DOMInnerHTMLTest, FallsBackToTextWhenParserUnavailable) {
 
     dom::register_html_fragment_parser(&html::parse_html_fragment);
 }
+
+TEST_F(DOMInnerHTMLTest, SerializesMarkupWithEscaping) {
+    auto container = document->create_element("div"_s);
+    document->append_child(container);
+
+    container->set_inner_html(
+        "<p class=\"a&quot;b\" title=\"x<y\">1 &lt; 2 &amp;&amp; 3 &gt; 2&nbsp;!</p>"
+        "<br><img src=\"i.png\"><!-- note -->"
+        "<script>if (a < b && c) {}</script><textarea>&lt;b&gt;</textarea>");
+
+    EXPECT_EQ(container->inner_html(),
+              "<p class=\"a&quot;b\" title=\"x&lt;y\">1 &lt; 2 &amp;&amp; 3 &gt; 2&nbsp;!</p>"
+              "<br><img src=\"i.png\"><!-- note -->"
+              "<script>if (a < b && c) {}</script><textarea>&lt;b&gt;</textarea>"_s);
+    EXPECT_EQ(container->outer_html(), "<div>"_s + container->inner_html() + "</div>"_s);
+}
+
+TEST_F(DOMInnerHTMLTest, SerializesElementAndAttributeNames) {
+    auto upper = document->create_element("SECTION"_s);
+    upper->set_attribute("data-x"_s, "1"_s);
+    EXPECT_EQ(upper->outer_html(), "<section data-x=\"1\"></section>"_s);
+
+    auto svg = document->create_element_ns("http://www.w3.org/2000/svg"_s, "svg"_s);
+    auto object = document->create_element_ns("http://www.w3.org/2000/svg"_s, "foreignObject"_s);
+    svg->append_child(object);
+    svg->set_attribute_ns("http://www.w3.org/1999/xlink"_s, "xlink:href"_s, "#a"_s);
+    EXPECT_EQ(svg->outer_html(), "<svg xlink:href=\"#a\"><foreignObject></foreignObject></svg>"_s);
+}
+
+TEST_F(DOMInnerHTMLTest, DeepTreesSerializeIteratively) {
+    constexpr usize DEPTH = 100000;
+    auto root = document->create_element("div"_s);
+    dom::Element* parent = root.get();
+    for (usize i = 0; i < DEPTH; ++i) {
+        auto child = document->create_element("b"_s);
+        parent->append_child(child);
+        parent = child.get();
+    }
+    parent->append_child(document->create_text_node("x"_s));
+
+    auto html = root->inner_html();
+    EXPECT_EQ(html.size(), DEPTH * 7 + 1);
+    EXPECT_TRUE(html.starts_with("<b><b>"_s));
+    EXPECT_EQ(html.view().find('x'), DEPTH * 3);
+    EXPECT_TRUE(html.ends_with("</b></b>"_s));
+
+    // Released from the innermost node out, so teardown does not recurse
+    while (parent != root.get()) {
+        auto* up = parent->parent_node();
+        up->remove_child(RefPtr<dom::Node>(parent));
+        parent = up->as_element();
+    }
+}
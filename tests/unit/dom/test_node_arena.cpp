@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "lithium/dom/document.hpp"
+#include "lithium/dom/element.hpp"
+#include "lithium/dom/text.hpp"
+
+using namespace lithium;
+
+TEST(NodeArenaTest, DocumentNodesUseAndReturnArenaSlots) {
+    auto document = make_ref<dom::Document>();
+    auto& arena = document->node_arena();
+    EXPECT_EQ(arena.stats().live(), 0u);
+
+    auto root = document->create_element("html"_s);
+    document->append_child(root);
+    for (int i = 0; i < 100; ++i) {
+        auto item = document->create_element("li"_s);
+        item->append_child(document->create_text_node("text"_s));
+        root->append_child(item);
+    }
+    auto stats = arena.stats();
+    EXPECT_EQ(stats.live(), 201u);
+    ASSERT_EQ(stats.slabs.size(), 2u);  // Elements and text nodes
+    EXPECT_GE(stats.reserved(), 201 * sizeof(dom::Text));
+
+    // Clones and splits come from the same arena
+    auto clone = root->clone_node(true);
+    EXPECT_EQ(arena.stats().live(), 402u);
+    clone = nullptr;
+    EXPECT_EQ(arena.stats().live(), 201u);
+
+    // Freed slots are reused before new blocks are carved
+    usize reserved = arena.stats().reserved();
+    document->remove_child(root);
+    root = nullptr;
+    EXPECT_EQ(arena.stats().live(), 0u);
+    for (int i = 0; i < 100; ++i) {
+        document->append_child(document->create_element("p"_s));
+    }
+    EXPECT_EQ(arena.stats().reserved(), reserved);
+}
+
+TEST(NodeArenaTest, NodesOutliveTheirDocument) {
+    RefPtr<dom::Element> kept;
+    RefPtr<dom::Node> text;
+    {
+        auto document = make_ref<dom::Document>();
+        auto root = document->create_element("div"_s);
+        document->append_child(root);
+        kept = document->create_element("span"_s);
+        kept->set_attribute("title"_s, "still here"_s);
+        root->append_child(kept);
+        text = document->create_text_node("tail"_s);
+        kept->append_child(text);
+    }
+    // The document is gone; its arena lives until these are released
+    EXPECT_EQ(kept->get_attribute("title"_s), "still here"_s);
+    EXPECT_EQ(kept->text_content(), "tail"_s);
+    EXPECT_EQ(text->parent_node(), kept.get());
+
+    // Clones and splits still come from the orphaned arena
+    auto clone = kept->clone_node(true);
+    EXPECT_EQ(clone->text_content(), "tail"_s);
+    auto split = text->as_text()->split_text(2);
+    ASSERT_NE(split, nullptr);
+    EXPECT_EQ(kept->text_content(), "tail"_s);
+    EXPECT_EQ(split->previous_sibling(), text.get());
+    clone = nullptr;
+    split = nullptr;
+
+    kept = nullptr;
+    EXPECT_EQ(text->parent_node(), nullptr);
+}
+
+TEST(NodeArenaTest, NamesAreInterned) {
+    const auto& div = dom::QualifiedName::html("DIV");
+    EXPECT_EQ(&div, &dom::QualifiedName::html("DIV"));
+    EXPECT_NE(&div, &dom::QualifiedName::html("div"));
+    EXPECT_EQ(div.qualified_name(), "DIV"_s);
+    EXPECT_EQ(div.local_name(), "div"_s);
+    EXPECT_EQ(div.uppercase_name(), "DIV"_s);
+    EXPECT_TRUE(div.namespace_uri().empty());
+
+    const auto& href = dom::QualifiedName::with_namespace("http://www.w3.org/1999/xlink", "xlink:href");
+    EXPECT_EQ(href.prefix(), "xlink"_s);
+    EXPECT_EQ(href.local_name(), "href"_s);
+    EXPECT_NE(&href, &dom::QualifiedName::with_namespace("", "xlink:href"));
+
+    auto document = make_ref<dom::Document>();
+    auto a = document->create_element("p"_s);
+    auto b = document->create_element("p"_s);
+    EXPECT_EQ(&a->qualified_name(), &b->qualified_name());
+    EXPECT_EQ(a->node_name(), "P"_s);
+
+    a->set_attribute("Data-X"_s, "1"_s);
+    b->set_attribute("data-x"_s, "2"_s);
+    EXPECT_EQ(a->attributes()[0].name(), "Data-X"_s);
+    EXPECT_EQ(a->attributes()[0].local_name(), "data-x"_s);
+    EXPECT_EQ(a->get_attribute("DATA-x"_s), "1"_s);
+
+    auto svg = document->create_element_ns("http://www.w3.org/2000/svg"_s, "svg"_s);
+    svg->set_attribute_ns("http://www.w3.org/1999/xlink"_s, "xlink:href"_s, "#a"_s);
+    svg->set_attribute_ns("http://www.w3.org/1999/xlink"_s, "x:href"_s, "#b"_s);
+    ASSERT_EQ(svg->attributes().size(), 1u);
+    EXPECT_EQ(svg->attributes()[0].prefix(), "x"_s);
+    EXPECT_EQ(svg->get_attribute_ns("http://www.w3.org/1999/xlink"_s, "href"_s), "#b"_s);
+}
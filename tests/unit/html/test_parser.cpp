@@ -958,8 +958,8 @@ TEST_F(HTMLParserTest, SvgAttributesAdjustedAndPrefixesHandled) {
     bool has_viewbox = false;
     bool has_preserve = false;
     for (const auto& attr : attrs) {
-        if (attr.name == "viewBox"_s) has_viewbox = true;
-        if (attr.name == "preserveAspectRatio"_s) has_preserve = true;
+        if (attr.name() == "viewBox"_s) has_viewbox = true;
+        if (attr.name() == "preserveAspectRatio"_s) has_preserve = true;
     }
     EXPECT_TRUE(has_viewbox);
     EXPECT_TRUE(has_preserve);
@@ -1328,3 +1328,35 @@ TEST_F(HTMLParserTest, StreamingMetaCharsetTriggersRestart) {
     ASSERT_EQ(ps.size(), 1u);
     EXPECT_EQ(ps.front()->text_content(), String("done"));
 }
+
+TEST_F(HTMLParserTest, TextRunsBuildOneTextNodePerRun) {
+    auto doc = parse("<head>\n  <title>Caf\xC3\xA9 &amp; bar</title>\n</head>"
+                     "<body>\n<p>na\xC3\xAFve <b>bold</b> text &lt; more</p>"
+                     "<table> <tr><td>cell \xE2\x82\xAC</td></tr>x</table></body>");
+    ASSERT_NE(doc, nullptr);
+
+    auto titles = doc->get_elements_by_tag_name("title"_s);
+    ASSERT_EQ(titles.size(), 1u);
+    ASSERT_NE(titles.front()->first_child(), nullptr);
+    EXPECT_EQ(titles.front()->first_child(), titles.front()->last_child());
+    EXPECT_EQ(titles.front()->text_content(), String("Caf\xC3\xA9 & bar"));
+
+    auto ps = doc->get_elements_by_tag_name("p"_s);
+    ASSERT_EQ(ps.size(), 1u);
+    EXPECT_EQ(ps.front()->text_content(), String("na\xC3\xAFve bold text < more"));
+    // Text on either side of a character reference shares one node
+    ASSERT_NE(ps.front()->last_child(), nullptr);
+    EXPECT_EQ(ps.front()->last_child()->text_content(), String(" text < more"));
+
+    auto cells = doc->get_elements_by_tag_name("td"_s);
+    ASSERT_EQ(cells.size(), 1u);
+    EXPECT_EQ(cells.front()->text_content(), String("cell \xE2\x82\xAC"));
+
+    // Non-whitespace table text is still foster parented before the table
+    auto tables = doc->get_elements_by_tag_name("table"_s);
+    ASSERT_EQ(tables.size(), 1u);
+    auto* before_table = tables.front()->previous_sibling();
+    ASSERT_NE(before_table, nullptr);
+    ASSERT_TRUE(before_table->is_text());
+    EXPECT_EQ(before_table->text_content(), String("x"));
+}
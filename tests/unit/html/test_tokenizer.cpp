@@ -12,7 +12,7 @@ class HTMLTokenizerTest : public ::testing::Test {
 protected:
     std::vector<Token> tokenize(const String& html) {
         std::vector<Token> tokens;
-        Tokenizer tokenizer;
+        tokenizer = Tokenizer();
         tokenizer.set_input(html);
         tokenizer.set_token_callback([&tokens](Token token) {
             tokens.push_back(std::move(token));
@@ -20,6 +20,10 @@ protected:
         tokenizer.run();
         return tokens;
     }
+
+    // Character runs point into the tokenizer's input, so it is kept until
+    // the next tokenize() call
+    Tokenizer tokenizer;
 };
 
 TEST_F(HTMLTokenizerTest, EmptyInput) {
@@ -45,7 +49,7 @@ TEST_F(HTMLTokenizerTest, SimpleStartTag) {
 
     auto* tag = std::get_if<TagToken>(&tokens[0]);
     ASSERT_NE(tag, nullptr);
-    EXPECT_EQ(tag->name, String("div"));
+    EXPECT_EQ(tag->name, atoms::div);
     EXPECT_FALSE(tag->is_end_tag);
     EXPECT_FALSE(tag->self_closing);
 }
@@ -58,7 +62,7 @@ TEST_F(HTMLTokenizerTest, SimpleEndTag) {
 
     auto* tag = std::get_if<TagToken>(&tokens[0]);
     ASSERT_NE(tag, nullptr);
-    EXPECT_EQ(tag->name, String("div"));
+    EXPECT_EQ(tag->name, atoms::div);
     EXPECT_TRUE(tag->is_end_tag);
 }
 
@@ -70,7 +74,7 @@ TEST_F(HTMLTokenizerTest, SelfClosingTag) {
 
     auto* tag = std::get_if<TagToken>(&tokens[0]);
     ASSERT_NE(tag, nullptr);
-    EXPECT_EQ(tag->name, String("br"));
+    EXPECT_EQ(tag->name, atoms::br);
     EXPECT_TRUE(tag->self_closing);
 }
 
@@ -82,7 +86,7 @@ TEST_F(HTMLTokenizerTest, TagWithAttribute) {
     ASSERT_NE(tag, nullptr);
 
     ASSERT_EQ(tag->attributes.size(), 1u);
-    EXPECT_EQ(tag->attributes[0].first, String("class"));
+    EXPECT_EQ(tag->attributes[0].first, atoms::class_);
     EXPECT_EQ(tag->attributes[0].second, String("foo"));
 }
 
@@ -126,7 +130,7 @@ TEST_F(HTMLTokenizerTest, MixedContent) {
     auto tokens = tokenize("<p>Hello <b>World</b>!</p>");
 
     // Should have: <p>, "Hello ", <b>, "World", </b>, "!", </p>, EOF
-    EXPECT_TRUE(is_start_tag_named(tokens[0], String("p")));
+    EXPECT_TRUE(is_start_tag_named(tokens[0], atoms::p));
     EXPECT_TRUE(is_eof(tokens.back()));
 }
 
@@ -158,7 +162,7 @@ TEST_F(HTMLTokenizerTest, BooleanAttribute) {
     ASSERT_NE(tag, nullptr);
 
     ASSERT_EQ(tag->attributes.size(), 1u);
-    EXPECT_EQ(tag->attributes[0].first, String("disabled"));
+    EXPECT_EQ(tag->attributes[0].first, atoms::disabled);
     EXPECT_EQ(tag->attributes[0].second, String(""));
 }
 
@@ -169,7 +173,7 @@ TEST_F(HTMLTokenizerTest, ScriptEscapedEndTagDetected) {
     size_t end_count = 0;
     for (const auto& tok : tokens) {
         if (auto* t = std::get_if<TagToken>(&tok)) {
-            if (t->name == "script"_s) {
+            if (t->name == atoms::script) {
                 if (t->is_end_tag) {
                     ++end_count;
                 } else {
@@ -189,7 +193,7 @@ TEST_F(HTMLTokenizerTest, ScriptDoubleEscapedDoesNotCloseEarly) {
     size_t end_count = 0;
     for (const auto& tok : tokens) {
         if (auto* t = std::get_if<TagToken>(&tok)) {
-            if (t->name == "script"_s) {
+            if (t->name == atoms::script) {
                 if (t->is_end_tag) {
                     ++end_count;
                 } else {
@@ -202,3 +206,76 @@ TEST_F(HTMLTokenizerTest, ScriptDoubleEscapedDoesNotCloseEarly) {
     EXPECT_EQ(start_count, 1u);
     EXPECT_EQ(end_count, 1u);
 }
+
+TEST_F(HTMLTokenizerTest, NamedCharacterReferencesUseLongestMatch) {
+    auto text_of = [](const std::vector<Token>& tokens) {
+        std::vector<unicode::CodePoint> code_points;
+        for (const auto& tok : tokens) {
+            if (auto* c = std::get_if<CharacterToken>(&tok)) {
+                code_points.push_back(c->code_point);
+            } else if (auto* run = std::get_if<CharacterRunToken>(&tok)) {
+                code_points.insert(code_points.end(), run->text.begin(), run->text.end());
+            }
+        }
+        return code_points;
+    };
+
+    // "&notin;" beats the legacy "&not", which still applies without ';'
+    EXPECT_EQ(text_of(tokenize("&notin;&not &amp")),
+              (std::vector<unicode::CodePoint>{0x2209, 0xAC, ' ', '&'}));
+    // Two code points, and a long name
+    EXPECT_EQ(text_of(tokenize("&NotEqualTilde;&CounterClockwiseContourIntegral;")),
+              (std::vector<unicode::CodePoint>{0x2242, 0x338, 0x2233}));
+    // Unknown names stay literal
+    EXPECT_EQ(text_of(tokenize("&zz;")), (std::vector<unicode::CodePoint>{'&', 'z', 'z', ';'}));
+
+    // In attributes a legacy name followed by '=' or an alphanumeric is not a reference
+    auto tokens = tokenize("<a href=\"?x=1&copy=2&lt;&amp;\">");
+    auto* tag = std::get_if<TagToken>(&tokens[0]);
+    ASSERT_NE(tag, nullptr);
+    EXPECT_EQ(tag->get_attribute("href"_s), std::optional<String>("?x=1&copy=2<&"_s));
+}
+
+TEST_F(HTMLTokenizerTest, TextIsEmittedAsCharacterRuns) {
+    auto tokens = tokenize("Hello <b>big</b> caf\xC3\xA9&amp;x\n");
+
+    ASSERT_EQ(tokens.size(), 8u);
+    auto run_text = [&](usize index) {
+        auto* run = std::get_if<CharacterRunToken>(&tokens[index]);
+        return run ? std::string(run->text) : std::string("<not a run>");
+    };
+    EXPECT_EQ(run_text(0), "Hello ");
+    EXPECT_TRUE(is_start_tag_named(tokens[1], atoms::b));
+    EXPECT_EQ(run_text(2), "big");
+    EXPECT_TRUE(is_end_tag_named(tokens[3], atoms::b));
+    // Runs carry the input bytes, so UTF-8 text passes through untouched
+    EXPECT_EQ(run_text(4), " caf\xC3\xA9");
+    // Character references still produce single characters
+    auto* amp = std::get_if<CharacterToken>(&tokens[5]);
+    ASSERT_NE(amp, nullptr);
+    EXPECT_EQ(amp->code_point, static_cast<unicode::CodePoint>('&'));
+    EXPECT_EQ(run_text(6), "x\n");
+    EXPECT_TRUE(is_eof(tokens[7]));
+}
+
+TEST_F(HTMLTokenizerTest, TagAndAttributeNamesAreInterned) {
+    auto tokens = tokenize("<DIV Class=a DATA-Role=b><x-Widget x-Attr=c></x-widget></div>");
+
+    ASSERT_EQ(tokens.size(), 5u);
+    auto* div = std::get_if<TagToken>(&tokens[0]);
+    ASSERT_NE(div, nullptr);
+    EXPECT_EQ(div->name, atoms::div);
+    ASSERT_EQ(div->attributes.size(), 2u);
+    EXPECT_EQ(div->attributes[0].first, atoms::class_);
+    EXPECT_EQ(div->attributes[1].first.view(), "data-role");
+    EXPECT_EQ(div->get_attribute("Data-Role"_s), std::optional<String>("b"_s));
+
+    // Names outside the static table are interned on first use
+    auto* widget = std::get_if<TagToken>(&tokens[1]);
+    ASSERT_NE(widget, nullptr);
+    EXPECT_FALSE(widget->name.is_static());
+    EXPECT_EQ(widget->name, Atom("x-widget"));
+    EXPECT_EQ(widget->get_attribute(Atom("x-attr")), std::optional<String>("c"_s));
+    EXPECT_TRUE(is_end_tag_named(tokens[2], Atom("x-widget")));
+    EXPECT_TRUE(is_end_tag_named(tokens[3], atoms::div));
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include "lithium/js/vm.hpp"
+#include "lithium/js/object.hpp"
+#include "lithium/core/string.hpp"
+
+using namespace lithium;
+using namespace lithium::js;
+
+class JSGcTest : public ::testing::Test {
+protected:
+    VM vm;
+
+    Value run(const String& src) {
+        auto result = vm.interpret(src);
+        EXPECT_EQ(result, VM::InterpretResult::Ok) << vm.error_message().c_str();
+        return vm.last_value();
+    }
+};
+
+TEST_F(JSGcTest, AllocationIsAccountedPerCell) {
+    auto& gc = vm.gc();
+    gc.collect(vm);
+    usize objects_before = gc.total_objects();
+    usize young_before = gc.young_bytes();
+
+    Value holder(gc.allocate<Object>());
+    GC_ROOT(gc, holder);
+    EXPECT_EQ(gc.total_objects(), objects_before + 1);
+    EXPECT_GE(gc.young_bytes(), young_before + sizeof(Object));
+    EXPECT_TRUE(holder.as_object()->is_managed());
+    EXPECT_TRUE(holder.as_object()->is_young());
+}
+
+TEST_F(JSGcTest, MinorCollectionFreesUnreachableYoungObjects) {
+    auto& gc = vm.gc();
+    gc.collect(vm);
+    usize objects_before = gc.total_objects();
+
+    for (int i = 0; i < 100; ++i) {
+        gc.allocate<Object>();
+    }
+    EXPECT_EQ(gc.total_objects(), objects_before + 100);
+
+    gc.collect_minor(vm);
+    EXPECT_EQ(gc.total_objects(), objects_before);
+    EXPECT_EQ(gc.minor_gc_count(), 1u);
+    EXPECT_GE(gc.minor_stats().objects_freed, 100u);
+    EXPECT_EQ(gc.young_bytes(), 0u);
+}
+
+TEST_F(JSGcTest, MinorCollectionPromotesSurvivorsInPlace) {
+    auto& gc = vm.gc();
+    Value survivor(gc.allocate<Object>());
+    GC_ROOT(gc, survivor);
+    Object* before = survivor.as_object();
+
+    gc.collect_minor(vm);
+    EXPECT_EQ(survivor.as_object(), before);
+    EXPECT_FALSE(before->is_young());
+    EXPECT_GT(gc.minor_stats().bytes_promoted, 0u);
+}
+
+TEST_F(JSGcTest, WriteBarrierKeepsYoungObjectsReachableFromOldOnes) {
+    auto& gc = vm.gc();
+    Value holder(gc.allocate<Object>());
+    GC_ROOT(gc, holder);
+    gc.collect_minor(vm);
+    ASSERT_FALSE(holder.as_object()->is_young());
+
+    auto* young = gc.allocate<Object>();
+    young->set_property("x"_s, Value(42.0));
+    holder.as_object()->set_property("child"_s, Value(young));
+    EXPECT_TRUE(holder.as_object()->is_remembered());
+
+    usize objects_before = gc.total_objects();
+    gc.collect_minor(vm);
+    EXPECT_EQ(gc.total_objects(), objects_before);
+    Value child = holder.as_object()->get_property("child"_s);
+    ASSERT_TRUE(child.is_object());
+    EXPECT_DOUBLE_EQ(child.as_object()->get_property("x"_s).to_number(), 42.0);
+}
+
+TEST_F(JSGcTest, MajorCollectionFreesUnreachableOldObjects) {
+    auto& gc = vm.gc();
+    {
+        Value temp(gc.allocate<Object>());
+        GC_ROOT(gc, temp);
+        gc.collect_minor(vm);
+        ASSERT_FALSE(temp.as_object()->is_young());
+    }
+    usize objects_before = gc.total_objects();
+    gc.collect(vm);
+    EXPECT_EQ(gc.total_objects(), objects_before - 1);
+    EXPECT_EQ(gc.major_gc_count(), 1u);
+    EXPECT_GE(gc.major_stats().objects_freed, 1u);
+}
+
+TEST_F(JSGcTest, ClosuresSurviveSmallNursery) {
+    vm.gc().set_nursery_size(4 * 1024);
+    Value result = run(
+        "function counter() { let n = 0; return function() { n = n + 1; return { value: n }; }; }"
+        "let c = counter();"
+        "let last = null;"
+        "for (let i = 0; i < 2000; i = i + 1) { last = c(); }"
+        "last.value;"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 2000.0);
+    EXPECT_GT(vm.gc().minor_gc_count(), 0u);
+}
+
+TEST_F(JSGcTest, OldArraysKeepYoungElements) {
+    vm.gc().set_nursery_size(4 * 1024);
+    Value result = run(
+        "let keep = [];"
+        "for (let i = 0; i < 1000; i = i + 1) { keep.push({ v: i }); let junk = { a: i, b: [i, i] }; }"
+        "let sum = 0;"
+        "for (let i = 0; i < keep.length; i = i + 1) { sum = sum + keep[i].v; }"
+        "sum;"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 499500.0);
+    EXPECT_GT(vm.gc().minor_gc_count(), 0u);
+}
+
+TEST_F(JSGcTest, StressModeRunsProgramsCorrectly) {
+    vm.gc().set_stress_gc(true);
+    Value result = run(
+        "let m = new Map();"
+        "function make(k) { return { key: k, items: [k, k + 1] }; }"
+        "for (let i = 0; i < 50; i = i + 1) { m.set(i, make(i)); }"
+        "let last = m.get(49);"
+        "last.items[1];"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 50.0);
+}
+
+TEST_F(JSGcTest, WeakMapDropsDeadKeys) {
+    auto& gc = vm.gc();
+    Value map(gc.allocate<WeakMapObject>());
+    GC_ROOT(gc, map);
+    Value live_key(gc.allocate<Object>());
+    GC_ROOT(gc, live_key);
+
+    auto* weak_map = static_cast<WeakMapObject*>(map.as_object());
+    auto* dead_key = gc.allocate<Object>();
+    weak_map->set(live_key, Value(1.0));
+    weak_map->set(Value(dead_key), Value(2.0));
+
+    gc.collect(vm);
+    EXPECT_TRUE(weak_map->has(live_key));
+    EXPECT_DOUBLE_EQ(weak_map->get(live_key).to_number(), 1.0);
+    EXPECT_FALSE(weak_map->has(Value(dead_key)));
+}
+
+TEST_F(JSGcTest, IncrementalMarkingInterleavesWithExecution) {
+    auto& gc = vm.gc();
+    gc.set_nursery_size(8 * 1024);
+    gc.set_initial_threshold(16 * 1024);
+    gc.set_mark_slice_budget_us(0);
+    gc.set_mark_step_bytes(1024);
+    Value result = run(
+        "function node(v, next) { return { v: v, next: next }; }"
+        "function counter() { let n = 0; return function() { n = n + 1; return [n]; }; }"
+        "let c = counter();"
+        "let list = null;"
+        "let m = new Map();"
+        "for (let i = 0; i < 3000; i = i + 1) {"
+        "  list = node(i, list);"
+        "  m.set(i % 50, c());"
+        "  let junk = { a: [i, i], b: { c: i } };"
+        "}"
+        "let sum = 0;"
+        "let p = list;"
+        "while (p !== null) { sum = sum + p.v; p = p.next; }"
+        "let last = m.get(49);"
+        "sum + last[0];"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 4498500.0 + 3000.0);
+    EXPECT_GT(gc.major_stats().mark_slices, gc.major_stats().collections);
+    EXPECT_GT(gc.major_stats().collections, 0u);
+}
+
+TEST_F(JSGcTest, FullCollectionFinishesIncrementalCycle) {
+    auto& gc = vm.gc();
+    gc.set_initial_threshold(0);
+    gc.set_nursery_size(1024);
+    gc.set_mark_slice_budget_us(0);
+    gc.set_mark_step_bytes(1024 * 1024);
+    bool was_marking = false;
+    vm.define_native("fullGC"_s, [&was_marking](VM& vm, const std::vector<Value>&) -> Value {
+        was_marking = vm.gc().is_marking();
+        vm.gc().collect(vm);
+        return Value(vm.gc().is_marking());
+    }, 0);
+    Value result = run(
+        "let keep = [];"
+        "for (let i = 0; i < 500; i = i + 1) { keep.push({ i: i }); }"
+        "let still_marking = fullGC();"
+        "still_marking ? -1 : keep[499].i;"_s);
+    EXPECT_TRUE(was_marking);
+    EXPECT_DOUBLE_EQ(result.to_number(), 499.0);
+    EXPECT_FALSE(gc.is_marking());
+}
+
+TEST_F(JSGcTest, RecordsPauseHistograms) {
+    auto& gc = vm.gc();
+    gc.collect_minor(vm);
+    gc.collect(vm);
+
+    const auto& minor = gc.minor_stats().pauses;
+    const auto& major = gc.major_stats().pauses;
+    EXPECT_EQ(minor.pauses, 1u);
+    EXPECT_EQ(major.pauses, 1u);
+
+    usize bucketed = 0;
+    for (usize count : major.buckets) {
+        bucketed += count;
+    }
+    EXPECT_EQ(bucketed, 1u);
+    EXPECT_GE(major.total_us, major.max_us);
+    EXPECT_EQ(GarbageCollector::PauseHistogram::bucket_lower_bound(3), 8u);
+}
+
+TEST_F(JSGcTest, IncrementalCycleSweepsLazily) {
+    auto& gc = vm.gc();
+    gc.set_mark_slice_budget_us(1000 * 1000);
+
+    Value holder(gc.allocate<Array>());
+    GC_ROOT(gc, holder);
+    auto* array = static_cast<Array*>(holder.as_object());
+    for (int i = 0; i < 500; ++i) {
+        array->push(Value(gc.allocate<Object>()));
+    }
+    gc.collect_minor(vm);
+    usize objects_before = gc.total_objects();
+
+    // Drop the array and let the next check start (and finish) a major cycle
+    holder = Value::undefined();
+    gc.set_initial_threshold(0);
+    gc.collect_if_needed(vm);
+    ASSERT_EQ(gc.major_gc_count(), 1u);
+    EXPECT_TRUE(gc.is_sweeping());
+    EXPECT_GT(gc.bytes_awaiting_sweep(), 500 * sizeof(Object));
+    EXPECT_EQ(gc.total_objects(), objects_before);
+
+    // Allocating from a size class sweeps the block it takes a cell from
+    usize awaiting = gc.bytes_awaiting_sweep();
+    Value fresh(gc.allocate<Object>());
+    GC_ROOT(gc, fresh);
+    EXPECT_LT(gc.bytes_awaiting_sweep(), awaiting);
+
+    while (gc.is_sweeping()) {
+        gc.collect_if_needed(vm);
+    }
+    EXPECT_EQ(gc.bytes_awaiting_sweep(), 0u);
+    EXPECT_EQ(gc.total_objects(), objects_before - 501 + 1);
+    EXPECT_GT(gc.major_stats().sweep_steps, 0u);
+    EXPECT_TRUE(fresh.as_object()->is_managed());
+}
@@ -1,6 +1,9 @@
 #include <cmath>
+#include <limits>
 #include <gtest/gtest.h>
 #include "lithium/js/vm.hpp"
+#include "lithium/js/json.hpp"
+#include "lithium/js/object.hpp"
 #include "lithium/core/string.hpp"
 
 using namespace lithium;
@@ -258,10 +261,228 @@ TEST_F(JSVmTest, MathAndJsonAreAvailable) {
     EXPECT_DOUBLE_EQ(maxv.to_number(), 5.0);
 
     Value json = run("JSON.stringify({ a: 1 });"_s);
-    EXPECT_EQ(json.to_string(), String("[object Object]"));
+    EXPECT_EQ(json.to_string(), String("{\"a\":1}"));
 }
 
 TEST_F(JSVmTest, FunctionObjectsExposeLength) {
     Value len = run("function foo(a, b, c) {} foo.length;"_s);
     EXPECT_DOUBLE_EQ(len.to_number(), 3.0);
 }
+
+TEST_F(JSVmTest, InlineCachesStayCorrectAcrossCalls) {
+    // Property sites keep their feedback between invocations; objects with
+    // different shapes must still read and write the right slots
+    Value result = run(
+        "function getX(o) { return o.x; }"
+        "function setX(o, v) { o.x = v; return o; }"
+        "let a = { x: 1 };"
+        "let b = { y: 2, x: 3 };"
+        "let c = { z: 0, y: 0, x: 5 };"
+        "let d = { w: 0, z: 0, y: 0, x: 7 };"
+        "let e = { v: 0, w: 0, z: 0, y: 0, x: 11 };"
+        "let sum = 0;"
+        "for (let i = 0; i < 10; i = i + 1) {"
+        "  sum = sum + getX(a) + getX(b) + getX(c) + getX(d) + getX(e);"
+        "}"
+        "setX(b, 100);"
+        "setX({ q: 1 }, 5);"
+        "sum + getX(b) + getX(a);"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 270.0 + 100.0 + 1.0);
+}
+
+TEST_F(JSVmTest, NonCapturingFunctionsKeepLocalsOnTheStack) {
+    Value fib = run(
+        "function fib(n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); }"
+        "fib(15);"_s);
+    EXPECT_DOUBLE_EQ(fib.to_number(), 610.0);
+
+    // Missing arguments are undefined, extra arguments are dropped
+    Value args = run(
+        "function pick(a, b, c) { let d = 4; return c === void 0 ? a + b + d : 0; }"
+        "pick(1, 2) + pick(1, 2, void 0, 9);"_s);
+    EXPECT_DOUBLE_EQ(args.to_number(), 14.0);
+
+    // Nested functions that do not capture locals do not force an environment
+    Value nested = run(
+        "function outer(a) { let b = a * 2; let f = function(x) { return x + 1; }; return f(b); }"
+        "outer(5);"_s);
+    EXPECT_DOUBLE_EQ(nested.to_number(), 11.0);
+
+    Value caught = run(
+        "function g(n) { let acc = n; try { throw 1; } catch (e) { acc = acc + e; } return acc; }"
+        "g(4);"_s);
+    EXPECT_DOUBLE_EQ(caught.to_number(), 5.0);
+}
+
+TEST_F(JSVmTest, StackLocalsStillEnforceConst) {
+    auto result = vm.interpret("function h() { const c = 1; c = 2; return c; } h();"_s);
+    EXPECT_EQ(result, VM::InterpretResult::RuntimeError);
+}
+
+TEST_F(JSVmTest, CapturedLocalsStayInEnvironments) {
+    Value result = run(
+        "function make() { let n = 0; let inc = function() { n = n + 1; return n; }; inc(); inc(); return inc; }"
+        "let f = make();"
+        "f();"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 3.0);
+}
+
+TEST_F(JSVmTest, ClosuresReachOuterLocalsBySlot) {
+    // `bump` skips the frameless `helper` level and writes to `make`'s locals
+    Value result = run(
+        "function make(step) {"
+        "  let count = 0;"
+        "  function helper(k) { let t = k * 2; return t; }"
+        "  function outer() {"
+        "    let scale = helper(1);"
+        "    return function bump() { count = count + step * scale; return count; };"
+        "  }"
+        "  return outer();"
+        "}"
+        "let b = make(3);"
+        "b(); b();"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 12.0);
+
+    auto result_const = vm.interpret(
+        "function frozen() { const c = 1; return function() { c = 2; }; }"
+        "frozen()();"_s);
+    EXPECT_EQ(result_const, VM::InterpretResult::RuntimeError);
+}
+
+TEST_F(JSVmTest, GlobalCellsPersistAcrossScripts) {
+    run("let total = 1; function addTo(n) { total = total + n; return total; }"_s);
+    Value result = run("addTo(4); addTo(5);"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 10.0);
+
+    // Builtins resolve through the same cells
+    Value builtin = run("function biggest(a, b) { return Math.max(a, b); } biggest(3, 8);"_s);
+    EXPECT_DOUBLE_EQ(builtin.to_number(), 8.0);
+
+    auto missing = vm.interpret("function f() { return notDefinedAnywhere; } f();"_s);
+    EXPECT_EQ(missing, VM::InterpretResult::RuntimeError);
+}
+
+TEST_F(JSVmTest, WithBodiesStillResolveNamesDynamically) {
+    Value result = run(
+        "let o = { q: 3 };"
+        "let q = 1;"
+        "function read() { with (o) { return function() { return q; }; } }"
+        "read()();"_s);
+    EXPECT_DOUBLE_EQ(result.to_number(), 3.0);
+}
+
+TEST_F(JSVmTest, MapKeysUseSameValueZero) {
+    Value result = run(
+        "let m = new Map();"
+        "m.set(1, 'one'); m.set(Math.sqrt(-1), 'nan'); m.set(-0, 'zero'); m.set('1', 'str');"
+        "m.set(1.5 - 0.5, 'uno');"
+        "m.get(1) + m.get(Math.sqrt(-2)) + m.get(0) + m.get('1') + m.size;"_s);
+    EXPECT_EQ(result.to_string(), "unonanzerostr4"_s);
+
+    Value set_size = run(
+        "let s = new Set();"
+        "for (let i = 0; i < 2000; i = i + 1) { s.add(i % 500); s.add('k' + (i % 250)); }"
+        "s['delete'](3); s['delete']('k7');"
+        "s.size;"_s);
+    EXPECT_DOUBLE_EQ(set_size.to_number(), 748.0);
+}
+
+TEST_F(JSVmTest, MapIterationKeepsInsertionOrderAcrossDeletes) {
+    auto& gc = vm.gc();
+    Value holder(gc.allocate<MapObject>());
+    GC_ROOT(gc, holder);
+    auto* map = static_cast<MapObject*>(holder.as_object());
+
+    for (int i = 0; i < 100; ++i) {
+        map->set(Value(static_cast<f64>(i)), Value(static_cast<f64>(i * 10)));
+    }
+    // Enough removals to force compaction of the tombstones
+    for (int i = 0; i < 100; i += 3) {
+        EXPECT_TRUE(map->remove(Value(i)));
+    }
+    EXPECT_FALSE(map->remove(Value(0)));
+    map->set(Value(3.0), Value(-1.0));
+
+    const auto& entries = map->internal_entries();
+    ASSERT_EQ(entries.size(), map->size());
+    ASSERT_EQ(entries.size(), 67u);
+    EXPECT_DOUBLE_EQ(entries.front().key.to_number(), 1.0);
+    EXPECT_DOUBLE_EQ(entries[entries.size() - 2].key.to_number(), 98.0);
+    EXPECT_DOUBLE_EQ(entries.back().key.to_number(), 3.0);
+    EXPECT_DOUBLE_EQ(map->get(Value(50)).to_number(), 500.0);
+    EXPECT_TRUE(map->get(Value(51)).is_undefined());
+}
+
+TEST_F(JSVmTest, JsonRoundTripsThroughParseAndStringify) {
+    Value result = run(
+        "let v = JSON.parse(' { \"n\": -1.5e2, \"s\": \"a\\\\\\\"b\\\\u00e9\\\\n\", \"l\": [true, false, null, [], {}], \"o\": { \"x\": 0.1 } } ');"
+        "JSON.stringify(v);"_s);
+    EXPECT_EQ(result.to_string(), String("{\"n\":-150,\"s\":\"a\\\"b\u00e9\\n\",\"l\":[true,false,null,[],{}],\"o\":{\"x\":0.1}}"));
+
+    Value numbers = run("JSON.stringify([1e21, 1.5e-7, 123456789012, -0, Math.sqrt(-1), 'q']);"_s);
+    EXPECT_EQ(numbers.to_string(), String("[1e+21,1.5e-7,123456789012,0,null,\"q\"]"));
+
+    Value omitted = run("JSON.stringify({ a: void 0, f: Math.max, b: [void 0, Math.max] });"_s);
+    EXPECT_EQ(omitted.to_string(), String("{\"b\":[null,null]}"));
+    EXPECT_TRUE(run("JSON.stringify(void 0);"_s).is_undefined());
+}
+
+TEST_F(JSVmTest, JsonStringifyHonoursReplacerListAndIndent) {
+    Value filtered = run("JSON.stringify({ c: 3, a: 1, b: 2 }, ['b', 'a', 'b']);"_s);
+    EXPECT_EQ(filtered.to_string(), String("{\"b\":2,\"a\":1}"));
+
+    Value indented = run("JSON.stringify({ a: [1, { b: 2 }], e: [] }, null, 2);"_s);
+    EXPECT_EQ(indented.to_string(),
+              String("{\n  \"a\": [\n    1,\n    {\n      \"b\": 2\n    }\n  ],\n  \"e\": []\n}"));
+
+    Value tabbed = run("JSON.stringify([1], null, '--');"_s);
+    EXPECT_EQ(tabbed.to_string(), String("[\n--1\n]"));
+}
+
+TEST_F(JSVmTest, JsonParseSaturatesOutOfRangeNumbers) {
+    f64 infinity = std::numeric_limits<f64>::infinity();
+    EXPECT_EQ(run("JSON.parse('1e400');"_s).to_number(), infinity);
+    EXPECT_EQ(run("JSON.parse('-1e400');"_s).to_number(), -infinity);
+    EXPECT_EQ(run("let a = JSON.parse('[1e309]'); a[0];"_s).to_number(), infinity);
+    EXPECT_EQ(run("JSON.parse('100e307');"_s).to_number(), infinity);
+
+    f64 tiny = run("JSON.parse('1e-400');"_s).to_number();
+    EXPECT_EQ(tiny, 0.0);
+    EXPECT_FALSE(std::signbit(tiny));
+    f64 negative_tiny = run("JSON.parse('-0.0001e-400');"_s).to_number();
+    EXPECT_EQ(negative_tiny, 0.0);
+    EXPECT_TRUE(std::signbit(negative_tiny));
+}
+
+TEST_F(JSVmTest, JsonReportsCyclesAndSyntaxErrors) {
+    auto cyclic = vm.interpret("let o = { a: [] }; o.a.push(o); JSON.stringify(o);"_s);
+    EXPECT_EQ(cyclic, VM::InterpretResult::RuntimeError);
+    EXPECT_NE(vm.error_message().view().find("circular"), std::string_view::npos);
+
+    for (const char* bad : {"JSON.parse('{\"a\":1,}');", "JSON.parse('[1 2]');", "JSON.parse('01');",
+                            "JSON.parse('\"abc');", "JSON.parse('');"}) {
+        VM fresh;
+        EXPECT_EQ(fresh.interpret(String(bad)), VM::InterpretResult::RuntimeError) << bad;
+    }
+}
+
+TEST_F(JSVmTest, JsonParseSharesShapesAcrossRecords) {
+    auto& gc = vm.gc();
+    JsonParser parser(gc, nullptr, nullptr);
+    JsonResult result = parser.parse(R"([{"id":1,"name":"a"},{"id":2,"name":"b"},{"name":"c","id":3},{"id":4,"id":5}])");
+    ASSERT_TRUE(result.ok()) << result.error.c_str();
+    Value root = result.value;
+    GC_ROOT(gc, root);
+
+    auto* records = root.as_object();
+    Object* first = records->get_element(0).as_object();
+    Object* second = records->get_element(1).as_object();
+    Object* reordered = records->get_element(2).as_object();
+    Object* duplicate = records->get_element(3).as_object();
+    EXPECT_EQ(first->shape_id(), second->shape_id());
+    EXPECT_NE(first->shape_id(), reordered->shape_id());
+    EXPECT_EQ(second->get_property("name"_s).to_string(), "b"_s);
+    EXPECT_DOUBLE_EQ(reordered->get_property("id"_s).to_number(), 3.0);
+    EXPECT_DOUBLE_EQ(duplicate->get_property("id"_s).to_number(), 5.0);
+    EXPECT_EQ(duplicate->own_property_names().size(), 1u);
+}
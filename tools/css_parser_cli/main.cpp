@@ -1,37 +1,130 @@
 /**
  * CSS Parser CLI Tool
- * Usage: lithium-css [file.css] or pipe CSS to stdin
+ * Usage: lithium-css [--bench] [file.css] or pipe CSS to stdin
+ *
+ * --bench times the tokenizer and the parser over the file (or, without
+ * one, a generated bundle of about 4 MB) and prints their throughput
  */
 
 #include "lithium/css/parser.hpp"
 #include "lithium/core/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string>
 
 using namespace lithium;
 
+namespace {
+
+// Shaped like a bundled framework: utility and component rules, comments,
+// vendor prefixes, media blocks, strings and inline data urls
+std::string make_bundle(usize target_bytes) {
+    std::string css = "/*! bundle: reset, grid, components, utilities */\n";
+    for (usize i = 0; css.size() < target_bytes; ++i) {
+        auto n = std::to_string(i);
+        css += "/* component " + n + " */\n";
+        css += ".btn-" + n + ", .btn-" + n + ":hover > .icon, a.link-" + n + "[data-state=\"open\"] {\n"
+               "  display: inline-flex; padding: 0.375rem 0.75rem; margin: 0 auto -1px;\n"
+               "  font: 500 14px/1.5 \"Helvetica Neue\", Arial, sans-serif;\n"
+               "  color: #212529; background-color: rgba(13, 110, 253, 0.25) !important;\n"
+               "  -webkit-transition: color .15s ease-in-out, background-color .15s ease-in-out;\n"
+               "  transition: color .15s ease-in-out, background-color .15s ease-in-out;\n"
+               "}\n";
+        css += ".u-m-" + n + " { margin-top: " + std::to_string(i % 48) + "px }\n";
+        if (i % 10 == 0) {
+            css += "@media (min-width: 768px) { .col-md-" + n + " { flex: 0 0 auto; width: 33.33333333% } }\n";
+            css += ".icon-" + n + "::before { content: \"\\f101\"; background-image: url(data:image/svg+xml;base64,"
+                   "PHN2ZyB4bWxucz0iaHR0cDovL3d3dy53My5vcmcvMjAwMC9zdmciIHZpZXdCb3g9IjAgMCAxNiAxNiI+PHBhdGggZD0iTTIgMmgxMnYxMkgyeiIvPjwvc3ZnPg=="
+                   ") }\n";
+        }
+    }
+    return css;
+}
+
+template<typename Fn>
+double best_ms(Fn&& fn) {
+    double best = 0.0;
+    for (int round = 0; round < 5; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = round == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void report(const char* label, usize count, const char* unit, usize bytes, double ms) {
+    double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::printf("%-9s %8zu %-7s %7.2f MB %9.2f ms %9.1f MB/s\n", label, count, unit, mb, ms,
+                ms > 0 ? mb / (ms / 1000.0) : 0.0);
+}
+
+int run_bench(const String& css) {
+    usize tokens = 0;
+    double tokenize_ms = best_ms([&] {
+        css::TokenStream stream(css.view());
+        tokens = 0;
+        while (stream.next().kind != css::TokenKind::EndOfFile) {
+            ++tokens;
+        }
+    });
+    report("tokenize", tokens, "tokens", css.size(), tokenize_ms);
+
+    usize rules = 0;
+    double parse_ms = best_ms([&] {
+        css::Parser parser;
+        rules = parser.parse_stylesheet(css).rules.size();
+    });
+    report("parse", rules, "rules", css.size(), parse_ms);
+    return 0;
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
     logging::init();
     logging::set_level(LogLevel::Warn);
 
+    bool bench = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench") {
+            bench = true;
+        } else if (!path) {
+            path = argv[i];
+        }
+    }
+
     String css;
 
-    if (argc > 1) {
-        std::ifstream file(argv[1]);
+    if (path) {
+        std::ifstream file(path);
         if (!file) {
-            std::cerr << "Error: Cannot open file: " << argv[1] << "\n";
+            std::cerr << "Error: Cannot open file: " << path << "\n";
             return 1;
         }
         std::stringstream buffer;
         buffer << file.rdbuf();
         css = String(buffer.str());
+    } else if (bench) {
+        css = String(make_bundle(4 * 1024 * 1024));
     } else {
         std::stringstream buffer;
         buffer << std::cin.rdbuf();
         css = String(buffer.str());
     }
 
+    if (bench) {
+        int status = run_bench(css);
+        logging::shutdown();
+        return status;
+    }
+
     css::Parser parser;
     auto stylesheet = parser.parse_stylesheet(css);
 
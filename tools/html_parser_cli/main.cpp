@@ -22,13 +22,13 @@ void print_node(const dom::Node* node, int indent = 0) {
         std::cout << prefix << "<" << element->tag_name().c_str();
 
         for (const auto& attr : element->attributes()) {
-            std::cout << " " << attr.name.c_str() << "=\"" << attr.value.c_str() << "\"";
+            std::cout << " " << attr.name().c_str() << "=\"" << attr.value.c_str() << "\"";
         }
 
         std::cout << ">\n";
 
         for (const auto& child : node->child_nodes()) {
-            print_node(child.get(), indent + 1);
+            print_node(child, indent + 1);
         }
 
         std::cout << prefix << "</" << element->tag_name().c_str() << ">\n";
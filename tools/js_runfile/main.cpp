@@ -8,18 +8,56 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string>
 
 using namespace lithium;
 
+namespace {
+
+void print_pause_histogram(const char* label, const js::GarbageCollector::CollectionStats& stats) {
+    const auto& pauses = stats.pauses;
+    std::cerr << label << ": " << stats.collections << " collections, "
+              << pauses.pauses << " pauses, total " << pauses.total_us << "us, max "
+              << pauses.max_us << "us";
+    if (stats.mark_slices > 0) {
+        std::cerr << ", " << stats.mark_slices << " mark slices";
+    }
+    if (stats.sweep_steps > 0) {
+        std::cerr << ", " << stats.sweep_steps << " sweep steps";
+    }
+    std::cerr << "\n";
+    for (usize i = 0; i < pauses.buckets.size(); ++i) {
+        if (pauses.buckets[i] == 0) {
+            continue;
+        }
+        std::cerr << "  >= " << js::GarbageCollector::PauseHistogram::bucket_lower_bound(i)
+                  << "us: " << pauses.buckets[i] << "\n";
+    }
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
     logging::init();
     logging::set_level(LogLevel::Warn);
 
+    // Usage: lithium-js-run [--gc-stats] [file]
+    bool gc_stats = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--gc-stats") {
+            gc_stats = true;
+        } else if (!path) {
+            path = argv[i];
+        }
+    }
+
     String source;
-    if (argc > 1) {
-        std::ifstream in(argv[1], std::ios::in | std::ios::binary);
+    if (path) {
+        std::ifstream in(path, std::ios::in | std::ios::binary);
         if (!in) {
-            std::cerr << "Failed to read file: " << argv[1] << "\n";
+            std::cerr << "Failed to read file: " << path << "\n";
             return 1;
         }
         std::ostringstream ss;
@@ -34,7 +72,7 @@ int main(int argc, char* argv[]) {
     js::VM vm;
 
     // Determine filename
-    String filename = argc > 1 ? String(argv[1]) : "<stdin>"_s;
+    String filename = path ? String(path) : "<stdin>"_s;
 
     // Add print native function
     vm.define_native("print"_s, [](js::VM&, const std::vector<js::Value>& args) -> js::Value {
@@ -48,7 +86,7 @@ int main(int argc, char* argv[]) {
 
     // Add console.log
     auto console = std::make_shared<js::Object>();
-    console->set_property("log"_s, js::Value(std::make_shared<js::NativeFunction>(
+    console->set_property("log"_s, js::Value(vm.gc().allocate<js::NativeFunction>(
         "log"_s, [](js::VM&, const std::vector<js::Value>& args) -> js::Value {
             for (usize i = 0; i < args.size(); ++i) {
                 if (i > 0) std::cout << " ";
@@ -56,13 +94,18 @@ int main(int argc, char* argv[]) {
             }
             std::cout << "\n";
             return js::Value::undefined();
-        }, 1)));
+        }, u8{1})));
     vm.define_native("console"_s, [console](js::VM&, const std::vector<js::Value>&) -> js::Value {
         return js::Value(console);
     }, 0);
 
     auto result = vm.interpret(source, filename);
 
+    if (gc_stats) {
+        print_pause_histogram("minor GC", vm.gc().minor_stats());
+        print_pause_histogram("major GC", vm.gc().major_stats());
+    }
+
     auto error_type_name = [](js::ErrorType type) -> const char* {
         switch (type) {
             case js::ErrorType::ReferenceError: return "ReferenceError";